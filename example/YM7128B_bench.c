@@ -0,0 +1,1965 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2020-2023, Andrea Zoppi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#if !defined(_POSIX_C_SOURCE) && !defined(_WIN32)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "YM7128B_emu.h"
+
+#include <errno.h>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "endian.h"
+#include "presets.h"
+
+#ifdef __WINDOWS__
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAS_CYCLES 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define HAS_CYCLES 1
+#else
+#define HAS_CYCLES 0
+#endif
+
+
+static char const* USAGE = ("\
+YM7128B_bench (c) 2020, Andrea Zoppi. All rights reserved.\n\
+\n\
+This program measures the processing throughput of the YM7128B emulation\n\
+engines, over synthetic input (white noise) and optionally over a real\n\
+recording.\n\
+For each engine, it measures the per-sample Process() path, the\n\
+ProcessBlock() path for each block size and supported kernel, and for the\n\
+fixed and float engines, the batched ChipBank path.\n\
+Timings are the best of the repeated runs, per input sample and per chip.\n\
+Cycles are measured via the time-stamp counter, where available.\n\
+\n\
+With --check, it verifies instead that all the processing paths produce the\n\
+same outputs as the per-sample scalar reference, over a matrix of register\n\
+settings: presets, all the tap values, extreme gains and feedback.\n\
+Fixed and short engines must be bit-exact; the first differing sample is\n\
+reported. Float and ideal engines report the maximum error, in ULP and dB,\n\
+within the --ulp tolerance; ULP are those of full scale, or of the expected\n\
+sample when larger, so that rounding noise around zero stays negligible.\n\
+The reference itself can be recorded into a golden file, and checked\n\
+against it later, to guard the scalar code across changes.\n\
+\n\
+\n\
+USAGE:\n\
+  bench [OPTION]...\n\
+\n\
+\n\
+OPTIONS:\n\
+\n\
+-b, --block SIZE\n\
+    Benchmarks only the given block size; default: 1, 16, 64, 256, 1024.\n\
+\n\
+--check\n\
+    Checks the bit-exactness of all the processing paths.\n\
+\n\
+--chips COUNT\n\
+    Number of chips of the batched path; default: 64.\n\
+\n\
+--csv\n\
+    Prints comma-separated values.\n\
+\n\
+-e, --engine ENGINE\n\
+    Benchmarks only the given engine; default: all. See ENGINE table.\n\
+\n\
+--golden PATH\n\
+    Checks the reference against a golden file; implies --check.\n\
+\n\
+-h, --help\n\
+    Prints this help message and quits.\n\
+\n\
+-i, --input PATH\n\
+    Also benchmarks the given mono S16_LE raw file, like\n\
+    sample_mono_23550Hz_S16LE.raw; default: none.\n\
+\n\
+-n, --repeat COUNT\n\
+    Number of repeated runs; default: 3.\n\
+\n\
+--preset PRESET\n\
+    Register preset; default: dune/arrakis. See the YM7128B_pipe presets.\n\
+\n\
+--record PATH\n\
+    Records the reference into a golden file; implies --check.\n\
+\n\
+-r, --rate RATE\n\
+    Sample rate of the ideal and short engines; default: 23550.\n\
+\n\
+-s, --seconds SECONDS\n\
+    Length of the synthetic input; default: 10.\n\
+\n\
+--ulp COUNT\n\
+    Error tolerance of the float and ideal engines checks; default: 16.\n\
+\n\
+\n\
+ENGINE:\n\
+| Name  | Description                           |\n\
+|-------|---------------------------------------|\n\
+| fixed | Fixed point emulation (default).      |\n\
+| float | Floating point emulation.             |\n\
+| ideal | Ideal emulation.                      |\n\
+| short | 16-bit fixed point emulation.         |\n\
+");
+
+
+struct ChipModeTable {
+    char const* label;
+    YM7128B_ChipEngine value;
+} const MODE_TABLE[] =
+{
+    { "fixed", YM7128B_ChipEngine_Fixed },
+    { "float", YM7128B_ChipEngine_Float },
+    { "ideal", YM7128B_ChipEngine_Ideal },
+    { "short", YM7128B_ChipEngine_Short },
+    { NULL,    YM7128B_ChipEngine_Count }
+};
+
+
+char const* const KERNEL_LABELS[YM7128B_Kernel_Count] =
+{
+    "scalar",
+    "sse2",
+    "avx2",
+    "neon",
+};
+
+
+size_t const BLOCK_SIZES[] = { 1, 16, 64, 256, 1024, 0 };
+
+
+typedef enum Path {
+    Path_Process = 0,
+    Path_Block,
+    Path_Bank,
+    Path_Count
+} Path;
+
+char const* const PATH_LABELS[Path_Count] =
+{
+    "process",
+    "block",
+    "bank",
+};
+
+
+typedef struct Args {
+    YM7128B_Register regs[YM7128B_Reg_Count];
+    YM7128B_TapIdeal rate;
+    size_t block;
+    size_t chips;
+    int repeat;
+    int engine;
+    int csv;
+    int check;
+    int recording;
+    char const* golden_path;
+    uint64_t ulp;
+} Args;
+
+
+typedef struct Signal {
+    char const* label;
+    YM7128B_Float* data;
+    size_t length;
+} Signal;
+
+
+typedef struct Timing {
+    double ns;
+    double cycles;
+} Timing;
+
+
+static volatile YM7128B_Float g_sink;
+
+
+static uint64_t NowNs(void);
+static uint64_t NowCycles(void);
+static int LoadSignal(Signal* signal, char const* path);
+static int MakeNoise(Signal* signal, size_t length);
+static void Report(Args const* args, Signal const* signal, YM7128B_ChipEngine engine,
+                   Path path, YM7128B_Kernel kernel, size_t block, Timing const* timing);
+static int BenchFixed(Args const* args, Signal const* signal);
+static int BenchFloat(Args const* args, Signal const* signal);
+static int BenchIdeal(Args const* args, Signal const* signal);
+static int BenchShort(Args const* args, Signal const* signal);
+static int RunCheck(Args const* args);
+
+
+static uint64_t NowNs(void)
+{
+#ifdef __WINDOWS__
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)(((double)counter.QuadPart * 1e9) / (double)frequency.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+
+static uint64_t NowCycles(void)
+{
+#if HAS_CYCLES
+    return (uint64_t)__rdtsc();
+#else
+    return 0;
+#endif
+}
+
+
+static void TimingBegin(uint64_t* ns, uint64_t* cycles)
+{
+    *cycles = NowCycles();
+    *ns = NowNs();
+}
+
+
+static void TimingEnd(Timing* timing, uint64_t ns, uint64_t cycles, size_t samples)
+{
+    double elapsed_ns = (double)(NowNs() - ns);
+    double elapsed_cycles = (double)(NowCycles() - cycles);
+    double n = (double)samples;
+
+    if (timing->ns <= 0 || (elapsed_ns / n) < timing->ns) {
+        timing->ns = elapsed_ns / n;
+        timing->cycles = elapsed_cycles / n;
+    }
+}
+
+
+static int LoadSignal(Signal* signal, char const* path)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        perror(path);
+        return 1;
+    }
+
+    size_t capacity = 1 << 16;
+    size_t length = 0;
+    YM7128B_Float* data = (YM7128B_Float*)malloc(capacity * sizeof(YM7128B_Float));
+    unsigned char bytes[2];
+
+    while (data && fread(bytes, sizeof(bytes), 1, file) == 1) {
+        if (length >= capacity) {
+            capacity *= 2;
+            YM7128B_Float* grown = (YM7128B_Float*)realloc(data, capacity * sizeof(YM7128B_Float));
+            if (!grown) {
+                free(data);
+                data = NULL;
+                break;
+            }
+            data = grown;
+        }
+        int16_t value = (int16_t)((unsigned)bytes[0] | ((unsigned)bytes[1] << 8));
+        data[length++] = (YM7128B_Float)value / 32768;
+    }
+    fclose(file);
+
+    if (!data || !length) {
+        fprintf(stderr, "Cannot load input: %s\n", path);
+        free(data);
+        return 1;
+    }
+
+    signal->label = path;
+    signal->data = data;
+    signal->length = length;
+    return 0;
+}
+
+
+static int MakeNoise(Signal* signal, size_t length)
+{
+    YM7128B_Float* data = (YM7128B_Float*)malloc(length * sizeof(YM7128B_Float));
+    if (!data) {
+        return 1;
+    }
+
+    uint32_t lfsr = 0x12345678u;
+    for (size_t i = 0; i < length; ++i) {
+        lfsr ^= lfsr << 13;
+        lfsr ^= lfsr >> 17;
+        lfsr ^= lfsr << 5;
+        data[i] = ((YM7128B_Float)(int32_t)lfsr / (YM7128B_Float)2147483648.0) / 2;
+    }
+
+    signal->label = "noise";
+    signal->data = data;
+    signal->length = length;
+    return 0;
+}
+
+
+static void Report(Args const* args, Signal const* signal, YM7128B_ChipEngine engine,
+                   Path path, YM7128B_Kernel kernel, size_t block, Timing const* timing)
+{
+    char const* engine_label = MODE_TABLE[engine].label;
+    double rate = (timing->ns > 0) ? (1e9 / timing->ns) : 0;
+
+    if (args->csv) {
+        printf("%s,%s,%s,%lu,%s,%.3f,%.0f,", engine_label, PATH_LABELS[path],
+               KERNEL_LABELS[kernel], (unsigned long)block, signal->label, timing->ns, rate);
+        if (HAS_CYCLES) {
+            printf("%.2f\n", timing->cycles);
+        }
+        else {
+            printf("\n");
+        }
+    }
+    else {
+        printf("%-6s %-8s %-6s %6lu  %-12.12s %10.3f %14.0f", engine_label, PATH_LABELS[path],
+               KERNEL_LABELS[kernel], (unsigned long)block, signal->label, timing->ns, rate);
+        if (HAS_CYCLES) {
+            printf(" %14.2f\n", timing->cycles);
+        }
+        else {
+            printf(" %14s\n", "n/a");
+        }
+    }
+    fflush(stdout);
+}
+
+
+static void ReportHeader(Args const* args)
+{
+    if (args->csv) {
+        printf("engine,path,kernel,block,input,ns_per_sample,samples_per_sec,cycles_per_sample\n");
+    }
+    else {
+        printf("%-6s %-8s %-6s %6s  %-12s %10s %14s %14s\n", "engine", "path", "kernel", "block",
+               "input", "ns/sample", "samples/sec", "cycles/sample");
+    }
+}
+
+
+int main(int argc, char const* argv[])
+{
+    Args args;
+    args.rate = (YM7128B_TapIdeal)YM7128B_Input_Rate;
+    args.block = 0;
+    args.chips = 64;
+    args.repeat = 3;
+    args.engine = -1;
+    args.csv = 0;
+    args.check = 0;
+    args.recording = 0;
+    args.golden_path = NULL;
+    args.ulp = 16;
+    for (YM7128B_Address r = 0; r < (YM7128B_Address)YM7128B_Reg_Count; ++r) {
+        args.regs[r] = 0;
+    }
+
+    char const* preset = "dune/arrakis";
+    char const* input_path = NULL;
+    long seconds = 10;
+
+    for (int i = 1; i < argc; ++i) {
+        // Unary arguments
+        if (!strcmp(argv[i], "-h") ||
+            !strcmp(argv[i], "--help")) {
+            puts(USAGE);
+            return 0;
+        }
+        if (!strcmp(argv[i], "--csv")) {
+            args.csv = 1;
+            continue;
+        }
+        if (!strcmp(argv[i], "--check")) {
+            args.check = 1;
+            continue;
+        }
+
+        // Binary arguments
+        if (i >= argc - 1) {
+            fprintf(stderr, "Expecting binary argument: %s\n", argv[i]);
+            return 1;
+        }
+        else if (!strcmp(argv[i], "-b") || !strcmp(argv[i], "--block")) {
+            long block = strtol(argv[++i], NULL, 10);
+            if (errno || block < 1) {
+                fprintf(stderr, "Invalid block size: %s\n", argv[i]);
+                return 1;
+            }
+            args.block = (size_t)block;
+        }
+        else if (!strcmp(argv[i], "--chips")) {
+            long chips = strtol(argv[++i], NULL, 10);
+            if (errno || chips < 1) {
+                fprintf(stderr, "Invalid chip count: %s\n", argv[i]);
+                return 1;
+            }
+            args.chips = (size_t)chips;
+        }
+        else if (!strcmp(argv[i], "-e") || !strcmp(argv[i], "--engine")) {
+            char const* label = argv[++i];
+            int j;
+            for (j = 0; MODE_TABLE[j].label; ++j) {
+                if (!strcmp(label, MODE_TABLE[j].label)) {
+                    args.engine = (int)MODE_TABLE[j].value;
+                    break;
+                }
+            }
+            if (!MODE_TABLE[j].label) {
+                fprintf(stderr, "Unknown engine: %s\n", label);
+                return 1;
+            }
+        }
+        else if (!strcmp(argv[i], "--golden")) {
+            args.check = 1;
+            args.recording = 0;
+            args.golden_path = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-i") || !strcmp(argv[i], "--input")) {
+            input_path = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-n") || !strcmp(argv[i], "--repeat")) {
+            long repeat = strtol(argv[++i], NULL, 10);
+            if (errno || repeat < 1) {
+                fprintf(stderr, "Invalid repeat count: %s\n", argv[i]);
+                return 1;
+            }
+            args.repeat = (int)repeat;
+        }
+        else if (!strcmp(argv[i], "--preset")) {
+            preset = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--record")) {
+            args.check = 1;
+            args.recording = 1;
+            args.golden_path = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-r") || !strcmp(argv[i], "--rate")) {
+            long rate = strtol(argv[++i], NULL, 10);
+            if (errno || rate < 10) {
+                fprintf(stderr, "Invalid rate: %s\n", argv[i]);
+                return 1;
+            }
+            args.rate = (YM7128B_TapIdeal)rate;
+        }
+        else if (!strcmp(argv[i], "-s") || !strcmp(argv[i], "--seconds")) {
+            seconds = strtol(argv[++i], NULL, 10);
+            if (errno || seconds < 1) {
+                fprintf(stderr, "Invalid seconds: %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (!strcmp(argv[i], "--ulp")) {
+            long ulp = strtol(argv[++i], NULL, 10);
+            if (errno || ulp < 0) {
+                fprintf(stderr, "Invalid ULP tolerance: %s\n", argv[i]);
+                return 1;
+            }
+            args.ulp = (uint64_t)ulp;
+        }
+        else {
+            fprintf(stderr, "Unknown switch: %s\n", argv[i]);
+            return 1;
+        }
+
+        if (errno) {
+            fprintf(stderr, "arg %d", i);
+            perror("");
+            return 1;
+        }
+    }
+
+    int j;
+    for (j = 0; PRESET_TABLE[j].label; ++j) {
+        if (!strcmp(preset, PRESET_TABLE[j].label)) {
+            break;
+        }
+    }
+    if (!PRESET_TABLE[j].label) {
+        fprintf(stderr, "Unknown preset: %s\n", preset);
+        return 1;
+    }
+    for (YM7128B_Address r = 0; r < (YM7128B_Address)YM7128B_Reg_Count; ++r) {
+        args.regs[r] = PRESET_TABLE[j].regs[r];
+    }
+
+    if (args.check) {
+        return RunCheck(&args);
+    }
+
+    Signal signals[2];
+    int signal_count = 0;
+
+    if (MakeNoise(&signals[signal_count], (size_t)seconds * (size_t)YM7128B_Input_Rate)) {
+        fprintf(stderr, "Cannot allocate input\n");
+        return 1;
+    }
+    ++signal_count;
+
+    if (input_path) {
+        if (LoadSignal(&signals[signal_count], input_path)) {
+            free(signals[0].data);
+            return 1;
+        }
+        ++signal_count;
+    }
+
+    int error = 0;
+    ReportHeader(&args);
+
+    for (int s = 0; s < signal_count && !error; ++s) {
+        Signal const* signal = &signals[s];
+
+        if (args.engine < 0 || args.engine == (int)YM7128B_ChipEngine_Fixed) {
+            error = error || BenchFixed(&args, signal);
+        }
+        if (args.engine < 0 || args.engine == (int)YM7128B_ChipEngine_Float) {
+            error = error || BenchFloat(&args, signal);
+        }
+        if (args.engine < 0 || args.engine == (int)YM7128B_ChipEngine_Ideal) {
+            error = error || BenchIdeal(&args, signal);
+        }
+        if (args.engine < 0 || args.engine == (int)YM7128B_ChipEngine_Short) {
+            error = error || BenchShort(&args, signal);
+        }
+    }
+
+    for (int s = 0; s < signal_count; ++s) {
+        free(signals[s].data);
+    }
+    return error;
+}
+
+
+static size_t const* GetBlockSizes(Args const* args, size_t single[2])
+{
+    if (args->block) {
+        single[0] = args->block;
+        single[1] = 0;
+        return single;
+    }
+    return BLOCK_SIZES;
+}
+
+
+static int BenchFixed(Args const* args, Signal const* signal)
+{
+    size_t single[2];
+    size_t const* blocks = GetBlockSizes(args, single);
+    size_t max_block = 1;
+    for (size_t b = 0; blocks[b]; ++b) {
+        if (max_block < blocks[b]) {
+            max_block = blocks[b];
+        }
+    }
+
+    size_t const length = signal->length;
+    size_t const outputs_length = max_block * YM7128B_Oversampling;
+    YM7128B_ChipFixed* chip = (YM7128B_ChipFixed*)malloc(sizeof(YM7128B_ChipFixed));
+    YM7128B_Fixed* inputs = (YM7128B_Fixed*)malloc(length * sizeof(YM7128B_Fixed));
+    YM7128B_Fixed* outputs = (YM7128B_Fixed*)malloc(outputs_length * YM7128B_OutputChannel_Count * sizeof(YM7128B_Fixed));
+    if (!chip || !inputs || !outputs) {
+        fprintf(stderr, "Cannot allocate Fixed buffers\n");
+        free(chip);
+        free(inputs);
+        free(outputs);
+        return 1;
+    }
+    YM7128B_Fixed* outputs_left = &outputs[0];
+    YM7128B_Fixed* outputs_right = &outputs[outputs_length];
+
+    for (size_t i = 0; i < length; ++i) {
+        inputs[i] = (YM7128B_Fixed)(YM7128B_ClampFloat(signal->data[i]) * (YM7128B_Float)YM7128B_Fixed_Max);
+    }
+
+    // Per-sample path
+    Timing timing = { 0, 0 };
+    for (int r = 0; r < args->repeat; ++r) {
+        YM7128B_ChipFixed_Ctor(chip);
+        YM7128B_ChipFixed_Reset(chip);
+        for (YM7128B_Address a = 0; a < (YM7128B_Address)YM7128B_Reg_Count; ++a) {
+            YM7128B_ChipFixed_Write(chip, a, args->regs[a]);
+        }
+        YM7128B_ChipFixed_Start(chip);
+
+        YM7128B_ChipFixed_Process_Data data;
+        uint64_t ns, cycles;
+        TimingBegin(&ns, &cycles);
+        for (size_t i = 0; i < length; ++i) {
+            data.inputs[YM7128B_InputChannel_Mono] = inputs[i];
+            YM7128B_ChipFixed_Process(chip, &data);
+        }
+        TimingEnd(&timing, ns, cycles, length);
+        g_sink += (YM7128B_Float)data.outputs[YM7128B_OutputChannel_Left][0];
+
+        YM7128B_ChipFixed_Stop(chip);
+        YM7128B_ChipFixed_Dtor(chip);
+    }
+    Report(args, signal, YM7128B_ChipEngine_Fixed, Path_Process, YM7128B_Kernel_GetBest(), 1, &timing);
+
+    // Block path
+    for (int kernel = 0; kernel < (int)YM7128B_Kernel_Count; ++kernel) {
+        if (!YM7128B_Kernel_IsSupported((YM7128B_Kernel)kernel)) {
+            continue;
+        }
+        for (size_t b = 0; blocks[b]; ++b) {
+            size_t const block = blocks[b];
+            timing.ns = 0;
+            timing.cycles = 0;
+
+            for (int r = 0; r < args->repeat; ++r) {
+                YM7128B_ChipFixed_Ctor(chip);
+                YM7128B_ChipFixed_Reset(chip);
+                for (YM7128B_Address a = 0; a < (YM7128B_Address)YM7128B_Reg_Count; ++a) {
+                    YM7128B_ChipFixed_Write(chip, a, args->regs[a]);
+                }
+                YM7128B_ChipFixed_SetKernel(chip, (YM7128B_Kernel)kernel);
+                YM7128B_ChipFixed_Start(chip);
+
+                uint64_t ns, cycles;
+                TimingBegin(&ns, &cycles);
+                for (size_t i = 0; i < length; i += block) {
+                    size_t count = ((length - i) < block) ? (length - i) : block;
+                    YM7128B_ChipFixed_ProcessBlock(chip, &inputs[i], count, outputs_left, outputs_right);
+                }
+                TimingEnd(&timing, ns, cycles, length);
+                g_sink += (YM7128B_Float)outputs_left[0];
+
+                YM7128B_ChipFixed_Stop(chip);
+                YM7128B_ChipFixed_Dtor(chip);
+            }
+            Report(args, signal, YM7128B_ChipEngine_Fixed, Path_Block, (YM7128B_Kernel)kernel, block, &timing);
+        }
+    }
+
+    // Batched path
+    size_t const chips = args->chips;
+    size_t const frames = (length >= chips) ? (length / chips) : 1;
+    YM7128B_Fixed* bank_inputs = (YM7128B_Fixed*)malloc(frames * chips * sizeof(YM7128B_Fixed));
+    YM7128B_Fixed* bank_outputs = (YM7128B_Fixed*)malloc(outputs_length * chips * YM7128B_OutputChannel_Count * sizeof(YM7128B_Fixed));
+    YM7128B_ChipBankFixed bank;
+    YM7128B_ChipBankFixed_Ctor(&bank);
+
+    if (!bank_inputs || !bank_outputs || !YM7128B_ChipBankFixed_Setup(&bank, chips)) {
+        fprintf(stderr, "Cannot allocate Fixed bank buffers\n");
+        free(bank_inputs);
+        free(bank_outputs);
+        free(chip);
+        free(inputs);
+        free(outputs);
+        return 1;
+    }
+
+    for (size_t i = 0; i < frames; ++i) {
+        for (size_t c = 0; c < chips; ++c) {
+            bank_inputs[(i * chips) + c] = inputs[((c * frames) + i) % length];
+        }
+    }
+
+    YM7128B_Fixed* bank_outputs_left = &bank_outputs[0];
+    YM7128B_Fixed* bank_outputs_right = &bank_outputs[outputs_length * chips];
+
+    for (size_t b = 0; blocks[b]; ++b) {
+        size_t const block = blocks[b];
+        timing.ns = 0;
+        timing.cycles = 0;
+
+        for (int r = 0; r < args->repeat; ++r) {
+            YM7128B_ChipBankFixed_Reset(&bank);
+            for (size_t c = 0; c < chips; ++c) {
+                for (YM7128B_Address a = 0; a < (YM7128B_Address)YM7128B_Reg_Count; ++a) {
+                    YM7128B_ChipBankFixed_Write(&bank, c, a, args->regs[a]);
+                }
+            }
+            YM7128B_ChipBankFixed_Start(&bank);
+
+            uint64_t ns, cycles;
+            TimingBegin(&ns, &cycles);
+            for (size_t i = 0; i < frames; i += block) {
+                size_t count = ((frames - i) < block) ? (frames - i) : block;
+                YM7128B_ChipBankFixed_ProcessBlock(&bank, &bank_inputs[i * chips], count,
+                                                 bank_outputs_left, bank_outputs_right);
+            }
+            TimingEnd(&timing, ns, cycles, frames * chips);
+            g_sink += (YM7128B_Float)bank_outputs_left[0];
+
+            YM7128B_ChipBankFixed_Stop(&bank);
+        }
+        Report(args, signal, YM7128B_ChipEngine_Fixed, Path_Bank, YM7128B_Kernel_Scalar, block, &timing);
+    }
+
+    YM7128B_ChipBankFixed_Dtor(&bank);
+    free(bank_inputs);
+    free(bank_outputs);
+
+    free(chip);
+    free(inputs);
+    free(outputs);
+    return 0;
+}
+
+
+static int BenchFloat(Args const* args, Signal const* signal)
+{
+    size_t single[2];
+    size_t const* blocks = GetBlockSizes(args, single);
+    size_t max_block = 1;
+    for (size_t b = 0; blocks[b]; ++b) {
+        if (max_block < blocks[b]) {
+            max_block = blocks[b];
+        }
+    }
+
+    size_t const length = signal->length;
+    size_t const outputs_length = max_block * YM7128B_Oversampling;
+    YM7128B_ChipFloat* chip = (YM7128B_ChipFloat*)malloc(sizeof(YM7128B_ChipFloat));
+    YM7128B_Float* inputs = (YM7128B_Float*)malloc(length * sizeof(YM7128B_Float));
+    YM7128B_Float* outputs = (YM7128B_Float*)malloc(outputs_length * YM7128B_OutputChannel_Count * sizeof(YM7128B_Float));
+    if (!chip || !inputs || !outputs) {
+        fprintf(stderr, "Cannot allocate Float buffers\n");
+        free(chip);
+        free(inputs);
+        free(outputs);
+        return 1;
+    }
+    YM7128B_Float* outputs_left = &outputs[0];
+    YM7128B_Float* outputs_right = &outputs[outputs_length];
+
+    for (size_t i = 0; i < length; ++i) {
+        inputs[i] = signal->data[i];
+    }
+
+    // Per-sample path
+    Timing timing = { 0, 0 };
+    for (int r = 0; r < args->repeat; ++r) {
+        YM7128B_ChipFloat_Ctor(chip);
+        YM7128B_ChipFloat_Reset(chip);
+        for (YM7128B_Address a = 0; a < (YM7128B_Address)YM7128B_Reg_Count; ++a) {
+            YM7128B_ChipFloat_Write(chip, a, args->regs[a]);
+        }
+        YM7128B_ChipFloat_Start(chip);
+
+        YM7128B_ChipFloat_Process_Data data;
+        uint64_t ns, cycles;
+        TimingBegin(&ns, &cycles);
+        for (size_t i = 0; i < length; ++i) {
+            data.inputs[YM7128B_InputChannel_Mono] = inputs[i];
+            YM7128B_ChipFloat_Process(chip, &data);
+        }
+        TimingEnd(&timing, ns, cycles, length);
+        g_sink += (YM7128B_Float)data.outputs[YM7128B_OutputChannel_Left][0];
+
+        YM7128B_ChipFloat_Stop(chip);
+        YM7128B_ChipFloat_Dtor(chip);
+    }
+    Report(args, signal, YM7128B_ChipEngine_Float, Path_Process, YM7128B_Kernel_Scalar, 1, &timing);
+
+    // Block path
+    for (int kernel = 0; kernel < (int)YM7128B_Kernel_Count; ++kernel) {
+        if (kernel != (int)YM7128B_Kernel_Scalar) {
+            continue;
+        }
+        for (size_t b = 0; blocks[b]; ++b) {
+            size_t const block = blocks[b];
+            timing.ns = 0;
+            timing.cycles = 0;
+
+            for (int r = 0; r < args->repeat; ++r) {
+                YM7128B_ChipFloat_Ctor(chip);
+                YM7128B_ChipFloat_Reset(chip);
+                for (YM7128B_Address a = 0; a < (YM7128B_Address)YM7128B_Reg_Count; ++a) {
+                    YM7128B_ChipFloat_Write(chip, a, args->regs[a]);
+                }
+                YM7128B_ChipFloat_Start(chip);
+
+                uint64_t ns, cycles;
+                TimingBegin(&ns, &cycles);
+                for (size_t i = 0; i < length; i += block) {
+                    size_t count = ((length - i) < block) ? (length - i) : block;
+                    YM7128B_ChipFloat_ProcessBlock(chip, &inputs[i], count, outputs_left, outputs_right);
+                }
+                TimingEnd(&timing, ns, cycles, length);
+                g_sink += (YM7128B_Float)outputs_left[0];
+
+                YM7128B_ChipFloat_Stop(chip);
+                YM7128B_ChipFloat_Dtor(chip);
+            }
+            Report(args, signal, YM7128B_ChipEngine_Float, Path_Block, (YM7128B_Kernel)kernel, block, &timing);
+        }
+    }
+
+    // Batched path
+    size_t const chips = args->chips;
+    size_t const frames = (length >= chips) ? (length / chips) : 1;
+    YM7128B_Float* bank_inputs = (YM7128B_Float*)malloc(frames * chips * sizeof(YM7128B_Float));
+    YM7128B_Float* bank_outputs = (YM7128B_Float*)malloc(outputs_length * chips * YM7128B_OutputChannel_Count * sizeof(YM7128B_Float));
+    YM7128B_ChipBankFloat bank;
+    YM7128B_ChipBankFloat_Ctor(&bank);
+
+    if (!bank_inputs || !bank_outputs || !YM7128B_ChipBankFloat_Setup(&bank, chips)) {
+        fprintf(stderr, "Cannot allocate Float bank buffers\n");
+        free(bank_inputs);
+        free(bank_outputs);
+        free(chip);
+        free(inputs);
+        free(outputs);
+        return 1;
+    }
+
+    for (size_t i = 0; i < frames; ++i) {
+        for (size_t c = 0; c < chips; ++c) {
+            bank_inputs[(i * chips) + c] = inputs[((c * frames) + i) % length];
+        }
+    }
+
+    YM7128B_Float* bank_outputs_left = &bank_outputs[0];
+    YM7128B_Float* bank_outputs_right = &bank_outputs[outputs_length * chips];
+
+    for (int kernel = 0; kernel < (int)YM7128B_Kernel_Count; ++kernel) {
+        if (!YM7128B_ChipBankFloat_SetKernel(&bank, (YM7128B_Kernel)kernel)) {
+            continue;
+        }
+        for (size_t b = 0; blocks[b]; ++b) {
+            size_t const block = blocks[b];
+            timing.ns = 0;
+            timing.cycles = 0;
+
+            for (int r = 0; r < args->repeat; ++r) {
+                YM7128B_ChipBankFloat_Reset(&bank);
+                for (size_t c = 0; c < chips; ++c) {
+                    for (YM7128B_Address a = 0; a < (YM7128B_Address)YM7128B_Reg_Count; ++a) {
+                        YM7128B_ChipBankFloat_Write(&bank, c, a, args->regs[a]);
+                    }
+                }
+                YM7128B_ChipBankFloat_Start(&bank);
+
+                uint64_t ns, cycles;
+                TimingBegin(&ns, &cycles);
+                for (size_t i = 0; i < frames; i += block) {
+                    size_t count = ((frames - i) < block) ? (frames - i) : block;
+                    YM7128B_ChipBankFloat_ProcessBlock(&bank, &bank_inputs[i * chips], count,
+                                                     bank_outputs_left, bank_outputs_right);
+                }
+                TimingEnd(&timing, ns, cycles, frames * chips);
+                g_sink += (YM7128B_Float)bank_outputs_left[0];
+
+                YM7128B_ChipBankFloat_Stop(&bank);
+            }
+            Report(args, signal, YM7128B_ChipEngine_Float, Path_Bank, (YM7128B_Kernel)kernel, block, &timing);
+        }
+    }
+
+    YM7128B_ChipBankFloat_Dtor(&bank);
+    free(bank_inputs);
+    free(bank_outputs);
+
+    free(chip);
+    free(inputs);
+    free(outputs);
+    return 0;
+}
+
+
+static int BenchIdeal(Args const* args, Signal const* signal)
+{
+    size_t single[2];
+    size_t const* blocks = GetBlockSizes(args, single);
+    size_t max_block = 1;
+    for (size_t b = 0; blocks[b]; ++b) {
+        if (max_block < blocks[b]) {
+            max_block = blocks[b];
+        }
+    }
+
+    size_t const length = signal->length;
+    size_t const outputs_length = max_block * 1;
+    YM7128B_ChipIdeal* chip = (YM7128B_ChipIdeal*)malloc(sizeof(YM7128B_ChipIdeal));
+    YM7128B_Float* inputs = (YM7128B_Float*)malloc(length * sizeof(YM7128B_Float));
+    YM7128B_Float* outputs = (YM7128B_Float*)malloc(outputs_length * YM7128B_OutputChannel_Count * sizeof(YM7128B_Float));
+    if (!chip || !inputs || !outputs) {
+        fprintf(stderr, "Cannot allocate Ideal buffers\n");
+        free(chip);
+        free(inputs);
+        free(outputs);
+        return 1;
+    }
+    YM7128B_Float* outputs_left = &outputs[0];
+    YM7128B_Float* outputs_right = &outputs[outputs_length];
+
+    for (size_t i = 0; i < length; ++i) {
+        inputs[i] = signal->data[i];
+    }
+
+    // Per-sample path
+    Timing timing = { 0, 0 };
+    for (int r = 0; r < args->repeat; ++r) {
+        YM7128B_ChipIdeal_Ctor(chip);
+        YM7128B_ChipIdeal_Setup(chip, args->rate);
+        YM7128B_ChipIdeal_Reset(chip);
+        for (YM7128B_Address a = 0; a < (YM7128B_Address)YM7128B_Reg_Count; ++a) {
+            YM7128B_ChipIdeal_Write(chip, a, args->regs[a]);
+        }
+        YM7128B_ChipIdeal_Start(chip);
+
+        YM7128B_ChipIdeal_Process_Data data;
+        uint64_t ns, cycles;
+        TimingBegin(&ns, &cycles);
+        for (size_t i = 0; i < length; ++i) {
+            data.inputs[YM7128B_InputChannel_Mono] = inputs[i];
+            YM7128B_ChipIdeal_Process(chip, &data);
+        }
+        TimingEnd(&timing, ns, cycles, length);
+        g_sink += (YM7128B_Float)data.outputs[YM7128B_OutputChannel_Left];
+
+        YM7128B_ChipIdeal_Stop(chip);
+        YM7128B_ChipIdeal_Dtor(chip);
+    }
+    Report(args, signal, YM7128B_ChipEngine_Ideal, Path_Process, YM7128B_Kernel_Scalar, 1, &timing);
+
+    // Block path
+    for (int kernel = 0; kernel < (int)YM7128B_Kernel_Count; ++kernel) {
+        if (kernel != (int)YM7128B_Kernel_Scalar) {
+            continue;
+        }
+        for (size_t b = 0; blocks[b]; ++b) {
+            size_t const block = blocks[b];
+            timing.ns = 0;
+            timing.cycles = 0;
+
+            for (int r = 0; r < args->repeat; ++r) {
+                YM7128B_ChipIdeal_Ctor(chip);
+                YM7128B_ChipIdeal_Setup(chip, args->rate);
+                YM7128B_ChipIdeal_Reset(chip);
+                for (YM7128B_Address a = 0; a < (YM7128B_Address)YM7128B_Reg_Count; ++a) {
+                    YM7128B_ChipIdeal_Write(chip, a, args->regs[a]);
+                }
+                YM7128B_ChipIdeal_Start(chip);
+
+                uint64_t ns, cycles;
+                TimingBegin(&ns, &cycles);
+                for (size_t i = 0; i < length; i += block) {
+                    size_t count = ((length - i) < block) ? (length - i) : block;
+                    YM7128B_ChipIdeal_ProcessBlock(chip, &inputs[i], count, outputs_left, outputs_right);
+                }
+                TimingEnd(&timing, ns, cycles, length);
+                g_sink += (YM7128B_Float)outputs_left[0];
+
+                YM7128B_ChipIdeal_Stop(chip);
+                YM7128B_ChipIdeal_Dtor(chip);
+            }
+            Report(args, signal, YM7128B_ChipEngine_Ideal, Path_Block, (YM7128B_Kernel)kernel, block, &timing);
+        }
+    }
+
+    free(chip);
+    free(inputs);
+    free(outputs);
+    return 0;
+}
+
+
+static int BenchShort(Args const* args, Signal const* signal)
+{
+    size_t single[2];
+    size_t const* blocks = GetBlockSizes(args, single);
+    size_t max_block = 1;
+    for (size_t b = 0; blocks[b]; ++b) {
+        if (max_block < blocks[b]) {
+            max_block = blocks[b];
+        }
+    }
+
+    size_t const length = signal->length;
+    size_t const outputs_length = max_block * 1;
+    YM7128B_ChipShort* chip = (YM7128B_ChipShort*)malloc(sizeof(YM7128B_ChipShort));
+    YM7128B_Fixed* inputs = (YM7128B_Fixed*)malloc(length * sizeof(YM7128B_Fixed));
+    YM7128B_Fixed* outputs = (YM7128B_Fixed*)malloc(outputs_length * YM7128B_OutputChannel_Count * sizeof(YM7128B_Fixed));
+    if (!chip || !inputs || !outputs) {
+        fprintf(stderr, "Cannot allocate Short buffers\n");
+        free(chip);
+        free(inputs);
+        free(outputs);
+        return 1;
+    }
+    YM7128B_Fixed* outputs_left = &outputs[0];
+    YM7128B_Fixed* outputs_right = &outputs[outputs_length];
+
+    for (size_t i = 0; i < length; ++i) {
+        inputs[i] = (YM7128B_Fixed)(YM7128B_ClampFloat(signal->data[i]) * (YM7128B_Float)YM7128B_Fixed_Max);
+    }
+
+    // Per-sample path
+    Timing timing = { 0, 0 };
+    for (int r = 0; r < args->repeat; ++r) {
+        YM7128B_ChipShort_Ctor(chip);
+        YM7128B_ChipShort_Setup(chip, args->rate);
+        YM7128B_ChipShort_Reset(chip);
+        for (YM7128B_Address a = 0; a < (YM7128B_Address)YM7128B_Reg_Count; ++a) {
+            YM7128B_ChipShort_Write(chip, a, args->regs[a]);
+        }
+        YM7128B_ChipShort_Start(chip);
+
+        YM7128B_ChipShort_Process_Data data;
+        uint64_t ns, cycles;
+        TimingBegin(&ns, &cycles);
+        for (size_t i = 0; i < length; ++i) {
+            data.inputs[YM7128B_InputChannel_Mono] = inputs[i];
+            YM7128B_ChipShort_Process(chip, &data);
+        }
+        TimingEnd(&timing, ns, cycles, length);
+        g_sink += (YM7128B_Float)data.outputs[YM7128B_OutputChannel_Left];
+
+        YM7128B_ChipShort_Stop(chip);
+        YM7128B_ChipShort_Dtor(chip);
+    }
+    Report(args, signal, YM7128B_ChipEngine_Short, Path_Process, YM7128B_Kernel_GetBest(), 1, &timing);
+
+    // Block path
+    for (int kernel = 0; kernel < (int)YM7128B_Kernel_Count; ++kernel) {
+        if (!YM7128B_Kernel_IsSupported((YM7128B_Kernel)kernel)) {
+            continue;
+        }
+        for (size_t b = 0; blocks[b]; ++b) {
+            size_t const block = blocks[b];
+            timing.ns = 0;
+            timing.cycles = 0;
+
+            for (int r = 0; r < args->repeat; ++r) {
+                YM7128B_ChipShort_Ctor(chip);
+                YM7128B_ChipShort_Setup(chip, args->rate);
+                YM7128B_ChipShort_Reset(chip);
+                for (YM7128B_Address a = 0; a < (YM7128B_Address)YM7128B_Reg_Count; ++a) {
+                    YM7128B_ChipShort_Write(chip, a, args->regs[a]);
+                }
+                YM7128B_ChipShort_SetKernel(chip, (YM7128B_Kernel)kernel);
+                YM7128B_ChipShort_Start(chip);
+
+                uint64_t ns, cycles;
+                TimingBegin(&ns, &cycles);
+                for (size_t i = 0; i < length; i += block) {
+                    size_t count = ((length - i) < block) ? (length - i) : block;
+                    YM7128B_ChipShort_ProcessBlock(chip, &inputs[i], count, outputs_left, outputs_right);
+                }
+                TimingEnd(&timing, ns, cycles, length);
+                g_sink += (YM7128B_Float)outputs_left[0];
+
+                YM7128B_ChipShort_Stop(chip);
+                YM7128B_ChipShort_Dtor(chip);
+            }
+            Report(args, signal, YM7128B_ChipEngine_Short, Path_Block, (YM7128B_Kernel)kernel, block, &timing);
+        }
+    }
+
+    free(chip);
+    free(inputs);
+    free(outputs);
+    return 0;
+}
+
+
+// ============================================================================
+// Bit-exactness check
+
+size_t const CHECK_BLOCKS[] = { 1, 3, 64, 1024, 0 };
+
+enum {
+    CHECK_LENGTH = YM7128B_Buffer_Length * 3,
+    CHECK_CASES_MAX = 128
+};
+
+static char const GOLDEN_MAGIC[16] = "YM7128B-GOLDEN";
+static uint32_t const GOLDEN_VERSION = 1;
+
+
+typedef struct CheckCase {
+    char label[32];
+    YM7128B_Register regs[YM7128B_Reg_Count];
+} CheckCase;
+
+
+typedef struct Mismatch {
+    size_t count;
+    size_t chip;
+    size_t sample;
+    int channel;
+    YM7128B_Float expected;
+    YM7128B_Float actual;
+    uint64_t max_ulp;
+    double max_error;
+} Mismatch;
+
+
+static void SetCheckCase(CheckCase* c, char const* label, YM7128B_Register gain,
+                         YM7128B_Register coeff, YM7128B_Register tap)
+{
+    snprintf(c->label, sizeof(c->label), "%s", label);
+
+    for (YM7128B_Address r = 0; r < (YM7128B_Address)YM7128B_Reg_C0; ++r) {
+        c->regs[r] = gain;
+    }
+    c->regs[YM7128B_Reg_C0] = coeff;
+    c->regs[YM7128B_Reg_C1] = coeff;
+
+    for (YM7128B_Address r = YM7128B_Reg_T0; r < (YM7128B_Address)YM7128B_Reg_Count; ++r) {
+        c->regs[r] = tap;
+    }
+}
+
+
+static size_t MakeCheckCases(CheckCase* cases)
+{
+    size_t count = 0;
+
+    // Presets
+    for (int j = 0; PRESET_TABLE[j].label && count < CHECK_CASES_MAX; ++j) {
+        CheckCase* c = &cases[count++];
+        SetCheckCase(c, PRESET_TABLE[j].label, 0, 0, 0);
+        for (YM7128B_Address r = 0; r < (YM7128B_Address)YM7128B_Reg_Count; ++r) {
+            c->regs[r] = PRESET_TABLE[j].regs[r];
+        }
+    }
+
+    // All the tap values, on each tap, with alternating full gains
+    for (int v = 0; v < YM7128B_Tap_Value_Count && count < CHECK_CASES_MAX; ++v) {
+        CheckCase* c = &cases[count++];
+        char label[32];
+        sprintf(label, "taps/%02X", v);
+        SetCheckCase(c, label, 0x3F, 0x1F, 0);
+        for (YM7128B_Address r = YM7128B_Reg_GL1; r <= YM7128B_Reg_GR8; ++r) {
+            c->regs[r] = (r & 1) ? 0x1F : 0x3F;
+        }
+        for (int t = 0; t < YM7128B_Tap_Count; ++t) {
+            c->regs[YM7128B_Reg_T0 + t] = (YM7128B_Register)((v + (t * 7)) % YM7128B_Tap_Value_Count);
+        }
+    }
+
+    // Extreme gains and feedback coefficients
+    if (count + 6 <= CHECK_CASES_MAX) {
+        SetCheckCase(&cases[count++], "gains/max+", 0x3F, 0x00, 0x10);
+        SetCheckCase(&cases[count++], "gains/max-", 0x1F, 0x00, 0x10);
+        SetCheckCase(&cases[count++], "feedback/max+", 0x3F, 0x1F, 0x01);
+        SetCheckCase(&cases[count++], "feedback/max-", 0x3F, 0x20, 0x01);
+        SetCheckCase(&cases[count++], "feedback/max+-", 0x1F, 0x1F, 0x1F);
+        SetCheckCase(&cases[count], "feedback/mixed", 0x3F, 0x1F, 0x00);
+        cases[count].regs[YM7128B_Reg_C1] = 0x20;
+        cases[count].regs[YM7128B_Reg_T0] = 0x1F;
+        ++count;
+    }
+    return count;
+}
+
+
+static void MakeCheckSignal(YM7128B_Float* data, size_t length)
+{
+    uint32_t lfsr = 0xACE1u;
+
+    for (size_t i = 0; i < length; ++i) {
+        YM7128B_Float value;
+        if (i < (length / 3)) {
+            // Full-scale noise, to stress saturations; 16-bit samples are
+            // exact in any precision, so that golden files are comparable
+            lfsr ^= lfsr << 13;
+            lfsr ^= lfsr >> 17;
+            lfsr ^= lfsr << 5;
+            value = (YM7128B_Float)(int16_t)(lfsr >> 16) / (YM7128B_Float)32768;
+        }
+        else if (i < ((length * 2) / 3)) {
+            // Full-scale square wave
+            value = (i & 32) ? (YM7128B_Float)-1 : (YM7128B_Float)+1;
+        }
+        else {
+            // Silence, to check the feedback tails
+            value = 0;
+        }
+        data[i] = value;
+    }
+}
+
+
+// Error in ULP of full scale, or of the expected value when larger, so that
+// rounding noise around zero does not count as billions of ULP.
+static uint64_t UlpError(YM7128B_Float expected, YM7128B_Float actual)
+{
+    int const digits = (sizeof(YM7128B_Float) == sizeof(float)) ? FLT_MANT_DIG : DBL_MANT_DIG;
+    double magnitude = fabs((double)expected);
+    double const floor = 1.0;
+    int exponent;
+
+    if (magnitude < floor) {
+        magnitude = floor;
+    }
+    frexp(magnitude, &exponent);
+    double ulp = ldexp(1.0, exponent - digits);
+    double error = fabs((double)actual - (double)expected);
+    return (uint64_t)ceil(error / ulp);
+}
+
+
+static void Compare(YM7128B_Float const* expected, YM7128B_Float const* actual,
+                    size_t length, size_t chip, int exact, Mismatch* m)
+{
+    for (int channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+        YM7128B_Float const* e = &expected[channel * length];
+        YM7128B_Float const* a = &actual[channel * length];
+
+        for (size_t i = 0; i < length; ++i) {
+            if (exact ? !memcmp(&e[i], &a[i], sizeof(YM7128B_Float))
+                      : ((e[i] == a[i]) || (isnan(e[i]) && isnan(a[i])))) {
+                continue;
+            }
+            if (!m->count || (chip == m->chip && i < m->sample)) {
+                m->chip = chip;
+                m->sample = i;
+                m->channel = channel;
+                m->expected = e[i];
+                m->actual = a[i];
+            }
+            ++m->count;
+
+            uint64_t ulp = UlpError(e[i], a[i]);
+            double error = fabs((double)e[i] - (double)a[i]);
+            if (m->max_ulp < ulp) {
+                m->max_ulp = ulp;
+            }
+            if (m->max_error < error) {
+                m->max_error = error;
+            }
+        }
+    }
+}
+
+
+static size_t CheckOutputLength(YM7128B_ChipEngine engine)
+{
+    if (engine == YM7128B_ChipEngine_Fixed || engine == YM7128B_ChipEngine_Float) {
+        return (size_t)CHECK_LENGTH * YM7128B_Oversampling;
+    }
+    return (size_t)CHECK_LENGTH;
+}
+
+
+static int IsExactEngine(YM7128B_ChipEngine engine)
+{
+    return (engine == YM7128B_ChipEngine_Fixed || engine == YM7128B_ChipEngine_Short);
+}
+
+
+static int RenderFixed(CheckCase const* c, YM7128B_Float const* signal, Path path,
+                       YM7128B_Kernel kernel, size_t block, YM7128B_Float* outputs)
+{
+    size_t const length = (size_t)CHECK_LENGTH;
+    size_t const outputs_length = length * YM7128B_Oversampling;
+    YM7128B_ChipFixed* chip = (YM7128B_ChipFixed*)malloc(sizeof(YM7128B_ChipFixed));
+    YM7128B_Fixed* inputs = (YM7128B_Fixed*)malloc(length * sizeof(YM7128B_Fixed));
+    YM7128B_Fixed* rendered = (YM7128B_Fixed*)malloc(outputs_length * YM7128B_OutputChannel_Count * sizeof(YM7128B_Fixed));
+    if (!chip || !inputs || !rendered) {
+        free(chip);
+        free(inputs);
+        free(rendered);
+        return 1;
+    }
+    YM7128B_Fixed* rendered_left = &rendered[0];
+    YM7128B_Fixed* rendered_right = &rendered[outputs_length];
+
+    for (size_t i = 0; i < length; ++i) {
+        inputs[i] = (YM7128B_Fixed)((double)YM7128B_ClampFloat(signal[i]) * YM7128B_Fixed_Max);
+    }
+
+    YM7128B_ChipFixed_Ctor(chip);
+    YM7128B_ChipFixed_Reset(chip);
+    for (YM7128B_Address a = 0; a < (YM7128B_Address)YM7128B_Reg_Count; ++a) {
+        YM7128B_ChipFixed_Write(chip, a, c->regs[a]);
+    }
+    YM7128B_ChipFixed_SetKernel(chip, kernel);
+    YM7128B_ChipFixed_Start(chip);
+
+    if (path == Path_Process) {
+        for (size_t i = 0; i < length; ++i) {
+            YM7128B_ChipFixed_Process_Data data;
+            data.inputs[YM7128B_InputChannel_Mono] = inputs[i];
+            YM7128B_ChipFixed_Process(chip, &data);
+            for (int ovs = 0; ovs < YM7128B_Oversampling; ++ovs) {
+                rendered_left[(i * YM7128B_Oversampling) + ovs] = data.outputs[YM7128B_OutputChannel_Left][ovs];
+                rendered_right[(i * YM7128B_Oversampling) + ovs] = data.outputs[YM7128B_OutputChannel_Right][ovs];
+            }
+        }
+    }
+    else {
+        for (size_t i = 0; i < length; i += block) {
+            size_t count = ((length - i) < block) ? (length - i) : block;
+            YM7128B_ChipFixed_ProcessBlock(chip, &inputs[i], count,
+                                        &rendered_left[i * YM7128B_Oversampling], &rendered_right[i * YM7128B_Oversampling]);
+        }
+    }
+
+    YM7128B_ChipFixed_Stop(chip);
+    YM7128B_ChipFixed_Dtor(chip);
+
+    for (size_t i = 0; i < (outputs_length * YM7128B_OutputChannel_Count); ++i) {
+        outputs[i] = (YM7128B_Float)rendered[i];
+    }
+
+    free(chip);
+    free(inputs);
+    free(rendered);
+    return 0;
+}
+
+
+static int RenderFloat(CheckCase const* c, YM7128B_Float const* signal, Path path,
+                       YM7128B_Kernel kernel, size_t block, YM7128B_Float* outputs)
+{
+    (void)kernel;
+
+    size_t const length = (size_t)CHECK_LENGTH;
+    size_t const outputs_length = length * YM7128B_Oversampling;
+    YM7128B_ChipFloat* chip = (YM7128B_ChipFloat*)malloc(sizeof(YM7128B_ChipFloat));
+    YM7128B_Float* inputs = (YM7128B_Float*)malloc(length * sizeof(YM7128B_Float));
+    YM7128B_Float* rendered = (YM7128B_Float*)malloc(outputs_length * YM7128B_OutputChannel_Count * sizeof(YM7128B_Float));
+    if (!chip || !inputs || !rendered) {
+        free(chip);
+        free(inputs);
+        free(rendered);
+        return 1;
+    }
+    YM7128B_Float* rendered_left = &rendered[0];
+    YM7128B_Float* rendered_right = &rendered[outputs_length];
+
+    for (size_t i = 0; i < length; ++i) {
+        inputs[i] = signal[i];
+    }
+
+    YM7128B_ChipFloat_Ctor(chip);
+    YM7128B_ChipFloat_Reset(chip);
+    for (YM7128B_Address a = 0; a < (YM7128B_Address)YM7128B_Reg_Count; ++a) {
+        YM7128B_ChipFloat_Write(chip, a, c->regs[a]);
+    }
+    YM7128B_ChipFloat_Start(chip);
+
+    if (path == Path_Process) {
+        for (size_t i = 0; i < length; ++i) {
+            YM7128B_ChipFloat_Process_Data data;
+            data.inputs[YM7128B_InputChannel_Mono] = inputs[i];
+            YM7128B_ChipFloat_Process(chip, &data);
+            for (int ovs = 0; ovs < YM7128B_Oversampling; ++ovs) {
+                rendered_left[(i * YM7128B_Oversampling) + ovs] = data.outputs[YM7128B_OutputChannel_Left][ovs];
+                rendered_right[(i * YM7128B_Oversampling) + ovs] = data.outputs[YM7128B_OutputChannel_Right][ovs];
+            }
+        }
+    }
+    else {
+        for (size_t i = 0; i < length; i += block) {
+            size_t count = ((length - i) < block) ? (length - i) : block;
+            YM7128B_ChipFloat_ProcessBlock(chip, &inputs[i], count,
+                                        &rendered_left[i * YM7128B_Oversampling], &rendered_right[i * YM7128B_Oversampling]);
+        }
+    }
+
+    YM7128B_ChipFloat_Stop(chip);
+    YM7128B_ChipFloat_Dtor(chip);
+
+    for (size_t i = 0; i < (outputs_length * YM7128B_OutputChannel_Count); ++i) {
+        outputs[i] = (YM7128B_Float)rendered[i];
+    }
+
+    free(chip);
+    free(inputs);
+    free(rendered);
+    return 0;
+}
+
+
+static int RenderIdeal(CheckCase const* c, YM7128B_Float const* signal, Path path,
+                       YM7128B_Kernel kernel, size_t block, YM7128B_Float* outputs)
+{
+    (void)kernel;
+
+    size_t const length = (size_t)CHECK_LENGTH;
+    size_t const outputs_length = length * 1;
+    YM7128B_ChipIdeal* chip = (YM7128B_ChipIdeal*)malloc(sizeof(YM7128B_ChipIdeal));
+    YM7128B_Float* inputs = (YM7128B_Float*)malloc(length * sizeof(YM7128B_Float));
+    YM7128B_Float* rendered = (YM7128B_Float*)malloc(outputs_length * YM7128B_OutputChannel_Count * sizeof(YM7128B_Float));
+    if (!chip || !inputs || !rendered) {
+        free(chip);
+        free(inputs);
+        free(rendered);
+        return 1;
+    }
+    YM7128B_Float* rendered_left = &rendered[0];
+    YM7128B_Float* rendered_right = &rendered[outputs_length];
+
+    for (size_t i = 0; i < length; ++i) {
+        inputs[i] = signal[i];
+    }
+
+    YM7128B_ChipIdeal_Ctor(chip);
+    YM7128B_ChipIdeal_Setup(chip, (YM7128B_TapIdeal)YM7128B_Input_Rate);
+    YM7128B_ChipIdeal_Reset(chip);
+    for (YM7128B_Address a = 0; a < (YM7128B_Address)YM7128B_Reg_Count; ++a) {
+        YM7128B_ChipIdeal_Write(chip, a, c->regs[a]);
+    }
+    YM7128B_ChipIdeal_Start(chip);
+
+    if (path == Path_Process) {
+        for (size_t i = 0; i < length; ++i) {
+            YM7128B_ChipIdeal_Process_Data data;
+            data.inputs[YM7128B_InputChannel_Mono] = inputs[i];
+            YM7128B_ChipIdeal_Process(chip, &data);
+            rendered_left[i] = data.outputs[YM7128B_OutputChannel_Left];
+            rendered_right[i] = data.outputs[YM7128B_OutputChannel_Right];
+        }
+    }
+    else {
+        for (size_t i = 0; i < length; i += block) {
+            size_t count = ((length - i) < block) ? (length - i) : block;
+            YM7128B_ChipIdeal_ProcessBlock(chip, &inputs[i], count,
+                                        &rendered_left[i * 1], &rendered_right[i * 1]);
+        }
+    }
+
+    YM7128B_ChipIdeal_Stop(chip);
+    YM7128B_ChipIdeal_Dtor(chip);
+
+    for (size_t i = 0; i < (outputs_length * YM7128B_OutputChannel_Count); ++i) {
+        outputs[i] = (YM7128B_Float)rendered[i];
+    }
+
+    free(chip);
+    free(inputs);
+    free(rendered);
+    return 0;
+}
+
+
+static int RenderShort(CheckCase const* c, YM7128B_Float const* signal, Path path,
+                       YM7128B_Kernel kernel, size_t block, YM7128B_Float* outputs)
+{
+    size_t const length = (size_t)CHECK_LENGTH;
+    size_t const outputs_length = length * 1;
+    YM7128B_ChipShort* chip = (YM7128B_ChipShort*)malloc(sizeof(YM7128B_ChipShort));
+    YM7128B_Fixed* inputs = (YM7128B_Fixed*)malloc(length * sizeof(YM7128B_Fixed));
+    YM7128B_Fixed* rendered = (YM7128B_Fixed*)malloc(outputs_length * YM7128B_OutputChannel_Count * sizeof(YM7128B_Fixed));
+    if (!chip || !inputs || !rendered) {
+        free(chip);
+        free(inputs);
+        free(rendered);
+        return 1;
+    }
+    YM7128B_Fixed* rendered_left = &rendered[0];
+    YM7128B_Fixed* rendered_right = &rendered[outputs_length];
+
+    for (size_t i = 0; i < length; ++i) {
+        inputs[i] = (YM7128B_Fixed)((double)YM7128B_ClampFloat(signal[i]) * YM7128B_Fixed_Max);
+    }
+
+    YM7128B_ChipShort_Ctor(chip);
+    YM7128B_ChipShort_Setup(chip, (YM7128B_TapIdeal)YM7128B_Input_Rate);
+    YM7128B_ChipShort_Reset(chip);
+    for (YM7128B_Address a = 0; a < (YM7128B_Address)YM7128B_Reg_Count; ++a) {
+        YM7128B_ChipShort_Write(chip, a, c->regs[a]);
+    }
+    YM7128B_ChipShort_SetKernel(chip, kernel);
+    YM7128B_ChipShort_Start(chip);
+
+    if (path == Path_Process) {
+        for (size_t i = 0; i < length; ++i) {
+            YM7128B_ChipShort_Process_Data data;
+            data.inputs[YM7128B_InputChannel_Mono] = inputs[i];
+            YM7128B_ChipShort_Process(chip, &data);
+            rendered_left[i] = data.outputs[YM7128B_OutputChannel_Left];
+            rendered_right[i] = data.outputs[YM7128B_OutputChannel_Right];
+        }
+    }
+    else {
+        for (size_t i = 0; i < length; i += block) {
+            size_t count = ((length - i) < block) ? (length - i) : block;
+            YM7128B_ChipShort_ProcessBlock(chip, &inputs[i], count,
+                                        &rendered_left[i * 1], &rendered_right[i * 1]);
+        }
+    }
+
+    YM7128B_ChipShort_Stop(chip);
+    YM7128B_ChipShort_Dtor(chip);
+
+    for (size_t i = 0; i < (outputs_length * YM7128B_OutputChannel_Count); ++i) {
+        outputs[i] = (YM7128B_Float)rendered[i];
+    }
+
+    free(chip);
+    free(inputs);
+    free(rendered);
+    return 0;
+}
+
+
+static int RenderBankFixed(CheckCase const* cases, size_t chips, YM7128B_Float const* signal,
+                           size_t block, YM7128B_Float* outputs)
+{
+    size_t const length = (size_t)CHECK_LENGTH;
+    size_t const outputs_length = length * YM7128B_Oversampling;
+    YM7128B_Fixed* inputs = (YM7128B_Fixed*)malloc(length * chips * sizeof(YM7128B_Fixed));
+    YM7128B_Fixed* rendered = (YM7128B_Fixed*)malloc(outputs_length * chips * YM7128B_OutputChannel_Count * sizeof(YM7128B_Fixed));
+    YM7128B_ChipBankFixed bank;
+    YM7128B_ChipBankFixed_Ctor(&bank);
+
+    if (!inputs || !rendered || !YM7128B_ChipBankFixed_Setup(&bank, chips)) {
+        YM7128B_ChipBankFixed_Dtor(&bank);
+        free(inputs);
+        free(rendered);
+        return 1;
+    }
+    YM7128B_Fixed* rendered_left = &rendered[0];
+    YM7128B_Fixed* rendered_right = &rendered[outputs_length * chips];
+
+    for (size_t i = 0; i < length; ++i) {
+        for (size_t chip = 0; chip < chips; ++chip) {
+            inputs[(i * chips) + chip] = (YM7128B_Fixed)((double)YM7128B_ClampFloat(signal[i]) * YM7128B_Fixed_Max);
+        }
+    }
+
+    YM7128B_ChipBankFixed_Reset(&bank);
+    for (size_t chip = 0; chip < chips; ++chip) {
+        for (YM7128B_Address a = 0; a < (YM7128B_Address)YM7128B_Reg_Count; ++a) {
+            YM7128B_ChipBankFixed_Write(&bank, chip, a, cases[chip].regs[a]);
+        }
+    }
+    YM7128B_ChipBankFixed_Start(&bank);
+
+    for (size_t i = 0; i < length; i += block) {
+        size_t count = ((length - i) < block) ? (length - i) : block;
+        size_t offset = i * YM7128B_Oversampling * chips;
+        YM7128B_ChipBankFixed_ProcessBlock(&bank, &inputs[i * chips], count,
+                                        &rendered_left[offset], &rendered_right[offset]);
+    }
+
+    YM7128B_ChipBankFixed_Stop(&bank);
+    YM7128B_ChipBankFixed_Dtor(&bank);
+
+    for (size_t chip = 0; chip < chips; ++chip) {
+        YM7128B_Float* chip_outputs = &outputs[chip * outputs_length * YM7128B_OutputChannel_Count];
+        for (size_t i = 0; i < outputs_length; ++i) {
+            chip_outputs[i] = (YM7128B_Float)rendered_left[(i * chips) + chip];
+            chip_outputs[outputs_length + i] = (YM7128B_Float)rendered_right[(i * chips) + chip];
+        }
+    }
+
+    free(inputs);
+    free(rendered);
+    return 0;
+}
+
+
+static int RenderBankFloat(CheckCase const* cases, size_t chips, YM7128B_Float const* signal,
+                           YM7128B_Kernel kernel, size_t block, YM7128B_Float* outputs)
+{
+    size_t const length = (size_t)CHECK_LENGTH;
+    size_t const outputs_length = length * YM7128B_Oversampling;
+    YM7128B_Float* inputs = (YM7128B_Float*)malloc(length * chips * sizeof(YM7128B_Float));
+    YM7128B_Float* rendered = (YM7128B_Float*)malloc(outputs_length * chips * YM7128B_OutputChannel_Count * sizeof(YM7128B_Float));
+    YM7128B_ChipBankFloat bank;
+    YM7128B_ChipBankFloat_Ctor(&bank);
+
+    if (!inputs || !rendered || !YM7128B_ChipBankFloat_Setup(&bank, chips)) {
+        YM7128B_ChipBankFloat_Dtor(&bank);
+        free(inputs);
+        free(rendered);
+        return 1;
+    }
+    YM7128B_ChipBankFloat_SetKernel(&bank, kernel);
+    YM7128B_Float* rendered_left = &rendered[0];
+    YM7128B_Float* rendered_right = &rendered[outputs_length * chips];
+
+    for (size_t i = 0; i < length; ++i) {
+        for (size_t chip = 0; chip < chips; ++chip) {
+            inputs[(i * chips) + chip] = signal[i];
+        }
+    }
+
+    YM7128B_ChipBankFloat_Reset(&bank);
+    for (size_t chip = 0; chip < chips; ++chip) {
+        for (YM7128B_Address a = 0; a < (YM7128B_Address)YM7128B_Reg_Count; ++a) {
+            YM7128B_ChipBankFloat_Write(&bank, chip, a, cases[chip].regs[a]);
+        }
+    }
+    YM7128B_ChipBankFloat_Start(&bank);
+
+    for (size_t i = 0; i < length; i += block) {
+        size_t count = ((length - i) < block) ? (length - i) : block;
+        size_t offset = i * YM7128B_Oversampling * chips;
+        YM7128B_ChipBankFloat_ProcessBlock(&bank, &inputs[i * chips], count,
+                                        &rendered_left[offset], &rendered_right[offset]);
+    }
+
+    YM7128B_ChipBankFloat_Stop(&bank);
+    YM7128B_ChipBankFloat_Dtor(&bank);
+
+    for (size_t chip = 0; chip < chips; ++chip) {
+        YM7128B_Float* chip_outputs = &outputs[chip * outputs_length * YM7128B_OutputChannel_Count];
+        for (size_t i = 0; i < outputs_length; ++i) {
+            chip_outputs[i] = (YM7128B_Float)rendered_left[(i * chips) + chip];
+            chip_outputs[outputs_length + i] = (YM7128B_Float)rendered_right[(i * chips) + chip];
+        }
+    }
+
+    free(inputs);
+    free(rendered);
+    return 0;
+}
+
+
+static int Render(YM7128B_ChipEngine engine, CheckCase const* c, YM7128B_Float const* signal,
+                  Path path, YM7128B_Kernel kernel, size_t block, YM7128B_Float* outputs)
+{
+    switch (engine)
+    {
+    case YM7128B_ChipEngine_Fixed:
+        return RenderFixed(c, signal, path, kernel, block, outputs);
+
+    case YM7128B_ChipEngine_Float:
+        return RenderFloat(c, signal, path, kernel, block, outputs);
+
+    case YM7128B_ChipEngine_Ideal:
+        return RenderIdeal(c, signal, path, kernel, block, outputs);
+
+    case YM7128B_ChipEngine_Short:
+        return RenderShort(c, signal, path, kernel, block, outputs);
+
+    default:
+        return 1;
+    }
+}
+
+
+static int WriteGolden(FILE* file, YM7128B_ChipEngine engine, YM7128B_Float const* values, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        unsigned char bytes[8];
+        size_t size;
+
+        if (IsExactEngine(engine)) {
+            uint16_t value = (uint16_t)(int16_t)values[i];
+            bytes[0] = (unsigned char)(value >> 0);
+            bytes[1] = (unsigned char)(value >> 8);
+            size = 2;
+        }
+        else {
+            double real = (double)values[i];
+            uint64_t value;
+            memcpy(&value, &real, sizeof(value));
+            for (int b = 0; b < 8; ++b) {
+                bytes[b] = (unsigned char)(value >> (b * 8));
+            }
+            size = 8;
+        }
+
+        if (fwrite(bytes, size, 1, file) != 1) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+static int ReadGolden(FILE* file, YM7128B_ChipEngine engine, YM7128B_Float* values, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        unsigned char bytes[8];
+
+        if (IsExactEngine(engine)) {
+            if (fread(bytes, 2, 1, file) != 1) {
+                return 1;
+            }
+            uint16_t value = (uint16_t)((unsigned)bytes[0] | ((unsigned)bytes[1] << 8));
+            values[i] = (YM7128B_Float)(int16_t)value;
+        }
+        else {
+            if (fread(bytes, 8, 1, file) != 1) {
+                return 1;
+            }
+            uint64_t value = 0;
+            for (int b = 0; b < 8; ++b) {
+                value |= (uint64_t)bytes[b] << (b * 8);
+            }
+            double real;
+            memcpy(&real, &value, sizeof(real));
+            values[i] = (YM7128B_Float)real;
+        }
+    }
+    return 0;
+}
+
+
+static int GoldenHeader(FILE* file, int writing, size_t case_count)
+{
+    unsigned char header[28];
+    uint32_t const fields[3] = { GOLDEN_VERSION, (uint32_t)case_count, (uint32_t)CHECK_LENGTH };
+
+    memcpy(header, GOLDEN_MAGIC, sizeof(GOLDEN_MAGIC));
+    for (int f = 0; f < 3; ++f) {
+        for (int b = 0; b < 4; ++b) {
+            header[16 + (f * 4) + b] = (unsigned char)(fields[f] >> (b * 8));
+        }
+    }
+
+    if (writing) {
+        return fwrite(header, sizeof(header), 1, file) != 1;
+    }
+
+    unsigned char stored[sizeof(header)];
+    if (fread(stored, sizeof(stored), 1, file) != 1) {
+        return 1;
+    }
+    return memcmp(stored, header, sizeof(header)) != 0;
+}
+
+
+static int ReportCheck(Args const* args, YM7128B_ChipEngine engine, char const* path,
+                       char const* kernel, size_t block, CheckCase const* cases,
+                       size_t output_length, Mismatch const* m)
+{
+    int exact = IsExactEngine(engine);
+    int failed = exact ? (m->count != 0) : (m->max_ulp > args->ulp);
+    char block_label[24];
+
+    if (block) {
+        sprintf(block_label, "%lu", (unsigned long)block);
+    }
+    else {
+        strcpy(block_label, "-");
+    }
+
+    printf("%-6s %-8s %-6s %6s  %s", MODE_TABLE[engine].label, path, kernel, block_label,
+           failed ? "FAIL" : "OK");
+
+    if (!exact) {
+        if (m->max_error > 0) {
+            printf(", max %lu ULP, %.1f dB", (unsigned long)m->max_ulp, 20 * log10(m->max_error));
+        }
+        else {
+            printf(", max 0 ULP, -inf dB");
+        }
+    }
+
+    if (m->count) {
+        size_t sample = m->sample % output_length;
+        printf(", %lu differing samples; first: case %s, sample %lu, %s, expected %.17g, got %.17g",
+               (unsigned long)m->count, cases[m->chip].label, (unsigned long)sample,
+               (m->channel == YM7128B_OutputChannel_Left) ? "left" : "right",
+               (double)m->expected, (double)m->actual);
+    }
+    printf("\n");
+    fflush(stdout);
+    return failed;
+}
+
+
+static int RunCheck(Args const* args)
+{
+    CheckCase* cases = (CheckCase*)malloc(CHECK_CASES_MAX * sizeof(CheckCase));
+    YM7128B_Float* signal = (YM7128B_Float*)malloc((size_t)CHECK_LENGTH * sizeof(YM7128B_Float));
+    size_t const values_max = CHECK_CASES_MAX * CheckOutputLength(YM7128B_ChipEngine_Fixed) *
+                              YM7128B_OutputChannel_Count;
+    YM7128B_Float* reference = (YM7128B_Float*)malloc(values_max * sizeof(YM7128B_Float));
+    YM7128B_Float* actual = (YM7128B_Float*)malloc(values_max * sizeof(YM7128B_Float));
+    FILE* golden = NULL;
+    int error = 0;
+    int failures = 0;
+
+    if (!cases || !signal || !reference || !actual) {
+        fprintf(stderr, "Cannot allocate check buffers\n");
+        error = 1;
+        goto end;
+    }
+
+    size_t const case_count = MakeCheckCases(cases);
+    MakeCheckSignal(signal, (size_t)CHECK_LENGTH);
+
+    if (args->golden_path) {
+        if (args->recording && args->engine >= 0) {
+            fprintf(stderr, "Recording requires all the engines\n");
+            error = 1;
+            goto end;
+        }
+        golden = fopen(args->golden_path, args->recording ? "wb" : "rb");
+        if (!golden) {
+            perror(args->golden_path);
+            error = 1;
+            goto end;
+        }
+        if (GoldenHeader(golden, args->recording, case_count)) {
+            fprintf(stderr, "Invalid golden file: %s\n", args->golden_path);
+            error = 1;
+            goto end;
+        }
+    }
+
+    printf("%-6s %-8s %-6s %6s  %s (%lu cases, %lu input samples each)\n", "engine", "path",
+           "kernel", "block", "result", (unsigned long)case_count, (unsigned long)CHECK_LENGTH);
+
+    for (int e = 0; e < (int)YM7128B_ChipEngine_Count; ++e) {
+        YM7128B_ChipEngine const engine = (YM7128B_ChipEngine)e;
+        size_t const output_length = CheckOutputLength(engine);
+        size_t const case_size = output_length * YM7128B_OutputChannel_Count;
+        size_t const value_size = IsExactEngine(engine) ? 2 : 8;
+
+        if (args->engine >= 0 && args->engine != e) {
+            if (golden && fseek(golden, (long)(case_count * case_size * value_size), SEEK_CUR)) {
+                perror(args->golden_path);
+                error = 1;
+                goto end;
+            }
+            continue;
+        }
+
+        // Reference: per-sample scalar processing
+        for (size_t k = 0; k < case_count; ++k) {
+            if (Render(engine, &cases[k], signal, Path_Process, YM7128B_Kernel_Scalar, 1,
+                       &reference[k * case_size])) {
+                fprintf(stderr, "Cannot render reference\n");
+                error = 1;
+                goto end;
+            }
+        }
+
+        if (golden) {
+            if (args->recording) {
+                if (WriteGolden(golden, engine, reference, case_count * case_size)) {
+                    perror(args->golden_path);
+                    error = 1;
+                    goto end;
+                }
+            }
+            else {
+                if (ReadGolden(golden, engine, actual, case_count * case_size)) {
+                    fprintf(stderr, "Truncated golden file: %s\n", args->golden_path);
+                    error = 1;
+                    goto end;
+                }
+                Mismatch m;
+                memset(&m, 0, sizeof(m));
+                for (size_t k = 0; k < case_count; ++k) {
+                    Compare(&actual[k * case_size], &reference[k * case_size], output_length, k, IsExactEngine(engine), &m);
+                }
+                failures += ReportCheck(args, engine, "golden", KERNEL_LABELS[YM7128B_Kernel_Scalar],
+                                        0, cases, output_length, &m);
+            }
+        }
+
+        // Block paths, for each supported kernel
+        for (int kernel = 0; kernel < (int)YM7128B_Kernel_Count; ++kernel) {
+            if (!YM7128B_Kernel_IsSupported((YM7128B_Kernel)kernel)) {
+                continue;
+            }
+            if (!IsExactEngine(engine) && kernel != (int)YM7128B_Kernel_Scalar) {
+                continue;
+            }
+
+            for (size_t b = 0; CHECK_BLOCKS[b]; ++b) {
+                Mismatch m;
+                memset(&m, 0, sizeof(m));
+
+                for (size_t k = 0; k < case_count; ++k) {
+                    if (Render(engine, &cases[k], signal, Path_Block, (YM7128B_Kernel)kernel,
+                               CHECK_BLOCKS[b], actual)) {
+                        fprintf(stderr, "Cannot render block path\n");
+                        error = 1;
+                        goto end;
+                    }
+                    Compare(&reference[k * case_size], actual, output_length, k, IsExactEngine(engine), &m);
+                }
+                failures += ReportCheck(args, engine, PATH_LABELS[Path_Block], KERNEL_LABELS[kernel],
+                                        CHECK_BLOCKS[b], cases, output_length, &m);
+            }
+        }
+
+        // Batched path, with a chip per case
+        if (engine == YM7128B_ChipEngine_Fixed || engine == YM7128B_ChipEngine_Float) {
+            for (int kernel = 0; kernel < (int)YM7128B_Kernel_Count; ++kernel) {
+                if (!YM7128B_Kernel_IsSupported((YM7128B_Kernel)kernel)) {
+                    continue;
+                }
+                if (engine == YM7128B_ChipEngine_Fixed && kernel != (int)YM7128B_Kernel_Scalar) {
+                    continue;
+                }
+                for (size_t b = 0; CHECK_BLOCKS[b]; ++b) {
+                    int failed = (engine == YM7128B_ChipEngine_Fixed) ?
+                        RenderBankFixed(cases, case_count, signal, CHECK_BLOCKS[b], actual) :
+                        RenderBankFloat(cases, case_count, signal, (YM7128B_Kernel)kernel, CHECK_BLOCKS[b], actual);
+                    if (failed) {
+                        fprintf(stderr, "Cannot render bank path\n");
+                        error = 1;
+                        goto end;
+                    }
+
+                    Mismatch m;
+                    memset(&m, 0, sizeof(m));
+                    for (size_t k = 0; k < case_count; ++k) {
+                        Compare(&reference[k * case_size], &actual[k * case_size], output_length, k, IsExactEngine(engine), &m);
+                    }
+                    failures += ReportCheck(args, engine, PATH_LABELS[Path_Bank], KERNEL_LABELS[kernel],
+                                            CHECK_BLOCKS[b], cases, output_length, &m);
+                }
+            }
+        }
+    }
+
+    if (failures) {
+        printf("%d checks FAILED\n", failures);
+    }
+    else if (args->recording) {
+        printf("Recorded: %s\n", args->golden_path);
+    }
+    else {
+        printf("All checks passed\n");
+    }
+
+end:
+    if (golden) {
+        fclose(golden);
+    }
+    free(cases);
+    free(signal);
+    free(reference);
+    free(actual);
+    return error || failures;
+}
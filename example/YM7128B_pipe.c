@@ -26,6 +26,10 @@ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE  200112L  // mmap(), ftruncate()
+#endif
+
 #include "YM7128B_emu.h"
 
 #include <errno.h>
@@ -36,11 +40,30 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string.h>
 
 #include "endian.h"
+#include "presets.h"
 
 #ifdef __WINDOWS__
 #include <io.h>
 #endif
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define PIPE_MMAP  1
+#else
+#define PIPE_MMAP  0
+#endif
+
+#if PIPE_MMAP && defined(__GNUC__)
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#define PIPE_THREADS  1
+#else
+#define PIPE_THREADS  0
+#endif
+
 
 static char const* USAGE = ("\
 YM7128B_pipe (c) 2020, Andrea Zoppi. All rights reserved.\n\
@@ -48,8 +71,11 @@ YM7128B_pipe (c) 2020, Andrea Zoppi. All rights reserved.\n\
 This program emulates a YM7128B Surround Processor, made by Yamaha.\n\
 It reads a sample stream from standard input, processes data, and writes\n\
 to the standard output.\n\
-The sample format is as specified by the --format option.\n\
-The output is always stereo, with the same sample format as per the input.\n\
+The sample format is as specified by the --format option, or by the\n\
+RIFF/WAVE header as per the --container option.\n\
+The output is always stereo, with the same sample format as per the input,\n\
+interleaved as left/right frames.\n\
+The stream is processed in blocks of 4096 input samples.\n\
 In case of fixed and float engines, the output rate is doubled\n\
 (2x oversampling).\n\
 \n\
@@ -60,6 +86,16 @@ USAGE:\n\
 \n\
 OPTION (evaluated as per command line argument order):\n\
 \n\
+-b, --batch FILE\n\
+    Job list file, processed instead of the standard streams.\n\
+    Each line is a job: INPUT OUTPUT [OPTION]...\n\
+    Jobs inherit the command line options, and may override them.\n\
+    Blank lines and lines starting with '#' are skipped.\n\
+\n\
+-c, --container CONTAINER\n\
+    Stream container; default: raw.\n\
+    See CONTAINER table.\n\
+\n\
 --dry DECIBEL\n\
     Dry (unprocessed) output volume multiplier [dB]; default: 0.\n\
     Values outside range (-128; +128) do mute.\n\
@@ -75,12 +111,36 @@ OPTION (evaluated as per command line argument order):\n\
     Chip engine; default: fixed.\n\
     See ENGINE table.\n\
 \n\
+--filter FILTER\n\
+    Oversampler filter of the fixed and float engines; default: linear,\n\
+    or minimum if built with YM7128B_USE_MINPHASE.\n\
+    See FILTER table.\n\
+\n\
+-i, --input FILE\n\
+    Input file, read instead of standard input; default: none.\n\
+    Mapped into memory where supported.\n\
+\n\
+-o, --output FILE\n\
+    Output file, written instead of standard output; default: none.\n\
+    Preallocated and mapped into memory when the input file is mapped.\n\
+\n\
 -r, --rate RATE\n\
     Sample rate [Hz]; default: 23550.\n\
+    Sets up the ideal and short engines, and the WAVE output rate.\n\
+    Overridden by a WAVE input header.\n\
 \n\
 --preset PRESET\n\
     Register preset; default: off. See PRESET table.\n\
 \n\
+-t, --threads COUNT\n\
+    Processing threads; default: 1.\n\
+    Values above 1 run reading/decoding, chip processing, and\n\
+    encoding/writing as three pipelined threads, where supported.\n\
+    With mapped input and output files, the fixed or short engine, and\n\
+    registers without feedback, the stream is split into COUNT chunks\n\
+    rendered in parallel instead, each after priming its own chip.\n\
+    In batch mode, this is the number of worker threads instead.\n\
+\n\
 --reg-<REGISTER> [0x]HEX\n\
     Value of <REGISTER> register; hexadecimal string.\n\
 \n\
@@ -93,6 +153,10 @@ OPTION (evaluated as per command line argument order):\n\
     Values outside range (-128; +128) do mute.\n\
 \n\
 \n\
+");
+
+
+static char const* USAGE_TABLES = ("\
 ENGINE:\n\
 \n\
 - fixed:  Fixed-point (default).\n\
@@ -101,25 +165,47 @@ ENGINE:\n\
 - short:  Ideal short model.\n\
 \n\
 \n\
+FILTER:\n\
+\n\
+- linear:    Linear phase, 19 taps; latency: 9 output samples.\n\
+- minimum:   Minimum phase, 19 taps; latency: 2 output samples.\n\
+- loworder:  Linear phase, 7 taps; latency: 3 output samples.\n\
+\n\
+\n\
+CONTAINER:\n\
+\n\
+- raw:      Headerless samples (default).\n\
+- wav:      RIFF/WAVE input and output.\n\
+- wav-in:   RIFF/WAVE input, raw output.\n\
+- wav-out:  Raw input, RIFF/WAVE output.\n\
+\n\
+A WAVE input must be mono, in a WAVE format of the FORMAT table; its\n\
+header sets the sample format and rate, overriding --format and --rate.\n\
+RF64 and streamed headers are accepted, the latter read up to the end.\n\
+A WAVE output is stereo, at the output rate of the engine, and has its\n\
+sizes patched at the end; it becomes RF64 beyond 4 GiB.\n\
+If the output cannot seek, as for pipes, the streamed header is kept.\n\
+\n\
+\n\
 FORMAT:\n\
 \n\
-| Name       | Bits | Sign | Endian |\n\
-|------------|------|------|--------|\n\
-| dummy      |    0 | no   | same   |\n\
-| U8         |    8 | no   | same   |\n\
-| S8         |    8 | yes  | same   |\n\
-| U16_LE     |   16 | no   | little |\n\
-| U16_BE     |   16 | no   | big    |\n\
-| S16_LE     |   16 | yes  | little |\n\
-| S16_BE     |   16 | yes  | big    |\n\
-| U32_LE     |   32 | no   | little |\n\
-| U32_BE     |   32 | no   | big    |\n\
-| S32_LE     |   32 | yes  | little |\n\
-| S32_BE     |   32 | yes  | big    |\n\
-| FLOAT_LE   |   32 | yes  | little |\n\
-| FLOAT_BE   |   32 | yes  | big    |\n\
-| FLOAT64_LE |   64 | yes  | little |\n\
-| FLOAT64_BE |   64 | yes  | big    |\n\
+| Name       | Bits | Sign | Endian | WAVE |\n\
+|------------|------|------|--------|------|\n\
+| dummy      |    0 | no   | same   | no   |\n\
+| U8         |    8 | no   | same   | PCM  |\n\
+| S8         |    8 | yes  | same   | no   |\n\
+| U16_LE     |   16 | no   | little | no   |\n\
+| U16_BE     |   16 | no   | big    | no   |\n\
+| S16_LE     |   16 | yes  | little | PCM  |\n\
+| S16_BE     |   16 | yes  | big    | no   |\n\
+| U32_LE     |   32 | no   | little | no   |\n\
+| U32_BE     |   32 | no   | big    | no   |\n\
+| S32_LE     |   32 | yes  | little | PCM  |\n\
+| S32_BE     |   32 | yes  | big    | no   |\n\
+| FLOAT_LE   |   32 | yes  | little | IEEE |\n\
+| FLOAT_BE   |   32 | yes  | big    | no   |\n\
+| FLOAT64_LE |   64 | yes  | little | IEEE |\n\
+| FLOAT64_BE |   64 | yes  | big    | no   |\n\
 \n\
 \n\
 PRESET:\n\
@@ -145,6 +231,10 @@ PRESET:\n\
 - gold/stadium\n\
 \n\
 \n\
+");
+
+
+static char const* LICENSE = ("\
 LICENSE:\n\
 \n\
 BSD 2-Clause License\n\
@@ -176,983 +266,2336 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.\n\
 
 
 #if __BYTE_ORDER == __LITTLE_ENDIAN
-#define READ_LE( dst_, size_)  (fread ((dst_), (size_), 1, stdin ) == 1)
-#define WRITE_LE(src_, size_)  (fwrite((src_), (size_), 1, stdout) == 1)
-#define READ_BE( dst_, size_)  (fread ((dst_), 1, (size_), stdin ) == (size_))
-#define WRITE_BE(src_, size_)  (fwrite((src_), 1, (size_), stdout) == (size_))
+#define SWAP_LE  0
+#define SWAP_BE  1
 #elif __BYTE_ORDER == __BIG_ENDIAN
-#define READ_LE( dst_, size_)  (fread ((dst_), 1, (size_), stdin ) == (size_))
-#define WRITE_LE(src_, size_)  (fwrite((src_), 1, (size_), stdout) == (size_))
-#define READ_BE( dst_, size_)  (fread ((dst_), (size_), 1, stdin ) == 1)
-#define WRITE_BE(src_, size_)  (fwrite((src_), (size_), 1, stdout) == 1)
+#define SWAP_LE  1
+#define SWAP_BE  0
 #else
 #error "Unsupported __BYTE_ORDER"
 #endif
 
+//! Input samples per I/O block.
+#define BLOCK_LENGTH  4096
 
-int ReadDummy(YM7128B_Float* dst) {
-    *dst = 0;
-    return 1;
-}
+//! Output samples per I/O block, at most.
+#define BLOCK_FRAMES_LENGTH  (BLOCK_LENGTH * YM7128B_Oversampling * YM7128B_OutputChannel_Count)
 
-int ReadU8(YM7128B_Float* dst) {
-    int8_t src;
-    if (READ_LE(&src, sizeof(src))) {
-        src += INT8_MIN;
-        *dst = (YM7128B_Float)src / -(YM7128B_Float)INT8_MIN;
-        return 1;
-    }
-    return 0;
-}
+//! Alignment of the I/O block buffers [bytes].
+#define BLOCK_ALIGNMENT  64
 
-int ReadS8(YM7128B_Float* dst) {
-    int8_t src;
-    if (READ_LE(&src, sizeof(src))) {
-        *dst = (YM7128B_Float)src / -(YM7128B_Float)INT8_MIN;
-        return 1;
-    }
-    return 0;
-}
 
-int ReadU16L(YM7128B_Float* dst) {
-    int16_t src;
-    if (READ_LE(&src, sizeof(src))) {
-        src += INT16_MIN;
-        *dst = (YM7128B_Float)src / -(YM7128B_Float)INT16_MIN;
-        return 1;
-    }
-    return 0;
-}
+//! Blocks in flight within the threaded pipeline; power of two.
+#define RING_LENGTH  8
 
-int ReadU16B(YM7128B_Float* dst) {
-    int16_t src;
-    if (READ_BE(&src, sizeof(src))) {
-        src += INT16_MIN;
-        *dst = (YM7128B_Float)src / -(YM7128B_Float)INT16_MIN;
-        return 1;
-    }
-    return 0;
-}
 
-int ReadS16L(YM7128B_Float* dst) {
-    int16_t src;
-    if (READ_LE(&src, sizeof(src))) {
-        *dst = (YM7128B_Float)src / -(YM7128B_Float)INT16_MIN;
-        return 1;
-    }
-    return 0;
-}
+//! WAVE format tags.
+#define WAVE_FORMAT_PCM         0x0001
+#define WAVE_FORMAT_FLOAT       0x0003
+#define WAVE_FORMAT_EXTENSIBLE  0xFFFE
 
-int ReadS16B(YM7128B_Float* dst) {
-    int16_t src;
-    if (READ_BE(&src, sizeof(src))) {
-        *dst = (YM7128B_Float)src / -(YM7128B_Float)INT16_MIN;
-        return 1;
-    }
-    return 0;
-}
+//! Size of the written WAVE header [bytes]: RIFF, JUNK (room for ds64),
+//! fmt (18 bytes), and data chunk headers.
+#define WAVE_HEADER_SIZE  82
 
-int ReadU32L(YM7128B_Float* dst) {
-    int32_t src;
-    if (READ_LE(&src, sizeof(src))) {
-        src += INT32_MIN;
-        *dst = (YM7128B_Float)src / -(YM7128B_Float)INT32_MIN;
-        return 1;
+//! Streamed chunk size placeholder, until patched at the end.
+#define WAVE_SIZE_UNKNOWN  0xFFFFFFFFu
+
+//! Container flags.
+#define CONTAINER_WAVE_INPUT   1
+#define CONTAINER_WAVE_OUTPUT  2
+
+
+typedef struct Stream {
+    FILE* input_file;  // stdin by default
+    FILE* output_file;  // stdout by default
+
+    uint8_t const* input_map;  // mapped input file, or NULL for stdin
+    size_t input_map_size;  // [bytes]
+    size_t input_size;  // [bytes] end of the sample data
+    size_t input_offset;  // [bytes]
+    size_t input_base;  // [bytes] start of the sample data
+    uint64_t input_remaining;  // [bytes] sample data left to read from input_file
+
+    uint8_t* output_map;  // mapped output file, or NULL for stdout
+    size_t output_size;  // [bytes]
+    size_t output_offset;  // [bytes]
+    size_t output_base;  // [bytes] start of the sample data; WAVE header size
+    uint64_t output_written;  // [bytes] sample data written to output_file
+    int output_fd;
+
+    uint8_t wave_header[WAVE_HEADER_SIZE];  // patched at the end
+} Stream;
+
+
+typedef struct Block {
+    void* memory;
+    size_t count;  // input samples
+    size_t frames_count;  // output samples
+    int last;  // end of stream
+    int encoded;  // raw holds the output frames, by the chip output stage
+
+    union {
+        YM7128B_Fixed fixed[BLOCK_LENGTH];
+        YM7128B_Float real[BLOCK_LENGTH];
+    } inputs;
+
+    union {
+        YM7128B_Fixed fixed[YM7128B_OutputChannel_Count][BLOCK_LENGTH * YM7128B_Oversampling];
+        YM7128B_Float real[YM7128B_OutputChannel_Count][BLOCK_LENGTH * YM7128B_Oversampling];
+    } outputs;
+
+    YM7128B_Float frames[BLOCK_FRAMES_LENGTH];
+
+    uint64_t raw[BLOCK_FRAMES_LENGTH];  // stream bytes, up to 64 bits per sample
+} Block;
+
+
+static Block* AllocBlock(void)
+{
+    void* memory = malloc(sizeof(Block) + BLOCK_ALIGNMENT);
+    if (!memory) {
+        return NULL;
     }
-    return 0;
+    uintptr_t address = (uintptr_t)memory + (BLOCK_ALIGNMENT - 1);
+    address -= address % BLOCK_ALIGNMENT;
+    Block* block = (Block*)address;
+    block->memory = memory;
+    block->count = 0;
+    block->frames_count = 0;
+    block->last = 0;
+    return block;
 }
 
-int ReadU32B(YM7128B_Float* dst) {
-    int32_t src;
-    if (READ_BE(&src, sizeof(src))) {
-        src += INT32_MIN;
-        *dst = (YM7128B_Float)src / -(YM7128B_Float)INT32_MIN;
-        return 1;
+static void FreeBlock(Block* block)
+{
+    if (block) {
+        free(block->memory);
     }
-    return 0;
 }
 
-int ReadS32L(YM7128B_Float* dst) {
-    int32_t src;
-    if (READ_LE(&src, sizeof(src))) {
-        *dst = (YM7128B_Float)src / -(YM7128B_Float)INT32_MIN;
-        return 1;
+
+static void SwapBytes(void* buffer, size_t size, size_t count)
+{
+    if (size == sizeof(uint16_t)) {
+        uint16_t* ptr = (uint16_t*)buffer;
+        for (size_t i = 0; i < count; ++i) {
+            uint16_t x = ptr[i];
+            ptr[i] = (uint16_t)((x >> 8) | (x << 8));
+        }
+    }
+    else if (size == sizeof(uint32_t)) {
+        uint32_t* ptr = (uint32_t*)buffer;
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t x = ptr[i];
+            x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+            ptr[i] = (x >> 16) | (x << 16);
+        }
+    }
+    else if (size == sizeof(uint64_t)) {
+        uint64_t* ptr = (uint64_t*)buffer;
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t x = ptr[i];
+            x = ((x >> 8) & 0x00FF00FF00FF00FFull) | ((x & 0x00FF00FF00FF00FFull) << 8);
+            x = ((x >> 16) & 0x0000FFFF0000FFFFull) | ((x & 0x0000FFFF0000FFFFull) << 16);
+            ptr[i] = (x >> 32) | (x << 32);
+        }
     }
-    return 0;
 }
 
-int ReadS32B(YM7128B_Float* dst) {
-    int32_t src;
-    if (READ_BE(&src, sizeof(src))) {
-        *dst = (YM7128B_Float)src / -(YM7128B_Float)INT32_MIN;
-        return 1;
+
+void DecodeDummy(void const* src, YM7128B_Float* dst, size_t count) {
+    (void)src;
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = 0;
     }
-    return 0;
 }
 
-int ReadU64L(YM7128B_Float* dst) {
-    int64_t src;
-    if (READ_LE(&src, sizeof(src))) {
-        src += INT64_MIN;
-        *dst = (YM7128B_Float)src / -(YM7128B_Float)INT64_MIN;
-        return 1;
+void DecodeU8(void const* src, YM7128B_Float* dst, size_t count) {
+    uint8_t const* s = (uint8_t const*)src;
+    for (size_t i = 0; i < count; ++i) {
+        int32_t x = (int32_t)s[i] + INT8_MIN;
+        dst[i] = (YM7128B_Float)x / -(YM7128B_Float)INT8_MIN;
     }
-    return 0;
 }
 
-int ReadU64B(YM7128B_Float* dst) {
-    int64_t src;
-    if (READ_BE(&src, sizeof(src))) {
-        src += INT64_MIN;
-        *dst = (YM7128B_Float)src / -(YM7128B_Float)INT64_MIN;
-        return 1;
+void DecodeS8(void const* src, YM7128B_Float* dst, size_t count) {
+    int8_t const* s = (int8_t const*)src;
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = (YM7128B_Float)s[i] / -(YM7128B_Float)INT8_MIN;
     }
-    return 0;
 }
 
-int ReadS64L(YM7128B_Float* dst) {
-    int64_t src;
-    if (READ_LE(&src, sizeof(src))) {
-        *dst = (YM7128B_Float)src / -(YM7128B_Float)INT64_MIN;
-        return 1;
+void DecodeU16(void const* src, YM7128B_Float* dst, size_t count) {
+    uint16_t const* s = (uint16_t const*)src;
+    for (size_t i = 0; i < count; ++i) {
+        int32_t x = (int32_t)s[i] + INT16_MIN;
+        dst[i] = (YM7128B_Float)x / -(YM7128B_Float)INT16_MIN;
     }
-    return 0;
 }
 
-int ReadS64B(YM7128B_Float* dst) {
-    int64_t src;
-    if (READ_BE(&src, sizeof(src))) {
-        *dst = (YM7128B_Float)src / -(YM7128B_Float)INT64_MIN;
-        return 1;
+void DecodeS16(void const* src, YM7128B_Float* dst, size_t count) {
+    int16_t const* s = (int16_t const*)src;
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = (YM7128B_Float)s[i] / -(YM7128B_Float)INT16_MIN;
     }
-    return 0;
 }
 
-int ReadF32L(YM7128B_Float* dst) {
-    float src;
-    if (READ_LE(&src, sizeof(src))) {
-        *dst = (YM7128B_Float)src;
-        return 1;
+void DecodeU32(void const* src, YM7128B_Float* dst, size_t count) {
+    uint32_t const* s = (uint32_t const*)src;
+    for (size_t i = 0; i < count; ++i) {
+        int32_t x = (int32_t)(s[i] ^ 0x80000000u);
+        dst[i] = (YM7128B_Float)x / -(YM7128B_Float)INT32_MIN;
     }
-    return 0;
 }
 
-int ReadF32B(YM7128B_Float* dst) {
-    float src;
-    if (READ_BE(&src, sizeof(src))) {
-        *dst = (YM7128B_Float)src;
-        return 1;
+void DecodeS32(void const* src, YM7128B_Float* dst, size_t count) {
+    int32_t const* s = (int32_t const*)src;
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = (YM7128B_Float)s[i] / -(YM7128B_Float)INT32_MIN;
     }
-    return 0;
 }
 
-int ReadF64L(YM7128B_Float* dst) {
-    double src;
-    if (READ_LE(&src, sizeof(src))) {
-        *dst = (YM7128B_Float)src;
-        return 1;
+void DecodeF32(void const* src, YM7128B_Float* dst, size_t count) {
+    float const* s = (float const*)src;
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = (YM7128B_Float)s[i];
     }
-    return 0;
 }
 
-int ReadF64B(YM7128B_Float* dst) {
-    double src;
-    if (READ_BE(&src, sizeof(src))) {
-        *dst = (YM7128B_Float)src;
-        return 1;
+void DecodeF64(void const* src, YM7128B_Float* dst, size_t count) {
+    double const* s = (double const*)src;
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = (YM7128B_Float)s[i];
     }
-    return 0;
 }
 
 
-int WriteDummy(YM7128B_Float src) {
+void DecodeFixedDummy(void const* src, YM7128B_Fixed* dst, size_t count) {
     (void)src;
-    return 1;
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = 0;
+    }
 }
 
-int WriteU8(YM7128B_Float src) {
-    double scaled = src * -(double)INT8_MIN;
-    int8_t dst = (int8_t)fmin(fmax(scaled, INT8_MIN), INT8_MAX);
-    dst -= INT8_MIN;
-    return WRITE_LE(&dst, sizeof(dst));
+void DecodeFixedU8(void const* src, YM7128B_Fixed* dst, size_t count) {
+    uint8_t const* s = (uint8_t const*)src;
+    for (size_t i = 0; i < count; ++i) {
+        int32_t x = (int32_t)s[i] + INT8_MIN;
+        dst[i] = (YM7128B_Fixed)((x * YM7128B_Fixed_Max) / -INT8_MIN);
+    }
 }
 
-int WriteS8(YM7128B_Float src) {
-    double scaled = src * -(double)INT8_MIN;
-    int8_t dst = (int8_t)fmin(fmax(scaled, INT8_MIN), INT8_MAX);
-    return WRITE_LE(&dst, sizeof(dst));
+void DecodeFixedS8(void const* src, YM7128B_Fixed* dst, size_t count) {
+    int8_t const* s = (int8_t const*)src;
+    for (size_t i = 0; i < count; ++i) {
+        int32_t x = (int32_t)s[i];
+        dst[i] = (YM7128B_Fixed)((x * YM7128B_Fixed_Max) / -INT8_MIN);
+    }
 }
 
-int WriteU16L(YM7128B_Float src) {
-    double scaled = src * -(double)INT16_MIN;
-    int16_t dst = (int16_t)fmin(fmax(scaled, INT16_MIN), INT16_MAX);
-    dst -= INT16_MIN;
-    return WRITE_LE(&dst, sizeof(dst));
+void DecodeFixedU16(void const* src, YM7128B_Fixed* dst, size_t count) {
+    uint16_t const* s = (uint16_t const*)src;
+    for (size_t i = 0; i < count; ++i) {
+        int32_t x = (int32_t)s[i] + INT16_MIN;
+        dst[i] = (YM7128B_Fixed)((x * YM7128B_Fixed_Max) / -INT16_MIN);
+    }
 }
 
-int WriteU16B(YM7128B_Float src) {
-    double scaled = src * -(double)INT16_MIN;
-    int16_t dst = (int16_t)fmin(fmax(scaled, INT16_MIN), INT16_MAX);
-    dst -= INT16_MIN;
-    return WRITE_BE(&dst, sizeof(dst));
+void DecodeFixedS16(void const* src, YM7128B_Fixed* dst, size_t count) {
+    int16_t const* s = (int16_t const*)src;
+    for (size_t i = 0; i < count; ++i) {
+        int32_t x = (int32_t)s[i];
+        dst[i] = (YM7128B_Fixed)((x * YM7128B_Fixed_Max) / -INT16_MIN);
+    }
 }
 
-int WriteS16L(YM7128B_Float src) {
-    double scaled = src * -(double)INT16_MIN;
-    int16_t dst = (int16_t)fmin(fmax(scaled, INT16_MIN), INT16_MAX);
-    return WRITE_LE(&dst, sizeof(dst));
+void DecodeFixedU32(void const* src, YM7128B_Fixed* dst, size_t count) {
+    uint32_t const* s = (uint32_t const*)src;
+    for (size_t i = 0; i < count; ++i) {
+        int64_t x = (int32_t)(s[i] ^ 0x80000000u);
+        dst[i] = (YM7128B_Fixed)((x * YM7128B_Fixed_Max) / -(int64_t)INT32_MIN);
+    }
 }
 
-int WriteS16B(YM7128B_Float src) {
-    double scaled = src * -(double)INT16_MIN;
-    int16_t dst = (int16_t)fmin(fmax(scaled, INT16_MIN), INT16_MAX);
-    return WRITE_BE(&dst, sizeof(dst));
+void DecodeFixedS32(void const* src, YM7128B_Fixed* dst, size_t count) {
+    int32_t const* s = (int32_t const*)src;
+    for (size_t i = 0; i < count; ++i) {
+        int64_t x = s[i];
+        dst[i] = (YM7128B_Fixed)((x * YM7128B_Fixed_Max) / -(int64_t)INT32_MIN);
+    }
 }
 
-int WriteU32L(YM7128B_Float src) {
-    double scaled = src * -(double)INT32_MIN;
-    int32_t dst = (int32_t)fmin(fmax(scaled, INT32_MIN), INT32_MAX);
-    dst -= INT32_MIN;
-    return WRITE_LE(&dst, sizeof(dst));
+void DecodeFixedF32(void const* src, YM7128B_Fixed* dst, size_t count) {
+    float const* s = (float const*)src;
+    YM7128B_Float const k = (YM7128B_Float)YM7128B_Fixed_Max;
+    for (size_t i = 0; i < count; ++i) {
+        YM7128B_Float x = YM7128B_ClampFloat((YM7128B_Float)s[i]);
+        dst[i] = (YM7128B_Fixed)(x * k);
+    }
 }
 
-int WriteU32B(YM7128B_Float src) {
-    double scaled = src * -(double)INT32_MIN;
-    int32_t dst = (int32_t)fmin(fmax(scaled, INT32_MIN), INT32_MAX);
-    dst -= INT32_MIN;
-    return WRITE_BE(&dst, sizeof(dst));
+void DecodeFixedF64(void const* src, YM7128B_Fixed* dst, size_t count) {
+    double const* s = (double const*)src;
+    YM7128B_Float const k = (YM7128B_Float)YM7128B_Fixed_Max;
+    for (size_t i = 0; i < count; ++i) {
+        YM7128B_Float x = YM7128B_ClampFloat((YM7128B_Float)s[i]);
+        dst[i] = (YM7128B_Fixed)(x * k);
+    }
 }
 
-int WriteS32L(YM7128B_Float src) {
-    double scaled = src * -(double)INT32_MIN;
-    int32_t dst = (int32_t)fmin(fmax(scaled, INT32_MIN), INT32_MAX);
-    return WRITE_LE(&dst, sizeof(dst));
-}
 
-int WriteS32B(YM7128B_Float src) {
-    double scaled = src * -(double)INT32_MIN;
-    int32_t dst = (int32_t)fmin(fmax(scaled, INT32_MIN), INT32_MAX);
-    return WRITE_BE(&dst, sizeof(dst));
+void EncodeDummy(YM7128B_Float const* src, void* dst, size_t count) {
+    (void)src;
+    (void)dst;
+    (void)count;
 }
 
-int WriteU64L(YM7128B_Float src) {
-    double scaled = src * -(double)INT64_MIN;
-    int64_t dst = (int64_t)fmin(fmax(scaled, (double)INT64_MIN), (double)INT64_MAX);
-    dst -= INT64_MIN;
-    return WRITE_LE(&dst, sizeof(dst));
+void EncodeU8(YM7128B_Float const* src, void* dst, size_t count) {
+    uint8_t* d = (uint8_t*)dst;
+    for (size_t i = 0; i < count; ++i) {
+        double scaled = src[i] * -(double)INT8_MIN;
+        int32_t x = (int32_t)fmin(fmax(scaled, INT8_MIN), INT8_MAX);
+        d[i] = (uint8_t)(x - INT8_MIN);
+    }
 }
 
-int WriteU64B(YM7128B_Float src) {
-    double scaled = src * -(double)INT64_MIN;
-    int64_t dst = (int64_t)fmin(fmax(scaled, (double)INT64_MIN), (double)INT64_MAX);
-    dst -= INT64_MIN;
-    return WRITE_BE(&dst, sizeof(dst));
+void EncodeS8(YM7128B_Float const* src, void* dst, size_t count) {
+    int8_t* d = (int8_t*)dst;
+    for (size_t i = 0; i < count; ++i) {
+        double scaled = src[i] * -(double)INT8_MIN;
+        d[i] = (int8_t)fmin(fmax(scaled, INT8_MIN), INT8_MAX);
+    }
 }
 
-int WriteS64L(YM7128B_Float src) {
-    double scaled = src * -(double)INT64_MIN;
-    int64_t dst = (int64_t)fmin(fmax(scaled, (double)INT64_MIN), (double)INT64_MAX);
-    return WRITE_LE(&dst, sizeof(dst));
+void EncodeU16(YM7128B_Float const* src, void* dst, size_t count) {
+    uint16_t* d = (uint16_t*)dst;
+    for (size_t i = 0; i < count; ++i) {
+        double scaled = src[i] * -(double)INT16_MIN;
+        int32_t x = (int32_t)fmin(fmax(scaled, INT16_MIN), INT16_MAX);
+        d[i] = (uint16_t)(x - INT16_MIN);
+    }
 }
 
-int WriteS64B(YM7128B_Float src) {
-    double scaled = src * -(double)INT64_MIN;
-    int64_t dst = (int64_t)fmin(fmax(scaled, (double)INT64_MIN), (double)INT64_MAX);
-    return WRITE_BE(&dst, sizeof(dst));
+void EncodeS16(YM7128B_Float const* src, void* dst, size_t count) {
+    int16_t* d = (int16_t*)dst;
+    for (size_t i = 0; i < count; ++i) {
+        double scaled = src[i] * -(double)INT16_MIN;
+        d[i] = (int16_t)fmin(fmax(scaled, INT16_MIN), INT16_MAX);
+    }
 }
 
-int WriteF32L(YM7128B_Float src) {
-    float dst = (float)src;
-    return WRITE_LE(&dst, sizeof(dst));
+void EncodeU32(YM7128B_Float const* src, void* dst, size_t count) {
+    uint32_t* d = (uint32_t*)dst;
+    for (size_t i = 0; i < count; ++i) {
+        double scaled = src[i] * -(double)INT32_MIN;
+        int64_t x = (int32_t)fmin(fmax(scaled, INT32_MIN), INT32_MAX);
+        d[i] = (uint32_t)(x - INT32_MIN);
+    }
 }
 
-int WriteF32B(YM7128B_Float src) {
-    float dst = (float)src;
-    return WRITE_BE(&dst, sizeof(dst));
+void EncodeS32(YM7128B_Float const* src, void* dst, size_t count) {
+    int32_t* d = (int32_t*)dst;
+    for (size_t i = 0; i < count; ++i) {
+        double scaled = src[i] * -(double)INT32_MIN;
+        d[i] = (int32_t)fmin(fmax(scaled, INT32_MIN), INT32_MAX);
+    }
 }
 
-int WriteF64L(YM7128B_Float src) {
-    double dst = (double)src;
-    return WRITE_LE(&dst, sizeof(dst));
+void EncodeF32(YM7128B_Float const* src, void* dst, size_t count) {
+    float* d = (float*)dst;
+    for (size_t i = 0; i < count; ++i) {
+        d[i] = (float)src[i];
+    }
 }
 
-int WriteF64B(YM7128B_Float src) {
-    double dst = (double)src;
-    return WRITE_BE(&dst, sizeof(dst));
+void EncodeF64(YM7128B_Float const* src, void* dst, size_t count) {
+    double* d = (double*)dst;
+    for (size_t i = 0; i < count; ++i) {
+        d[i] = (double)src[i];
+    }
 }
 
 
-typedef int (*STREAM_READER)(YM7128B_Float* dst);
-typedef int (*STREAM_WRITER)(YM7128B_Float src);
+typedef void (*BLOCK_DECODER)(void const* src, YM7128B_Float* dst, size_t count);
+typedef void (*BLOCK_DECODER_FIXED)(void const* src, YM7128B_Fixed* dst, size_t count);
+typedef void (*BLOCK_ENCODER)(YM7128B_Float const* src, void* dst, size_t count);
 
 struct FormatTable {
     char const* label;
-    STREAM_READER reader;
-    STREAM_WRITER writer;
+    size_t size;
+    int swap;
+    BLOCK_DECODER decoder;
+    BLOCK_DECODER_FIXED decoder_fixed;
+    BLOCK_ENCODER encoder;
+    YM7128B_OutputFormat output;  // chip output stage, if supported
+    unsigned wave;  // WAVE format tag, or 0 if not representable
 } const FORMAT_TABLE[] =
 {
-    { "dummy",      ReadDummy, WriteDummy },
-    { "U8",         ReadU8,    WriteU8    },
-    { "S8",         ReadS8,    WriteS8    },
-    { "U16_LE",     ReadU16L,  WriteU16L  },
-    { "U16_BE",     ReadU16B,  WriteU16B  },
-    { "S16_LE",     ReadS16L,  WriteS16L  },
-    { "S16_BE",     ReadS16B,  WriteS16B  },
-    { "U32_LE",     ReadU32L,  WriteU32L  },
-    { "U32_BE",     ReadU32B,  WriteU32B  },
-    { "S32_LE",     ReadS32L,  WriteS32L  },
-    { "S32_BE",     ReadS32B,  WriteS32B  },
-    { "FLOAT_LE",   ReadF32L,  WriteF32L  },
-    { "FLOAT_BE",   ReadF32B,  WriteF32B  },
-    { "FLOAT64_LE", ReadF64L,  WriteF64L  },
-    { "FLOAT64_BE", ReadF64B,  WriteF64B  },
-    { NULL,         NULL,      NULL       }
+    { "dummy",      0, 0,       DecodeDummy, DecodeFixedDummy, EncodeDummy, YM7128B_OutputFormat_Count, 0 },
+    { "U8",         1, 0,       DecodeU8,    DecodeFixedU8,    EncodeU8,    YM7128B_OutputFormat_Count, WAVE_FORMAT_PCM },
+    { "S8",         1, 0,       DecodeS8,    DecodeFixedS8,    EncodeS8,    YM7128B_OutputFormat_Count, 0 },
+    { "U16_LE",     2, SWAP_LE, DecodeU16,   DecodeFixedU16,   EncodeU16,   YM7128B_OutputFormat_Count, 0 },
+    { "U16_BE",     2, SWAP_BE, DecodeU16,   DecodeFixedU16,   EncodeU16,   YM7128B_OutputFormat_Count, 0 },
+    { "S16_LE",     2, SWAP_LE, DecodeS16,   DecodeFixedS16,   EncodeS16,   YM7128B_OutputFormat_S16,   WAVE_FORMAT_PCM },
+    { "S16_BE",     2, SWAP_BE, DecodeS16,   DecodeFixedS16,   EncodeS16,   YM7128B_OutputFormat_S16,   0 },
+    { "U32_LE",     4, SWAP_LE, DecodeU32,   DecodeFixedU32,   EncodeU32,   YM7128B_OutputFormat_Count, 0 },
+    { "U32_BE",     4, SWAP_BE, DecodeU32,   DecodeFixedU32,   EncodeU32,   YM7128B_OutputFormat_Count, 0 },
+    { "S32_LE",     4, SWAP_LE, DecodeS32,   DecodeFixedS32,   EncodeS32,   YM7128B_OutputFormat_Count, WAVE_FORMAT_PCM },
+    { "S32_BE",     4, SWAP_BE, DecodeS32,   DecodeFixedS32,   EncodeS32,   YM7128B_OutputFormat_Count, 0 },
+    { "FLOAT_LE",   4, SWAP_LE, DecodeF32,   DecodeFixedF32,   EncodeF32,   YM7128B_OutputFormat_F32,   WAVE_FORMAT_FLOAT },
+    { "FLOAT_BE",   4, SWAP_BE, DecodeF32,   DecodeFixedF32,   EncodeF32,   YM7128B_OutputFormat_F32,   0 },
+    { "FLOAT64_LE", 8, SWAP_LE, DecodeF64,   DecodeFixedF64,   EncodeF64,   YM7128B_OutputFormat_Count, WAVE_FORMAT_FLOAT },
+    { "FLOAT64_BE", 8, SWAP_BE, DecodeF64,   DecodeFixedF64,   EncodeF64,   YM7128B_OutputFormat_Count, 0 },
+    { NULL,         0, 0,       NULL,        NULL,             NULL,        YM7128B_OutputFormat_Count, 0 }
 };
 
 
-struct ChipModeTable {
-    char const* label;
-    YM7128B_ChipEngine value;
-} const MODE_TABLE[] =
-{
-    { "fixed", YM7128B_ChipEngine_Fixed },
-    { "float", YM7128B_ChipEngine_Float },
-    { "ideal", YM7128B_ChipEngine_Ideal },
-    { "short", YM7128B_ChipEngine_Short },
-    { NULL,    YM7128B_ChipEngine_Count }
-};
+typedef struct Args {
+    struct FormatTable const* format;
+    int container;  // CONTAINER_* flags
+    char const* input_path;
+    char const* output_path;
+    char const* batch_path;
+    long threads;
+    int dry_db;
+    int wet_db;
+    YM7128B_OutputStage stage;  // from dry_db and wet_db
+    YM7128B_TapIdeal rate;
+    YM7128B_ChipEngine chip_engine;
+    YM7128B_Filter filter;
+    YM7128B_Reg regs[YM7128B_Reg_Count];
+} Args;
 
 
-struct RegisterTable {
-    char const* label;
-    YM7128B_Reg value;
-} const REGISTER_TABLE[] =
+// Converts option decibels into a linear gain, muting out of range.
+static YM7128B_Float DecibelToGain(int db)
 {
-    { "GL1", YM7128B_Reg_GL1 },
-    { "GL2", YM7128B_Reg_GL2 },
-    { "GL3", YM7128B_Reg_GL3 },
-    { "GL4", YM7128B_Reg_GL4 },
-    { "GL5", YM7128B_Reg_GL5 },
-    { "GL6", YM7128B_Reg_GL6 },
-    { "GL7", YM7128B_Reg_GL7 },
-    { "GL8", YM7128B_Reg_GL8 },
+    if (db <= -YM7128B_OutputStage_Muted_dB || db >= YM7128B_OutputStage_Muted_dB) {
+        return 0;
+    }
+    return (YM7128B_Float)pow(10, (double)db / 20);
+}
 
-    { "GR1", YM7128B_Reg_GR1 },
-    { "GR2", YM7128B_Reg_GR2 },
-    { "GR3", YM7128B_Reg_GR3 },
-    { "GR4", YM7128B_Reg_GR4 },
-    { "GR5", YM7128B_Reg_GR5 },
-    { "GR6", YM7128B_Reg_GR6 },
-    { "GR7", YM7128B_Reg_GR7 },
-    { "GR8", YM7128B_Reg_GR8 },
 
-    { "VM",  YM7128B_Reg_VM },
-    { "VC",  YM7128B_Reg_VC },
-    { "VL",  YM7128B_Reg_VL },
-    { "VR",  YM7128B_Reg_VR },
+// Sets up the output stage from the option decibels; the linear gains
+// come from libm, as the library table may be off by an ulp.
+static void SetupStage(Args* args)
+{
+    YM7128B_OutputStage_Setup(&args->stage, args->dry_db, args->wet_db);
+    args->stage.dry = DecibelToGain(args->dry_db);
+    args->stage.wet = DecibelToGain(args->wet_db);
+}
 
-    { "C0",  YM7128B_Reg_C0 },
-    { "C1",  YM7128B_Reg_C1 },
 
-    { "T0",  YM7128B_Reg_T0 },
-    { "T1",  YM7128B_Reg_T1 },
-    { "T2",  YM7128B_Reg_T2 },
-    { "T3",  YM7128B_Reg_T3 },
-    { "T4",  YM7128B_Reg_T4 },
-    { "T5",  YM7128B_Reg_T5 },
-    { "T6",  YM7128B_Reg_T6 },
-    { "T7",  YM7128B_Reg_T7 },
-    { "T8",  YM7128B_Reg_T8 },
+// Returns up to BLOCK_LENGTH samples as host-order stream bytes.
+static void const* ReadBlock(Stream* stream, Block* block, struct FormatTable const* format, size_t* count)
+{
+    if (!format->size) {
+        *count = BLOCK_LENGTH;  // endless silence
+        return block->raw;
+    }
 
-    { NULL,  YM7128B_Reg_Count }
-};
+    if (stream->input_map) {
+        size_t available = (stream->input_size - stream->input_offset) / format->size;
+        *count = (available < BLOCK_LENGTH) ? available : BLOCK_LENGTH;
+        uint8_t const* src = &stream->input_map[stream->input_offset];
+        stream->input_offset += *count * format->size;
 
+        if (!format->swap) {
+            return src;  // zero copy
+        }
+        memcpy(block->raw, src, *count * format->size);
+    }
+    else {
+        size_t length = BLOCK_LENGTH;
+        if (stream->input_remaining / format->size < length) {
+            length = (size_t)(stream->input_remaining / format->size);
+        }
+        *count = fread(block->raw, format->size, length, stream->input_file);
+        stream->input_remaining -= *count * format->size;
+    }
 
-struct PresetTable {
-    char const* label;
-    YM7128B_Register regs[YM7128B_Reg_Count];
-} const PRESET_TABLE[] =
-{
-    { "off", {
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-        0x00, 0x00, 0x00, 0x00,
-        0x00, 0x00,
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    }},
-    { "direct", {
-        0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-        0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-        0x3F, 0x00, 0x3F, 0x3F,
-        0x00, 0x00,
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    }},
-    { "dune/arrakis", {
-        0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07, 0x00,
-        0x00, 0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07,
-        0x1A, 0x1D, 0x1A, 0x1A,
-        0x16, 0x16,
-        0x1F, 0x03, 0x07, 0x0B, 0x0F, 0x13, 0x17, 0x1B, 0x1F,
-    }},
-    { "dune/baghdad", {
-        0x1F, 0x00, 0x1B, 0x00, 0x17, 0x00, 0x33, 0x00,
-        0x00, 0x1D, 0x00, 0x19, 0x00, 0x15, 0x00, 0x11,
-        0x1D, 0x1D, 0x1D, 0x1D,
-        0x13, 0x13,
-        0x06, 0x02, 0x04, 0x06, 0x08, 0x0A, 0x0C, 0x0E, 0x10,
-    }},
-    { "dune/morning", {
-        0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07, 0x00,
-        0x00, 0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07,
-        0x1A, 0x1D, 0x1B, 0x1B,
-        0x16, 0x16,
-        0x1F, 0x03, 0x07, 0x0B, 0x0F, 0x13, 0x17, 0x1B, 0x1F,
-    }},
-    { "dune/sequence", {
-        0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07, 0x00,
-        0x00, 0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07,
-        0x1A, 0x1D, 0x1C, 0x1C,
-        0x16, 0x16,
-        0x1F, 0x03, 0x07, 0x0B, 0x0F, 0x13, 0x17, 0x1B, 0x1F,
-    }},
-    { "dune/sietch", {
-        0x1F, 0x00, 0x1B, 0x00, 0x17, 0x00, 0x33, 0x00,
-        0x00, 0x1D, 0x00, 0x19, 0x00, 0x15, 0x00, 0x11,
-        0x1D, 0x1D, 0x1D, 0x1D,
-        0x13, 0x13,
-        0x06, 0x02, 0x04, 0x06, 0x08, 0x0A, 0x0C, 0x0E, 0x10,
-    }},
-    { "dune/warsong", {
-        0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07, 0x00,
-        0x00, 0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07,
-        0x1A, 0x1D, 0x1C, 0x1C,
-        0x16, 0x16,
-        0x1F, 0x03, 0x07, 0x0B, 0x0F, 0x13, 0x17, 0x1B, 0x1F,
-    }},
-    { "dune/water", {
-        0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07, 0x00,
-        0x00, 0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07,
-        0x1A, 0x1D, 0x1A, 0x1A,
-        0x16, 0x16,
-        0x1F, 0x03, 0x07, 0x0B, 0x0F, 0x13, 0x17, 0x1B, 0x1F,
-    }},
-    { "dune/wormintro", {
-        0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07, 0x00,
-        0x00, 0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07,
-        0x1A, 0x1D, 0x18, 0x18,
-        0x16, 0x16,
-        0x1F, 0x03, 0x07, 0x0B, 0x0F, 0x13, 0x17, 0x1B, 0x1F,
-    }},
-    { "dune/wormsuit", {
-        0x18, 0x00, 0x1A, 0x00, 0x1C, 0x00, 0x1E, 0x00,
-        0x00, 0x19, 0x00, 0x1B, 0x00, 0x1D, 0x00, 0x1F,
-        0x1B, 0x1F, 0x17, 0x17,
-        0x12, 0x08,
-        0x1F, 0x07, 0x0A, 0x0D, 0x10, 0x13, 0x16, 0x19, 0x1C,
-    }},
-    { "gold/cavern", {
-        0x1F, 0x00, 0x1D, 0x00, 0x1B, 0x00, 0x19, 0x00,
-        0x20, 0x3E, 0x20, 0x3C, 0x20, 0x3A, 0x20, 0x38,
-        0x3C, 0x3E, 0x1C, 0x1C,
-        0x11, 0x0A,
-        0x12, 0x10, 0x0E, 0x0C, 0x0A, 0x08, 0x06, 0x04, 0x02,
-    }},
-    { "gold/chapel", {
-        0x1F, 0x1E, 0x1D, 0x1C, 0x1B, 0x1A, 0x19, 0x18,
-        0x3F, 0x3E, 0x3D, 0x3C, 0x3B, 0x3A, 0x39, 0x38,
-        0x38, 0x3D, 0x1B, 0x1B,
-        0x10, 0x10,
-        0x1F, 0x1F, 0x1D, 0x1B, 0x19, 0x17, 0x15, 0x13, 0x11,
-    }},
-    { "gold/concert_hall", {
-        0x31, 0x00, 0x15, 0x00, 0x39, 0x00, 0x1D, 0x00,
-        0x00, 0x33, 0x00, 0x17, 0x00, 0x3B, 0x00, 0x1F,
-        0x1A, 0x1C, 0x1D, 0x1D,
-        0x16, 0x16,
-        0x1F, 0x1C, 0x19, 0x16, 0x13, 0x10, 0x0D, 0x0A, 0x07,
-    }},
-    { "gold/deep_space", {
-        0x18, 0x00, 0x1A, 0x00, 0x1C, 0x00, 0x1E, 0x00,
-        0x00, 0x19, 0x00, 0x1B, 0x00, 0x1D, 0x00, 0x1F,
-        0x1B, 0x1F, 0x1C, 0x1C,
-        0x12, 0x08,
-        0x1F, 0x07, 0x0A, 0x0D, 0x10, 0x13, 0x16, 0x19, 0x1C,
-    }},
-    { "gold/jazz_club", {
-        0x1F, 0x1B, 0x37, 0x13, 0x2F, 0x0B, 0x27, 0x03,
-        0x1F, 0x3B, 0x17, 0x33, 0x0F, 0x2B, 0x07, 0x23,
-        0x1C, 0x1F, 0x1B, 0x1B,
-        0x0C, 0x0C,
-        0x1F, 0x03, 0x07, 0x0B, 0x0F, 0x13, 0x17, 0x1B, 0x1F,
-    }},
-    { "gold/movie_theater", {
-        0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07, 0x00,
-        0x00, 0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07,
-        0x1A, 0x1D, 0x1C, 0x1C,
-        0x16, 0x16,
-        0x1F, 0x03, 0x07, 0x0B, 0x0F, 0x13, 0x17, 0x1B, 0x1F,
-    }},
-    { "gold/recital_hall", {
-        0x1F, 0x3E, 0x1D, 0x3C, 0x1B, 0x3A, 0x19, 0x38,
-        0x3F, 0x1E, 0x3D, 0x1C, 0x3B, 0x1A, 0x39, 0x18,
-        0x18, 0x1C, 0x1C, 0x1C,
-        0x15, 0x15,
-        0x14, 0x04, 0x06, 0x08, 0x0A, 0x0C, 0x0E, 0x10, 0x12,
-    }},
-    { "gold/stadium", {
-        0x1F, 0x00, 0x1B, 0x00, 0x17, 0x00, 0x33, 0x00,
-        0x00, 0x1D, 0x00, 0x19, 0x00, 0x15, 0x00, 0x11,
-        0x1D, 0x1D, 0x3D, 0x3D,
-        0x13, 0x13,
-        0x06, 0x02, 0x04, 0x06, 0x08, 0x0A, 0x0C, 0x0E, 0x10,
-    }},
-    { NULL, {0} }
-};
+    if (format->swap) {
+        SwapBytes(block->raw, format->size, *count);
+    }
+    return block->raw;
+}
 
 
-typedef struct Args {
-    STREAM_READER stream_reader;
-    STREAM_WRITER stream_writer;
-    YM7128B_Float dry;
-    YM7128B_Float wet;
-    YM7128B_TapIdeal rate;
-    YM7128B_ChipEngine chip_engine;
-    YM7128B_Reg regs[YM7128B_Reg_Count];
-} Args;
+// Encodes and writes the first count samples of the frames buffer.
+static int WriteBlock(Stream* stream, Block* block, struct FormatTable const* format, size_t count)
+{
+    if (!format->size) {
+        return 1;
+    }
+    size_t size = count * format->size;
+    void* dst = block->raw;
+
+    if (stream->output_map) {
+        if (size > stream->output_size - stream->output_offset) {
+            errno = ENOSPC;
+            return 0;
+        }
+        dst = &stream->output_map[stream->output_offset];
+        stream->output_offset += size;
+    }
 
+    if (!block->encoded) {
+        format->encoder(block->frames, dst, count);
+    }
+    else if (dst != (void*)block->raw) {
+        memcpy(dst, block->raw, count * format->size);
+    }
+    if (format->swap) {
+        SwapBytes(dst, format->size, count);
+    }
 
-static uint8_t HexToByte(char const* str);
-static int RunFixed(Args const* args);
-static int RunFloat(Args const* args);
-static int RunIdeal(Args const* args);
-static int RunShort(Args const* args);
+    if (stream->output_map) {
+        return 1;
+    }
+    if (fwrite(dst, format->size, count, stream->output_file) != count) {
+        return 0;
+    }
+    stream->output_written += size;
+    return 1;
+}
 
 
-static uint8_t HexToByte(char const* str)
+static int MapInput(Stream* stream, char const* path)
 {
-    uint8_t value = 0;
-    for (int i = 0; i < 2; ++i) {
-        char c = str[i];
-        if (c >= '0' && c <= '9') {
-            value |= (uint8_t)(c - '0');
-        }
-        else if (c >= 'a' && c <= 'f') {
-            value |= (uint8_t)((c - 'a') + 10);
-        }
-        else if (c >= 'A' && c <= 'F') {
-            value |= (uint8_t)((c - 'A') + 10);
-        }
-        else {
-            errno = ERANGE;
-            return 0;
-        }
-        value <<= 4;
+#if PIPE_MMAP
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return 0;
     }
-    return value;
+    struct stat st;
+    void* map = MAP_FAILED;
+    size_t size = 0;
+    if (!fstat(fd, &st) && st.st_size > 0 && (uintmax_t)st.st_size <= SIZE_MAX) {
+        size = (size_t)st.st_size;
+        map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (map == MAP_FAILED) {
+        return 0;
+    }
+    posix_madvise(map, size, POSIX_MADV_SEQUENTIAL);
+    stream->input_map = (uint8_t const*)map;
+    stream->input_map_size = size;
+    stream->input_size = size;
+    return 1;
+#else
+    (void)stream;
+    (void)path;
+    return 0;
+#endif
 }
 
 
-int main(int argc, char const* argv[])
+static int MapOutput(Stream* stream, char const* path, size_t size)
 {
-    Args args;
-    args.stream_reader = ReadU8;
-    args.stream_writer = WriteU8;
-    args.dry = 1;
-    args.wet = 1;
-    args.rate = (YM7128B_TapIdeal)YM7128B_Input_Rate;
-    args.chip_engine = YM7128B_ChipEngine_Fixed;
-    for (YM7128B_Address r = 0; r < (YM7128B_Address)YM7128B_Reg_Count; ++r) {
-        args.regs[r] = 0;
+#if PIPE_MMAP
+    if (!size || (off_t)size < 0) {
+        return 0;
+    }
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0) {
+        return 0;
+    }
+    void* map = MAP_FAILED;
+    if (!ftruncate(fd, (off_t)size)) {
+        map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (map == MAP_FAILED) {
+        close(fd);
+        return 0;
     }
+    stream->output_map = (uint8_t*)map;
+    stream->output_size = size;
+    stream->output_fd = fd;
+    return 1;
+#else
+    (void)stream;
+    (void)path;
+    (void)size;
+    return 0;
+#endif
+}
 
-    for (int i = 1; i < argc; ++i) {
-        // Unary arguments
-        if (!strcmp(argv[i], "-h") ||
-            !strcmp(argv[i], "--help")) {
-            puts(USAGE);
-            return 0;
-        }
 
-        // Binary arguments
-        if (i >= argc - 1) {
-            fprintf(stderr, "Expecting binary argument: %s\n", argv[i]);
+static uint16_t GetLE16(uint8_t const* src)
+{
+    return (uint16_t)(src[0] | (src[1] << 8));
+}
+
+static uint32_t GetLE32(uint8_t const* src)
+{
+    return ((uint32_t)GetLE16(&src[0]) | ((uint32_t)GetLE16(&src[2]) << 16));
+}
+
+static uint64_t GetLE64(uint8_t const* src)
+{
+    return ((uint64_t)GetLE32(&src[0]) | ((uint64_t)GetLE32(&src[4]) << 32));
+}
+
+static void PutLE16(uint8_t* dst, uint16_t value)
+{
+    dst[0] = (uint8_t)value;
+    dst[1] = (uint8_t)(value >> 8);
+}
+
+static void PutLE32(uint8_t* dst, uint32_t value)
+{
+    PutLE16(&dst[0], (uint16_t)value);
+    PutLE16(&dst[2], (uint16_t)(value >> 16));
+}
+
+static void PutLE64(uint8_t* dst, uint64_t value)
+{
+    PutLE32(&dst[0], (uint32_t)value);
+    PutLE32(&dst[4], (uint32_t)(value >> 32));
+}
+
+
+// Reads header bytes from the input, either mapped or streamed.
+static int ReadInput(Stream* stream, void* dst, size_t size)
+{
+    if (stream->input_map) {
+        if (size > stream->input_size - stream->input_offset) {
+            return 0;
+        }
+        memcpy(dst, &stream->input_map[stream->input_offset], size);
+        stream->input_offset += size;
+        return 1;
+    }
+    return fread(dst, 1, size, stream->input_file) == size;
+}
+
+
+// Skips input bytes by reading them, as pipes cannot seek.
+static int SkipInput(Stream* stream, uint64_t size)
+{
+    if (stream->input_map) {
+        if (size > stream->input_size - stream->input_offset) {
+            return 0;
+        }
+        stream->input_offset += (size_t)size;
+        return 1;
+    }
+    uint8_t buffer[256];
+    while (size) {
+        size_t length = (size < sizeof(buffer)) ? (size_t)size : sizeof(buffer);
+        if (!ReadInput(stream, buffer, length)) {
+            return 0;
+        }
+        size -= length;
+    }
+    return 1;
+}
+
+
+// Parses a RIFF/WAVE or RF64 header up to the start of the sample data,
+// overriding the sample format and rate.
+// Unknown chunks are skipped; a streamed data size reads up to the end.
+static int ReadWave(Stream* stream, Args* args, char const* path)
+{
+    uint8_t header[40];
+    uint64_t data_size = UINT64_MAX;  // from ds64
+    unsigned tag = 0;
+    unsigned channels = 0;
+    unsigned align = 0;
+    unsigned bits = 0;
+    uint32_t rate = 0;
+
+    if (!ReadInput(stream, header, 12) || memcmp(&header[8], "WAVE", 4) ||
+        (memcmp(&header[0], "RIFF", 4) && memcmp(&header[0], "RF64", 4))) {
+        fprintf(stderr, "%s: Not a RIFF/WAVE stream\n", path);
+        return 1;
+    }
+    int rf64 = !memcmp(&header[0], "RF64", 4);
+    int data = 0;
+
+    while (ReadInput(stream, header, 8)) {
+        uint64_t size = GetLE32(&header[4]);
+        if (!memcmp(&header[0], "data", 4)) {
+            if (size == WAVE_SIZE_UNKNOWN) {
+                size = rf64 ? data_size : UINT64_MAX;
+            }
+            data_size = size;
+            data = 1;
+            break;
+        }
+        uint64_t skip = size + (size & 1);  // word aligned
+
+        if (!memcmp(&header[0], "ds64", 4) && size >= 28) {
+            if (!ReadInput(stream, header, 28)) {
+                break;
+            }
+            data_size = GetLE64(&header[8]);
+            skip -= 28;
+        }
+        else if (!memcmp(&header[0], "fmt ", 4) && size >= 16) {
+            size_t length = (size < sizeof(header)) ? (size_t)size : sizeof(header);
+            if (!ReadInput(stream, header, length)) {
+                break;
+            }
+            tag = GetLE16(&header[0]);
+            channels = GetLE16(&header[2]);
+            rate = GetLE32(&header[4]);
+            align = GetLE16(&header[12]);
+            bits = GetLE16(&header[14]);
+            if (tag == WAVE_FORMAT_EXTENSIBLE && length >= 40) {
+                tag = GetLE16(&header[24]);  // leading SubFormat GUID bytes
+            }
+            skip -= length;
+        }
+        if (!SkipInput(stream, skip)) {
+            break;
+        }
+    }
+
+    if (!data) {
+        fprintf(stderr, "%s: Missing WAVE data chunk\n", path);
+        return 1;
+    }
+
+    struct FormatTable const* format = NULL;
+    for (int j = 0; tag && FORMAT_TABLE[j].label; ++j) {
+        if (FORMAT_TABLE[j].wave == tag && FORMAT_TABLE[j].size * 8 == bits) {
+            format = &FORMAT_TABLE[j];
+            break;
+        }
+    }
+    if (!format || channels != 1 || align != format->size || !rate) {
+        fprintf(stderr, "%s: Unsupported WAVE format: tag 0x%04X, %u channels, %u bits, %lu Hz\n",
+                path, tag, channels, bits, (unsigned long)rate);
+        return 1;
+    }
+    args->format = format;
+    args->rate = (YM7128B_TapIdeal)rate;
+
+    if (stream->input_map) {
+        stream->input_base = stream->input_offset;
+        if (data_size < stream->input_size - stream->input_offset) {
+            stream->input_size = stream->input_offset + (size_t)data_size;
+        }
+    }
+    else {
+        stream->input_remaining = data_size;
+    }
+    return 0;
+}
+
+
+// Builds a stereo WAVE header, with streamed size placeholders.
+static void FormatWave(uint8_t* header, struct FormatTable const* format, uint32_t rate)
+{
+    uint16_t align = (uint16_t)(format->size * YM7128B_OutputChannel_Count);
+
+    memcpy(&header[0], "RIFF", 4);
+    PutLE32(&header[4], WAVE_SIZE_UNKNOWN);
+    memcpy(&header[8], "WAVE", 4);
+
+    memcpy(&header[12], "JUNK", 4);  // becomes ds64 for RF64
+    PutLE32(&header[16], 28);
+    memset(&header[20], 0, 28);
+
+    memcpy(&header[48], "fmt ", 4);
+    PutLE32(&header[52], 18);
+    PutLE16(&header[56], (uint16_t)format->wave);
+    PutLE16(&header[58], (uint16_t)YM7128B_OutputChannel_Count);
+    PutLE32(&header[60], rate);
+    PutLE32(&header[64], rate * align);
+    PutLE16(&header[68], align);
+    PutLE16(&header[70], (uint16_t)(format->size * 8));
+    PutLE16(&header[72], 0);
+
+    memcpy(&header[74], "data", 4);
+    PutLE32(&header[78], WAVE_SIZE_UNKNOWN);
+}
+
+
+// Patches the WAVE header sizes, turning it into RF64 beyond 4 GiB.
+static void PatchWave(uint8_t* header, uint64_t data_size)
+{
+    uint64_t riff_size = (WAVE_HEADER_SIZE - 8) + data_size;
+
+    if (riff_size <= UINT32_MAX) {
+        memcpy(&header[0], "RIFF", 4);
+        PutLE32(&header[4], (uint32_t)riff_size);
+        PutLE32(&header[78], (uint32_t)data_size);
+    }
+    else {
+        memcpy(&header[0], "RF64", 4);
+        PutLE32(&header[4], WAVE_SIZE_UNKNOWN);
+        memcpy(&header[12], "ds64", 4);
+        PutLE64(&header[20], riff_size);
+        PutLE64(&header[28], data_size);
+        PutLE64(&header[36], data_size / GetLE16(&header[68]));  // frames
+        PutLE32(&header[44], 0);  // no table
+        PutLE32(&header[78], WAVE_SIZE_UNKNOWN);
+    }
+}
+
+
+// Rewrites the output WAVE header with the final sizes; placeholders are kept
+// if the output cannot seek, as for pipes.
+static int FinishWave(Stream* stream)
+{
+    uint64_t data_size = stream->output_written;
+    if (stream->output_map) {
+        data_size = stream->output_offset - stream->output_base;
+    }
+    PatchWave(stream->wave_header, data_size);
+
+    if (stream->output_map) {
+        memcpy(stream->output_map, stream->wave_header, WAVE_HEADER_SIZE);
+        return 0;
+    }
+    FILE* file = stream->output_file;
+    if (fflush(file)) {
+        perror("fflush()");
+        return 1;
+    }
+    if (fseek(file, 0, SEEK_SET)) {
+        errno = 0;
+        return 0;  // streamed
+    }
+    if (fwrite(stream->wave_header, 1, WAVE_HEADER_SIZE, file) != WAVE_HEADER_SIZE ||
+        fflush(file)) {
+        perror("fwrite()");
+        return 1;
+    }
+    return 0;
+}
+
+
+static int CloseStream(Stream* stream);
+
+// Opens the stream files, instead of stdin/stdout.
+// Files are mapped into memory where possible, else they are opened as files.
+// A WAVE input header overrides the sample format and rate of args.
+// The output file is preallocated for output_ratio samples per input sample,
+// after the WAVE header, if any.
+static int OpenStream(Stream* stream, Args* args, size_t output_ratio)
+{
+    stream->input_file = stdin;
+    stream->output_file = stdout;
+    stream->input_map = NULL;
+    stream->input_map_size = 0;
+    stream->input_size = 0;
+    stream->input_offset = 0;
+    stream->input_base = 0;
+    stream->input_remaining = UINT64_MAX;
+    stream->output_map = NULL;
+    stream->output_size = 0;
+    stream->output_offset = 0;
+    stream->output_base = 0;
+    stream->output_written = 0;
+    stream->output_fd = -1;
+
+    int wave_input = (args->container & CONTAINER_WAVE_INPUT);
+    int wave_output = (args->container & CONTAINER_WAVE_OUTPUT);
+    char const* input_path = args->input_path;
+    char const* output_path = args->output_path;
+
+    if (input_path && (args->format->size || wave_input)) {
+        if (!MapInput(stream, input_path)) {
+            stream->input_file = fopen(input_path, "rb");
+            if (!stream->input_file) {
+                stream->input_file = stdin;
+                perror(input_path);
+                return 1;
+            }
+        }
+    }
+    if (wave_input && ReadWave(stream, args, input_path ? input_path : "stdin")) {
+        CloseStream(stream);
+        return 1;
+    }
+
+    struct FormatTable const* format = args->format;
+    if (wave_output) {
+        if (!format->wave) {
+            fprintf(stderr, "Unsupported WAVE format: %s\n", format->label);
+            CloseStream(stream);
+            return 1;
+        }
+        size_t rate = args->rate * (output_ratio / YM7128B_OutputChannel_Count);
+        FormatWave(stream->wave_header, format, (uint32_t)rate);
+    }
+    size_t header_size = wave_output ? WAVE_HEADER_SIZE : 0;
+
+    if (output_path) {
+        size_t size = 0;
+        if (stream->input_map && format->size) {
+            size_t count = (stream->input_size - stream->input_offset) / format->size;
+            if (count <= (SIZE_MAX - header_size) / (output_ratio * format->size)) {
+                size = header_size + (count * output_ratio * format->size);
+            }
+        }
+        if (!MapOutput(stream, output_path, size)) {
+            stream->output_file = fopen(output_path, "wb");
+            if (!stream->output_file) {
+                stream->output_file = stdout;
+                perror(output_path);
+                CloseStream(stream);
+                return 1;
+            }
+        }
+    }
+
+    if (wave_output) {
+        if (stream->output_map) {
+            memcpy(stream->output_map, stream->wave_header, header_size);
+            stream->output_offset = header_size;
+        }
+        else if (fwrite(stream->wave_header, 1, header_size, stream->output_file) != header_size) {
+            perror("fwrite()");
+            CloseStream(stream);
+            return 1;
+        }
+        stream->output_base = header_size;
+    }
+    return 0;
+}
+
+
+// Closes the stream files, trimming a mapped output to the written size, and
+// patching the WAVE header sizes.
+static int CloseStream(Stream* stream)
+{
+    int error = 0;
+    if (stream->output_base) {
+        error |= FinishWave(stream);
+        stream->output_base = 0;
+    }
+    if (stream->input_file != stdin) {
+        fclose(stream->input_file);
+        stream->input_file = stdin;
+    }
+    if (stream->output_file != stdout) {
+        if (fclose(stream->output_file)) {
+            perror("fclose()");
+            error = 1;
+        }
+        stream->output_file = stdout;
+    }
+#if PIPE_MMAP
+    if (stream->input_map) {
+        munmap((void*)stream->input_map, stream->input_map_size);
+        stream->input_map = NULL;
+    }
+    if (stream->output_map) {
+        munmap(stream->output_map, stream->output_size);
+        stream->output_map = NULL;
+        if (ftruncate(stream->output_fd, (off_t)stream->output_offset)) {
+            perror("ftruncate()");
+            error = 1;
+        }
+        close(stream->output_fd);
+    }
+#endif
+    return error;
+}
+
+
+struct ChipModeTable {
+    char const* label;
+    YM7128B_ChipEngine value;
+} const MODE_TABLE[] =
+{
+    { "fixed", YM7128B_ChipEngine_Fixed },
+    { "float", YM7128B_ChipEngine_Float },
+    { "ideal", YM7128B_ChipEngine_Ideal },
+    { "short", YM7128B_ChipEngine_Short },
+    { NULL,    YM7128B_ChipEngine_Count }
+};
+
+
+struct ContainerTable {
+    char const* label;
+    int value;
+} const CONTAINER_TABLE[] =
+{
+    { "raw",     0 },
+    { "wav",     CONTAINER_WAVE_INPUT | CONTAINER_WAVE_OUTPUT },
+    { "wav-in",  CONTAINER_WAVE_INPUT },
+    { "wav-out", CONTAINER_WAVE_OUTPUT },
+    { NULL,      0 }
+};
+
+
+struct FilterTable {
+    char const* label;
+    YM7128B_Filter value;
+} const FILTER_TABLE[] =
+{
+    { "linear",   YM7128B_Filter_Linear },
+    { "minimum",  YM7128B_Filter_Minimum },
+    { "loworder", YM7128B_Filter_LowOrder },
+    { NULL,       YM7128B_Filter_Count }
+};
+
+
+struct RegisterTable {
+    char const* label;
+    YM7128B_Reg value;
+} const REGISTER_TABLE[] =
+{
+    { "GL1", YM7128B_Reg_GL1 },
+    { "GL2", YM7128B_Reg_GL2 },
+    { "GL3", YM7128B_Reg_GL3 },
+    { "GL4", YM7128B_Reg_GL4 },
+    { "GL5", YM7128B_Reg_GL5 },
+    { "GL6", YM7128B_Reg_GL6 },
+    { "GL7", YM7128B_Reg_GL7 },
+    { "GL8", YM7128B_Reg_GL8 },
+
+    { "GR1", YM7128B_Reg_GR1 },
+    { "GR2", YM7128B_Reg_GR2 },
+    { "GR3", YM7128B_Reg_GR3 },
+    { "GR4", YM7128B_Reg_GR4 },
+    { "GR5", YM7128B_Reg_GR5 },
+    { "GR6", YM7128B_Reg_GR6 },
+    { "GR7", YM7128B_Reg_GR7 },
+    { "GR8", YM7128B_Reg_GR8 },
+
+    { "VM",  YM7128B_Reg_VM },
+    { "VC",  YM7128B_Reg_VC },
+    { "VL",  YM7128B_Reg_VL },
+    { "VR",  YM7128B_Reg_VR },
+
+    { "C0",  YM7128B_Reg_C0 },
+    { "C1",  YM7128B_Reg_C1 },
+
+    { "T0",  YM7128B_Reg_T0 },
+    { "T1",  YM7128B_Reg_T1 },
+    { "T2",  YM7128B_Reg_T2 },
+    { "T3",  YM7128B_Reg_T3 },
+    { "T4",  YM7128B_Reg_T4 },
+    { "T5",  YM7128B_Reg_T5 },
+    { "T6",  YM7128B_Reg_T6 },
+    { "T7",  YM7128B_Reg_T7 },
+    { "T8",  YM7128B_Reg_T8 },
+
+    { NULL,  YM7128B_Reg_Count }
+};
+
+
+typedef void* (*CHIP_CREATOR)(void);
+typedef void (*CHIP_DESTROYER)(void* chip);
+typedef void (*CHIP_STARTER)(void* chip, Args const* args);
+typedef void (*CHIP_STOPPER)(void* chip);
+typedef void (*CHIP_PROCESSOR)(void* chip, Args const* args, Block* block);
+typedef size_t (*CHIP_OVERLAPPER)(void const* chip);  // 0 if not chunkable
+typedef void (*CHIP_PRIMER)(void* chip, YM7128B_Fixed const* inputs, size_t count);
+
+
+static uint8_t HexToByte(char const* str);
+static int ParseArg(Args* args, int argc, char const* argv[], int* index);
+static int DecodeStage(Stream* stream, Block* block, Args const* args, int fixed);
+static int EncodeStage(Stream* stream, Block* block, Args const* args);
+static int RunSerial(Stream* stream, Block* block, Args const* args, void* chip);
+static int RunThreads(Stream* stream, Args const* args, void* chip);
+static int RunChunks(Stream* stream, Args const* args, void* chip);
+static int RunStream(Args const* args, void* chip, Block* block);
+static int Run(Args const* args);
+static int RunBatch(Args const* args);
+
+static void* CreateFixed(void);
+static void DestroyFixed(void* chip);
+static void StartFixed(void* chip, Args const* args);
+static void StopFixed(void* chip);
+static void ProcessFixed(void* chip, Args const* args, Block* block);
+static size_t OverlapFixed(void const* chip);
+static void PrimeFixed(void* chip, YM7128B_Fixed const* inputs, size_t count);
+
+static void* CreateFloat(void);
+static void DestroyFloat(void* chip);
+static void StartFloat(void* chip, Args const* args);
+static void StopFloat(void* chip);
+static void ProcessFloat(void* chip, Args const* args, Block* block);
+
+static void* CreateIdeal(void);
+static void DestroyIdeal(void* chip);
+static void StartIdeal(void* chip, Args const* args);
+static void StopIdeal(void* chip);
+static void ProcessIdeal(void* chip, Args const* args, Block* block);
+
+static void* CreateShort(void);
+static void DestroyShort(void* chip);
+static void StartShort(void* chip, Args const* args);
+static void StopShort(void* chip);
+static void ProcessShort(void* chip, Args const* args, Block* block);
+static size_t OverlapShort(void const* chip);
+static void PrimeShort(void* chip, YM7128B_Fixed const* inputs, size_t count);
+
+
+struct EngineTable {
+    CHIP_CREATOR creator;
+    CHIP_DESTROYER destroyer;
+    CHIP_STARTER starter;
+    CHIP_STOPPER stopper;
+    CHIP_PROCESSOR processor;
+    CHIP_OVERLAPPER overlapper;  // NULL if not chunkable
+    CHIP_PRIMER primer;
+    int fixed;  // native YM7128B_Fixed samples
+    size_t output_ratio;  // output samples per input sample
+} const ENGINE_TABLE[YM7128B_ChipEngine_Count] =
+{
+    {  // YM7128B_ChipEngine_Fixed
+        CreateFixed, DestroyFixed, StartFixed, StopFixed, ProcessFixed,
+        OverlapFixed, PrimeFixed,
+        1, YM7128B_Oversampling * YM7128B_OutputChannel_Count
+    },
+    {  // YM7128B_ChipEngine_Float
+        CreateFloat, DestroyFloat, StartFloat, StopFloat, ProcessFloat,
+        NULL, NULL,
+        0, YM7128B_Oversampling * YM7128B_OutputChannel_Count
+    },
+    {  // YM7128B_ChipEngine_Ideal
+        CreateIdeal, DestroyIdeal, StartIdeal, StopIdeal, ProcessIdeal,
+        NULL, NULL,
+        0, YM7128B_OutputChannel_Count
+    },
+    {  // YM7128B_ChipEngine_Short
+        CreateShort, DestroyShort, StartShort, StopShort, ProcessShort,
+        OverlapShort, PrimeShort,
+        1, YM7128B_OutputChannel_Count
+    }
+};
+
+
+static uint8_t HexToByte(char const* str)
+{
+    uint8_t value = 0;
+    for (int i = 0; i < 2; ++i) {
+        char c = str[i];
+        if (c >= '0' && c <= '9') {
+            value |= (uint8_t)(c - '0');
+        }
+        else if (c >= 'a' && c <= 'f') {
+            value |= (uint8_t)((c - 'a') + 10);
+        }
+        else if (c >= 'A' && c <= 'F') {
+            value |= (uint8_t)((c - 'A') + 10);
+        }
+        else {
+            errno = ERANGE;
+            return 0;
+        }
+        value <<= 4;
+    }
+    return value;
+}
+
+
+// Parses the option at argv[*index], advancing *index past its value.
+static int ParseArg(Args* args, int argc, char const* argv[], int* index)
+{
+    int i = *index;
+
+    if (i >= argc - 1) {
+        fprintf(stderr, "Expecting binary argument: %s\n", argv[i]);
+        return 1;
+    }
+    else if (!strcmp(argv[i], "-c") || !strcmp(argv[i], "--container")) {
+        char const* label = argv[++i];
+        int j;
+        for (j = 0; CONTAINER_TABLE[j].label; ++j) {
+            if (!strcmp(label, CONTAINER_TABLE[j].label)) {
+                args->container = CONTAINER_TABLE[j].value;
+                break;
+            }
+        }
+        if (!CONTAINER_TABLE[j].label) {
+            fprintf(stderr, "Unknown container: %s\n", label);
+            return 1;
+        }
+    }
+    else if (!strcmp(argv[i], "--dry")) {
+        long db = strtol(argv[++i], NULL, 10);
+        if (errno) {
+            fprintf(stderr, "Invalid decibels: %s\n", argv[i]);
+            return 1;
+        }
+        if (db <= -YM7128B_OutputStage_Muted_dB || db >= YM7128B_OutputStage_Muted_dB) {
+            db = YM7128B_OutputStage_Muted_dB;
+        }
+        args->dry_db = (int)db;
+        SetupStage(args);
+    }
+    else if (!strcmp(argv[i], "-f") || !strcmp(argv[i], "--format")) {
+        char const* label = argv[++i];
+        int j;
+        for (j = 0; FORMAT_TABLE[j].label; ++j) {
+            if (!strcmp(label, FORMAT_TABLE[j].label)) {
+                args->format = &FORMAT_TABLE[j];
+                break;
+            }
+        }
+        if (!FORMAT_TABLE[j].label) {
+            fprintf(stderr, "Unknown format: %s\n", label);
+            return 1;
+        }
+    }
+    else if (!strcmp(argv[i], "-i") || !strcmp(argv[i], "--input")) {
+        args->input_path = argv[++i];
+    }
+    else if (!strcmp(argv[i], "-o") || !strcmp(argv[i], "--output")) {
+        args->output_path = argv[++i];
+    }
+    else if (!strcmp(argv[i], "-b") || !strcmp(argv[i], "--batch")) {
+        args->batch_path = argv[++i];
+    }
+    else if (!strcmp(argv[i], "-t") || !strcmp(argv[i], "--threads")) {
+        args->threads = strtol(argv[++i], NULL, 10);
+        if (errno || args->threads < 1) {
+            fprintf(stderr, "Invalid threads: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    else if (!strcmp(argv[i], "-e") || !strcmp(argv[i], "--engine")) {
+        char const* label = argv[++i];
+        int j;
+        for (j = 0; MODE_TABLE[j].label; ++j) {
+            if (!strcmp(label, MODE_TABLE[j].label)) {
+                args->chip_engine = MODE_TABLE[j].value;
+                break;
+            }
+        }
+        if (!MODE_TABLE[j].label) {
+            fprintf(stderr, "Unknown engine: %s\n", label);
+            return 1;
+        }
+    }
+    else if (!strcmp(argv[i], "--filter")) {
+        char const* label = argv[++i];
+        int j;
+        for (j = 0; FILTER_TABLE[j].label; ++j) {
+            if (!strcmp(label, FILTER_TABLE[j].label)) {
+                args->filter = FILTER_TABLE[j].value;
+                break;
+            }
+        }
+        if (!FILTER_TABLE[j].label) {
+            fprintf(stderr, "Unknown filter: %s\n", label);
+            return 1;
+        }
+    }
+    else if (!strcmp(argv[i], "--preset")) {
+        char const* label = argv[++i];
+        int j;
+        for (j = 0; PRESET_TABLE[j].label; ++j) {
+            if (!strcmp(label, PRESET_TABLE[j].label)) {
+                break;
+            }
+        }
+        if (!PRESET_TABLE[j].label) {
+            fprintf(stderr, "Unknown preset: %s\n", label);
+            return 1;
+        }
+        YM7128B_Register const* data = PRESET_TABLE[j].regs;
+        for (YM7128B_Address r = 0; r < (YM7128B_Address)YM7128B_Reg_Count; ++r) {
+            args->regs[r] = data[r];
+        }
+    }
+    else if (!strcmp(argv[i], "-r") || !strcmp(argv[i], "--rate")) {
+        long rate = strtol(argv[++i], NULL, 10);
+        if (errno || rate < 1) {
+            fprintf(stderr, "Invalid rate: %s\n", argv[i]);
+            return 1;
+        }
+        args->rate = (YM7128B_TapIdeal)rate;
+    }
+    else if (!strncmp(argv[i], "--reg-", 6)) {
+        char const* label = &argv[i][6];
+        int r;
+        for (r = 0; REGISTER_TABLE[r].label; ++r) {
+            if (!strcmp(label, REGISTER_TABLE[r].label)) {
+                break;
+            }
+        }
+        if (!REGISTER_TABLE[r].label) {
+            fprintf(stderr, "Unknown register: %s\n", label);
+            return 1;
+        }
+        long value = strtol(argv[++i], NULL, 16);
+        if (errno || value < 0x00 || value > 0xFF) {
+            fprintf(stderr, "Invalid register value: %s\n", argv[i]);
+            return 1;
+        }
+        args->regs[REGISTER_TABLE[r].value] = (YM7128B_Register)value;
+    }
+    else if (!strcmp(argv[i], "--regdump")) {
+        char const* strptr = argv[++i];
+        size_t length = strlen(strptr) / 2;
+        if (length > (size_t)YM7128B_Reg_Count) {
+            length = (size_t)YM7128B_Reg_Count;
+        }
+        for (size_t r = 0; r < length; ++r) {
+            uint8_t value = HexToByte(strptr);
+            strptr += 2;
+            if (errno) {
+                fprintf(stderr, "Invalid HEX string: %s\n", argv[i]);
+                return 1;
+            }
+            args->regs[r] = value;
+        }
+        for (size_t r = length; r < (size_t)YM7128B_Reg_Count; ++r) {
+            args->regs[r] = 0;
+        }
+    }
+    else if (!strcmp(argv[i], "--wet")) {
+        long db = strtol(argv[++i], NULL, 10);
+        if (errno) {
+            fprintf(stderr, "Invalid decibels: %s\n", argv[i]);
             return 1;
         }
-        else if (!strcmp(argv[i], "--dry")) {
-            long db = strtol(argv[++i], NULL, 10);
-            if (errno) {
-                fprintf(stderr, "Invalid decibels: %s\n", argv[i]);
-                return 1;
-            }
-            if (db <= -128 || db >= 128) {
-                args.dry = 0;
-            }
-            else {
-                args.dry = (YM7128B_Float)pow(10, (double)db / 20);
-            }
+        if (db <= -YM7128B_OutputStage_Muted_dB || db >= YM7128B_OutputStage_Muted_dB) {
+            db = YM7128B_OutputStage_Muted_dB;
+        }
+        args->wet_db = (int)db;
+        SetupStage(args);
+    }
+    else {
+        fprintf(stderr, "Unknown switch: %s\n", argv[i]);
+        return 1;
+    }
+
+    if (errno) {
+        fprintf(stderr, "arg %d", i);
+        perror("");
+        return 1;
+    }
+
+    *index = i;
+    return 0;
+}
+
+
+int main(int argc, char const* argv[])
+{
+    Args args;
+    args.format = &FORMAT_TABLE[1];  // U8
+    args.container = 0;  // raw
+    args.input_path = NULL;
+    args.output_path = NULL;
+    args.batch_path = NULL;
+    args.threads = 1;
+    args.dry_db = 0;
+    args.wet_db = 0;
+    SetupStage(&args);
+    args.rate = (YM7128B_TapIdeal)YM7128B_Input_Rate;
+    args.chip_engine = YM7128B_ChipEngine_Fixed;
+    args.filter = YM7128B_Filter_Default;
+    for (YM7128B_Address r = 0; r < (YM7128B_Address)YM7128B_Reg_Count; ++r) {
+        args.regs[r] = 0;
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        // Unary arguments
+        if (!strcmp(argv[i], "-h") ||
+            !strcmp(argv[i], "--help")) {
+            fputs(USAGE, stdout);
+            fputs(USAGE_TABLES, stdout);
+            puts(LICENSE);
+            return 0;
+        }
+
+        // Binary arguments
+        if (ParseArg(&args, argc, argv, &i)) {
+            return 1;
+        }
+    }
+
+#ifdef __WINDOWS__
+    _setmode(_fileno(stdin), O_BINARY);
+    if (errno) {
+        perror("_setmode(stdin)");
+        return 1;
+    }
+
+    _setmode(_fileno(stdout), O_BINARY);
+    if (errno) {
+        perror("_setmode(stdout)");
+        return 1;
+    }
+#endif  // __WINDOWS__
+
+    if (args.batch_path) {
+        return RunBatch(&args);
+    }
+    return Run(&args);
+}
+
+
+// Reads and decodes the next block into the native input type of the engine.
+static int DecodeStage(Stream* stream, Block* block, Args const* args, int fixed)
+{
+    size_t count;
+    void const* src = ReadBlock(stream, block, args->format, &count);
+    if (fixed) {
+        args->format->decoder_fixed(src, block->inputs.fixed, count);
+    }
+    else {
+        args->format->decoder(src, block->inputs.real, count);
+    }
+    block->count = count;
+    block->frames_count = 0;
+    block->last = (count < BLOCK_LENGTH);
+    block->encoded = 0;
+
+    if (block->last && ferror(stream->input_file)) {
+        perror("ReadBlock()");
+        return 1;
+    }
+    return 0;
+}
+
+
+// Encodes and writes the output frames of a processed block.
+static int EncodeStage(Stream* stream, Block* block, Args const* args)
+{
+    if (!WriteBlock(stream, block, args->format, block->frames_count)) {
+        perror("WriteBlock()");
+        return 1;
+    }
+    return 0;
+}
+
+
+static int RunSerial(Stream* stream, Block* block, Args const* args, void* chip)
+{
+    struct EngineTable const* engine = &ENGINE_TABLE[args->chip_engine];
+    int error;
+
+    do {
+        error = DecodeStage(stream, block, args, engine->fixed);
+        if (block->count) {
+            engine->processor(chip, args, block);
+            error |= EncodeStage(stream, block, args);
+        }
+    } while (!error && !block->last);
+
+    return error;
+}
+
+
+#if PIPE_THREADS
+
+// Lock-free single-producer single-consumer queue of blocks.
+typedef struct Ring {
+    Block* slots[RING_LENGTH];
+    size_t head;  // written by the consumer only
+    uint8_t padding_[BLOCK_ALIGNMENT];
+    size_t tail;  // written by the producer only
+    uint8_t padding2_[BLOCK_ALIGNMENT];
+} Ring;
+
+
+static void WaitRing(unsigned* spins)
+{
+    if (*spins < 64) {
+        ++*spins;
+    }
+    else if (*spins < 128) {
+        ++*spins;
+        sched_yield();
+    }
+    else {
+        struct timespec pause = { 0, 50000 };
+        nanosleep(&pause, NULL);
+    }
+}
+
+
+static void PushRing(Ring* ring, Block* block)
+{
+    size_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    unsigned spins = 0;
+    while (tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) >= RING_LENGTH) {
+        WaitRing(&spins);
+    }
+    ring->slots[tail % RING_LENGTH] = block;
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+
+static Block* PopRing(Ring* ring)
+{
+    size_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    unsigned spins = 0;
+    while (__atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == head) {
+        WaitRing(&spins);
+    }
+    Block* block = ring->slots[head % RING_LENGTH];
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+    return block;
+}
+
+
+typedef struct Pipeline {
+    Ring free_ring;  // writer -> reader
+    Ring decoded_ring;  // reader -> chip
+    Ring processed_ring;  // chip -> writer
+    Stream* stream;
+    Args const* args;
+    int fixed;
+    int aborted;  // set by the writer on failure
+    int reader_error;
+    int writer_error;
+} Pipeline;
+
+
+static void* ReaderThread(void* context)
+{
+    Pipeline* pipeline = (Pipeline*)context;
+    int last;
+    do {
+        Block* block = PopRing(&pipeline->free_ring);
+        if (__atomic_load_n(&pipeline->aborted, __ATOMIC_ACQUIRE)) {
+            block->count = 0;
+            block->frames_count = 0;
+            block->last = 1;
+        }
+        else if (DecodeStage(pipeline->stream, block, pipeline->args, pipeline->fixed)) {
+            pipeline->reader_error = 1;
+            block->last = 1;
+        }
+        last = block->last;  // the next stage owns the block once pushed
+        PushRing(&pipeline->decoded_ring, block);
+    } while (!last);
+    return NULL;
+}
+
+
+static void* WriterThread(void* context)
+{
+    Pipeline* pipeline = (Pipeline*)context;
+    int last;
+    do {
+        Block* block = PopRing(&pipeline->processed_ring);
+        if (!pipeline->writer_error && block->count) {
+            if (EncodeStage(pipeline->stream, block, pipeline->args)) {
+                pipeline->writer_error = 1;
+                __atomic_store_n(&pipeline->aborted, 1, __ATOMIC_RELEASE);
+            }
+        }
+        last = block->last;
+        if (!last) {
+            PushRing(&pipeline->free_ring, block);
+        }
+    } while (!last);
+    return NULL;
+}
+
+
+// Runs the reader/decoder and encoder/writer stages in their own threads,
+// while the calling thread runs the chip.
+static int RunThreads(Stream* stream, Args const* args, void* chip)
+{
+    struct EngineTable const* engine = &ENGINE_TABLE[args->chip_engine];
+    Pipeline* pipeline = (Pipeline*)calloc(1, sizeof(Pipeline));
+    Block* blocks[RING_LENGTH] = { NULL };
+    int error = !pipeline;
+
+    for (int i = 0; !error && i < RING_LENGTH; ++i) {
+        blocks[i] = AllocBlock();
+        error = !blocks[i];
+    }
+
+    if (!error) {
+        pipeline->stream = stream;
+        pipeline->args = args;
+        pipeline->fixed = engine->fixed;
+        for (int i = 0; i < RING_LENGTH; ++i) {
+            PushRing(&pipeline->free_ring, blocks[i]);
+        }
+
+        pthread_t reader, writer;
+        if (pthread_create(&reader, NULL, ReaderThread, pipeline)) {
+            perror("pthread_create()");
+            error = 1;
+        }
+        else if (pthread_create(&writer, NULL, WriterThread, pipeline)) {
+            perror("pthread_create()");
+            __atomic_store_n(&pipeline->aborted, 1, __ATOMIC_RELEASE);
+            int last;
+            do {
+                Block* block = PopRing(&pipeline->decoded_ring);
+                last = block->last;
+                PushRing(&pipeline->free_ring, block);
+            } while (!last);
+            pthread_join(reader, NULL);
+            error = 1;
+        }
+        else {
+            int last;
+            do {
+                Block* block = PopRing(&pipeline->decoded_ring);
+                if (block->count) {
+                    engine->processor(chip, args, block);
+                }
+                last = block->last;
+                PushRing(&pipeline->processed_ring, block);
+            } while (!last);
+
+            pthread_join(reader, NULL);
+            pthread_join(writer, NULL);
+            error = pipeline->reader_error | pipeline->writer_error;
+        }
+    }
+
+    for (int i = 0; i < RING_LENGTH; ++i) {
+        FreeBlock(blocks[i]);
+    }
+    free(pipeline);
+    return error;
+}
+
+
+typedef struct Chunk {
+    Stream stream;  // view of the chunk within the shared maps
+    Args const* args;
+    void* chip;  // owned, but by the first chunk
+    size_t overlap;  // [samples]
+    int error;
+} Chunk;
+
+
+// Decodes the overlap before the chunk to prime its chip, then renders the
+// chunk with the serial loop.
+static void* ChunkThread(void* context)
+{
+    Chunk* chunk = (Chunk*)context;
+    Stream* stream = &chunk->stream;
+    Args const* args = chunk->args;
+    struct EngineTable const* engine = &ENGINE_TABLE[args->chip_engine];
+    size_t size = args->format->size;
+    Block* block = AllocBlock();
+    chunk->error = !block;
+
+    size_t begin = (stream->input_offset - stream->input_base) / size;
+    if (!chunk->error && begin) {
+        size_t count = (begin < chunk->overlap) ? begin : chunk->overlap;
+        YM7128B_Fixed* warmup = (YM7128B_Fixed*)malloc(count * sizeof(YM7128B_Fixed));
+        chunk->error = !warmup;
+
+        if (warmup) {
+            Stream view = *stream;
+            view.input_offset = stream->input_offset - (count * size);
+            view.input_size = stream->input_offset;
+            for (size_t done = 0; done < count; ) {
+                size_t length;
+                void const* src = ReadBlock(&view, block, args->format, &length);
+                args->format->decoder_fixed(src, &warmup[done], length);
+                done += length;
+            }
+            engine->primer(chunk->chip, warmup, count);
+            free(warmup);
+        }
+    }
+
+    if (!chunk->error) {
+        chunk->error = RunSerial(stream, block, args, chunk->chip);
+    }
+    FreeBlock(block);
+    return NULL;
+}
+
+
+// Splits a mapped stream into chunks rendered in parallel, each by its own
+// chip primed with the inputs before it; valid only without feedback.
+static int RunChunks(Stream* stream, Args const* args, void* chip)
+{
+    struct EngineTable const* engine = &ENGINE_TABLE[args->chip_engine];
+    size_t size = args->format->size;
+    size_t total = (stream->input_size - stream->input_base) / size;
+    size_t overlap = engine->overlapper(chip);
+    size_t chunk_count = (size_t)args->threads;
+    if (chunk_count > total / overlap) {
+        chunk_count = total / overlap;
+    }
+    if (chunk_count < 2) {
+        return RunThreads(stream, args, chip);
+    }
+
+    Chunk* chunks = (Chunk*)calloc(chunk_count, sizeof(Chunk));
+    pthread_t* threads = (pthread_t*)calloc(chunk_count, sizeof(pthread_t));
+    int error = !chunks || !threads;
+    size_t started = 0;
+
+    for (size_t i = 0; !error && i < chunk_count; ++i) {
+        Chunk* chunk = &chunks[i];
+        size_t begin = (size_t)(((uint_fast64_t)total * i) / chunk_count);
+        size_t end = (size_t)(((uint_fast64_t)total * (i + 1)) / chunk_count);
+
+        chunk->stream = *stream;
+        chunk->stream.input_offset = stream->input_base + (begin * size);
+        chunk->stream.input_size = stream->input_base + (end * size);
+        chunk->stream.output_offset = stream->output_base + (begin * engine->output_ratio * size);
+        chunk->args = args;
+        chunk->overlap = overlap;
+        chunk->chip = i ? engine->creator() : chip;
+        if (!chunk->chip) {
+            error = 1;
+            break;
+        }
+        if (i) {
+            engine->starter(chunk->chip, args);
+        }
+        if (pthread_create(&threads[i], NULL, ChunkThread, chunk)) {
+            perror("pthread_create()");
+            error = 1;
+            break;
+        }
+        ++started;
+    }
+
+    for (size_t i = 0; i < started; ++i) {
+        pthread_join(threads[i], NULL);
+        error |= chunks[i].error;
+    }
+    if (chunks) {
+        for (size_t i = 1; i < chunk_count && chunks[i].chip; ++i) {
+            engine->stopper(chunks[i].chip);
+            engine->destroyer(chunks[i].chip);
+        }
+        if (started) {
+            stream->input_offset = chunks[started - 1].stream.input_offset;
+            stream->output_offset = chunks[started - 1].stream.output_offset;
+        }
+    }
+    free(threads);
+    free(chunks);
+    return error;
+}
+
+#else  // PIPE_THREADS
+
+static int RunThreads(Stream* stream, Args const* args, void* chip)
+{
+    Block* block = AllocBlock();
+    int error = block ? RunSerial(stream, block, args, chip) : 1;
+    FreeBlock(block);
+    return error;
+}
+
+
+static int RunChunks(Stream* stream, Args const* args, void* chip)
+{
+    return RunThreads(stream, args, chip);
+}
+
+#endif  // PIPE_THREADS
+
+
+// Starts the chip and processes a whole stream; block is optional, to reuse
+// serial buffers.
+// The chip is set up after the stream header, which may override the sample
+// format and rate.
+static int RunStream(Args const* options, void* chip, Block* block)
+{
+    struct EngineTable const* engine = &ENGINE_TABLE[options->chip_engine];
+    Args stream_args = *options;
+    Args const* args = &stream_args;
+    Stream stream;
+    if (OpenStream(&stream, &stream_args, engine->output_ratio)) {
+        return 1;
+    }
+    engine->starter(chip, args);
+    int error;
+    if ((args->threads > 1) && stream.input_map && stream.output_map &&
+        engine->overlapper && engine->overlapper(chip)) {
+        error = RunChunks(&stream, args, chip);
+    }
+    else if (args->threads > 1) {
+        error = RunThreads(&stream, args, chip);
+    }
+    else if (block) {
+        error = RunSerial(&stream, block, args, chip);
+    }
+    else {
+        block = AllocBlock();
+        error = block ? RunSerial(&stream, block, args, chip) : 1;
+        FreeBlock(block);
+    }
+    engine->stopper(chip);
+    error |= CloseStream(&stream);
+    return error;
+}
+
+
+static int Run(Args const* args)
+{
+    if ((unsigned)args->chip_engine >= (unsigned)YM7128B_ChipEngine_Count) {
+        return 1;
+    }
+    struct EngineTable const* engine = &ENGINE_TABLE[args->chip_engine];
+    void* chip = engine->creator();
+    if (!chip) {
+        return 1;
+    }
+    int error = RunStream(args, chip, NULL);
+    engine->destroyer(chip);
+    return error;
+}
+
+
+//! Maximum tokens per batch job line.
+#define JOB_TOKENS_MAX  256
+
+
+typedef struct Job {
+    Args args;
+    size_t line;  // within the job list
+} Job;
+
+
+typedef struct Batch {
+    char const* path;
+    char* text;  // job list contents, tokenized in place
+    Job* jobs;
+    size_t count;
+    size_t next;  // next job to run, shared by the workers
+} Batch;
+
+
+typedef struct Worker {
+    Batch* batch;
+    void* chips[YM7128B_ChipEngine_Count];  // reused across jobs
+    Block* block;
+    int error;
+} Worker;
+
+
+static char* ReadText(char const* path)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return NULL;
+    }
+    size_t size = 0;
+    size_t capacity = 4096;
+    char* text = (char*)malloc(capacity + 1);
+
+    while (text) {
+        size += fread(&text[size], 1, capacity - size, file);
+        if (size < capacity) {
+            break;
+        }
+        char* grown = (char*)realloc(text, (capacity * 2) + 1);
+        if (!grown) {
+            free(text);
+            text = NULL;
+            break;
         }
-        else if (!strcmp(argv[i], "-f") || !strcmp(argv[i], "--format")) {
-            char const* label = argv[++i];
-            int j;
-            for (j = 0; FORMAT_TABLE[j].label; ++j) {
-                if (!strcmp(label, FORMAT_TABLE[j].label)) {
-                    args.stream_reader = FORMAT_TABLE[j].reader;
-                    args.stream_writer = FORMAT_TABLE[j].writer;
-                    break;
-                }
-            }
-            if (!FORMAT_TABLE[j].label) {
-                fprintf(stderr, "Unknown format: %s\n", label);
-                return 1;
-            }
+        text = grown;
+        capacity *= 2;
+    }
+
+    if (text) {
+        if (ferror(file)) {
+            free(text);
+            text = NULL;
         }
-        else if (!strcmp(argv[i], "-e") || !strcmp(argv[i], "--engine")) {
-            char const* label = argv[++i];
-            int j;
-            for (j = 0; MODE_TABLE[j].label; ++j) {
-                if (!strcmp(label, MODE_TABLE[j].label)) {
-                    args.chip_engine = MODE_TABLE[j].value;
-                    break;
-                }
-            }
-            if (!MODE_TABLE[j].label) {
-                fprintf(stderr, "Unknown engine: %s\n", label);
-                return 1;
-            }
+        else {
+            text[size] = '\0';
         }
-        else if (!strcmp(argv[i], "--preset")) {
-            char const* label = argv[++i];
-            int j;
-            for (j = 0; PRESET_TABLE[j].label; ++j) {
-                if (!strcmp(label, PRESET_TABLE[j].label)) {
-                    break;
-                }
+    }
+    fclose(file);
+    return text;
+}
+
+
+// Parses a job list: one "INPUT OUTPUT [OPTION]..." job per line.
+// Jobs inherit the command line options; blank and '#' lines are skipped.
+static int LoadBatch(Batch* batch, Args const* args)
+{
+    batch->text = ReadText(batch->path);
+    if (!batch->text) {
+        perror(batch->path);
+        return 1;
+    }
+    size_t capacity = 0;
+    size_t line = 0;
+
+    for (char* ptr = batch->text; *ptr; ) {
+        char* end = ptr + strcspn(ptr, "\n");
+        char* next = *end ? (end + 1) : end;
+        *end = '\0';
+        ++line;
+
+        char const* argv[JOB_TOKENS_MAX];
+        int argc = 0;
+        for (;;) {
+            ptr += strspn(ptr, " \t\r");
+            if (!*ptr || *ptr == '#') {
+                break;
             }
-            if (!PRESET_TABLE[j].label) {
-                fprintf(stderr, "Unknown preset: %s\n", label);
+            if (argc >= JOB_TOKENS_MAX) {
+                fprintf(stderr, "%s:%lu: Too many tokens\n", batch->path, (unsigned long)line);
                 return 1;
             }
-            YM7128B_Register const* data = PRESET_TABLE[j].regs;
-            for (YM7128B_Address r = 0; r < (YM7128B_Address)YM7128B_Reg_Count; ++r) {
-                args.regs[r] = data[r];
+            argv[argc++] = ptr;
+            ptr += strcspn(ptr, " \t\r");
+            if (*ptr) {
+                *ptr++ = '\0';
             }
         }
-        else if (!strcmp(argv[i], "-r") || !strcmp(argv[i], "--rate")) {
-            long rate = strtol(argv[++i], NULL, 10);
-            if (errno || rate < 1) {
-                fprintf(stderr, "Invalid rate: %s\n", argv[i]);
-                return 1;
-            }
-            args.rate = (YM7128B_TapIdeal)rate;
-        }
-        else if (!strncmp(argv[i], "--reg-", 6)) {
-            char const* label = &argv[i][6];
-            int r;
-            for (r = 0; REGISTER_TABLE[r].label; ++r) {
-                if (!strcmp(label, REGISTER_TABLE[r].label)) {
-                    break;
-                }
-            }
-            if (!REGISTER_TABLE[r].label) {
-                fprintf(stderr, "Unknown register: %s\n", label);
-                return 1;
-            }
-            long value = strtol(argv[++i], NULL, 16);
-            if (errno || value < 0x00 || value > 0xFF) {
-                fprintf(stderr, "Invalid register value: %s\n", argv[i]);
-                return 1;
-            }
-            args.regs[REGISTER_TABLE[r].value] = (YM7128B_Register)value;
+        ptr = next;
+
+        if (!argc) {
+            continue;
         }
-        else if (!strcmp(argv[i], "--regdump")) {
-            char const* strptr = argv[++i];
-            size_t length = strlen(strptr) / 2;
-            if (length > (size_t)YM7128B_Reg_Count) {
-                length = (size_t)YM7128B_Reg_Count;
-            }
-            for (size_t r = 0; r < length; ++r) {
-                uint8_t value = HexToByte(strptr);
-                strptr += 2;
-                if (errno) {
-                    fprintf(stderr, "Invalid HEX string: %s\n", argv[i]);
-                    return 1;
-                }
-                args.regs[r] = value;
-            }
-            for (size_t r = length; r < (size_t)YM7128B_Reg_Count; ++r) {
-                args.regs[r] = 0;
-            }
+        if (argc < 2) {
+            fprintf(stderr, "%s:%lu: Expecting INPUT OUTPUT\n", batch->path, (unsigned long)line);
+            return 1;
         }
-        else if (!strcmp(argv[i], "--wet")) {
-            long db = strtol(argv[++i], NULL, 10);
-            if (errno) {
-                fprintf(stderr, "Invalid decibels: %s\n", argv[i]);
+
+        if (batch->count >= capacity) {
+            capacity = capacity ? (capacity * 2) : 64;
+            Job* jobs = (Job*)realloc(batch->jobs, capacity * sizeof(Job));
+            if (!jobs) {
+                perror("realloc()");
                 return 1;
             }
-            if (db <= -128 || db >= 128) {
-                args.wet = 0;
-            }
-            else {
-                args.wet = (YM7128B_Float)pow(10, (double)db / 20);
+            batch->jobs = jobs;
+        }
+        Job* job = &batch->jobs[batch->count++];
+        job->args = *args;
+        job->args.input_path = argv[0];
+        job->args.output_path = argv[1];
+        job->line = line;
+
+        for (int i = 2; i < argc; ++i) {
+            errno = 0;
+            if (ParseArg(&job->args, argc, argv, &i)) {
+                fprintf(stderr, "%s:%lu: Invalid job\n", batch->path, (unsigned long)line);
+                return 1;
             }
         }
-        else {
-            fprintf(stderr, "Unknown switch: %s\n", argv[i]);
+        job->args.batch_path = NULL;
+        job->args.threads = 1;
+
+        if (!job->args.format->size && !(job->args.container & CONTAINER_WAVE_INPUT)) {
+            fprintf(stderr, "%s:%lu: Unsupported format: %s\n",
+                    batch->path, (unsigned long)line, job->args.format->label);
             return 1;
         }
+    }
+    return 0;
+}
 
-        if (errno) {
-            fprintf(stderr, "arg %d", i);
-            perror("");
+
+static int RunJob(Worker* worker, Job const* job)
+{
+    Args const* args = &job->args;
+    struct EngineTable const* engine = &ENGINE_TABLE[args->chip_engine];
+    void** chip = &worker->chips[args->chip_engine];
+    if (!*chip) {
+        *chip = engine->creator();
+        if (!*chip) {
             return 1;
         }
     }
+    return RunStream(args, *chip, worker->block);
+}
 
-#ifdef __WINDOWS__
-    _setmode(_fileno(stdin), O_BINARY);
-    if (errno) {
-        perror("_setmode(stdin)");
-        return 1;
-    }
 
-    _setmode(_fileno(stdout), O_BINARY);
-    if (errno) {
-        perror("_setmode(stdout)");
-        return 1;
+static void* RunWorker(void* context)
+{
+    Worker* worker = (Worker*)context;
+    Batch* batch = worker->batch;
+
+    for (;;) {
+#if PIPE_THREADS
+        size_t index = __atomic_fetch_add(&batch->next, 1, __ATOMIC_RELAXED);
+#else
+        size_t index = batch->next++;
+#endif
+        if (index >= batch->count) {
+            break;
+        }
+        Job const* job = &batch->jobs[index];
+        if (RunJob(worker, job)) {
+            fprintf(stderr, "%s:%lu: Job failed\n", batch->path, (unsigned long)job->line);
+            worker->error = 1;
+        }
     }
-#endif  // __WINDOWS__
+    return NULL;
+}
 
-    switch (args.chip_engine)
-    {
-    case YM7128B_ChipEngine_Fixed:
-        return RunFixed(&args);
 
-    case YM7128B_ChipEngine_Float:
-        return RunFloat(&args);
+// Runs the jobs of a job list over a pool of worker threads, each pulling the
+// next pending job as soon as it is done with the previous one.
+static int RunBatch(Args const* args)
+{
+    Batch batch;
+    batch.path = args->batch_path;
+    batch.text = NULL;
+    batch.jobs = NULL;
+    batch.count = 0;
+    batch.next = 0;
+
+    int error = LoadBatch(&batch, args);
+
+    size_t worker_count = 1;
+#if PIPE_THREADS
+    if ((size_t)args->threads > worker_count) {
+        worker_count = (size_t)args->threads;
+    }
+    if (worker_count > batch.count && batch.count) {
+        worker_count = batch.count;
+    }
+#endif
+    Worker* workers = NULL;
+    if (!error) {
+        workers = (Worker*)calloc(worker_count, sizeof(Worker));
+        error = !workers;
+    }
+    for (size_t w = 0; !error && w < worker_count; ++w) {
+        workers[w].batch = &batch;
+        workers[w].block = AllocBlock();
+        error = !workers[w].block;
+    }
+
+    if (!error) {
+#if PIPE_THREADS
+        pthread_t* threads = (pthread_t*)calloc(worker_count, sizeof(pthread_t));
+        size_t started = 1;
+        if (threads) {
+            for (; started < worker_count; ++started) {
+                if (pthread_create(&threads[started], NULL, RunWorker, &workers[started])) {
+                    perror("pthread_create()");
+                    break;  // run with fewer workers
+                }
+            }
+        }
+        RunWorker(&workers[0]);
+        for (size_t w = 1; w < started; ++w) {
+            pthread_join(threads[w], NULL);
+        }
+        free(threads);
+#else
+        RunWorker(&workers[0]);
+#endif
+        for (size_t w = 0; w < worker_count; ++w) {
+            error |= workers[w].error;
+        }
+    }
 
-    case YM7128B_ChipEngine_Ideal:
-        return RunIdeal(&args);
+    if (workers) {
+        for (size_t w = 0; w < worker_count; ++w) {
+            for (int e = 0; e < (int)YM7128B_ChipEngine_Count; ++e) {
+                if (workers[w].chips[e]) {
+                    ENGINE_TABLE[e].destroyer(workers[w].chips[e]);
+                }
+            }
+            FreeBlock(workers[w].block);
+        }
+        free(workers);
+    }
+    free(batch.jobs);
+    free(batch.text);
+    return error;
+}
+static void ProcessFixed(void* context, Args const* args, Block* block)
+{
+    YM7128B_ChipFixed* chip = (YM7128B_ChipFixed*)context;
+    size_t count = block->count;
+
+    if (args->format->output != YM7128B_OutputFormat_Count) {
+        YM7128B_ChipFixed_ProcessBlockOutput(chip, &args->stage, block->inputs.fixed, count,
+                                          args->format->output, block->raw);
+        block->frames_count = count * YM7128B_Oversampling * YM7128B_OutputChannel_Count;
+        block->encoded = 1;
+        return;
+    }
 
-    case YM7128B_ChipEngine_Short:
-        return RunShort(&args);
+    YM7128B_ChipFixed_ProcessBlock(chip, block->inputs.fixed, count,
+                                 block->outputs.fixed[YM7128B_OutputChannel_Left],
+                                 block->outputs.fixed[YM7128B_OutputChannel_Right]);
 
-    default:
-        return 1;
+    YM7128B_Float const k = ((YM7128B_Float)1 / (YM7128B_Float)YM7128B_Fixed_Max);
+    YM7128B_Float* frames = block->frames;
+    for (size_t i = 0; i < count * YM7128B_Oversampling; ++i) {
+        YM7128B_Float dry = ((YM7128B_Float)block->inputs.fixed[i / YM7128B_Oversampling] * k);
+        for (int c = 0; c < YM7128B_OutputChannel_Count; ++c) {
+            YM7128B_Float wet = ((YM7128B_Float)block->outputs.fixed[c][i] * k);
+            *frames++ = (dry * args->stage.dry) + (wet * args->stage.wet);
+        }
     }
+    block->frames_count = (size_t)(frames - block->frames);
+}
+
+
+static size_t OverlapFixed(void const* context)
+{
+    YM7128B_ChipFixed const* chip = (YM7128B_ChipFixed const*)context;
+    return YM7128B_ChipFixed_IsChunkable(chip) ? YM7128B_ChipFixed_GetOverlap(chip) : 0;
+}
+
+
+static void PrimeFixed(void* context, YM7128B_Fixed const* inputs, size_t count)
+{
+    YM7128B_ChipFixed* chip = (YM7128B_ChipFixed*)context;
+    YM7128B_ChipFixed_Prime(chip, inputs, count);
 }
 
 
-static int RunFixed(Args const* args)
+static void* CreateFixed(void)
 {
     YM7128B_ChipFixed* chip;
     chip = (YM7128B_ChipFixed*)malloc(sizeof(YM7128B_ChipFixed));
-    if (!chip) {
-        return 1;
+    if (chip) {
+        YM7128B_ChipFixed_Ctor(chip);
     }
-    YM7128B_ChipFixed_Ctor(chip);
+    return chip;
+}
+
+
+static void DestroyFixed(void* context)
+{
+    YM7128B_ChipFixed* chip = (YM7128B_ChipFixed*)context;
+    YM7128B_ChipFixed_Dtor(chip);
+    free(chip);
+}
+
+
+static void StartFixed(void* context, Args const* args)
+{
+    YM7128B_ChipFixed* chip = (YM7128B_ChipFixed*)context;
     YM7128B_ChipFixed_Reset(chip);
+    YM7128B_ChipFixed_SetFilter(chip, args->filter);
     for (YM7128B_Address r = 0; r < (YM7128B_Address)YM7128B_Reg_Count; ++r) {
         YM7128B_ChipFixed_Write(chip, r, args->regs[r]);
     }
     YM7128B_ChipFixed_Start(chip);
-    int error = 0;
+}
 
-    while (!feof(stdin)) {
-        YM7128B_ChipFixed_Process_Data data;
 
-        for (int c = 0; c < YM7128B_InputChannel_Count; ++c) {
-            YM7128B_Float value;
-            if (!args->stream_reader(&value)) {
-                if (ferror(stdin)) {
-                    perror("stream_reader()");
-                    error = 1;
-                }
-                goto end;
-            }
-            YM7128B_Float const k = (YM7128B_Float)YM7128B_Fixed_Max;
-            value = YM7128B_ClampFloat(value);
-            data.inputs[c] = (YM7128B_Fixed)(value * k);
-        }
+static void StopFixed(void* context)
+{
+    YM7128B_ChipFixed* chip = (YM7128B_ChipFixed*)context;
+    YM7128B_ChipFixed_Stop(chip);
+}
+
+
+static void ProcessFloat(void* context, Args const* args, Block* block)
+{
+    YM7128B_ChipFloat* chip = (YM7128B_ChipFloat*)context;
+    size_t count = block->count;
+
+    if (args->format->output != YM7128B_OutputFormat_Count) {
+        YM7128B_ChipFloat_ProcessBlockOutput(chip, &args->stage, block->inputs.real, count,
+                                          args->format->output, block->raw);
+        block->frames_count = count * YM7128B_Oversampling * YM7128B_OutputChannel_Count;
+        block->encoded = 1;
+        return;
+    }
 
-        YM7128B_ChipFixed_Process(chip, &data);
+    YM7128B_ChipFloat_ProcessBlock(chip, block->inputs.real, count,
+                                 block->outputs.real[YM7128B_OutputChannel_Left],
+                                 block->outputs.real[YM7128B_OutputChannel_Right]);
 
+    YM7128B_Float* frames = block->frames;
+    for (size_t i = 0; i < count * YM7128B_Oversampling; ++i) {
+        YM7128B_Float dry = block->inputs.real[i / YM7128B_Oversampling];
         for (int c = 0; c < YM7128B_OutputChannel_Count; ++c) {
-            for (int ovs = 0; ovs < YM7128B_Oversampling; ++ovs) {
-                YM7128B_Float const k = ((YM7128B_Float)1 / (YM7128B_Float)YM7128B_Fixed_Max);
-                YM7128B_Float wet = ((YM7128B_Float)data.outputs[c][ovs] * k);
-                YM7128B_Float dry = ((YM7128B_Float)data.inputs[YM7128B_InputChannel_Mono] * k);
-                YM7128B_Float value = (dry * args->dry) + (wet * args->wet);
-                if (!args->stream_writer(value)) {
-                    perror("stream_writer()");
-                    error = 1;
-                    goto end;
-                }
-            }
+            YM7128B_Float wet = block->outputs.real[c][i];
+            *frames++ = (dry * args->stage.dry) + (wet * args->stage.wet);
         }
     }
-
-end:
-    YM7128B_ChipFixed_Stop(chip);
-    YM7128B_ChipFixed_Dtor(chip);
-    free(chip);
-    return error;
+    block->frames_count = (size_t)(frames - block->frames);
 }
 
 
-static int RunFloat(Args const* args)
+static void* CreateFloat(void)
 {
     YM7128B_ChipFloat* chip;
     chip = (YM7128B_ChipFloat*)malloc(sizeof(YM7128B_ChipFloat));
-    if (!chip) {
-        return 1;
+    if (chip) {
+        YM7128B_ChipFloat_Ctor(chip);
     }
-    YM7128B_ChipFloat_Ctor(chip);
+    return chip;
+}
+
+
+static void DestroyFloat(void* context)
+{
+    YM7128B_ChipFloat* chip = (YM7128B_ChipFloat*)context;
+    YM7128B_ChipFloat_Dtor(chip);
+    free(chip);
+}
+
+
+static void StartFloat(void* context, Args const* args)
+{
+    YM7128B_ChipFloat* chip = (YM7128B_ChipFloat*)context;
     YM7128B_ChipFloat_Reset(chip);
+    YM7128B_ChipFloat_SetFilter(chip, args->filter);
     for (YM7128B_Address r = 0; r < (YM7128B_Address)YM7128B_Reg_Count; ++r) {
         YM7128B_ChipFloat_Write(chip, r, args->regs[r]);
     }
     YM7128B_ChipFloat_Start(chip);
-    int error = 0;
+}
 
-    while (!feof(stdin)) {
-        YM7128B_ChipFloat_Process_Data data;
 
-        for (int c = 0; c < YM7128B_InputChannel_Count; ++c) {
-            if (!args->stream_reader(&data.inputs[c])) {
-                if (ferror(stdin)) {
-                    perror("stream_reader()");
-                    error = 1;
-                }
-                goto end;
-            }
-        }
+static void StopFloat(void* context)
+{
+    YM7128B_ChipFloat* chip = (YM7128B_ChipFloat*)context;
+    YM7128B_ChipFloat_Stop(chip);
+}
+
+
+static void ProcessIdeal(void* context, Args const* args, Block* block)
+{
+    YM7128B_ChipIdeal* chip = (YM7128B_ChipIdeal*)context;
+    size_t count = block->count;
+
+    if (args->format->output != YM7128B_OutputFormat_Count) {
+        YM7128B_ChipIdeal_ProcessBlockOutput(chip, &args->stage, block->inputs.real, count,
+                                          args->format->output, block->raw);
+        block->frames_count = count * YM7128B_OutputChannel_Count;
+        block->encoded = 1;
+        return;
+    }
 
-        YM7128B_ChipFloat_Process(chip, &data);
+    YM7128B_ChipIdeal_ProcessBlock(chip, block->inputs.real, count,
+                                 block->outputs.real[YM7128B_OutputChannel_Left],
+                                 block->outputs.real[YM7128B_OutputChannel_Right]);
 
+    YM7128B_Float* frames = block->frames;
+    for (size_t i = 0; i < count; ++i) {
+        YM7128B_Float dry = block->inputs.real[i];
         for (int c = 0; c < YM7128B_OutputChannel_Count; ++c) {
-            for (int ovs = 0; ovs < YM7128B_Oversampling; ++ovs) {
-                YM7128B_Float wet = data.outputs[c][ovs];
-                YM7128B_Float dry = data.inputs[YM7128B_InputChannel_Mono];
-                YM7128B_Float value = (dry * args->dry) + (wet * args->wet);
-                if (!args->stream_writer(value)) {
-                    perror("stream_writer()");
-                    error = 1;
-                    goto end;
-                }
-            }
+            YM7128B_Float wet = block->outputs.real[c][i];
+            *frames++ = (dry * args->stage.dry) + (wet * args->stage.wet);
         }
     }
-
-end:
-    YM7128B_ChipFloat_Stop(chip);
-    YM7128B_ChipFloat_Dtor(chip);
-    free(chip);
-    return error;
+    block->frames_count = (size_t)(frames - block->frames);
 }
 
 
-static int RunIdeal(Args const* args)
+static void* CreateIdeal(void)
 {
     YM7128B_ChipIdeal* chip;
     chip = (YM7128B_ChipIdeal*)malloc(sizeof(YM7128B_ChipIdeal));
-    if (!chip) {
-        return 1;
+    if (chip) {
+        YM7128B_ChipIdeal_Ctor(chip);
     }
-    YM7128B_ChipIdeal_Ctor(chip);
+    return chip;
+}
+
+
+static void DestroyIdeal(void* context)
+{
+    YM7128B_ChipIdeal* chip = (YM7128B_ChipIdeal*)context;
+    YM7128B_ChipIdeal_Dtor(chip);
+    free(chip);
+}
+
+
+static void StartIdeal(void* context, Args const* args)
+{
+    YM7128B_ChipIdeal* chip = (YM7128B_ChipIdeal*)context;
     YM7128B_ChipIdeal_Setup(chip, args->rate);
     YM7128B_ChipIdeal_Reset(chip);
     for (YM7128B_Address r = 0; r < (YM7128B_Address)YM7128B_Reg_Count; ++r) {
         YM7128B_ChipIdeal_Write(chip, r, args->regs[r]);
     }
     YM7128B_ChipIdeal_Start(chip);
-    int error = 0;
+}
 
-    while (!feof(stdin)) {
-        YM7128B_ChipIdeal_Process_Data data;
 
-        for (int c = 0; c < YM7128B_InputChannel_Count; ++c) {
-            if (!args->stream_reader(&data.inputs[c])) {
-                if (ferror(stdin)) {
-                    perror("stream_reader()");
-                    error = 1;
-                }
-                goto end;
-            }
-        }
+static void StopIdeal(void* context)
+{
+    YM7128B_ChipIdeal* chip = (YM7128B_ChipIdeal*)context;
+    YM7128B_ChipIdeal_Stop(chip);
+}
+
+
+static void ProcessShort(void* context, Args const* args, Block* block)
+{
+    YM7128B_ChipShort* chip = (YM7128B_ChipShort*)context;
+    size_t count = block->count;
+
+    if (args->format->output != YM7128B_OutputFormat_Count) {
+        YM7128B_ChipShort_ProcessBlockOutput(chip, &args->stage, block->inputs.fixed, count,
+                                          args->format->output, block->raw);
+        block->frames_count = count * YM7128B_OutputChannel_Count;
+        block->encoded = 1;
+        return;
+    }
 
-        YM7128B_ChipIdeal_Process(chip, &data);
+    YM7128B_ChipShort_ProcessBlock(chip, block->inputs.fixed, count,
+                                 block->outputs.fixed[YM7128B_OutputChannel_Left],
+                                 block->outputs.fixed[YM7128B_OutputChannel_Right]);
 
+    YM7128B_Float const k = ((YM7128B_Float)1 / (YM7128B_Float)YM7128B_Fixed_Max);
+    YM7128B_Float* frames = block->frames;
+    for (size_t i = 0; i < count; ++i) {
+        YM7128B_Float dry = ((YM7128B_Float)block->inputs.fixed[i] * k);
         for (int c = 0; c < YM7128B_OutputChannel_Count; ++c) {
-            YM7128B_Float wet = data.outputs[c];
-            YM7128B_Float dry = data.inputs[YM7128B_InputChannel_Mono];
-            YM7128B_Float value = (dry * args->dry) + (wet * args->wet);
-            if (!args->stream_writer(value)) {
-                perror("stream_writer()");
-                error = 1;
-                goto end;
-            }
+            YM7128B_Float wet = ((YM7128B_Float)block->outputs.fixed[c][i] * k);
+            *frames++ = (dry * args->stage.dry) + (wet * args->stage.wet);
         }
     }
+    block->frames_count = (size_t)(frames - block->frames);
+}
 
-end:
-    YM7128B_ChipIdeal_Stop(chip);
-    YM7128B_ChipIdeal_Dtor(chip);
-    free(chip);
-    return error;
+
+static size_t OverlapShort(void const* context)
+{
+    YM7128B_ChipShort const* chip = (YM7128B_ChipShort const*)context;
+    return YM7128B_ChipShort_IsChunkable(chip) ? YM7128B_ChipShort_GetOverlap(chip) : 0;
 }
 
 
-static int RunShort(Args const* args)
+static void PrimeShort(void* context, YM7128B_Fixed const* inputs, size_t count)
+{
+    YM7128B_ChipShort* chip = (YM7128B_ChipShort*)context;
+    YM7128B_ChipShort_Prime(chip, inputs, count);
+}
+
+
+static void* CreateShort(void)
 {
     YM7128B_ChipShort* chip;
     chip = (YM7128B_ChipShort*)malloc(sizeof(YM7128B_ChipShort));
-    if (!chip) {
-        return 1;
+    if (chip) {
+        YM7128B_ChipShort_Ctor(chip);
     }
-    YM7128B_ChipShort_Ctor(chip);
+    return chip;
+}
+
+
+static void DestroyShort(void* context)
+{
+    YM7128B_ChipShort* chip = (YM7128B_ChipShort*)context;
+    YM7128B_ChipShort_Dtor(chip);
+    free(chip);
+}
+
+
+static void StartShort(void* context, Args const* args)
+{
+    YM7128B_ChipShort* chip = (YM7128B_ChipShort*)context;
     YM7128B_ChipShort_Setup(chip, args->rate);
     YM7128B_ChipShort_Reset(chip);
     for (YM7128B_Address r = 0; r < (YM7128B_Address)YM7128B_Reg_Count; ++r) {
         YM7128B_ChipShort_Write(chip, r, args->regs[r]);
     }
     YM7128B_ChipShort_Start(chip);
-    int error = 0;
-
-    while (!feof(stdin)) {
-        YM7128B_ChipShort_Process_Data data;
-
-        for (int c = 0; c < YM7128B_InputChannel_Count; ++c) {
-            YM7128B_Float value;
-            if (!args->stream_reader(&value)) {
-                if (ferror(stdin)) {
-                    perror("stream_reader()");
-                    error = 1;
-                }
-                goto end;
-            }
-            YM7128B_Float const k = (YM7128B_Float)YM7128B_Fixed_Max;
-            value = YM7128B_ClampFloat(value);
-            data.inputs[c] = (YM7128B_Fixed)(value * k);
-        }
-
-        YM7128B_ChipShort_Process(chip, &data);
+}
 
-        for (int c = 0; c < YM7128B_OutputChannel_Count; ++c) {
-            YM7128B_Float const k = ((YM7128B_Float)1 / (YM7128B_Float)YM7128B_Fixed_Max);
-            YM7128B_Float wet = ((YM7128B_Float)data.outputs[c] * k);
-            YM7128B_Float dry = ((YM7128B_Float)data.inputs[YM7128B_InputChannel_Mono] * k);
-            YM7128B_Float value = (dry * args->dry) + (wet * args->wet);
-            if (!args->stream_writer(value)) {
-                perror("stream_writer()");
-                error = 1;
-                goto end;
-            }
-        }
-    }
 
-end:
+static void StopShort(void* context)
+{
+    YM7128B_ChipShort* chip = (YM7128B_ChipShort*)context;
     YM7128B_ChipShort_Stop(chip);
-    YM7128B_ChipShort_Dtor(chip);
-    free(chip);
-    return error;
 }
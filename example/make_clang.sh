@@ -1 +1,2 @@
-clang -Wall -std=c99 -pedantic -I../src -Ofast -o YM7128B_pipe YM7128B_pipe.c ../src/YM7128B_emu.c -lm
+clang -Wall -std=c99 -pedantic -I../src -Ofast -o YM7128B_pipe YM7128B_pipe.c ../src/YM7128B_emu.c -lm -pthread "$@"
+clang -Wall -std=c99 -pedantic -I../src -Ofast -o YM7128B_bench YM7128B_bench.c ../src/YM7128B_emu.c -lm "$@"
@@ -0,0 +1,177 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2020-2023, Andrea Zoppi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Register presets shared by the example programs.
+
+#ifndef _YM7128B_EXAMPLE_PRESETS_H_
+#define _YM7128B_EXAMPLE_PRESETS_H_
+
+#include "YM7128B_emu.h"
+
+static struct PresetTable {
+    char const* label;
+    YM7128B_Register regs[YM7128B_Reg_Count];
+} const PRESET_TABLE[] =
+{
+    { "off", {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    }},
+    { "direct", {
+        0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x3F, 0x00, 0x3F, 0x3F,
+        0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    }},
+    { "dune/arrakis", {
+        0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07, 0x00,
+        0x00, 0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07,
+        0x1A, 0x1D, 0x1A, 0x1A,
+        0x16, 0x16,
+        0x1F, 0x03, 0x07, 0x0B, 0x0F, 0x13, 0x17, 0x1B, 0x1F,
+    }},
+    { "dune/baghdad", {
+        0x1F, 0x00, 0x1B, 0x00, 0x17, 0x00, 0x33, 0x00,
+        0x00, 0x1D, 0x00, 0x19, 0x00, 0x15, 0x00, 0x11,
+        0x1D, 0x1D, 0x1D, 0x1D,
+        0x13, 0x13,
+        0x06, 0x02, 0x04, 0x06, 0x08, 0x0A, 0x0C, 0x0E, 0x10,
+    }},
+    { "dune/morning", {
+        0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07, 0x00,
+        0x00, 0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07,
+        0x1A, 0x1D, 0x1B, 0x1B,
+        0x16, 0x16,
+        0x1F, 0x03, 0x07, 0x0B, 0x0F, 0x13, 0x17, 0x1B, 0x1F,
+    }},
+    { "dune/sequence", {
+        0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07, 0x00,
+        0x00, 0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07,
+        0x1A, 0x1D, 0x1C, 0x1C,
+        0x16, 0x16,
+        0x1F, 0x03, 0x07, 0x0B, 0x0F, 0x13, 0x17, 0x1B, 0x1F,
+    }},
+    { "dune/sietch", {
+        0x1F, 0x00, 0x1B, 0x00, 0x17, 0x00, 0x33, 0x00,
+        0x00, 0x1D, 0x00, 0x19, 0x00, 0x15, 0x00, 0x11,
+        0x1D, 0x1D, 0x1D, 0x1D,
+        0x13, 0x13,
+        0x06, 0x02, 0x04, 0x06, 0x08, 0x0A, 0x0C, 0x0E, 0x10,
+    }},
+    { "dune/warsong", {
+        0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07, 0x00,
+        0x00, 0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07,
+        0x1A, 0x1D, 0x1C, 0x1C,
+        0x16, 0x16,
+        0x1F, 0x03, 0x07, 0x0B, 0x0F, 0x13, 0x17, 0x1B, 0x1F,
+    }},
+    { "dune/water", {
+        0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07, 0x00,
+        0x00, 0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07,
+        0x1A, 0x1D, 0x1A, 0x1A,
+        0x16, 0x16,
+        0x1F, 0x03, 0x07, 0x0B, 0x0F, 0x13, 0x17, 0x1B, 0x1F,
+    }},
+    { "dune/wormintro", {
+        0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07, 0x00,
+        0x00, 0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07,
+        0x1A, 0x1D, 0x18, 0x18,
+        0x16, 0x16,
+        0x1F, 0x03, 0x07, 0x0B, 0x0F, 0x13, 0x17, 0x1B, 0x1F,
+    }},
+    { "dune/wormsuit", {
+        0x18, 0x00, 0x1A, 0x00, 0x1C, 0x00, 0x1E, 0x00,
+        0x00, 0x19, 0x00, 0x1B, 0x00, 0x1D, 0x00, 0x1F,
+        0x1B, 0x1F, 0x17, 0x17,
+        0x12, 0x08,
+        0x1F, 0x07, 0x0A, 0x0D, 0x10, 0x13, 0x16, 0x19, 0x1C,
+    }},
+    { "gold/cavern", {
+        0x1F, 0x00, 0x1D, 0x00, 0x1B, 0x00, 0x19, 0x00,
+        0x20, 0x3E, 0x20, 0x3C, 0x20, 0x3A, 0x20, 0x38,
+        0x3C, 0x3E, 0x1C, 0x1C,
+        0x11, 0x0A,
+        0x12, 0x10, 0x0E, 0x0C, 0x0A, 0x08, 0x06, 0x04, 0x02,
+    }},
+    { "gold/chapel", {
+        0x1F, 0x1E, 0x1D, 0x1C, 0x1B, 0x1A, 0x19, 0x18,
+        0x3F, 0x3E, 0x3D, 0x3C, 0x3B, 0x3A, 0x39, 0x38,
+        0x38, 0x3D, 0x1B, 0x1B,
+        0x10, 0x10,
+        0x1F, 0x1F, 0x1D, 0x1B, 0x19, 0x17, 0x15, 0x13, 0x11,
+    }},
+    { "gold/concert_hall", {
+        0x31, 0x00, 0x15, 0x00, 0x39, 0x00, 0x1D, 0x00,
+        0x00, 0x33, 0x00, 0x17, 0x00, 0x3B, 0x00, 0x1F,
+        0x1A, 0x1C, 0x1D, 0x1D,
+        0x16, 0x16,
+        0x1F, 0x1C, 0x19, 0x16, 0x13, 0x10, 0x0D, 0x0A, 0x07,
+    }},
+    { "gold/deep_space", {
+        0x18, 0x00, 0x1A, 0x00, 0x1C, 0x00, 0x1E, 0x00,
+        0x00, 0x19, 0x00, 0x1B, 0x00, 0x1D, 0x00, 0x1F,
+        0x1B, 0x1F, 0x1C, 0x1C,
+        0x12, 0x08,
+        0x1F, 0x07, 0x0A, 0x0D, 0x10, 0x13, 0x16, 0x19, 0x1C,
+    }},
+    { "gold/jazz_club", {
+        0x1F, 0x1B, 0x37, 0x13, 0x2F, 0x0B, 0x27, 0x03,
+        0x1F, 0x3B, 0x17, 0x33, 0x0F, 0x2B, 0x07, 0x23,
+        0x1C, 0x1F, 0x1B, 0x1B,
+        0x0C, 0x0C,
+        0x1F, 0x03, 0x07, 0x0B, 0x0F, 0x13, 0x17, 0x1B, 0x1F,
+    }},
+    { "gold/movie_theater", {
+        0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07, 0x00,
+        0x00, 0x1F, 0x00, 0x17, 0x00, 0x0F, 0x00, 0x07,
+        0x1A, 0x1D, 0x1C, 0x1C,
+        0x16, 0x16,
+        0x1F, 0x03, 0x07, 0x0B, 0x0F, 0x13, 0x17, 0x1B, 0x1F,
+    }},
+    { "gold/recital_hall", {
+        0x1F, 0x3E, 0x1D, 0x3C, 0x1B, 0x3A, 0x19, 0x38,
+        0x3F, 0x1E, 0x3D, 0x1C, 0x3B, 0x1A, 0x39, 0x18,
+        0x18, 0x1C, 0x1C, 0x1C,
+        0x15, 0x15,
+        0x14, 0x04, 0x06, 0x08, 0x0A, 0x0C, 0x0E, 0x10, 0x12,
+    }},
+    { "gold/stadium", {
+        0x1F, 0x00, 0x1B, 0x00, 0x17, 0x00, 0x33, 0x00,
+        0x00, 0x1D, 0x00, 0x19, 0x00, 0x15, 0x00, 0x11,
+        0x1D, 0x1D, 0x3D, 0x3D,
+        0x13, 0x13,
+        0x06, 0x02, 0x04, 0x06, 0x08, 0x0A, 0x0C, 0x0E, 0x10,
+    }},
+    { NULL, {0} }
+};
+
+#endif  // !_YM7128B_EXAMPLE_PRESETS_H_
@@ -29,6 +29,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "YM7128B_emu.h"
 
 #include <assert.h>
+#include <string.h>
+
+// Real literals, rounded straight to the floating point precision in use
+#if YM7128B_FLOAT_SINGLE
+#define YM7128B_FLOAT_LITERAL(real) ((YM7128B_Float)(real##f))
+#else
+#define YM7128B_FLOAT_LITERAL(real) ((YM7128B_Float)(real))
+#endif
 
 // ============================================================================
 
@@ -162,7 +170,7 @@ YM7128B_Fixed const YM7128B_GainFixed_Table[YM7128B_Gain_Data_Count] =
 #endif
 
 #define GAIN(real) \
-    ((YM7128B_Float)(real))
+    YM7128B_FLOAT_LITERAL(real)
 
 YM7128B_Float const YM7128B_GainFloat_Table[YM7128B_Gain_Data_Count] =
 {
@@ -425,15 +433,19 @@ YM7128B_Fixed YM7128B_OversamplerFixed_Process(
 {
     assert(self);
 
+    YM7128B_Oversampler_Index index = self->index_;
+    index = index ? (index - 1) : (YM7128B_Oversampler_Length - 1);
+    self->index_ = index;
+    self->buffer_[index] = input;
+    self->buffer_[index + YM7128B_Oversampler_Length] = input;
+
+    YM7128B_Fixed const* window = &self->buffer_[index];
     YM7128B_Accumulator accum = 0;
 
     for (YM7128B_Oversampler_Index i = 0; i < YM7128B_Oversampler_Length; ++i) {
         YM7128B_Fixed kernel = YM7128B_OversamplerFixed_Kernel[i];
-        YM7128B_Fixed oversampled = YM7128B_MulFixed(input, kernel);
+        YM7128B_Fixed oversampled = YM7128B_MulFixed(window[i], kernel);
         accum += oversampled;
-        YM7128B_Fixed sample = self->buffer_[i];
-        self->buffer_[i] = input;
-        input = sample;
     }
 
     YM7128B_Fixed clamped = YM7128B_ClampFixed(accum);
@@ -448,7 +460,7 @@ YM7128B_Fixed YM7128B_OversamplerFixed_Process(
 #endif
 
 #define KERNEL(real) \
-    ((YM7128B_Float)(real))
+    YM7128B_FLOAT_LITERAL(real)
 
 YM7128B_Float const YM7128B_OversamplerFloat_Kernel[YM7128B_Oversampler_Length] =
 {
@@ -506,15 +518,19 @@ YM7128B_Float YM7128B_OversamplerFloat_Process(
 {
     assert(self);
 
+    YM7128B_Oversampler_Index index = self->index_;
+    index = index ? (index - 1) : (YM7128B_Oversampler_Length - 1);
+    self->index_ = index;
+    self->buffer_[index] = input;
+    self->buffer_[index + YM7128B_Oversampler_Length] = input;
+
+    YM7128B_Float const* window = &self->buffer_[index];
     YM7128B_Float accum = 0;
 
     for (YM7128B_Oversampler_Index i = 0; i < YM7128B_Oversampler_Length; ++i) {
         YM7128B_Float kernel = YM7128B_OversamplerFloat_Kernel[i];
-        YM7128B_Float oversampled = YM7128B_MulFloat(input, kernel);
+        YM7128B_Float oversampled = YM7128B_MulFloat(window[i], kernel);
         accum += oversampled;
-        YM7128B_Float sample = self->buffer_[i];
-        self->buffer_[i] = input;
-        input = sample;
     }
 
     YM7128B_Float output = YM7128B_ClampFloat(accum);
@@ -523,694 +539,8464 @@ YM7128B_Float YM7128B_OversamplerFloat_Process(
 
 // ============================================================================
 
-void YM7128B_ChipFixed_Ctor(YM7128B_ChipFixed* self)
-{
-    (void)self;
-    assert(self);
-}
+#ifdef KERNEL
+#undef KERNEL
+#endif
 
-// ----------------------------------------------------------------------------
+#define KERNEL(real) \
+    ((YM7128B_Fixed)((real) * YM7128B_Fixed_Max) & (YM7128B_Fixed)YM7128B_Coeff_Mask)
 
-void YM7128B_ChipFixed_Dtor(YM7128B_ChipFixed* self)
+YM7128B_Fixed const YM7128B_InterpolatorFixed_Kernels[YM7128B_Filter_Count][YM7128B_Oversampler_Factor][YM7128B_Interpolator_Stride] =
 {
-    (void)self;
-    assert(self);
-}
+    {  // YM7128B_Filter_Linear
+        {  // even phase
+            KERNEL(+0.005969087803865891),
+            KERNEL(-0.016623943725986926),
+            KERNEL(+0.038895802111020034),
+            KERNEL(-0.089238395139830201),
+            KERNEL(+0.312314472963171053),
+            KERNEL(+0.312314472963171053),
+            KERNEL(-0.089238395139830201),
+            KERNEL(+0.038895802111020034),
+            KERNEL(-0.016623943725986926),
+            KERNEL(+0.005969087803865891)
+        },
+        {  // odd phase
+            KERNEL(-0.003826518613910499),
+            KERNEL(+0.007053928712894589),
+            KERNEL(-0.010501507751597486),
+            KERNEL(+0.013171814880420758),
+            KERNEL(+0.485820312497107776),
+            KERNEL(+0.013171814880420758),
+            KERNEL(-0.010501507751597486),
+            KERNEL(+0.007053928712894589),
+            KERNEL(-0.003826518613910499)
+        }
+    },
+    {  // YM7128B_Filter_Minimum
+        {  // even phase
+            KERNEL(+0.073585247514714749),
+            KERNEL(+0.442535202999738531),
+            KERNEL(+0.026195691646307945),
+            KERNEL(-0.081176763571493171),
+            KERNEL(+0.067960765530891545),
+            KERNEL(-0.044393769145659796),
+            KERNEL(+0.023451305043275420),
+            KERNEL(-0.009480786001493536),
+            KERNEL(+0.003347671274177581),
+            KERNEL(+0.000483958628744376)
+        },
+        {  // odd phase
+            KERNEL(+0.269340051166713890),
+            KERNEL(+0.350129745841520346),
+            KERNEL(-0.178423532471468610),
+            KERNEL(+0.083194010466739091),
+            KERNEL(-0.035840063980478287),
+            KERNEL(+0.013156688603347873),
+            KERNEL(-0.004374029821991059),
+            KERNEL(+0.002700502551912207),
+            KERNEL(-0.002391896275498628)
+        }
+    },
+    {  // YM7128B_Filter_LowOrder
+        {  // even phase
+            KERNEL(-0.031250000000000000),
+            KERNEL(+0.281250000000000000),
+            KERNEL(+0.281250000000000000),
+            KERNEL(-0.031250000000000000)
+        },
+        {  // odd phase
+            KERNEL(+0.000000000000000000),
+            KERNEL(+0.500000000000000000),
+            KERNEL(+0.000000000000000000)
+        }
+    }
+};
 
 // ----------------------------------------------------------------------------
 
-void YM7128B_ChipFixed_Reset(YM7128B_ChipFixed* self)
+void YM7128B_InterpolatorFixed_Process(
+    YM7128B_InterpolatorFixed* self,
+    YM7128B_Fixed input,
+    YM7128B_Fixed outputs[YM7128B_Oversampler_Factor]
+)
 {
     assert(self);
+    assert(outputs);
 
-    for (YM7128B_Address i = YM7128B_Address_Min; i <= YM7128B_Address_Max; ++i) {
-        YM7128B_ChipFixed_Write(self, i, 0x00);
+    YM7128B_Oversampler_Index index = self->index_;
+    index = index ? (index - 1) : (YM7128B_Interpolator_Length - 1);
+    self->index_ = index;
+    self->buffer_[index] = input;
+    self->buffer_[index + YM7128B_Interpolator_Length] = input;
+
+    YM7128B_Fixed const* window = &self->buffer_[index];
+
+    for (YM7128B_Oversampler_Index phase = 0; phase < YM7128B_Oversampler_Factor; ++phase) {
+        YM7128B_Fixed const* kernel = &YM7128B_InterpolatorFixed_Kernel[phase][0];
+        YM7128B_Oversampler_Index length = YM7128B_Interpolator_PhaseLength(phase);
+        YM7128B_Accumulator accum = 0;
+
+        for (YM7128B_Oversampler_Index i = 0; i < length; ++i) {
+            YM7128B_Fixed oversampled = YM7128B_MulFixed(window[i], kernel[i]);
+            accum += oversampled;
+        }
+
+        YM7128B_Fixed clamped = YM7128B_ClampFixed(accum);
+        outputs[phase] = clamped & (YM7128B_Fixed)YM7128B_Signal_Mask;
     }
 }
 
+// ============================================================================
+
+#ifdef KERNEL
+#undef KERNEL
+#endif
+
+#define KERNEL(real) \
+    YM7128B_FLOAT_LITERAL(real)
+
+YM7128B_Float const YM7128B_InterpolatorFloat_Kernels[YM7128B_Filter_Count][YM7128B_Oversampler_Factor][YM7128B_Interpolator_Stride] =
+{
+    {  // YM7128B_Filter_Linear
+        {  // even phase
+            KERNEL(+0.005969087803865891),
+            KERNEL(-0.016623943725986926),
+            KERNEL(+0.038895802111020034),
+            KERNEL(-0.089238395139830201),
+            KERNEL(+0.312314472963171053),
+            KERNEL(+0.312314472963171053),
+            KERNEL(-0.089238395139830201),
+            KERNEL(+0.038895802111020034),
+            KERNEL(-0.016623943725986926),
+            KERNEL(+0.005969087803865891)
+        },
+        {  // odd phase
+            KERNEL(-0.003826518613910499),
+            KERNEL(+0.007053928712894589),
+            KERNEL(-0.010501507751597486),
+            KERNEL(+0.013171814880420758),
+            KERNEL(+0.485820312497107776),
+            KERNEL(+0.013171814880420758),
+            KERNEL(-0.010501507751597486),
+            KERNEL(+0.007053928712894589),
+            KERNEL(-0.003826518613910499)
+        }
+    },
+    {  // YM7128B_Filter_Minimum
+        {  // even phase
+            KERNEL(+0.073585247514714749),
+            KERNEL(+0.442535202999738531),
+            KERNEL(+0.026195691646307945),
+            KERNEL(-0.081176763571493171),
+            KERNEL(+0.067960765530891545),
+            KERNEL(-0.044393769145659796),
+            KERNEL(+0.023451305043275420),
+            KERNEL(-0.009480786001493536),
+            KERNEL(+0.003347671274177581),
+            KERNEL(+0.000483958628744376)
+        },
+        {  // odd phase
+            KERNEL(+0.269340051166713890),
+            KERNEL(+0.350129745841520346),
+            KERNEL(-0.178423532471468610),
+            KERNEL(+0.083194010466739091),
+            KERNEL(-0.035840063980478287),
+            KERNEL(+0.013156688603347873),
+            KERNEL(-0.004374029821991059),
+            KERNEL(+0.002700502551912207),
+            KERNEL(-0.002391896275498628)
+        }
+    },
+    {  // YM7128B_Filter_LowOrder
+        {  // even phase
+            KERNEL(-0.031250000000000000),
+            KERNEL(+0.281250000000000000),
+            KERNEL(+0.281250000000000000),
+            KERNEL(-0.031250000000000000)
+        },
+        {  // odd phase
+            KERNEL(+0.000000000000000000),
+            KERNEL(+0.500000000000000000),
+            KERNEL(+0.000000000000000000)
+        }
+    }
+};
+
 // ----------------------------------------------------------------------------
 
-void YM7128B_ChipFixed_Start(YM7128B_ChipFixed* self)
+// Interpolates with the given filter kernel
+static void YM7128B_InterpolatorFloat_Process_(
+    YM7128B_InterpolatorFloat* self,
+    YM7128B_Float const coeffs[YM7128B_Oversampler_Factor][YM7128B_Interpolator_Stride],
+    YM7128B_Float input,
+    YM7128B_Float outputs[YM7128B_Oversampler_Factor]
+)
 {
-    assert(self);
+    YM7128B_Oversampler_Index index = self->index_;
+    index = index ? (index - 1) : (YM7128B_Interpolator_Length - 1);
+    self->index_ = index;
+    self->buffer_[index] = input;
+    self->buffer_[index + YM7128B_Interpolator_Length] = input;
 
-    self->t0_d_ = 0;
+    YM7128B_Float const* window = &self->buffer_[index];
 
-    self->tail_ = 0;
+    for (YM7128B_Oversampler_Index phase = 0; phase < YM7128B_Oversampler_Factor; ++phase) {
+        YM7128B_Float const* kernel = &coeffs[phase][0];
+        YM7128B_Oversampler_Index length = YM7128B_Interpolator_PhaseLength(phase);
+        YM7128B_Float accum = 0;
 
-    for (YM7128B_Tap i = 0; i < YM7128B_Buffer_Length; ++i) {
-        self->buffer_[i] = 0;
-    }
+        for (YM7128B_Oversampler_Index i = 0; i < length; ++i) {
+            YM7128B_Float oversampled = YM7128B_MulFloat(window[i], kernel[i]);
+            accum += oversampled;
+        }
 
-    for (YM7128B_Oversampler_Index i = 0; i < YM7128B_OutputChannel_Count; ++i) {
-        YM7128B_OversamplerFixed_Reset(&self->oversampler_[i]);
+        outputs[phase] = YM7128B_ClampFloat(accum);
     }
 }
 
 // ----------------------------------------------------------------------------
 
-void YM7128B_ChipFixed_Stop(YM7128B_ChipFixed* self)
+void YM7128B_InterpolatorFloat_Process(
+    YM7128B_InterpolatorFloat* self,
+    YM7128B_Float input,
+    YM7128B_Float outputs[YM7128B_Oversampler_Factor]
+)
 {
-    (void)self;
     assert(self);
+    assert(outputs);
+
+    YM7128B_InterpolatorFloat_Process_(self, YM7128B_InterpolatorFloat_Kernel, input, outputs);
 }
 
 // ----------------------------------------------------------------------------
 
-void YM7128B_ChipFixed_Process(
-    YM7128B_ChipFixed* self,
-    YM7128B_ChipFixed_Process_Data* data
-)
+size_t YM7128B_Filter_GetLatency(YM7128B_Filter filter)
 {
-    assert(self);
-    assert(data);
+    // Rounded low-frequency group delays of YM7128B_InterpolatorFixed_Kernels
+    static size_t const latencies[YM7128B_Filter_Count] = { 9, 2, 3 };
 
-    YM7128B_Fixed input = data->inputs[YM7128B_InputChannel_Mono];
-    YM7128B_Fixed sample = input & (YM7128B_Fixed)YM7128B_Signal_Mask;
-
-    YM7128B_Tap t0 = self->tail_ + self->taps_[0];
-    YM7128B_Tap filter_head  = (t0 >= YM7128B_Buffer_Length) ? (t0 - YM7128B_Buffer_Length) : t0;
-    YM7128B_Fixed filter_t0  = self->buffer_[filter_head];
-    YM7128B_Fixed filter_d   = self->t0_d_;
-    self->t0_d_ = filter_t0;
-    YM7128B_Fixed filter_c0  = YM7128B_MulFixed(filter_t0, self->gains_[YM7128B_Reg_C0]);
-    YM7128B_Fixed filter_c1  = YM7128B_MulFixed(filter_d, self->gains_[YM7128B_Reg_C1]);
-    YM7128B_Fixed filter_sum = YM7128B_ClampAddFixed(filter_c0, filter_c1);
-    YM7128B_Fixed filter_vc  = YM7128B_MulFixed(filter_sum, self->gains_[YM7128B_Reg_VC]);
+    if ((unsigned)filter >= (unsigned)YM7128B_Filter_Count) {
+        return 0;
+    }
+    return latencies[filter];
+}
 
-    YM7128B_Fixed input_vm  = YM7128B_MulFixed(sample, self->gains_[YM7128B_Reg_VM]);
-    YM7128B_Fixed input_sum = YM7128B_ClampAddFixed(input_vm, filter_vc);
+// ============================================================================
 
-    self->tail_ = self->tail_ ? (self->tail_ - 1) : (YM7128B_Buffer_Length - 1);
-    self->buffer_[self->tail_] = input_sum;
+// Kaiser-windowed sinc (beta = 7) of YM7128B_Resampler_Length taps, cut off
+// at the Nyquist frequency of YM7128B_Input_Rate, sampled at each phase.
+// The taps of phase p apply to the history from the newest sample onwards,
+// at time offsets <tt>k - (Length / 2) + (p / Phases)</tt>; each phase is
+// normalized to the DC gain of the 2x interpolator.
+#define YM7128B_RESAMPLER_KERNEL_(K) \
+    {  /* phase 0 */ \
+        K(+0.000000000000000000), K(+0.000000000000000000), K(+0.000000000000000000), K(+0.000000000000000000), \
+        K(+0.000000000000000000), K(+0.000000000000000000), K(+0.000000000000000000), K(+0.000000000000000000), \
+        K(+0.000000000000000000), K(+0.000000000000000000), K(+0.000000000000000000), K(+0.000000000000000000), \
+        K(+0.500000000000000000), K(+0.000000000000000000), K(+0.000000000000000000), K(+0.000000000000000000), \
+        K(+0.000000000000000000), K(+0.000000000000000000), K(+0.000000000000000000), K(+0.000000000000000000), \
+        K(+0.000000000000000000), K(+0.000000000000000000), K(+0.000000000000000000), K(+0.000000000000000000), \
+    }, \
+    {  /* phase 1 */ \
+        K(-0.000003989314248164), K(+0.000017789264560807), K(-0.000047411690761459), K(+0.000102012361423778), \
+        K(-0.000193433511785371), K(+0.000336975947172438), K(-0.000553456363526232), K(+0.000874669367849477), \
+        K(-0.001358416786748468), K(+0.002135418268382919), K(-0.003599818913442993), K(+0.007762058538560125), \
+        K(+0.499800274217549967), K(-0.007512622195251725), K(+0.003533927322515309), K(-0.002104129029809739), \
+        K(+0.001339870538224030), K(-0.000862580581637803), K(+0.000545314268017982), K(-0.000331514159772165), \
+        K(+0.000189878199378501), K(-0.000099818028836237), K(+0.000046161962832793), K(-0.000017159680647897), \
+    }, \
+    {  /* phase 2 */ \
+        K(-0.000008231557895977), K(+0.000036176165041702), K(-0.000095976159599081), K(+0.000205998845847386), \
+        K(-0.000389992658511750), K(+0.000678652921780663), K(-0.001113794914435156), K(+0.001759433589249749), \
+        K(-0.002732306796280659), K(+0.004297421572050309), K(-0.007258295609662518), K(+0.015766473311215119), \
+        K(+0.499193669625839831), K(-0.014769207632281858), K(+0.006995000273845939), K(-0.004172405728779417), \
+        K(+0.002658207872060244), K(-0.001711135192744464), K(+0.001081264932617414), K(-0.000656831560398308), \
+        K(+0.000375788172630889), K(-0.000197231822308935), K(+0.000090983075033989), K(-0.000033660724315178), \
+    }, \
+    {  /* phase 3 */ \
+        K(-0.000012722086131388), K(+0.000055125588587903), K(-0.000145590012064546), K(+0.000311727710399971), \
+        K(-0.000589228781960419), K(+0.001024240625908545), K(-0.001679711286992715), K(+0.002652232454131119), \
+        K(-0.004118495974190992), K(+0.006481140165416948), K(-0.010967879570306172), K(+0.024005569171185813), \
+        K(+0.498181085855370021), K(-0.021763530869647871), K(+0.010376483794727121), K(-0.006200384694964440), \
+        K(+0.003952096729556208), K(-0.002543774234387674), K(+0.001606663073264844), K(-0.000975239432352328), \
+        K(+0.000557331659645574), K(-0.000292040624421578), K(+0.000134377461958225), K(-0.000049476722732349), \
+    }, \
+    {  /* phase 4 */ \
+        K(-0.000017455054800228), K(+0.000074599548056259), K(-0.000196144279981884), K(+0.000418957647759024), \
+        K(-0.000790678075880330), K(+0.001372926001350870), K(-0.002249867876617562), K(+0.003550957232823654), \
+        K(-0.005513736641810745), K(+0.008681580911879563), K(-0.014720770053466928), K(+0.032471201689834646), \
+        K(+0.496764028684837100), K(-0.028489868192383336), K(+0.013671935997201285), K(-0.008183779523329432), \
+        K(+0.005218720347829153), K(-0.003358673051484525), K(+0.002120363300502002), K(-0.001286053800528705), \
+        K(+0.000734128766771128), K(-0.000384054722248196), K(+0.000176265328117741), K(-0.000064584184430611), \
+    }, \
+    {  /* phase 5 */ \
+        K(-0.000022423401118998), K(+0.000094557217460290), K(-0.000247524599284320), K(+0.000527438248295501), \
+        K(-0.000993862542316211), K(+0.001723874972389573), K(-0.002822896761279333), K(+0.004453455292508590), \
+        K(-0.006914714473939663), K(+0.010893637352862345), K(-0.018508928659551539), K(+0.041154767830693668), \
+        K(+0.494944607295806749), K(-0.034943003490525530), K(+0.016875217293526635), K(-0.010118470655830455), \
+        K(+0.006455366004922732), K(-0.004154075570601722), K(+0.002621266008073437), K(-0.001588620776491656), \
+        K(+0.000905818631299391), K(-0.000473095730346499), K(+0.000216573036362756), K(-0.000078962522915797), \
+    }, \
+    {  /* phase 6 */ \
+        K(-0.000027618828371703), K(+0.000114954977442191), K(-0.000299611407672006), K(+0.000636910496526694), \
+        K(-0.001198291002441932), K(+0.002076234270383232), K(-0.003397402741721664), K(+0.005357534884962056), \
+        K(-0.008318055729503802), K(+0.013112100173050957), K(-0.022324092534917517), K(+0.050047217552528098), \
+        K(+0.492725530430664804), K(-0.041118233137002323), K(+0.019980498788121484), K(-0.012000512742651386), \
+        K(+0.007659430228621448), K(-0.004928297719410824), K(+0.003108319477476661), K(-0.001882317753213337), \
+        K(+0.001072060024279090), K(-0.000558996838711807), K(+0.000255233167582679), K(-0.000092594036021036), \
+    }, \
+    {  /* phase 7 */ \
+        K(-0.000033031794755297), K(+0.000135746470878424), K(-0.000352280161941660), K(+0.000747107301140326), \
+        K(-0.001403460160080676), K(+0.002429133336591315), K(-0.003971966494301112), K(+0.006260970095713199), \
+        K(-0.009720334720554306), K(+0.015331668042261513), K(-0.026157788191136112), K(+0.059139066322708170), \
+        K(+0.490110101462313708), K(-0.047011369861018622), K(+0.022982269921916092), K(-0.013826141503420427), \
+        K(+0.008828423673547791), K(-0.005679730622063487), K(+0.003580521831599458), K(-0.002166554500661432), \
+        K(+0.001232531891089061), K(-0.000641603024282319), K(+0.000292184561180351), K(-0.000105463876724031), \
+    }, \
+    {  /* phase 8 */ \
+        K(-0.000038651506527568), K(+0.000156882668695674), K(-0.000405401574777666), K(+0.000857754057745412), \
+        K(-0.001608855715921034), K(+0.002781686299396279), K(-0.004545147829861296), K(+0.007161505944217937), \
+        K(-0.011118081504284128), K(+0.017546958813334637), K(-0.030001345916256156), K(+0.068420408520243253), \
+        K(+0.487102212386313738), K(-0.052618745615237876), K(+0.025875345360238316), K(-0.015591780078536528), \
+        K(+0.009959975658792629), K(-0.006406843565395373), K(+0.004036922834545566), K(-0.002440774160883731), \
+        K(+0.001386933829378924), K(-0.000720771226108663), K(+0.000327372336623182), K(-0.000117560015735598), \
+    }, \
+    {  /* phase 9 */ \
+        K(-0.000044465915599696), K(+0.000178311945943104), K(-0.000458841870732754), K(+0.000968569243399089), \
+        K(-0.001813953530270604), K(+0.003132994021838440), K(-0.005115489051707806), K(+0.008056863624147663), \
+        K(-0.012507789782029245), K(+0.019752521054424654), K(-0.033845914753007800), K(+0.077880931705957973), \
+        K(+0.483706336748348009), K(-0.057937213437198085), K(+0.028654871117120242), K(-0.017294044862044413), \
+        K(+0.011051838359260310), K(-0.007108186731516827), K(+0.004476625535192774), K(-0.002704454141526587), \
+        K(+0.001534986504163486), K(-0.000796370484401722), K(+0.000360747896425059), K(-0.000128873196185313), \
+    }, \
+    {  /* phase 10 */ \
+        K(-0.000050461721703474), K(+0.000199980168135351), K(-0.000512463061064072), K(+0.001079265041852245), \
+        K(-0.002018220832022688), K(+0.003482146215134847), K(-0.005681518405404156), K(+0.008944745872415286), \
+        K(-0.013885924988547247), K(+0.021942845893082343), K(-0.037682478017500597), K(+0.087509931735460872), \
+        K(+0.479927521522045875), K(-0.062964148307524087), K(+0.031316329910674200), K(-0.018929750808817213), \
+        K(+0.012101890644850214), K(-0.007782393692998499), K(+0.004898787752466320), K(-0.002957106907009375), \
+        K(+0.001676432000031635), K(-0.000868282043770489), K(+0.000392268910960543), K(-0.000139396880747902), \
+    }, \
+    {  /* phase 11 */ \
+        K(-0.000056624379250116), K(+0.000221830787848354), K(-0.000566123237028514), K(+0.001189547998352699), \
+        K(-0.002221117471351582), K(+0.003828223613621053), K(-0.006241753612784334), K(+0.009822842455105497), \
+        K(-0.015248932554223603), K(+0.024112379148597721), K(-0.041501869330634586), K(+0.097296328688787390), \
+        K(+0.475771377954302521), K(-0.067697447009603770), K(+0.033855545745939991), K(-0.020495916210124195), \
+        K(+0.013108141562536533), K(-0.008428183667515540), K(+0.005302623400752190), K(-0.003198280666862347), \
+        K(+0.001811034110603763), K(-0.000936399421057498), K(+0.000421899285558585), K(-0.000149127191570186), \
+    }, \
+    {  /* phase 12 */ \
+        K(-0.000062938108983896), K(+0.000243804951517256), K(-0.000619676881178676), K(+0.001299119702741010), \
+        K(-0.002422097213494216), K(+0.004170300206328510), K(-0.006794705482262654), K(+0.010688835758046536), \
+        K(-0.016593246322250021), K(+0.026255533728186772), K(-0.045294789133162233), K(+0.107228683588879103), \
+        K(+0.471244071397281694), K(-0.072135526997467878), K(+0.036268687723353225), K(-0.021989766932979066), \
+        K(+0.014068733457349826), K(-0.009044363529462416), K(+0.005687403654310808), K(-0.003427559961015150), \
+        K(+0.001938578565539914), K(-0.001000628438271401), K(+0.000449609110366097), K(-0.000158062843373156), \
+    }, \
+    {  /* phase 13 */ \
+        K(-0.000069385914519434), K(+0.000265841616352226), K(-0.000672975196139040), K(+0.001407677499473231), \
+        K(-0.002620609070825043), K(+0.004507445520196415), K(-0.007338881587228976), K(+0.011540406469357316), \
+        K(-0.017915297102251905), K(+0.028366702261771796), K(-0.049051821654119240), K(+0.117295215879403558), \
+        K(+0.466352310148308191), K(-0.076277324280658865), K(+0.038552273072716234), K(-0.023408740119980016), \
+        K(+0.014981944729203771), K(-0.009629829576703433), K(+0.006052457949987396), K(-0.003644566142101322), \
+        K(+0.002058873195567004), K(-0.001060887221205941), K(+0.000475374593512747), K(-0.000166205070116868), \
+    }, \
+    {  /* phase 14 */ \
+        K(-0.000075949603836482), K(+0.000287877677254080), K(-0.000725866450280135), K(+0.001514915223105546), \
+        K(-0.002816098670283893), K(+0.004838726949711314), K(-0.007872790004038236), K(+0.012375239340926531), \
+        K(-0.019211521341311842), K(+0.030440269949322814), K(-0.052763452301176565), K(+0.127483821630827221), \
+        K(+0.461103333320788955), K(-0.080122290336879370), K(+0.040703169414268381), K(-0.024750487347657352), \
+        K(+0.015846192223444577), K(-0.010183569051266689), K(+0.006397174827944144), K(-0.003848957755116144), \
+        K(+0.002171748036154079), K(-0.001117106164420023), K(+0.000499177978146601), K(-0.000173557545627420), \
+    }, \
+    {  /* phase 15 */ \
+        K(-0.000082609815790435), K(+0.000309848103577487), K(-0.000778196339647301), K(+0.001620523957678951), \
+        K(-0.003008009653075781), K(+0.005163212127573721), K(-0.008394943100843606), K(+0.013191029015432868), \
+        K(-0.020478369892847115), K(+0.032470627593995487), K(-0.056420085440364316), K(+0.137782092442121723), \
+        K(+0.455504897771191575), K(-0.083670388065175780), K(+0.042718596250144958), K(-0.026012877242639430), \
+        K(+0.016660033253928903), K(-0.010704661413428965), K(+0.006721002610563045), K(-0.004040430815032177), \
+        K(+0.002277055370621171), K(-0.001169227863335964), K(+0.000521007443946224), K(-0.000180126298595310), \
+    }, \
+    {  /* phase 16 */ \
+        K(-0.000089346051680637), K(+0.000331686085554963), K(-0.000829808365440391), K(+0.001724192818348468), \
+        K(-0.003195785103427491), K(+0.005479971330809554), K(-0.008903861368283979), K(+0.013985485905195256), \
+        K(-0.021712316863352212), K(+0.034452184793626016), K(-0.060012062531583345), K(+0.148177335004019917), \
+        K(+0.449565264108953866), K(-0.086922086794334913), K(+0.044596125691182084), K(-0.027193997556229175), \
+        K(+0.017422167258353587), K(-0.011192279369271989), K(+0.007023449920086648), K(-0.004218718983238832), \
+        K(+0.002374669713619202), K(-0.001217207014291540), K(+0.000540856993747950), K(-0.000185919622362907), \
+    }, \
+    {  /* phase 17 */ \
+        K(-0.000096136711901900), K(+0.000353323190160375), K(-0.000880544226281006), K(+0.001825609753510025), \
+        K(-0.003378869003056930), K(+0.005788079916572354), K(-0.009398077282813545), K(+0.014756342108854075), \
+        K(-0.022909868516611118), K(+0.036379383262521499), K(-0.063529680585343806), K(+0.158656591288349247), \
+        K(+0.443293181817918214), K(-0.089878356363038953), K(+0.046333682425662118), K(-0.028292156699244630), \
+        K(+0.018131437086467712), K(-0.011645689652409998), K(+0.007304086035971572), K(-0.004383593643925845), \
+        K(+0.002464487736064242), K(-0.001261010283455647), K(+0.000558726325957762), K(-0.000190947979925661), \
+    }, \
+    {  /* phase 18 */ \
+        K(-0.000102959137687541), K(+0.000374689526155857), K(-0.000930244224445626), K(+0.001924462365590801), \
+        K(-0.003556707707891010), K(+0.006086620781726131), K(-0.009876139193264079), K(+0.015501357351625713), \
+        K(-0.024067572214625584), K(+0.038246710254924904), K(-0.066963210905270756), K(+0.169206659326646747), \
+        K(+0.436697873519614199), K(-0.092540660290146362), K(+0.047929542938199281), K(-0.029305884740222280), \
+        K(+0.018786829922689947), K(-0.012064253561203718), K(+0.007562541093332165), K(-0.004534863881779104), \
+        K(+0.002546428132750482), K(-0.001300616145588173), K(+0.000574620693445025), K(-0.000195223904576991), \
+    }, \
+    {  /* phase 19 */ \
+        K(-0.000109789657934662), K(+0.000395713918031560), K(-0.000978747685185623), K(+0.002020438748584323), \
+        K(-0.003728751443453364), K(+0.006374686840152426), K(-0.010336615221049016), K(+0.016218324934646967), \
+        K(-0.025182025374187258), K(+0.040048712061024047), K(-0.070302918080078283), K(+0.179814114540015418), \
+        K(+0.429789018410301371), K(-0.094910948055228012), K(+0.049382333988534650), K(-0.030233933871298000), \
+        K(+0.019387477845530538), K(-0.012447427253371985), K(+0.007798506124240571), K(-0.004672376362595689), \
+        K(+0.002620431434000620), K(-0.001336014693690507), K(+0.000588550749640582), K(-0.000198761896630644), \
+    }, \
+    {  /* phase 20 */ \
+        K(-0.000116603641084530), K(+0.000416324088513123), K(-0.001025893388199525), K(+0.002113228340331744), \
+        K(-0.003894455815237912), K(+0.006651383511595479), K(-0.010778097164263771), K(+0.016905077678731839), \
+        K(-0.026249884417752483), K(+0.041780007545934895), K(-0.073539079187949191), K(+0.190465331581010033), \
+        K(+0.422576734905234397), K(-0.096991646511185012), K(+0.050691030361535848), K(-0.031075278347278214), \
+        K(+0.019932658027076597), K(-0.012794761800500438), K(+0.008011732944031033), K(-0.004796015118657332), \
+        K(+0.002686459762841216), K(-0.001367207420655243), K(+0.000600532382584035), K(-0.000201578316656551), \
+    }, \
+    {  /* phase 21 */ \
+        K(-0.000123375552012658), K(+0.000436446849277623), K(-0.001071520010268682), K(+0.002202522787474119), \
+        K(-0.004053283330285904), K(+0.006915831215741470), K(-0.011199204395800688), K(+0.017559493847704347), \
+        K(-0.027267873697056345), K(+0.043435301701703483), K(-0.076662003175571244), K(+0.201146506647247536), \
+        K(+0.415071562525092863), K(-0.098785650452428611), K(+0.051854951901187524), K(-0.031829113904576246), \
+        K(+0.020421792576638176), K(-0.013105903005516662), K(+0.008202033885124037), K(-0.004905701240923325), \
+        K(+0.002744496539312434), K(-0.001394206974080921), K(+0.000610586537684875), K(-0.000203691275667095), \
+    }, \
+    {  /* phase 22 */ \
+        K(-0.000130079013864709), K(+0.000456008299484866), K(-0.001115466578015226), K(+0.002288016820929059), \
+        K(-0.004204704926095348), K(+0.007167167865126155), K(-0.011598587745486050), K(+0.018179503036343452), \
+        K(-0.028232794367725033), K(+0.045009399182050436), K(-0.079662050373452420), K(+0.211843680225425185), \
+        K(+0.407284443060876578), K(-0.100296312363660933), K(+0.052873759842795506), K(-0.032494856667825228), \
+        K(+0.020854448033469846), K(-0.013380590986756629), K(+0.008369281381242821), K(-0.005001392480317626), \
+        K(+0.002794546133637085), K(-0.001417036885470727), K(+0.000618739029978916), K(-0.000205120522689993), \
+    }, \
+    {  /* phase 23 */ \
+        K(-0.000136686874755656), K(+0.000474934031697613), K(-0.001157572929690740), K(+0.002369409139677674), \
+        K(-0.004348201502910613), K(+0.007404551350376811), K(-0.011974933356158030), K(+0.018763092007885104), \
+        K(-0.029141533193019452), K(+0.046497217789324474), K(-0.082529652108605592), K(+0.222542760223491232), \
+        K(+0.399226701054911426), K(-0.101527431375820917), K(+0.053747452459022321), K(-0.033072141553080782), \
+        K(+0.021230334514276136), K(-0.013618659532784325), K(+0.008513407405237585), K(-0.005083082760588142), \
+        K(+0.002836633470082345), K(-0.001435731275082268), K(+0.000625020346675795), K(-0.000205887330162016), \
+    }, \
+    {  /* phase 24 */ \
+        K(-0.000143171279230756), K(+0.000493149344731577), K(-0.001197680184856029), K(+0.002446403300585669), \
+        K(-0.004483265455369142), K(+0.007627162011223390), K(-0.012326966503540418), K(+0.019308310465970972), \
+        K(-0.029991071254764908), K(+0.047893801882937473), K(-0.085255330375217514), K(+0.233229545447867420), \
+        K(+0.390910023636801218), K(-0.102483241457187194), K(+0.054476360036715403), K(-0.033560820177593140), \
+        K(+0.021549304521979912), K(-0.013820035232646789), K(+0.008634402764063112), K(-0.005150801605410299), \
+        K(+0.002870803583449202), K(-0.001450334533739584), K(+0.000629465440804694), K(-0.000206014377574290), \
+    }, \
+    {  /* phase 25 */ \
+        K(-0.000149503744367978), K(+0.000510579462943916), K(-0.001235631220766315), K(+0.002518708611925065), \
+        K(-0.004609402199420076), K(+0.007834205086656467), K(-0.012653455369726604), K(+0.019813276745910248), \
+        K(-0.030778492549491963), K(+0.049194335678424565), K(-0.087829717523531053), K(+0.243889749381846016), \
+        K(+0.382346439754332301), K(-0.103168398868999825), K(+0.055061139202775708), K(-0.033960958287158192), \
+        K(+0.021811351422972705), K(-0.013984736386745886), K(+0.008732316254770200), K(-0.005204613482589757), \
+        K(+0.002897121130218848), K(-0.001460900982957503), K(+0.000632113516774234), K(-0.000205525633795203), \
+    }, \
+    {  /* phase 26 */ \
+        K(-0.000155655240382553), K(+0.000527149761437800), K(-0.001271271154232893), K(+0.002586041028211330), \
+        K(-0.004726131690377343), K(+0.008024913137569471), K(-0.012953214760072813), K(+0.020276183410138437), \
+        K(-0.031500992447835344), K(+0.050394156406208604), K(-0.090243575926853822), K(+0.254509024220603952), \
+        K(+0.373548298840377602), K(-0.103587968916260389), K(+0.055502766618552982), K(-0.034272832713048595), \
+        K(+0.022016607600784357), K(-0.014112871703988139), K(+0.008807253685672206), K(-0.005244617068391921), \
+        K(+0.002915669856472362), K(-0.001467494514763008), K(+0.000633007808668636), K(-0.000204446238490866), \
+    }, \
+    {  /* phase 27 */ \
+        K(-0.000161596275575327), K(+0.000542785996630230), K(-0.001304447827691607), K(+0.002648124043924508), \
+        K(-0.004832989927928045), K(+0.008198548435198950), K(-0.013225109753309710), K(+0.020695302732806710), \
+        K(-0.032155885995310232), K(+0.051488767299152416), K(-0.092487817586378432), K(+0.265072985117671578), \
+        K(+0.364528248957833145), K(-0.103747412025582755), K(+0.055802532063428348), K(-0.034496927871475680), \
+        K(+0.022165342294791945), K(-0.014204638791332970), K(+0.008859376767133343), K(-0.005270944435187894), \
+        K(+0.002926552024779766), K(-0.001470188212628248), K(+0.000632195352105659), K(-0.000202802383055842), \
+    }, \
+    {  /* phase 28 */ \
+        K(-0.000167296985447812), K(+0.000557414541601076), K(-0.001335012298170495), K(+0.002704689583642318), \
+        K(-0.004929530443884606), K(+0.008354405308668903), K(-0.013468059274715572), K(+0.021068992058524090), \
+        K(-0.032740616032706241), K(+0.052473850378049608), K(-0.094553523633337119), K(+0.275567234597178579), \
+        K(+0.355299214465496116), K(-0.103652569183110319), K(+0.055962030929368398), K(-0.034633931819441841), \
+        K(+0.022257959133246644), K(-0.014260322442295491), K(+0.008888901876693993), K(-0.005283760165756366), \
+        K(+0.002929887802326497), K(-0.001469063954954868), K(+0.000629726750482799), K(-0.000200621191458350), \
+    }, \
+    {  /* phase 29 */ \
+        K(-0.000172727225788060), K(+0.000570962625613080), K(-0.001362819327814174), K(+0.002755478886079103), \
+        K(-0.005015325768448461), K(+0.008491812444954989), K(-0.013681039582255510), K(+0.021395699020399898), \
+        K(-0.033252761114515320), K(+0.053345279004342598), K(-0.096431963687949110), K(+0.285977387085768364), \
+        K(+0.345874373248608868), K(-0.103309646766585980), K(+0.055983156149289996), K(-0.034684731881708078), \
+        K(+0.022294993370519163), K(-0.014280292731375106), K(+0.008896098703502248), K(-0.005283260397720923), \
+        K(+0.002925814612610462), K(-0.001464212002570154), K(+0.000625655936436591), K(-0.000197930601394603), \
+    }, \
+    {  /* phase 30 */ \
+        K(-0.000177856669513070), K(+0.000583358577165729), K(-0.001387727874590695), K(+0.002800243379495906), \
+        K(-0.005089968870741863), K(+0.008610135134610886), K(-0.013863087655676202), K(+0.021673966602694369), \
+        K(-0.033690043204031489), K(+0.054099130169557065), K(-0.098114615034616687), K(+0.296289093517729918), \
+        K(+0.336267133558490250), K(-0.102725200806632722), K(+0.055868089583076715), K(-0.034650409864420188), \
+        K(+0.022277108839057810), K(-0.014265002921770542), K(+0.008881288777256524), K(-0.005269671801729396), \
+        K(+0.002914486453099440), K(-0.001455730571711303), K(+0.000620039929335828), K(-0.000194759246136259), \
+    }, \
+    {  /* phase 31 */ \
+        K(-0.000182654907035195), K(+0.000594532069920354), K(-0.001409601581778247), K(+0.002838745545925615), \
+        K(-0.005153074569365541), K(+0.008708777456643455), K(-0.014013304478658666), K(+0.021902438033586175), \
+        K(-0.034050335124039953), K(+0.054731696491217334), K(-0.099593181572920741), K(+0.306488065966637468), \
+        K(+0.326491110506312854), K(-0.101906120713223566), K(+0.055619292886021403), K(-0.034532236871713119), \
+        K(+0.022205094627112218), K(-0.014214987194110277), K(+0.008844843887084322), K(-0.005243250497098459), \
+        K(+0.002896073181288834), K(-0.001443725393985963), K(+0.000612938589623025), K(-0.000191136337443327), \
+    }, \
+    {  /* phase 32 */ \
+        K(-0.000187091549902220), K(+0.000604414370809743), K(-0.001428309264803991), K(+0.002870759771641425), \
+        K(-0.005204280908750873), K(+0.008787184395984228), K(-0.014130858204268988), K(+0.022079861493800226), \
+        K(-0.034331667742338541), K(+0.055239497885341098), K(-0.100859612504134874), K(+0.316560102256622733), \
+        K(+0.316560102256622733), K(-0.100859612504134874), K(+0.055239497885341098), K(-0.034331667742338541), \
+        K(+0.022079861493800226), K(-0.014130858204268988), K(+0.008787184395984228), K(-0.005204280908750873), \
+        K(+0.002870759771641425), K(-0.001428309264803991), K(+0.000604414370809743), K(-0.000187091549902220), \
+    }, \
+    {  /* phase 33 */ \
+        K(-0.000191136337443327), K(+0.000612938589623025), K(-0.001443725393985963), K(+0.002896073181288834), \
+        K(-0.005243250497098460), K(+0.008844843887084322), K(-0.014214987194110278), K(+0.022205094627112221), \
+        K(-0.034532236871713119), K(+0.055619292886021410), K(-0.101906120713223580), K(+0.326491110506312854), \
+        K(+0.306488065966637524), K(-0.099593181572920755), K(+0.054731696491217341), K(-0.034050335124039953), \
+        K(+0.021902438033586175), K(-0.014013304478658667), K(+0.008708777456643455), K(-0.005153074569365541), \
+        K(+0.002838745545925615), K(-0.001409601581778247), K(+0.000594532069920354), K(-0.000182654907035195), \
+    }, \
+    {  /* phase 34 */ \
+        K(-0.000194759246136259), K(+0.000620039929335828), K(-0.001455730571711303), K(+0.002914486453099440), \
+        K(-0.005269671801729396), K(+0.008881288777256524), K(-0.014265002921770542), K(+0.022277108839057810), \
+        K(-0.034650409864420188), K(+0.055868089583076715), K(-0.102725200806632722), K(+0.336267133558490250), \
+        K(+0.296289093517729918), K(-0.098114615034616687), K(+0.054099130169557065), K(-0.033690043204031489), \
+        K(+0.021673966602694369), K(-0.013863087655676202), K(+0.008610135134610886), K(-0.005089968870741863), \
+        K(+0.002800243379495906), K(-0.001387727874590695), K(+0.000583358577165729), K(-0.000177856669513070), \
+    }, \
+    {  /* phase 35 */ \
+        K(-0.000197930601394603), K(+0.000625655936436591), K(-0.001464212002570154), K(+0.002925814612610462), \
+        K(-0.005283260397720924), K(+0.008896098703502249), K(-0.014280292731375108), K(+0.022294993370519166), \
+        K(-0.034684731881708085), K(+0.055983156149290003), K(-0.103309646766585994), K(+0.345874373248608924), \
+        K(+0.285977387085768420), K(-0.096431963687949124), K(+0.053345279004342605), K(-0.033252761114515327), \
+        K(+0.021395699020399901), K(-0.013681039582255512), K(+0.008491812444954989), K(-0.005015325768448461), \
+        K(+0.002755478886079104), K(-0.001362819327814175), K(+0.000570962625613080), K(-0.000172727225788060), \
+    }, \
+    {  /* phase 36 */ \
+        K(-0.000200621191458350), K(+0.000629726750482799), K(-0.001469063954954869), K(+0.002929887802326497), \
+        K(-0.005283760165756367), K(+0.008888901876693993), K(-0.014260322442295493), K(+0.022257959133246647), \
+        K(-0.034633931819441841), K(+0.055962030929368405), K(-0.103652569183110332), K(+0.355299214465496171), \
+        K(+0.275567234597178634), K(-0.094553523633337119), K(+0.052473850378049615), K(-0.032740616032706248), \
+        K(+0.021068992058524093), K(-0.013468059274715574), K(+0.008354405308668905), K(-0.004929530443884607), \
+        K(+0.002704689583642318), K(-0.001335012298170495), K(+0.000557414541601076), K(-0.000167296985447812), \
+    }, \
+    {  /* phase 37 */ \
+        K(-0.000202802383055842), K(+0.000632195352105659), K(-0.001470188212628247), K(+0.002926552024779765), \
+        K(-0.005270944435187893), K(+0.008859376767133342), K(-0.014204638791332967), K(+0.022165342294791938), \
+        K(-0.034496927871475673), K(+0.055802532063428334), K(-0.103747412025582741), K(+0.364528248957833090), \
+        K(+0.265072985117671522), K(-0.092487817586378418), K(+0.051488767299152402), K(-0.032155885995310225), \
+        K(+0.020695302732806703), K(-0.013225109753309707), K(+0.008198548435198948), K(-0.004832989927928044), \
+        K(+0.002648124043924508), K(-0.001304447827691607), K(+0.000542785996630230), K(-0.000161596275575327), \
+    }, \
+    {  /* phase 38 */ \
+        K(-0.000204446238490866), K(+0.000633007808668636), K(-0.001467494514763008), K(+0.002915669856472361), \
+        K(-0.005244617068391919), K(+0.008807253685672202), K(-0.014112871703988134), K(+0.022016607600784350), \
+        K(-0.034272832713048582), K(+0.055502766618552968), K(-0.103587968916260348), K(+0.373548298840377491), \
+        K(+0.254509024220603897), K(-0.090243575926853795), K(+0.050394156406208583), K(-0.031500992447835330), \
+        K(+0.020276183410138430), K(-0.012953214760072810), K(+0.008024913137569468), K(-0.004726131690377341), \
+        K(+0.002586041028211329), K(-0.001271271154232893), K(+0.000527149761437800), K(-0.000155655240382553), \
+    }, \
+    {  /* phase 39 */ \
+        K(-0.000205525633795203), K(+0.000632113516774234), K(-0.001460900982957502), K(+0.002897121130218847), \
+        K(-0.005204613482589755), K(+0.008732316254770197), K(-0.013984736386745881), K(+0.021811351422972698), \
+        K(-0.033960958287158186), K(+0.055061139202775694), K(-0.103168398868999783), K(+0.382346439754332190), \
+        K(+0.243889749381845933), K(-0.087829717523531026), K(+0.049194335678424551), K(-0.030778492549491953), \
+        K(+0.019813276745910241), K(-0.012653455369726601), K(+0.007834205086656464), K(-0.004609402199420075), \
+        K(+0.002518708611925064), K(-0.001235631220766315), K(+0.000510579462943916), K(-0.000149503744367978), \
+    }, \
+    {  /* phase 40 */ \
+        K(-0.000206014377574290), K(+0.000629465440804694), K(-0.001450334533739584), K(+0.002870803583449202), \
+        K(-0.005150801605410300), K(+0.008634402764063112), K(-0.013820035232646790), K(+0.021549304521979916), \
+        K(-0.033560820177593140), K(+0.054476360036715410), K(-0.102483241457187194), K(+0.390910023636801218), \
+        K(+0.233229545447867448), K(-0.085255330375217528), K(+0.047893801882937480), K(-0.029991071254764912), \
+        K(+0.019308310465970976), K(-0.012326966503540418), K(+0.007627162011223391), K(-0.004483265455369143), \
+        K(+0.002446403300585669), K(-0.001197680184856029), K(+0.000493149344731577), K(-0.000143171279230756), \
+    }, \
+    {  /* phase 41 */ \
+        K(-0.000205887330162016), K(+0.000625020346675795), K(-0.001435731275082268), K(+0.002836633470082345), \
+        K(-0.005083082760588142), K(+0.008513407405237585), K(-0.013618659532784325), K(+0.021230334514276136), \
+        K(-0.033072141553080782), K(+0.053747452459022321), K(-0.101527431375820917), K(+0.399226701054911426), \
+        K(+0.222542760223491232), K(-0.082529652108605592), K(+0.046497217789324474), K(-0.029141533193019452), \
+        K(+0.018763092007885104), K(-0.011974933356158030), K(+0.007404551350376811), K(-0.004348201502910613), \
+        K(+0.002369409139677674), K(-0.001157572929690740), K(+0.000474934031697613), K(-0.000136686874755656), \
+    }, \
+    {  /* phase 42 */ \
+        K(-0.000205120522689993), K(+0.000618739029978916), K(-0.001417036885470727), K(+0.002794546133637085), \
+        K(-0.005001392480317627), K(+0.008369281381242821), K(-0.013380590986756631), K(+0.020854448033469850), \
+        K(-0.032494856667825235), K(+0.052873759842795513), K(-0.100296312363660947), K(+0.407284443060876633), \
+        K(+0.211843680225425213), K(-0.079662050373452420), K(+0.045009399182050443), K(-0.028232794367725036), \
+        K(+0.018179503036343452), K(-0.011598587745486052), K(+0.007167167865126156), K(-0.004204704926095348), \
+        K(+0.002288016820929060), K(-0.001115466578015226), K(+0.000456008299484866), K(-0.000130079013864710), \
+    }, \
+    {  /* phase 43 */ \
+        K(-0.000203691275667094), K(+0.000610586537684875), K(-0.001394206974080921), K(+0.002744496539312433), \
+        K(-0.004905701240923322), K(+0.008202033885124032), K(-0.013105903005516655), K(+0.020421792576638165), \
+        K(-0.031829113904576233), K(+0.051854951901187503), K(-0.098785650452428569), K(+0.415071562525092697), \
+        K(+0.201146506647247425), K(-0.076662003175571217), K(+0.043435301701703462), K(-0.027267873697056331), \
+        K(+0.017559493847704340), K(-0.011199204395800683), K(+0.006915831215741466), K(-0.004053283330285902), \
+        K(+0.002202522787474119), K(-0.001071520010268681), K(+0.000436446849277623), K(-0.000123375552012658), \
+    }, \
+    {  /* phase 44 */ \
+        K(-0.000201578316656551), K(+0.000600532382584035), K(-0.001367207420655243), K(+0.002686459762841216), \
+        K(-0.004796015118657331), K(+0.008011732944031031), K(-0.012794761800500435), K(+0.019932658027076593), \
+        K(-0.031075278347278208), K(+0.050691030361535834), K(-0.096991646511184984), K(+0.422576734905234286), \
+        K(+0.190465331581010006), K(-0.073539079187949177), K(+0.041780007545934882), K(-0.026249884417752476), \
+        K(+0.016905077678731836), K(-0.010778097164263770), K(+0.006651383511595477), K(-0.003894455815237911), \
+        K(+0.002113228340331743), K(-0.001025893388199524), K(+0.000416324088513123), K(-0.000116603641084530), \
+    }, \
+    {  /* phase 45 */ \
+        K(-0.000198761896630644), K(+0.000588550749640582), K(-0.001336014693690506), K(+0.002620431434000620), \
+        K(-0.004672376362595688), K(+0.007798506124240570), K(-0.012447427253371984), K(+0.019387477845530538), \
+        K(-0.030233933871297997), K(+0.049382333988534644), K(-0.094910948055227998), K(+0.429789018410301316), \
+        K(+0.179814114540015391), K(-0.070302918080078269), K(+0.040048712061024040), K(-0.025182025374187254), \
+        K(+0.016218324934646967), K(-0.010336615221049016), K(+0.006374686840152425), K(-0.003728751443453363), \
+        K(+0.002020438748584323), K(-0.000978747685185623), K(+0.000395713918031560), K(-0.000109789657934662), \
+    }, \
+    {  /* phase 46 */ \
+        K(-0.000195223904576991), K(+0.000574620693445025), K(-0.001300616145588173), K(+0.002546428132750482), \
+        K(-0.004534863881779103), K(+0.007562541093332163), K(-0.012064253561203714), K(+0.018786829922689940), \
+        K(-0.029305884740222273), K(+0.047929542938199274), K(-0.092540660290146334), K(+0.436697873519614088), \
+        K(+0.169206659326646719), K(-0.066963210905270742), K(+0.038246710254924897), K(-0.024067572214625580), \
+        K(+0.015501357351625710), K(-0.009876139193264077), K(+0.006086620781726130), K(-0.003556707707891009), \
+        K(+0.001924462365590801), K(-0.000930244224445626), K(+0.000374689526155857), K(-0.000102959137687541), \
+    }, \
+    {  /* phase 47 */ \
+        K(-0.000190947979925660), K(+0.000558726325957762), K(-0.001261010283455647), K(+0.002464487736064241), \
+        K(-0.004383593643925843), K(+0.007304086035971568), K(-0.011645689652409993), K(+0.018131437086467705), \
+        K(-0.028292156699244616), K(+0.046333682425662097), K(-0.089878356363038911), K(+0.443293181817917992), \
+        K(+0.158656591288349191), K(-0.063529680585343778), K(+0.036379383262521478), K(-0.022909868516611108), \
+        K(+0.014756342108854069), K(-0.009398077282813539), K(+0.005788079916572352), K(-0.003378869003056928), \
+        K(+0.001825609753510024), K(-0.000880544226281006), K(+0.000353323190160375), K(-0.000096136711901900), \
+    }, \
+    {  /* phase 48 */ \
+        K(-0.000185919622362907), K(+0.000540856993747949), K(-0.001217207014291539), K(+0.002374669713619201), \
+        K(-0.004218718983238830), K(+0.007023449920086645), K(-0.011192279369271986), K(+0.017422167258353584), \
+        K(-0.027193997556229164), K(+0.044596125691182070), K(-0.086922086794334871), K(+0.449565264108953699), \
+        K(+0.148177335004019889), K(-0.060012062531583324), K(+0.034452184793626002), K(-0.021712316863352205), \
+        K(+0.013985485905195251), K(-0.008903861368283975), K(+0.005479971330809552), K(-0.003195785103427490), \
+        K(+0.001724192818348467), K(-0.000829808365440391), K(+0.000331686085554963), K(-0.000089346051680637), \
+    }, \
+    {  /* phase 49 */ \
+        K(-0.000180126298595310), K(+0.000521007443946224), K(-0.001169227863335965), K(+0.002277055370621172), \
+        K(-0.004040430815032178), K(+0.006721002610563047), K(-0.010704661413428969), K(+0.016660033253928910), \
+        K(-0.026012877242639440), K(+0.042718596250144979), K(-0.083670388065175808), K(+0.455504897771191741), \
+        K(+0.137782092442121779), K(-0.056420085440364344), K(+0.032470627593995501), K(-0.020478369892847126), \
+        K(+0.013191029015432874), K(-0.008394943100843610), K(+0.005163212127573723), K(-0.003008009653075783), \
+        K(+0.001620523957678951), K(-0.000778196339647301), K(+0.000309848103577487), K(-0.000082609815790435), \
+    }, \
+    {  /* phase 50 */ \
+        K(-0.000173557545627420), K(+0.000499177978146601), K(-0.001117106164420023), K(+0.002171748036154079), \
+        K(-0.003848957755116143), K(+0.006397174827944143), K(-0.010183569051266689), K(+0.015846192223444574), \
+        K(-0.024750487347657349), K(+0.040703169414268381), K(-0.080122290336879357), K(+0.461103333320788900), \
+        K(+0.127483821630827221), K(-0.052763452301176558), K(+0.030440269949322810), K(-0.019211521341311839), \
+        K(+0.012375239340926530), K(-0.007872790004038236), K(+0.004838726949711313), K(-0.002816098670283892), \
+        K(+0.001514915223105546), K(-0.000725866450280135), K(+0.000287877677254080), K(-0.000075949603836482), \
+    }, \
+    {  /* phase 51 */ \
+        K(-0.000166205070116868), K(+0.000475374593512747), K(-0.001060887221205941), K(+0.002058873195567005), \
+        K(-0.003644566142101323), K(+0.006052457949987397), K(-0.009629829576703434), K(+0.014981944729203774), \
+        K(-0.023408740119980020), K(+0.038552273072716241), K(-0.076277324280658879), K(+0.466352310148308302), \
+        K(+0.117295215879403586), K(-0.049051821654119254), K(+0.028366702261771799), K(-0.017915297102251908), \
+        K(+0.011540406469357320), K(-0.007338881587228977), K(+0.004507445520196416), K(-0.002620609070825044), \
+        K(+0.001407677499473232), K(-0.000672975196139040), K(+0.000265841616352226), K(-0.000069385914519434), \
+    }, \
+    {  /* phase 52 */ \
+        K(-0.000158062843373156), K(+0.000449609110366097), K(-0.001000628438271401), K(+0.001938578565539914), \
+        K(-0.003427559961015149), K(+0.005687403654310808), K(-0.009044363529462415), K(+0.014068733457349825), \
+        K(-0.021989766932979066), K(+0.036268687723353218), K(-0.072135526997467864), K(+0.471244071397281639), \
+        K(+0.107228683588879090), K(-0.045294789133162226), K(+0.026255533728186769), K(-0.016593246322250021), \
+        K(+0.010688835758046534), K(-0.006794705482262654), K(+0.004170300206328509), K(-0.002422097213494216), \
+        K(+0.001299119702741010), K(-0.000619676881178676), K(+0.000243804951517256), K(-0.000062938108983896), \
+    }, \
+    {  /* phase 53 */ \
+        K(-0.000149127191570186), K(+0.000421899285558585), K(-0.000936399421057498), K(+0.001811034110603762), \
+        K(-0.003198280666862346), K(+0.005302623400752189), K(-0.008428183667515536), K(+0.013108141562536530), \
+        K(-0.020495916210124188), K(+0.033855545745939977), K(-0.067697447009603756), K(+0.475771377954302410), \
+        K(+0.097296328688787362), K(-0.041501869330634572), K(+0.024112379148597714), K(-0.015248932554223597), \
+        K(+0.009822842455105493), K(-0.006241753612784332), K(+0.003828223613621052), K(-0.002221117471351581), \
+        K(+0.001189547998352699), K(-0.000566123237028513), K(+0.000221830787848354), K(-0.000056624379250116), \
+    }, \
+    {  /* phase 54 */ \
+        K(-0.000139396880747902), K(+0.000392268910960543), K(-0.000868282043770489), K(+0.001676432000031635), \
+        K(-0.002957106907009376), K(+0.004898787752466321), K(-0.007782393692998501), K(+0.012101890644850217), \
+        K(-0.018929750808817217), K(+0.031316329910674207), K(-0.062964148307524101), K(+0.479927521522045986), \
+        K(+0.087509931735460900), K(-0.037682478017500604), K(+0.021942845893082347), K(-0.013885924988547250), \
+        K(+0.008944745872415288), K(-0.005681518405404158), K(+0.003482146215134848), K(-0.002018220832022688), \
+        K(+0.001079265041852245), K(-0.000512463061064073), K(+0.000199980168135351), K(-0.000050461721703474), \
+    }, \
+    {  /* phase 55 */ \
+        K(-0.000128873196185313), K(+0.000360747896425059), K(-0.000796370484401722), K(+0.001534986504163487), \
+        K(-0.002704454141526587), K(+0.004476625535192776), K(-0.007108186731516829), K(+0.011051838359260312), \
+        K(-0.017294044862044416), K(+0.028654871117120249), K(-0.057937213437198092), K(+0.483706336748348120), \
+        K(+0.077880931705957987), K(-0.033845914753007807), K(+0.019752521054424658), K(-0.012507789782029249), \
+        K(+0.008056863624147665), K(-0.005115489051707806), K(+0.003132994021838440), K(-0.001813953530270604), \
+        K(+0.000968569243399089), K(-0.000458841870732754), K(+0.000178311945943104), K(-0.000044465915599696), \
+    }, \
+    {  /* phase 56 */ \
+        K(-0.000117560015735598), K(+0.000327372336623182), K(-0.000720771226108663), K(+0.001386933829378924), \
+        K(-0.002440774160883731), K(+0.004036922834545567), K(-0.006406843565395373), K(+0.009959975658792629), \
+        K(-0.015591780078536529), K(+0.025875345360238319), K(-0.052618745615237883), K(+0.487102212386313793), \
+        K(+0.068420408520243253), K(-0.030001345916256160), K(+0.017546958813334637), K(-0.011118081504284130), \
+        K(+0.007161505944217937), K(-0.004545147829861297), K(+0.002781686299396279), K(-0.001608855715921034), \
+        K(+0.000857754057745412), K(-0.000405401574777666), K(+0.000156882668695674), K(-0.000038651506527568), \
+    }, \
+    {  /* phase 57 */ \
+        K(-0.000105463876724031), K(+0.000292184561180351), K(-0.000641603024282319), K(+0.001232531891089060), \
+        K(-0.002166554500661432), K(+0.003580521831599458), K(-0.005679730622063486), K(+0.008828423673547789), \
+        K(-0.013826141503420424), K(+0.022982269921916085), K(-0.047011369861018615), K(+0.490110101462313652), \
+        K(+0.059139066322708156), K(-0.026157788191136108), K(+0.015331668042261510), K(-0.009720334720554303), \
+        K(+0.006260970095713198), K(-0.003971966494301111), K(+0.002429133336591314), K(-0.001403460160080676), \
+        K(+0.000747107301140326), K(-0.000352280161941660), K(+0.000135746470878424), K(-0.000033031794755297), \
+    }, \
+    {  /* phase 58 */ \
+        K(-0.000092594036021036), K(+0.000255233167582679), K(-0.000558996838711807), K(+0.001072060024279090), \
+        K(-0.001882317753213336), K(+0.003108319477476660), K(-0.004928297719410823), K(+0.007659430228621446), \
+        K(-0.012000512742651384), K(+0.019980498788121481), K(-0.041118233137002316), K(+0.492725530430664693), \
+        K(+0.050047217552528091), K(-0.022324092534917513), K(+0.013112100173050954), K(-0.008318055729503801), \
+        K(+0.005357534884962055), K(-0.003397402741721663), K(+0.002076234270383232), K(-0.001198291002441932), \
+        K(+0.000636910496526694), K(-0.000299611407672006), K(+0.000114954977442191), K(-0.000027618828371703), \
+    }, \
+    {  /* phase 59 */ \
+        K(-0.000078962522915797), K(+0.000216573036362756), K(-0.000473095730346499), K(+0.000905818631299391), \
+        K(-0.001588620776491656), K(+0.002621266008073437), K(-0.004154075570601723), K(+0.006455366004922734), \
+        K(-0.010118470655830457), K(+0.016875217293526638), K(-0.034943003490525537), K(+0.494944607295806860), \
+        K(+0.041154767830693675), K(-0.018508928659551543), K(+0.010893637352862348), K(-0.006914714473939665), \
+        K(+0.004453455292508591), K(-0.002822896761279334), K(+0.001723874972389573), K(-0.000993862542316212), \
+        K(+0.000527438248295502), K(-0.000247524599284320), K(+0.000094557217460290), K(-0.000022423401118998), \
+    }, \
+    {  /* phase 60 */ \
+        K(-0.000064584184430611), K(+0.000176265328117741), K(-0.000384054722248196), K(+0.000734128766771128), \
+        K(-0.001286053800528705), K(+0.002120363300502002), K(-0.003358673051484525), K(+0.005218720347829154), \
+        K(-0.008183779523329434), K(+0.013671935997201286), K(-0.028489868192383340), K(+0.496764028684837156), \
+        K(+0.032471201689834653), K(-0.014720770053466930), K(+0.008681580911879563), K(-0.005513736641810746), \
+        K(+0.003550957232823654), K(-0.002249867876617562), K(+0.001372926001350870), K(-0.000790678075880330), \
+        K(+0.000418957647759024), K(-0.000196144279981884), K(+0.000074599548056259), K(-0.000017455054800228), \
+    }, \
+    {  /* phase 61 */ \
+        K(-0.000049476722732349), K(+0.000134377461958225), K(-0.000292040624421578), K(+0.000557331659645574), \
+        K(-0.000975239432352328), K(+0.001606663073264844), K(-0.002543774234387674), K(+0.003952096729556208), \
+        K(-0.006200384694964441), K(+0.010376483794727123), K(-0.021763530869647874), K(+0.498181085855370076), \
+        K(+0.024005569171185816), K(-0.010967879570306172), K(+0.006481140165416949), K(-0.004118495974190992), \
+        K(+0.002652232454131119), K(-0.001679711286992716), K(+0.001024240625908545), K(-0.000589228781960419), \
+        K(+0.000311727710399971), K(-0.000145590012064546), K(+0.000055125588587903), K(-0.000012722086131388), \
+    }, \
+    {  /* phase 62 */ \
+        K(-0.000033660724315178), K(+0.000090983075033989), K(-0.000197231822308935), K(+0.000375788172630889), \
+        K(-0.000656831560398308), K(+0.001081264932617415), K(-0.001711135192744464), K(+0.002658207872060245), \
+        K(-0.004172405728779418), K(+0.006995000273845942), K(-0.014769207632281863), K(+0.499193669625839997), \
+        K(+0.015766473311215123), K(-0.007258295609662521), K(+0.004297421572050311), K(-0.002732306796280660), \
+        K(+0.001759433589249749), K(-0.001113794914435156), K(+0.000678652921780663), K(-0.000389992658511750), \
+        K(+0.000205998845847387), K(-0.000095976159599081), K(+0.000036176165041702), K(-0.000008231557895977), \
+    }, \
+    {  /* phase 63 */ \
+        K(-0.000017159680647897), K(+0.000046161962832793), K(-0.000099818028836237), K(+0.000189878199378501), \
+        K(-0.000331514159772165), K(+0.000545314268017982), K(-0.000862580581637803), K(+0.001339870538224030), \
+        K(-0.002104129029809739), K(+0.003533927322515310), K(-0.007512622195251726), K(+0.499800274217550022), \
+        K(+0.007762058538560126), K(-0.003599818913442993), K(+0.002135418268382919), K(-0.001358416786748468), \
+        K(+0.000874669367849477), K(-0.000553456363526233), K(+0.000336975947172438), K(-0.000193433511785371), \
+        K(+0.000102012361423778), K(-0.000047411690761459), K(+0.000017789264560807), K(-0.000003989314248164), \
+    }, \
+    {  /* phase 64 */ \
+        K(+0.000000000000000000), K(+0.000000000000000000), K(+0.000000000000000000), K(+0.000000000000000000), \
+        K(+0.000000000000000000), K(+0.000000000000000000), K(+0.000000000000000000), K(+0.000000000000000000), \
+        K(+0.000000000000000000), K(+0.000000000000000000), K(+0.000000000000000000), K(+0.500000000000000000), \
+        K(+0.000000000000000000), K(+0.000000000000000000), K(+0.000000000000000000), K(+0.000000000000000000), \
+        K(+0.000000000000000000), K(+0.000000000000000000), K(+0.000000000000000000), K(+0.000000000000000000), \
+        K(+0.000000000000000000), K(+0.000000000000000000), K(+0.000000000000000000), K(+0.000000000000000000), \
+    },
+
+#define RESAMPLER_FIXED(real) \
+    ((YM7128B_Fixed)(((real) * YM7128B_Fixed_Max) + (((real) < 0) ? -0.5 : +0.5)))
+
+#define RESAMPLER_FLOAT(real) \
+    ((YM7128B_Float)(real))
 
-    for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
-        YM7128B_Register gb = YM7128B_Reg_GL1 + (channel * YM7128B_Gain_Lane_Count);
-        YM7128B_Accumulator accum = 0;
+YM7128B_Fixed const YM7128B_ResamplerFixed_Kernel[YM7128B_Resampler_Phases + 1][YM7128B_Resampler_Length] =
+{
+    YM7128B_RESAMPLER_KERNEL_(RESAMPLER_FIXED)
+};
 
-        for (YM7128B_Register tap = 1; tap < YM7128B_Tap_Count; ++tap) {
-            YM7128B_Tap t = self->tail_ + self->taps_[tap];
-            YM7128B_Tap head = (t >= YM7128B_Buffer_Length) ? (t - YM7128B_Buffer_Length) : t;
-            YM7128B_Fixed buffered = self->buffer_[head];
-            YM7128B_Fixed g = self->gains_[gb + tap - 1];
-            YM7128B_Fixed buffered_g = YM7128B_MulFixed(buffered, g);
-            accum += buffered_g;
-        }
+YM7128B_Float const YM7128B_ResamplerFloat_Kernel[YM7128B_Resampler_Phases + 1][YM7128B_Resampler_Length] =
+{
+    YM7128B_RESAMPLER_KERNEL_(RESAMPLER_FLOAT)
+};
 
-        YM7128B_Fixed total = YM7128B_ClampFixed(accum);
-        YM7128B_Fixed v = self->gains_[YM7128B_Reg_VL + channel];
-        YM7128B_Fixed total_v = YM7128B_MulFixed(total, v);
+#undef RESAMPLER_FIXED
+#undef RESAMPLER_FLOAT
+#undef YM7128B_RESAMPLER_KERNEL_
 
-        YM7128B_OversamplerFixed* oversampler = &self->oversampler_[channel];
-        YM7128B_Fixed* outputs = &data->outputs[channel][0];
+// ----------------------------------------------------------------------------
 
-        outputs[0] = YM7128B_OversamplerFixed_Process(oversampler, total_v);
-        for (YM7128B_Register j = 1; j < YM7128B_Oversampling; ++j) {
-            outputs[j] = YM7128B_OversamplerFixed_Process(oversampler, 0);
-        }
+size_t YM7128B_Resampler_GetLatency(YM7128B_TapIdeal output_rate)
+{
+    if ((output_rate < YM7128B_Resampler_Min_Rate) || (output_rate > YM7128B_Resampler_Max_Rate)) {
+        return 0;
     }
+
+    // Each output is the input signal half the kernel length before
+    uint_fast64_t delay = (uint_fast64_t)output_rate * YM7128B_Resampler_Length;
+    return (size_t)((delay + YM7128B_Input_Rate) / (YM7128B_Input_Rate * 2));
 }
 
 // ----------------------------------------------------------------------------
 
-YM7128B_Register YM7128B_ChipFixed_Read(
-    YM7128B_ChipFixed const* self,
-    YM7128B_Address address
+// Output samples yielded by the next inputs of a resampler
+static size_t YM7128B_Resampler_OutputCount_(
+    YM7128B_TapIdeal output_rate,
+    YM7128B_TapIdeal phase,
+    size_t count
 )
 {
-    assert(self);
-
-    if (address < YM7128B_Reg_C0) {
-        return self->regs_[address] & YM7128B_Gain_Data_Mask;
+    if (!count) {
+        return 0;
     }
-    else if (address < YM7128B_Reg_T0) {
-        return self->regs_[address] & YM7128B_Coeff_Value_Mask;
-    }
-    else if (address < YM7128B_Reg_Count) {
-        return self->regs_[address] & YM7128B_Tap_Value_Mask;
-    }
-    return 0;
+    uint_fast64_t span = ((uint_fast64_t)count * output_rate) - phase;
+    return (size_t)((span + (YM7128B_Input_Rate - 1)) / YM7128B_Input_Rate);
 }
 
 // ----------------------------------------------------------------------------
 
-void YM7128B_ChipFixed_Write(
-    YM7128B_ChipFixed* self,
-    YM7128B_Address address,
-    YM7128B_Register data
-)
+// Kernel position of a resampler phase, as row index and interpolation fraction
+static uint_fast32_t YM7128B_Resampler_Position_(YM7128B_TapIdeal phase, uint_fast64_t scale)
 {
-    assert(self);
-
-    if (address < YM7128B_Reg_C0) {
-        self->regs_[address] = data & YM7128B_Gain_Data_Mask;
-        self->gains_[address] = YM7128B_RegisterToGainFixed(data);
-    }
-    else if (address < YM7128B_Reg_T0) {
-        self->regs_[address] = data & YM7128B_Coeff_Value_Mask;
-        self->gains_[address] = YM7128B_RegisterToCoeffFixed(data);
-    }
-    else if (address < YM7128B_Reg_Count) {
-        self->regs_[address] = data & YM7128B_Tap_Value_Mask;
-        self->taps_[address - YM7128B_Reg_T0] = YM7128B_RegisterToTap(data);
-    }
+    return (uint_fast32_t)(((uint_fast64_t)phase * scale) >> 32);
 }
 
 // ============================================================================
 
-void YM7128B_ChipFloat_Ctor(YM7128B_ChipFloat* self)
+bool YM7128B_ResamplerFixed_Setup(
+    YM7128B_ResamplerFixed* self,
+    YM7128B_TapIdeal output_rate
+)
 {
-    (void)self;
     assert(self);
+
+    if ((output_rate < YM7128B_Resampler_Min_Rate) || (output_rate > YM7128B_Resampler_Max_Rate)) {
+        return false;
+    }
+
+    uint_fast64_t positions = (uint_fast64_t)YM7128B_Resampler_Phases << YM7128B_Resampler_Fraction_Bits;
+    self->output_rate_ = output_rate;
+    self->scale_ = (positions << 32) / output_rate;
+    YM7128B_ResamplerFixed_Reset(self);
+    return true;
 }
 
 // ----------------------------------------------------------------------------
 
-void YM7128B_ChipFloat_Dtor(YM7128B_ChipFloat* self)
+void YM7128B_ResamplerFixed_Reset(YM7128B_ResamplerFixed* self)
 {
-    (void)self;
     assert(self);
+
+    memset(self->buffer_, 0, sizeof(self->buffer_));
+    self->phase_ = 0;
+    self->index_ = 0;
 }
 
 // ----------------------------------------------------------------------------
 
-void YM7128B_ChipFloat_Reset(YM7128B_ChipFloat* self)
+size_t YM7128B_ResamplerFixed_GetOutputCount(
+    YM7128B_ResamplerFixed const* self,
+    size_t count
+)
 {
     assert(self);
 
-    for (YM7128B_Address i = YM7128B_Address_Min; i <= YM7128B_Address_Max; ++i) {
-        YM7128B_ChipFloat_Write(self, i, 0x00);
-    }
+    return YM7128B_Resampler_OutputCount_(self->output_rate_, self->phase_, count);
 }
 
 // ----------------------------------------------------------------------------
 
-void YM7128B_ChipFloat_Start(YM7128B_ChipFloat* self)
+size_t YM7128B_ResamplerFixed_Process(
+    YM7128B_ResamplerFixed* self,
+    YM7128B_Fixed const* inputs_left,
+    YM7128B_Fixed const* inputs_right,
+    size_t count,
+    YM7128B_Fixed* outputs_left,
+    YM7128B_Fixed* outputs_right
+)
 {
     assert(self);
+    assert(self->output_rate_);
+    assert(inputs_left || !count);
+    assert(inputs_right || !count);
+    assert(outputs_left || !count);
+    assert(outputs_right || !count);
+
+    YM7128B_Fixed const* inputs[YM7128B_OutputChannel_Count];
+    inputs[YM7128B_OutputChannel_Left] = inputs_left;
+    inputs[YM7128B_OutputChannel_Right] = inputs_right;
+
+    YM7128B_Fixed* outputs[YM7128B_OutputChannel_Count];
+    outputs[YM7128B_OutputChannel_Left] = outputs_left;
+    outputs[YM7128B_OutputChannel_Right] = outputs_right;
+
+    YM7128B_TapIdeal const rate = self->output_rate_;
+    YM7128B_TapIdeal phase = self->phase_;
+    uint_fast8_t index = self->index_;
+    size_t done = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        index = index ? (index - 1) : (YM7128B_Resampler_Length - 1);
+        for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+            self->buffer_[channel][index] = inputs[channel][i];
+            self->buffer_[channel][index + YM7128B_Resampler_Length] = inputs[channel][i];
+        }
 
-    self->t0_d_ = 0;
-
-    self->tail_ = 0;
-
-    for (YM7128B_Tap i = 0; i < YM7128B_Buffer_Length; ++i) {
-        self->buffer_[i] = 0;
+        // Outputs falling before the next input, each from two adjacent phases
+        for (; phase < rate; phase += YM7128B_Input_Rate) {
+            uint_fast32_t position = YM7128B_Resampler_Position_(phase, self->scale_);
+            YM7128B_Fixed const* kernel0 = YM7128B_ResamplerFixed_Kernel[position >> YM7128B_Resampler_Fraction_Bits];
+            YM7128B_Fixed const* kernel1 = &kernel0[YM7128B_Resampler_Length];
+            int_fast32_t fraction = (int_fast32_t)(position & ((1u << YM7128B_Resampler_Fraction_Bits) - 1));
+
+            for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+                YM7128B_Fixed const* window = &self->buffer_[channel][index];
+                YM7128B_Accumulator accum0 = 0;
+                YM7128B_Accumulator accum1 = 0;
+
+                for (uint_fast8_t k = 0; k < YM7128B_Resampler_Length; ++k) {
+                    accum0 += YM7128B_MulFixed(window[k], kernel0[k]);
+                    accum1 += YM7128B_MulFixed(window[k], kernel1[k]);
+                }
+
+                int_fast64_t delta = ((int_fast64_t)(accum1 - accum0) * fraction) +
+                                     (1 << (YM7128B_Resampler_Fraction_Bits - 1));
+                YM7128B_Accumulator accum = accum0 + (YM7128B_Accumulator)(delta >> YM7128B_Resampler_Fraction_Bits);
+                YM7128B_Fixed clamped = YM7128B_ClampFixed(accum);
+                outputs[channel][done] = clamped & (YM7128B_Fixed)YM7128B_Signal_Mask;
+            }
+            ++done;
+        }
+        phase -= rate;
     }
 
-    for (YM7128B_Oversampler_Index i = 0; i < YM7128B_OutputChannel_Count; ++i) {
-        YM7128B_OversamplerFloat_Reset(&self->oversampler_[i]);
-    }
+    self->phase_ = phase;
+    self->index_ = index;
+    return done;
 }
 
-// ----------------------------------------------------------------------------
+// ============================================================================
 
-void YM7128B_ChipFloat_Stop(YM7128B_ChipFloat* self)
+bool YM7128B_ResamplerFloat_Setup(
+    YM7128B_ResamplerFloat* self,
+    YM7128B_TapIdeal output_rate
+)
 {
-    (void)self;
     assert(self);
+
+    if ((output_rate < YM7128B_Resampler_Min_Rate) || (output_rate > YM7128B_Resampler_Max_Rate)) {
+        return false;
+    }
+
+    uint_fast64_t positions = (uint_fast64_t)YM7128B_Resampler_Phases << YM7128B_Resampler_Fraction_Bits;
+    self->output_rate_ = output_rate;
+    self->scale_ = (positions << 32) / output_rate;
+    YM7128B_ResamplerFloat_Reset(self);
+    return true;
 }
 
 // ----------------------------------------------------------------------------
 
-void YM7128B_ChipFloat_Process(
-    YM7128B_ChipFloat* self,
-    YM7128B_ChipFloat_Process_Data* data
-)
+void YM7128B_ResamplerFloat_Reset(YM7128B_ResamplerFloat* self)
 {
     assert(self);
-    assert(data);
-
-    YM7128B_Float input = data->inputs[YM7128B_InputChannel_Mono];
-    YM7128B_Float sample = input;
-
-    YM7128B_Tap t0 = self->tail_ + self->taps_[0];
-    YM7128B_Tap filter_head  = (t0 >= YM7128B_Buffer_Length) ? (t0 - YM7128B_Buffer_Length) : t0;
-    YM7128B_Float filter_t0  = self->buffer_[filter_head];
-    YM7128B_Float filter_d   = self->t0_d_;
-    self->t0_d_ = filter_t0;
-    YM7128B_Float filter_c0  = YM7128B_MulFloat(filter_t0, self->gains_[YM7128B_Reg_C0]);
-    YM7128B_Float filter_c1  = YM7128B_MulFloat(filter_d, self->gains_[YM7128B_Reg_C1]);
-    YM7128B_Float filter_sum = YM7128B_ClampAddFloat(filter_c0, filter_c1);
-    YM7128B_Float filter_vc  = YM7128B_MulFloat(filter_sum, self->gains_[YM7128B_Reg_VC]);
-
-    YM7128B_Float input_vm  = YM7128B_MulFloat(sample, self->gains_[YM7128B_Reg_VM]);
-    YM7128B_Float input_sum = YM7128B_ClampAddFloat(input_vm, filter_vc);
-
-    self->tail_ = self->tail_ ? (self->tail_ - 1) : (YM7128B_Buffer_Length - 1);
-    self->buffer_[self->tail_] = input_sum;
 
     for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
-        YM7128B_Register gb = YM7128B_Reg_GL1 + (channel * YM7128B_Gain_Lane_Count);
-        YM7128B_Float accum = 0;
-
-        for (YM7128B_Register tap = 1; tap < YM7128B_Tap_Count; ++tap) {
-            YM7128B_Tap t = self->tail_ + self->taps_[tap];
-            YM7128B_Tap head = (t >= YM7128B_Buffer_Length) ? (t - YM7128B_Buffer_Length) : t;
-            YM7128B_Float buffered = self->buffer_[head];
-            YM7128B_Float g = self->gains_[gb + tap - 1];
-            YM7128B_Float buffered_g = YM7128B_MulFloat(buffered, g);
-            accum += buffered_g;
-        }
-
-        YM7128B_Float total = YM7128B_ClampFloat(accum);
-        YM7128B_Float v = self->gains_[YM7128B_Reg_VL + channel];
-        YM7128B_Float total_v = YM7128B_MulFloat(total, v);
-
-        YM7128B_OversamplerFloat* oversampler = &self->oversampler_[channel];
-        YM7128B_Float* outputs = &data->outputs[channel][0];
-
-        outputs[0] = YM7128B_OversamplerFloat_Process(oversampler, total_v);
-        for (YM7128B_Register j = 1; j < YM7128B_Oversampling; ++j) {
-            outputs[j] = YM7128B_OversamplerFloat_Process(oversampler, 0);
+        for (uint_fast8_t k = 0; k < YM7128B_Resampler_Length * 2; ++k) {
+            self->buffer_[channel][k] = 0;
         }
     }
+    self->phase_ = 0;
+    self->index_ = 0;
 }
 
 // ----------------------------------------------------------------------------
 
-YM7128B_Register YM7128B_ChipFloat_Read(
-    YM7128B_ChipFloat const* self,
-    YM7128B_Address address
+size_t YM7128B_ResamplerFloat_GetOutputCount(
+    YM7128B_ResamplerFloat const* self,
+    size_t count
 )
 {
     assert(self);
 
-    if (address < YM7128B_Reg_C0) {
-        return self->regs_[address] & YM7128B_Gain_Data_Mask;
-    }
-    else if (address < YM7128B_Reg_T0) {
-        return self->regs_[address] & YM7128B_Coeff_Value_Mask;
-    }
-    else if (address < YM7128B_Reg_Count) {
-        return self->regs_[address] & YM7128B_Tap_Value_Mask;
-    }
-    return 0;
+    return YM7128B_Resampler_OutputCount_(self->output_rate_, self->phase_, count);
 }
 
 // ----------------------------------------------------------------------------
 
-void YM7128B_ChipFloat_Write(
-    YM7128B_ChipFloat* self,
-    YM7128B_Address address,
-    YM7128B_Register data
+size_t YM7128B_ResamplerFloat_Process(
+    YM7128B_ResamplerFloat* self,
+    YM7128B_Float const* inputs_left,
+    YM7128B_Float const* inputs_right,
+    size_t count,
+    YM7128B_Float* outputs_left,
+    YM7128B_Float* outputs_right
 )
 {
     assert(self);
+    assert(self->output_rate_);
+    assert(inputs_left || !count);
+    assert(inputs_right || !count);
+    assert(outputs_left || !count);
+    assert(outputs_right || !count);
+
+    YM7128B_Float const* inputs[YM7128B_OutputChannel_Count];
+    inputs[YM7128B_OutputChannel_Left] = inputs_left;
+    inputs[YM7128B_OutputChannel_Right] = inputs_right;
+
+    YM7128B_Float* outputs[YM7128B_OutputChannel_Count];
+    outputs[YM7128B_OutputChannel_Left] = outputs_left;
+    outputs[YM7128B_OutputChannel_Right] = outputs_right;
+
+    YM7128B_Float const k_fraction = (YM7128B_Float)1 / (YM7128B_Float)(1u << YM7128B_Resampler_Fraction_Bits);
+    YM7128B_TapIdeal const rate = self->output_rate_;
+    YM7128B_TapIdeal phase = self->phase_;
+    uint_fast8_t index = self->index_;
+    size_t done = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        index = index ? (index - 1) : (YM7128B_Resampler_Length - 1);
+        for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+            self->buffer_[channel][index] = inputs[channel][i];
+            self->buffer_[channel][index + YM7128B_Resampler_Length] = inputs[channel][i];
+        }
 
-    if (address < YM7128B_Reg_C0) {
-        self->regs_[address] = data & YM7128B_Gain_Data_Mask;
-        self->gains_[address] = YM7128B_RegisterToGainFloat(data);
-    }
-    else if (address < YM7128B_Reg_T0) {
-        self->regs_[address] = data & YM7128B_Coeff_Value_Mask;
-        self->gains_[address] = YM7128B_RegisterToCoeffFloat(data);
-    }
-    else if (address < YM7128B_Reg_Count) {
-        self->regs_[address] = data & YM7128B_Tap_Value_Mask;
-        self->taps_[address - YM7128B_Reg_T0] = YM7128B_RegisterToTap(data);
+        // Outputs falling before the next input, each from two adjacent phases
+        for (; phase < rate; phase += YM7128B_Input_Rate) {
+            uint_fast32_t position = YM7128B_Resampler_Position_(phase, self->scale_);
+            YM7128B_Float const* kernel0 = YM7128B_ResamplerFloat_Kernel[position >> YM7128B_Resampler_Fraction_Bits];
+            YM7128B_Float const* kernel1 = &kernel0[YM7128B_Resampler_Length];
+            YM7128B_Float fraction = (YM7128B_Float)(position & ((1u << YM7128B_Resampler_Fraction_Bits) - 1)) * k_fraction;
+
+            for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+                YM7128B_Float const* window = &self->buffer_[channel][index];
+                YM7128B_Float accum0 = 0;
+                YM7128B_Float accum1 = 0;
+
+                for (uint_fast8_t k = 0; k < YM7128B_Resampler_Length; ++k) {
+                    accum0 += YM7128B_MulFloat(window[k], kernel0[k]);
+                    accum1 += YM7128B_MulFloat(window[k], kernel1[k]);
+                }
+
+                YM7128B_Float accum = accum0 + ((accum1 - accum0) * fraction);
+                outputs[channel][done] = YM7128B_ClampFloat(accum);
+            }
+            ++done;
+        }
+        phase -= rate;
     }
+
+    self->phase_ = phase;
+    self->index_ = index;
+    return done;
 }
 
 // ============================================================================
 
-void YM7128B_ChipIdeal_Ctor(YM7128B_ChipIdeal* self)
+void YM7128B_WriteQueue_Clear(YM7128B_WriteQueue* self)
 {
     assert(self);
 
-    self->buffer_ = NULL;
-    self->length_ = 0;
-    self->sample_rate_ = 0;
+    self->head_ = 0;
+    self->count_ = 0;
+    self->busy_ = 0;
 }
 
 // ----------------------------------------------------------------------------
 
-void YM7128B_ChipIdeal_Dtor(YM7128B_ChipIdeal* self)
+bool YM7128B_WriteQueue_Push(
+    YM7128B_WriteQueue* self,
+    size_t offset,
+    YM7128B_Address address,
+    YM7128B_Register data
+)
 {
     assert(self);
+    assert(self->head_ == 0);
 
-    if (self->buffer_) {
-        free(self->buffer_);
-        self->buffer_ = NULL;
-        self->length_ = 0;
+    size_t index = self->count_;
+    if (index >= YM7128B_WRITE_QUEUE_LENGTH) {
+        return false;
     }
-}
-
-// ----------------------------------------------------------------------------
-void YM7128B_ChipIdeal_Reset(YM7128B_ChipIdeal* self)
-{
-    assert(self);
 
-    for (YM7128B_Address i = YM7128B_Address_Min; i <= YM7128B_Address_Max; ++i) {
-        YM7128B_ChipIdeal_Write(self, i, 0x00);
+    while ((index > 0) && (self->events_[index - 1].offset > offset)) {
+        self->events_[index] = self->events_[index - 1];
+        --index;
     }
+
+    YM7128B_WriteEvent* event = &self->events_[index];
+    event->offset = offset;
+    event->address = address;
+    event->data = data;
+    ++self->count_;
+    return true;
 }
 
 // ----------------------------------------------------------------------------
 
-void YM7128B_ChipIdeal_Start(YM7128B_ChipIdeal* self)
+bool YM7128B_WriteQueue_Peek(
+    YM7128B_WriteQueue const* self,
+    size_t count,
+    size_t* offset,
+    YM7128B_WriteEvent const** event
+)
 {
     assert(self);
+    assert(offset);
+    assert(event);
 
-    self->t0_d_ = 0;
+    if (self->head_ >= self->count_) {
+        return false;
+    }
 
-    self->tail_ = 0;
+    YM7128B_WriteEvent const* head = &self->events_[self->head_];
+    size_t due = head->offset;
 
-    if (self->buffer_) {
-        for (YM7128B_TapIdeal i = 0; i < self->length_; ++i) {
-            self->buffer_[i] = 0;
+    if (self->pacing_) {
+        uint_fast64_t ready = self->busy_ / (uint_fast64_t)YM7128B_Write_Rate;
+        if (ready > (uint_fast64_t)due) {
+            due = (ready < (uint_fast64_t)count) ? (size_t)ready : count;
         }
     }
-}
 
-// ----------------------------------------------------------------------------
+    if (due >= count) {
+        return false;
+    }
 
-void YM7128B_ChipIdeal_Stop(YM7128B_ChipIdeal* self)
-{
-    (void)self;
-    assert(self);
+    *offset = due;
+    *event = head;
+    return true;
 }
 
 // ----------------------------------------------------------------------------
 
-void YM7128B_ChipIdeal_Process(
-    YM7128B_ChipIdeal* self,
-    YM7128B_ChipIdeal_Process_Data* data
+void YM7128B_WriteQueue_Pop(
+    YM7128B_WriteQueue* self,
+    size_t offset,
+    YM7128B_TapIdeal sample_rate
 )
 {
     assert(self);
-    assert(data);
+    assert(self->head_ < self->count_);
 
-    if ((self->buffer_ == NULL) || (self->length_ == 0)) {
-        return;
-    }
-
-    YM7128B_Float input = data->inputs[YM7128B_InputChannel_Mono];
-    YM7128B_Float sample = input;
-
-    YM7128B_TapIdeal t0 = self->tail_ + self->taps_[0];
-    YM7128B_TapIdeal filter_head = (t0 >= self->length_) ? (t0 - self->length_) : t0;
-    YM7128B_Float filter_t0  = self->buffer_[filter_head];
-    YM7128B_Float filter_d   = self->t0_d_;
-    self->t0_d_ = filter_t0;
-    YM7128B_Float filter_c0  = YM7128B_MulFloat(filter_t0, self->gains_[YM7128B_Reg_C0]);
-    YM7128B_Float filter_c1  = YM7128B_MulFloat(filter_d, self->gains_[YM7128B_Reg_C1]);
-    YM7128B_Float filter_sum = YM7128B_AddFloat(filter_c0, filter_c1);
-    YM7128B_Float filter_vc  = YM7128B_MulFloat(filter_sum, self->gains_[YM7128B_Reg_VC]);
-
-    YM7128B_Float input_vm  = YM7128B_MulFloat(sample, self->gains_[YM7128B_Reg_VM]);
-    YM7128B_Float input_sum = YM7128B_AddFloat(input_vm, filter_vc);
-
-    self->tail_ = self->tail_ ? (self->tail_ - 1) : (self->length_ - 1);
-    self->buffer_[self->tail_] = input_sum;
-
-    for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
-        YM7128B_Register gb = YM7128B_Reg_GL1 + (channel * YM7128B_Gain_Lane_Count);
-        YM7128B_Float accum = 0;
+    ++self->head_;
 
-        for (YM7128B_Register tap = 1; tap < YM7128B_Tap_Count; ++tap) {
-            YM7128B_TapIdeal t = self->tail_ + self->taps_[tap];
-            YM7128B_TapIdeal head = (t >= self->length_) ? (t - self->length_) : t;
-            YM7128B_Float buffered = self->buffer_[head];
-            YM7128B_Float g = self->gains_[gb + tap - 1];
-            YM7128B_Float buffered_g = YM7128B_MulFloat(buffered, g);
-            accum += buffered_g;
+    if (self->pacing_) {
+        uint_fast64_t start = (uint_fast64_t)offset * (uint_fast64_t)YM7128B_Write_Rate;
+        if (start < self->busy_) {
+            start = self->busy_;
         }
-
-        YM7128B_Float total = accum;
-        YM7128B_Float v = self->gains_[YM7128B_Reg_VL + channel];
-        YM7128B_Float total_v = YM7128B_MulFloat(total, v);
-        YM7128B_Float og = 1 / (YM7128B_Float)YM7128B_Oversampling;
-        YM7128B_Float oversampled = YM7128B_MulFloat(total_v, og);
-        data->outputs[channel] = oversampled;
+        self->busy_ = start + (uint_fast64_t)sample_rate;
     }
 }
 
 // ----------------------------------------------------------------------------
 
-YM7128B_Register YM7128B_ChipIdeal_Read(
-    YM7128B_ChipIdeal const* self,
-    YM7128B_Address address
+void YM7128B_WriteQueue_Advance(
+    YM7128B_WriteQueue* self,
+    size_t count
 )
 {
     assert(self);
 
+    size_t pending = self->count_ - self->head_;
+
+    for (size_t i = 0; i < pending; ++i) {
+        YM7128B_WriteEvent event = self->events_[self->head_ + i];
+        event.offset = (event.offset > count) ? (event.offset - count) : 0;
+        self->events_[i] = event;
+    }
+    self->head_ = 0;
+    self->count_ = pending;
+
+    uint_fast64_t elapsed = (uint_fast64_t)count * (uint_fast64_t)YM7128B_Write_Rate;
+    self->busy_ = (self->busy_ > elapsed) ? (self->busy_ - elapsed) : 0;
+}
+
+// ============================================================================
+
+#if YM7128B_USE_SIMD
+    #if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+        #define YM7128B_SIMD_X86 1
+        #include <immintrin.h>
+        #ifdef _MSC_VER
+            #include <intrin.h>
+        #endif
+    #elif defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+        #define YM7128B_SIMD_NEON 1
+        #include <arm_neon.h>
+    #endif
+#endif
+
+#ifndef YM7128B_SIMD_X86
+#define YM7128B_SIMD_X86 0
+#endif
+
+#ifndef YM7128B_SIMD_NEON
+#define YM7128B_SIMD_NEON 0
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define YM7128B_FORCE_INLINE static inline __attribute__((always_inline))
+    #define YM7128B_TARGET(isa) __attribute__((target(isa)))
+#elif defined(_MSC_VER)
+    #define YM7128B_FORCE_INLINE static __forceinline
+    #define YM7128B_TARGET(isa)
+#else
+    #define YM7128B_FORCE_INLINE static inline
+    #define YM7128B_TARGET(isa)
+#endif
+
+// ----------------------------------------------------------------------------
+
+#if YM7128B_SIMD_X86 && defined(_MSC_VER)
+
+static bool YM7128B_Kernel_HasAVX2_(void)
+{
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || ((_xgetbv(0) & 0x6) != 0x6)) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+}
+
+#endif
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_Kernel_IsSupported(YM7128B_Kernel kernel)
+{
+    switch (kernel)
+    {
+    case YM7128B_Kernel_Scalar:
+        return true;
+
+#if YM7128B_SIMD_X86
+    case YM7128B_Kernel_SSE2:
+    #if defined(__x86_64__) || defined(_M_X64)
+        return true;
+    #elif defined(_MSC_VER)
+        return IsProcessorFeaturePresent(PF_XMMI64_INSTRUCTIONS_AVAILABLE) != 0;
+    #else
+        return __builtin_cpu_supports("sse2") != 0;
+    #endif
+
+    case YM7128B_Kernel_AVX2:
+    #if defined(_MSC_VER)
+        return YM7128B_Kernel_HasAVX2_();
+    #else
+        return __builtin_cpu_supports("avx2") != 0;
+    #endif
+#endif
+
+#if YM7128B_SIMD_NEON
+    case YM7128B_Kernel_NEON:
+        return true;
+#endif
+
+    default:
+        return false;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_Kernel YM7128B_Kernel_GetBest(void)
+{
+    YM7128B_Kernel best = YM7128B_Kernel_Scalar;
+
+    for (int kernel = 0; kernel < (int)YM7128B_Kernel_Count; ++kernel) {
+        if (YM7128B_Kernel_IsSupported((YM7128B_Kernel)kernel)) {
+            best = (YM7128B_Kernel)kernel;
+        }
+    }
+    return best;
+}
+
+// ----------------------------------------------------------------------------
+// Output mix kernels: they take the 8 tap samples, loaded once, and compute
+// the dot products of both output channels, with gains laid out as per
+// YM7128B_Reg_GL1..YM7128B_Reg_GR8.
+
+YM7128B_FORCE_INLINE
+void YM7128B_MixFixed_Scalar(
+    YM7128B_Fixed const samples[YM7128B_Gain_Lane_Count],
+    YM7128B_Fixed const gains[YM7128B_OutputChannel_Count * YM7128B_Gain_Lane_Count],
+    YM7128B_Accumulator accums[YM7128B_OutputChannel_Count]
+)
+{
+    YM7128B_Accumulator accum_l = 0;
+    YM7128B_Accumulator accum_r = 0;
+
+    for (YM7128B_Register lane = 0; lane < YM7128B_Gain_Lane_Count; ++lane) {
+        YM7128B_Fixed buffered = samples[lane];
+        accum_l += YM7128B_MulFixed(buffered, gains[lane]);
+        accum_r += YM7128B_MulFixed(buffered, gains[lane + YM7128B_Gain_Lane_Count]);
+    }
+
+    accums[YM7128B_OutputChannel_Left] = accum_l;
+    accums[YM7128B_OutputChannel_Right] = accum_r;
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_FORCE_INLINE
+void YM7128B_MixShort_Scalar(
+    YM7128B_Fixed const samples[YM7128B_Gain_Lane_Count],
+    YM7128B_Fixed const gains[YM7128B_OutputChannel_Count * YM7128B_Gain_Lane_Count],
+    YM7128B_Fixed accums[YM7128B_OutputChannel_Count]
+)
+{
+    YM7128B_Fixed accum_l = 0;
+    YM7128B_Fixed accum_r = 0;
+
+    for (YM7128B_Register lane = 0; lane < YM7128B_Gain_Lane_Count; ++lane) {
+        YM7128B_Fixed buffered = samples[lane];
+        accum_l += YM7128B_MulShort(buffered, gains[lane]);
+        accum_r += YM7128B_MulShort(buffered, gains[lane + YM7128B_Gain_Lane_Count]);
+    }
+
+    accums[YM7128B_OutputChannel_Left] = accum_l;
+    accums[YM7128B_OutputChannel_Right] = accum_r;
+}
+
+// ----------------------------------------------------------------------------
+// Interpolator kernels: they update the history and compute all the phases.
+
+YM7128B_FORCE_INLINE
+YM7128B_Fixed const* YM7128B_InterpolatorFixed_Push_(
+    YM7128B_InterpolatorFixed* self,
+    YM7128B_Fixed input
+)
+{
+    YM7128B_Oversampler_Index index = self->index_;
+    index = index ? (index - 1) : (YM7128B_Interpolator_Length - 1);
+    self->index_ = index;
+    self->buffer_[index] = input;
+    self->buffer_[index + YM7128B_Interpolator_Length] = input;
+    return &self->buffer_[index];
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_FORCE_INLINE
+YM7128B_Fixed YM7128B_InterpolatorFixed_Output_(YM7128B_Accumulator accum)
+{
+    YM7128B_Fixed clamped = YM7128B_ClampFixed(accum);
+    YM7128B_Fixed output = clamped & (YM7128B_Fixed)YM7128B_Signal_Mask;
+    return output;
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_FORCE_INLINE
+void YM7128B_InterpolateFixed_Scalar(
+    YM7128B_InterpolatorFixed* self,
+    YM7128B_Fixed const coeffs[YM7128B_Oversampler_Factor][YM7128B_Interpolator_Stride],
+    YM7128B_Fixed input,
+    YM7128B_Fixed outputs[YM7128B_Oversampler_Factor]
+)
+{
+    YM7128B_Fixed const* window = YM7128B_InterpolatorFixed_Push_(self, input);
+
+    for (YM7128B_Oversampler_Index phase = 0; phase < YM7128B_Oversampler_Factor; ++phase) {
+        YM7128B_Fixed const* kernel = &coeffs[phase][0];
+        YM7128B_Oversampler_Index length = YM7128B_Interpolator_PhaseLength(phase);
+        YM7128B_Accumulator accum = 0;
+
+        for (YM7128B_Oversampler_Index i = 0; i < length; ++i) {
+            YM7128B_Fixed oversampled = YM7128B_MulFixed(window[i], kernel[i]);
+            accum += oversampled;
+        }
+
+        outputs[phase] = YM7128B_InterpolatorFixed_Output_(accum);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+#if YM7128B_SIMD_X86
+
+// YM7128B_MulFixed() of 8 lanes, sign-extended to 32-bit lanes
+YM7128B_FORCE_INLINE YM7128B_TARGET("sse2")
+void YM7128B_MulFixed_SSE2(__m128i a, __m128i b, __m128i* lo, __m128i* hi)
+{
+    __m128i const round = _mm_set1_epi32(1 << (YM7128B_Fixed_Decimals - 1));
+    __m128i mm_lo = _mm_mullo_epi16(a, b);
+    __m128i mm_hi = _mm_mulhi_epi16(a, b);
+    __m128i mm0 = _mm_unpacklo_epi16(mm_lo, mm_hi);
+    __m128i mm1 = _mm_unpackhi_epi16(mm_lo, mm_hi);
+    __m128i x0 = _mm_srai_epi32(_mm_add_epi32(mm0, round), YM7128B_Fixed_Decimals);
+    __m128i x1 = _mm_srai_epi32(_mm_add_epi32(mm1, round), YM7128B_Fixed_Decimals);
+    *lo = _mm_srai_epi32(_mm_slli_epi32(x0, 16), 16);
+    *hi = _mm_srai_epi32(_mm_slli_epi32(x1, 16), 16);
+}
+
+// ----------------------------------------------------------------------------
+
+// Horizontal sums of two vectors, into the first two lanes
+YM7128B_FORCE_INLINE YM7128B_TARGET("sse2")
+__m128i YM7128B_HorizontalSum2_SSE2(__m128i a, __m128i b)
+{
+    __m128i t = _mm_add_epi32(_mm_unpacklo_epi64(a, b), _mm_unpackhi_epi64(a, b));
+    __m128i u = _mm_add_epi32(t, _mm_shuffle_epi32(t, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_shuffle_epi32(u, _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_FORCE_INLINE YM7128B_TARGET("sse2")
+void YM7128B_MixFixed_SSE2(
+    YM7128B_Fixed const samples[YM7128B_Gain_Lane_Count],
+    YM7128B_Fixed const gains[YM7128B_OutputChannel_Count * YM7128B_Gain_Lane_Count],
+    YM7128B_Accumulator accums[YM7128B_OutputChannel_Count]
+)
+{
+    __m128i s = _mm_loadu_si128((__m128i const*)(void const*)samples);
+    __m128i gl = _mm_loadu_si128((__m128i const*)(void const*)&gains[0]);
+    __m128i gr = _mm_loadu_si128((__m128i const*)(void const*)&gains[YM7128B_Gain_Lane_Count]);
+    __m128i l0, l1, r0, r1;
+    YM7128B_MulFixed_SSE2(s, gl, &l0, &l1);
+    YM7128B_MulFixed_SSE2(s, gr, &r0, &r1);
+    __m128i sums = YM7128B_HorizontalSum2_SSE2(_mm_add_epi32(l0, l1), _mm_add_epi32(r0, r1));
+    accums[YM7128B_OutputChannel_Left] = _mm_cvtsi128_si32(sums);
+    accums[YM7128B_OutputChannel_Right] = _mm_cvtsi128_si32(_mm_srli_si128(sums, 4));
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_FORCE_INLINE YM7128B_TARGET("sse2")
+void YM7128B_MixShort_SSE2(
+    YM7128B_Fixed const samples[YM7128B_Gain_Lane_Count],
+    YM7128B_Fixed const gains[YM7128B_OutputChannel_Count * YM7128B_Gain_Lane_Count],
+    YM7128B_Fixed accums[YM7128B_OutputChannel_Count]
+)
+{
+    __m128i s = _mm_loadu_si128((__m128i const*)(void const*)samples);
+    __m128i gl = _mm_loadu_si128((__m128i const*)(void const*)&gains[0]);
+    __m128i gr = _mm_loadu_si128((__m128i const*)(void const*)&gains[YM7128B_Gain_Lane_Count]);
+    __m128i pl = _mm_mulhi_epi16(s, gl);
+    __m128i pr = _mm_mulhi_epi16(s, gr);
+    __m128i t = _mm_add_epi16(_mm_unpacklo_epi64(pl, pr), _mm_unpackhi_epi64(pl, pr));
+    t = _mm_add_epi16(t, _mm_srli_epi64(t, 32));
+    t = _mm_add_epi16(t, _mm_srli_epi32(t, 16));
+    accums[YM7128B_OutputChannel_Left] = (YM7128B_Fixed)_mm_extract_epi16(t, 0);
+    accums[YM7128B_OutputChannel_Right] = (YM7128B_Fixed)_mm_extract_epi16(t, 4);
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_FORCE_INLINE YM7128B_TARGET("sse2")
+void YM7128B_InterpolateFixed_SSE2(
+    YM7128B_InterpolatorFixed* self,
+    YM7128B_Fixed const coeffs[YM7128B_Oversampler_Factor][YM7128B_Interpolator_Stride],
+    YM7128B_Fixed input,
+    YM7128B_Fixed outputs[YM7128B_Oversampler_Factor]
+)
+{
+    YM7128B_Fixed const* window = YM7128B_InterpolatorFixed_Push_(self, input);
+    __m128i w0 = _mm_loadu_si128((__m128i const*)(void const*)&window[0]);
+    __m128i w1 = _mm_loadu_si128((__m128i const*)(void const*)&window[8]);
+    __m128i sums[YM7128B_Oversampler_Factor];
+
+    for (YM7128B_Oversampler_Index phase = 0; phase < YM7128B_Oversampler_Factor; ++phase) {
+        YM7128B_Fixed const* kernel = &coeffs[phase][0];
+        __m128i k0 = _mm_loadu_si128((__m128i const*)(void const*)&kernel[0]);
+        __m128i k1 = _mm_loadu_si128((__m128i const*)(void const*)&kernel[8]);
+        __m128i p0, p1, p2, p3;
+        YM7128B_MulFixed_SSE2(w0, k0, &p0, &p1);
+        YM7128B_MulFixed_SSE2(w1, k1, &p2, &p3);
+        sums[phase] = _mm_add_epi32(_mm_add_epi32(p0, p1), _mm_add_epi32(p2, p3));
+    }
+
+    __m128i total = YM7128B_HorizontalSum2_SSE2(sums[0], sums[1]);
+    outputs[0] = YM7128B_InterpolatorFixed_Output_(_mm_cvtsi128_si32(total));
+    outputs[1] = YM7128B_InterpolatorFixed_Output_(_mm_cvtsi128_si32(_mm_srli_si128(total, 4)));
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_FORCE_INLINE YM7128B_TARGET("avx2")
+void YM7128B_MixFixed_AVX2(
+    YM7128B_Fixed const samples[YM7128B_Gain_Lane_Count],
+    YM7128B_Fixed const gains[YM7128B_OutputChannel_Count * YM7128B_Gain_Lane_Count],
+    YM7128B_Accumulator accums[YM7128B_OutputChannel_Count]
+)
+{
+    __m128i s = _mm_loadu_si128((__m128i const*)(void const*)samples);
+    __m256i ss = _mm256_broadcastsi128_si256(s);
+    __m256i g = _mm256_loadu_si256((__m256i const*)(void const*)gains);
+    __m256i p = _mm256_mulhrs_epi16(ss, g);  // same as YM7128B_MulFixed()
+    __m256i q = _mm256_madd_epi16(p, _mm256_set1_epi16(1));
+    __m256i t = _mm256_hadd_epi32(q, q);
+    t = _mm256_hadd_epi32(t, t);
+    accums[YM7128B_OutputChannel_Left] = _mm_cvtsi128_si32(_mm256_castsi256_si128(t));
+    accums[YM7128B_OutputChannel_Right] = _mm_cvtsi128_si32(_mm256_extracti128_si256(t, 1));
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_FORCE_INLINE YM7128B_TARGET("avx2")
+void YM7128B_MixShort_AVX2(
+    YM7128B_Fixed const samples[YM7128B_Gain_Lane_Count],
+    YM7128B_Fixed const gains[YM7128B_OutputChannel_Count * YM7128B_Gain_Lane_Count],
+    YM7128B_Fixed accums[YM7128B_OutputChannel_Count]
+)
+{
+    __m128i s = _mm_loadu_si128((__m128i const*)(void const*)samples);
+    __m256i ss = _mm256_broadcastsi128_si256(s);
+    __m256i g = _mm256_loadu_si256((__m256i const*)(void const*)gains);
+    __m256i p = _mm256_mulhi_epi16(ss, g);  // same as YM7128B_MulShort()
+    __m256i q = _mm256_madd_epi16(p, _mm256_set1_epi16(1));
+    __m256i t = _mm256_hadd_epi32(q, q);
+    t = _mm256_hadd_epi32(t, t);
+    accums[YM7128B_OutputChannel_Left] = (YM7128B_Fixed)_mm_cvtsi128_si32(_mm256_castsi256_si128(t));
+    accums[YM7128B_OutputChannel_Right] = (YM7128B_Fixed)_mm_cvtsi128_si32(_mm256_extracti128_si256(t, 1));
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_FORCE_INLINE YM7128B_TARGET("avx2")
+void YM7128B_InterpolateFixed_AVX2(
+    YM7128B_InterpolatorFixed* self,
+    YM7128B_Fixed const coeffs[YM7128B_Oversampler_Factor][YM7128B_Interpolator_Stride],
+    YM7128B_Fixed input,
+    YM7128B_Fixed outputs[YM7128B_Oversampler_Factor]
+)
+{
+    YM7128B_Fixed const* window = YM7128B_InterpolatorFixed_Push_(self, input);
+    __m256i w = _mm256_loadu_si256((__m256i const*)(void const*)window);
+    __m256i ones = _mm256_set1_epi16(1);
+    __m256i k0 = _mm256_loadu_si256((__m256i const*)(void const*)&coeffs[0][0]);
+    __m256i k1 = _mm256_loadu_si256((__m256i const*)(void const*)&coeffs[1][0]);
+    __m256i q0 = _mm256_madd_epi16(_mm256_mulhrs_epi16(w, k0), ones);
+    __m256i q1 = _mm256_madd_epi16(_mm256_mulhrs_epi16(w, k1), ones);
+    __m256i h = _mm256_hadd_epi32(q0, q1);
+    h = _mm256_hadd_epi32(h, h);
+    __m128i t = _mm_add_epi32(_mm256_castsi256_si128(h), _mm256_extracti128_si256(h, 1));
+    outputs[0] = YM7128B_InterpolatorFixed_Output_(_mm_cvtsi128_si32(t));
+    outputs[1] = YM7128B_InterpolatorFixed_Output_(_mm_cvtsi128_si32(_mm_srli_si128(t, 4)));
+}
+
+#endif  // YM7128B_SIMD_X86
+
+// ----------------------------------------------------------------------------
+
+#if YM7128B_SIMD_NEON
+
+// Sum of all the lanes of YM7128B_MulFixed() products
+YM7128B_FORCE_INLINE
+YM7128B_Accumulator YM7128B_MulSumFixed_NEON(int16x8_t a, int16x8_t b)
+{
+    int16x8_t p = vqrdmulhq_s16(a, b);  // same as YM7128B_MulFixed(), for non-extreme operands
+    int64x2_t q = vpaddlq_s32(vpaddlq_s16(p));
+    return (YM7128B_Accumulator)(vgetq_lane_s64(q, 0) + vgetq_lane_s64(q, 1));
+}
+
+// ----------------------------------------------------------------------------
+
+// Sum of all the lanes of YM7128B_MulShort() products
+YM7128B_FORCE_INLINE
+YM7128B_Accumulator YM7128B_MulSumShort_NEON(int16x8_t a, int16x8_t b)
+{
+    int32x4_t lo = vshrq_n_s32(vmull_s16(vget_low_s16(a), vget_low_s16(b)), 16);
+    int32x4_t hi = vshrq_n_s32(vmull_s16(vget_high_s16(a), vget_high_s16(b)), 16);
+    int64x2_t q = vpaddlq_s32(vaddq_s32(lo, hi));
+    return (YM7128B_Accumulator)(vgetq_lane_s64(q, 0) + vgetq_lane_s64(q, 1));
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_FORCE_INLINE
+void YM7128B_MixFixed_NEON(
+    YM7128B_Fixed const samples[YM7128B_Gain_Lane_Count],
+    YM7128B_Fixed const gains[YM7128B_OutputChannel_Count * YM7128B_Gain_Lane_Count],
+    YM7128B_Accumulator accums[YM7128B_OutputChannel_Count]
+)
+{
+    int16x8_t s = vld1q_s16(samples);
+    accums[YM7128B_OutputChannel_Left] = YM7128B_MulSumFixed_NEON(s, vld1q_s16(&gains[0]));
+    accums[YM7128B_OutputChannel_Right] = YM7128B_MulSumFixed_NEON(s, vld1q_s16(&gains[YM7128B_Gain_Lane_Count]));
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_FORCE_INLINE
+void YM7128B_MixShort_NEON(
+    YM7128B_Fixed const samples[YM7128B_Gain_Lane_Count],
+    YM7128B_Fixed const gains[YM7128B_OutputChannel_Count * YM7128B_Gain_Lane_Count],
+    YM7128B_Fixed accums[YM7128B_OutputChannel_Count]
+)
+{
+    int16x8_t s = vld1q_s16(samples);
+    accums[YM7128B_OutputChannel_Left] = (YM7128B_Fixed)YM7128B_MulSumShort_NEON(s, vld1q_s16(&gains[0]));
+    accums[YM7128B_OutputChannel_Right] = (YM7128B_Fixed)YM7128B_MulSumShort_NEON(s, vld1q_s16(&gains[YM7128B_Gain_Lane_Count]));
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_FORCE_INLINE
+void YM7128B_InterpolateFixed_NEON(
+    YM7128B_InterpolatorFixed* self,
+    YM7128B_Fixed const coeffs[YM7128B_Oversampler_Factor][YM7128B_Interpolator_Stride],
+    YM7128B_Fixed input,
+    YM7128B_Fixed outputs[YM7128B_Oversampler_Factor]
+)
+{
+    YM7128B_Fixed const* window = YM7128B_InterpolatorFixed_Push_(self, input);
+    int16x8_t w0 = vld1q_s16(&window[0]);
+    int16x8_t w1 = vld1q_s16(&window[8]);
+
+    for (YM7128B_Oversampler_Index phase = 0; phase < YM7128B_Oversampler_Factor; ++phase) {
+        YM7128B_Fixed const* kernel = &coeffs[phase][0];
+        YM7128B_Accumulator accum = YM7128B_MulSumFixed_NEON(w0, vld1q_s16(&kernel[0]));
+        accum += YM7128B_MulSumFixed_NEON(w1, vld1q_s16(&kernel[8]));
+        outputs[phase] = YM7128B_InterpolatorFixed_Output_(accum);
+    }
+}
+
+#endif  // YM7128B_SIMD_NEON
+
+// ============================================================================
+
+// Moves a ring buffer position back by the given number of steps, as done by
+// the per-sample decrement of the processing loops
+static size_t YM7128B_Ring_Rewind_(size_t position, size_t steps, size_t length)
+{
+    steps %= length;
+    return (position >= steps) ? (position - steps) : (position + length - steps);
+}
+
+// ----------------------------------------------------------------------------
+
+// Wraps a delay line position of the Fixed and Float engines, from below twice
+// the buffer capacity; just masking when that is a power of two
+static YM7128B_Tap YM7128B_Buffer_Wrap_(YM7128B_Tap position)
+{
+#if YM7128B_USE_POW2_DELAY
+    return position & (YM7128B_Tap)(YM7128B_Buffer_Capacity - 1);
+#else
+    return (position >= YM7128B_Buffer_Capacity) ? (position - YM7128B_Buffer_Capacity) : position;
+#endif
+}
+
+// ============================================================================
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define YM7128B_ATOMIC_LOAD(pointer) __atomic_load_n((pointer), __ATOMIC_ACQUIRE)
+    #define YM7128B_ATOMIC_EXCHANGE(pointer, value) __atomic_exchange_n((pointer), (value), __ATOMIC_ACQ_REL)
+#elif defined(_MSC_VER)
+    #include <intrin.h>
+    #define YM7128B_ATOMIC_LOAD(pointer) _InterlockedOr((pointer), 0)
+    #define YM7128B_ATOMIC_EXCHANGE(pointer, value) _InterlockedExchange((pointer), (value))
+#else
+    #error "Atomic operations not supported by this compiler"
+#endif
+
+enum {
+    YM7128B_Mailbox_Fresh      = 1 << 2,
+    YM7128B_Mailbox_Index_Mask = YM7128B_Mailbox_Fresh - 1
+};
+
+// ----------------------------------------------------------------------------
+
+static void YM7128B_Mailbox_Ctor_(YM7128B_Mailbox* self)
+{
+    self->state_ = 1;
+    self->back_ = 2;
+    self->front_ = 0;
+}
+
+// ----------------------------------------------------------------------------
+
+// Producer side: publishes the back slot as the fresh middle one, taking the
+// previous middle slot as the next back one
+static void YM7128B_Mailbox_Publish_(YM7128B_Mailbox* self)
+{
+    long state = YM7128B_ATOMIC_EXCHANGE(&self->state_, (long)self->back_ | YM7128B_Mailbox_Fresh);
+    self->back_ = (unsigned char)(state & YM7128B_Mailbox_Index_Mask);
+}
+
+// ----------------------------------------------------------------------------
+
+// Consumer side: takes a fresh middle slot as the front one, if any, giving
+// the previous front slot back; returns true if taken
+static bool YM7128B_Mailbox_Acquire_(YM7128B_Mailbox* self)
+{
+    if (!(YM7128B_ATOMIC_LOAD(&self->state_) & YM7128B_Mailbox_Fresh)) {
+        return false;
+    }
+    long state = YM7128B_ATOMIC_EXCHANGE(&self->state_, (long)self->front_);
+    self->front_ = (unsigned char)(state & YM7128B_Mailbox_Index_Mask);
+    return true;
+}
+
+// ============================================================================
+
+#if YM7128B_USE_STATS
+    #define YM7128B_STATS(...) __VA_ARGS__
+
+    #if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+        #ifdef _MSC_VER
+            #include <intrin.h>
+        #else
+            #include <x86intrin.h>
+        #endif
+    #else
+        #include <time.h>
+    #endif
+
+// Reads the timestamp counter, or the processor time as a fallback
+static uint64_t YM7128B_Stats_Cycles_(void)
+{
+    #if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+        return (uint64_t)__rdtsc();
+    #elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+        uint64_t ticks;
+        __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+    #else
+        return (uint64_t)clock();
+    #endif
+}
+
+// ----------------------------------------------------------------------------
+
+// Accounts the cycles of a stage since the previous lap, starting the next one
+static uint64_t YM7128B_Stats_Lap_(YM7128B_Stats* stats, YM7128B_Stage stage, uint64_t start)
+{
+    uint64_t now = YM7128B_Stats_Cycles_();
+    stats->cycles[stage] += now - start;
+    return now;
+}
+
+// ----------------------------------------------------------------------------
+
+// Clamp detectors, as per the matching arithmetic functions
+static unsigned YM7128B_Stats_ClampsFixed_(YM7128B_Accumulator signal)
+{
+    return (signal < YM7128B_Fixed_Min) || (signal > YM7128B_Fixed_Max);
+}
+
+static unsigned YM7128B_Stats_ClampsAddFixed_(YM7128B_Fixed a, YM7128B_Fixed b)
+{
+    YM7128B_Accumulator aa = a & (YM7128B_Fixed)YM7128B_Operand_Mask;
+    YM7128B_Accumulator bb = b & (YM7128B_Fixed)YM7128B_Operand_Mask;
+    return YM7128B_Stats_ClampsFixed_(aa + bb);
+}
+
+static unsigned YM7128B_Stats_ClampsFloat_(YM7128B_Float signal)
+{
+    return (signal < YM7128B_Float_Min) || (signal > YM7128B_Float_Max);
+}
+
+static unsigned YM7128B_Stats_ClampsAddShort_(YM7128B_Fixed a, YM7128B_Fixed b)
+{
+    return YM7128B_Stats_ClampsFixed_((YM7128B_Accumulator)a + (YM7128B_Accumulator)b);
+}
+
+// ----------------------------------------------------------------------------
+
+static void YM7128B_Stats_PeakFixed_(YM7128B_Accumulator* peak, YM7128B_Fixed value)
+{
+    YM7128B_Accumulator magnitude = (value < 0) ? -(YM7128B_Accumulator)value : value;
+    if (*peak < magnitude) {
+        *peak = magnitude;
+    }
+}
+
+static void YM7128B_Stats_PeakFloat_(YM7128B_Float* peak, YM7128B_Float value)
+{
+    YM7128B_Float magnitude = (value < 0) ? -value : value;
+    if (*peak < magnitude) {
+        *peak = magnitude;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+// Merges the peaks of a processed block, scaled to the full scale
+static void YM7128B_Stats_MergeFixed_(
+    YM7128B_Stats* stats,
+    YM7128B_Accumulator const lane_peaks[YM7128B_Gain_Lane_Count],
+    YM7128B_Accumulator const output_peaks[YM7128B_OutputChannel_Count]
+)
+{
+    YM7128B_Float const scale = 1 / (YM7128B_Float)(1L << YM7128B_Fixed_Decimals);
+
+    for (YM7128B_Register lane = 0; lane < YM7128B_Gain_Lane_Count; ++lane) {
+        YM7128B_Stats_PeakFloat_(&stats->lane_peaks[lane], (YM7128B_Float)lane_peaks[lane] * scale);
+    }
+    for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+        YM7128B_Stats_PeakFloat_(&stats->output_peaks[channel], (YM7128B_Float)output_peaks[channel] * scale);
+    }
+}
+
+static void YM7128B_Stats_MergeFloat_(
+    YM7128B_Stats* stats,
+    YM7128B_Float const lane_peaks[YM7128B_Gain_Lane_Count],
+    YM7128B_Float const output_peaks[YM7128B_OutputChannel_Count]
+)
+{
+    for (YM7128B_Register lane = 0; lane < YM7128B_Gain_Lane_Count; ++lane) {
+        YM7128B_Stats_PeakFloat_(&stats->lane_peaks[lane], lane_peaks[lane]);
+    }
+    for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+        YM7128B_Stats_PeakFloat_(&stats->output_peaks[channel], output_peaks[channel]);
+    }
+}
+
+#else
+    #define YM7128B_STATS(...)
+#endif  // YM7128B_USE_STATS
+
+// ----------------------------------------------------------------------------
+
+static bool YM7128B_InterpolatorFixed_IsClear_(YM7128B_InterpolatorFixed const* self)
+{
+    for (YM7128B_Oversampler_Index i = 0; i < YM7128B_Interpolator_Buffer_Length; ++i) {
+        if (self->buffer_[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+static bool YM7128B_InterpolatorFloat_IsClear_(YM7128B_InterpolatorFloat const* self)
+{
+    for (YM7128B_Oversampler_Index i = 0; i < YM7128B_Interpolator_Buffer_Length; ++i) {
+        if (self->buffer_[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// State snapshots, in native byte order:
+//
+//     header:  magic[4], version, engine, flags, sample_size,
+//              length (u32), count (u32)
+//     body:    regs[YM7128B_Reg_Count], tail (u32), silence (u32), t0_d,
+//              pacing (u8), busy (u64), events (u32),
+//              events * { offset (u64), address (u8), data (u8) },
+//              interpolators * { index (u8), buffer[] },
+//              delay samples [count], from the newest one
+
+enum {
+    YM7128B_State_Header_Size = 16,
+    YM7128B_State_Event_Size  = 8 + 1 + 1,
+    YM7128B_State_Flag_Delta  = 1 << 0
+};
+
+static uint8_t const YM7128B_State_Magic[4] = { 'Y', 'M', '7', 'S' };
+
+// Engine agnostic view of the chip state
+typedef struct YM7128B_StateView_
+{
+    YM7128B_ChipEngine engine;
+    size_t sample_size;
+    size_t length;    // nominal, as saved
+    size_t capacity;  // of the ring, wrapping tail
+    size_t tail;
+    size_t silence;
+    size_t written;
+    YM7128B_Register const* regs;
+    void* t0_d;
+    void* buffer;
+    YM7128B_WriteQueue* queue;
+    size_t interpolators;
+    YM7128B_Oversampler_Index* indices[YM7128B_OutputChannel_Count];
+    void* histories[YM7128B_OutputChannel_Count];
+} YM7128B_StateView_;
+
+// ----------------------------------------------------------------------------
+
+static size_t YM7128B_State_Size_(
+    size_t sample_size,
+    size_t interpolators,
+    size_t events,
+    size_t count
+)
+{
+    size_t size = YM7128B_State_Header_Size;
+    size += YM7128B_Reg_Count + 4 + 4 + sample_size;
+    size += 1 + 8 + 4 + (events * YM7128B_State_Event_Size);
+    size += interpolators * (1 + (YM7128B_Interpolator_Buffer_Length * sample_size));
+    size += count * sample_size;
+    return size;
+}
+
+// ----------------------------------------------------------------------------
+
+static uint8_t* YM7128B_State_Put_(uint8_t* cursor, void const* data, size_t size)
+{
+    memcpy(cursor, data, size);
+    return cursor + size;
+}
+
+// ----------------------------------------------------------------------------
+
+static uint8_t const* YM7128B_State_Get_(uint8_t const* cursor, void* data, size_t size)
+{
+    memcpy(data, cursor, size);
+    return cursor + size;
+}
+
+// ----------------------------------------------------------------------------
+
+static size_t YM7128B_State_Save_(
+    YM7128B_StateView_ const* view,
+    void* buffer,
+    size_t size,
+    bool delta
+)
+{
+    size_t length = view->length;
+    size_t count = length;
+    if (delta && (view->written < length)) {
+        count = view->written;
+    }
+    else {
+        delta = false;
+    }
+
+    YM7128B_WriteQueue const* queue = view->queue;
+    size_t events = queue->count_ - queue->head_;
+    size_t total = YM7128B_State_Size_(view->sample_size, view->interpolators, events, count);
+    if (!buffer || (size < total)) {
+        return 0;
+    }
+
+    uint8_t* cursor = (uint8_t*)buffer;
+    cursor = YM7128B_State_Put_(cursor, YM7128B_State_Magic, sizeof(YM7128B_State_Magic));
+    *cursor++ = (uint8_t)YM7128B_STATE_VERSION;
+    *cursor++ = (uint8_t)view->engine;
+    *cursor++ = (uint8_t)(delta ? YM7128B_State_Flag_Delta : 0);
+    *cursor++ = (uint8_t)view->sample_size;
+    uint32_t u32 = (uint32_t)length;
+    cursor = YM7128B_State_Put_(cursor, &u32, 4);
+    u32 = (uint32_t)count;
+    cursor = YM7128B_State_Put_(cursor, &u32, 4);
+
+    cursor = YM7128B_State_Put_(cursor, view->regs, YM7128B_Reg_Count);
+    u32 = (uint32_t)view->tail;
+    cursor = YM7128B_State_Put_(cursor, &u32, 4);
+    u32 = (uint32_t)((view->silence < length) ? view->silence : length);
+    cursor = YM7128B_State_Put_(cursor, &u32, 4);
+    cursor = YM7128B_State_Put_(cursor, view->t0_d, view->sample_size);
+
+    *cursor++ = (uint8_t)queue->pacing_;
+    uint64_t u64 = (uint64_t)queue->busy_;
+    cursor = YM7128B_State_Put_(cursor, &u64, 8);
+    u32 = (uint32_t)events;
+    cursor = YM7128B_State_Put_(cursor, &u32, 4);
+    for (size_t i = 0; i < events; ++i) {
+        YM7128B_WriteEvent const* event = &queue->events_[queue->head_ + i];
+        u64 = (uint64_t)event->offset;
+        cursor = YM7128B_State_Put_(cursor, &u64, 8);
+        *cursor++ = (uint8_t)event->address;
+        *cursor++ = (uint8_t)event->data;
+    }
+
+    for (size_t i = 0; i < view->interpolators; ++i) {
+        *cursor++ = (uint8_t)*view->indices[i];
+        cursor = YM7128B_State_Put_(cursor, view->histories[i],
+                                    YM7128B_Interpolator_Buffer_Length * view->sample_size);
+    }
+
+    // Delay samples by age, in up to two contiguous spans of the ring
+    if (count) {
+        uint8_t const* samples = (uint8_t const*)view->buffer;
+        size_t first = view->capacity - view->tail;
+        if (first > count) {
+            first = count;
+        }
+        cursor = YM7128B_State_Put_(cursor, &samples[view->tail * view->sample_size],
+                                    first * view->sample_size);
+        cursor = YM7128B_State_Put_(cursor, samples, (count - first) * view->sample_size);
+    }
+
+    assert((size_t)(cursor - (uint8_t*)buffer) == total);
+    return total;
+}
+
+// ----------------------------------------------------------------------------
+
+// Validates the snapshot as a whole, before changing anything; the delay
+// line, feedback, queue and interpolators are then restored in place, while
+// tail and silence are returned within the view, and registers apart.
+static bool YM7128B_State_Load_(
+    YM7128B_StateView_* view,
+    void const* buffer,
+    size_t size,
+    YM7128B_Register regs[YM7128B_Reg_Count]
+)
+{
+    if (!buffer || (size < YM7128B_State_Header_Size)) {
+        return false;
+    }
+
+    uint8_t const* cursor = (uint8_t const*)buffer;
+    if (memcmp(cursor, YM7128B_State_Magic, sizeof(YM7128B_State_Magic)) ||
+        (cursor[4] != (uint8_t)YM7128B_STATE_VERSION) ||
+        (cursor[5] != (uint8_t)view->engine) ||
+        (cursor[6] & ~YM7128B_State_Flag_Delta) ||
+        (cursor[7] != (uint8_t)view->sample_size)) {
+        return false;
+    }
+    bool delta = (cursor[6] & YM7128B_State_Flag_Delta) != 0;
+    cursor += 8;
+
+    uint32_t u32;
+    cursor = YM7128B_State_Get_(cursor, &u32, 4);
+    size_t length = view->length;
+    if (u32 != (uint32_t)length) {
+        return false;
+    }
+    cursor = YM7128B_State_Get_(cursor, &u32, 4);
+    size_t count = u32;
+    if (delta ? (count >= length) : (count != length)) {
+        return false;
+    }
+
+    size_t fixed = YM7128B_State_Size_(view->sample_size, 0, 0, 0);
+    if (size < fixed) {
+        return false;
+    }
+    uint8_t const* events_field = (uint8_t const*)buffer + (fixed - 4);
+    memcpy(&u32, events_field, 4);
+    size_t events = u32;
+    if ((events > YM7128B_WRITE_QUEUE_LENGTH) ||
+        (size != YM7128B_State_Size_(view->sample_size, view->interpolators, events, count))) {
+        return false;
+    }
+
+    cursor = YM7128B_State_Get_(cursor, regs, YM7128B_Reg_Count);
+    cursor = YM7128B_State_Get_(cursor, &u32, 4);
+    size_t tail = u32;
+    cursor = YM7128B_State_Get_(cursor, &u32, 4);
+    size_t silence = u32;
+    size_t capacity = view->capacity;
+    if (length ? ((tail >= capacity) || (silence > length)) : (tail || silence)) {
+        return false;
+    }
+    // A delta must follow the snapshot the chip is currently at
+    if (delta && (((tail + count) % capacity) != view->tail)) {
+        return false;
+    }
+    uint8_t const* indices = cursor + view->sample_size + 1 + 8 + 4 + (events * YM7128B_State_Event_Size);
+    for (size_t i = 0; i < view->interpolators; ++i) {
+        if (indices[i * (1 + (YM7128B_Interpolator_Buffer_Length * view->sample_size))] >=
+            YM7128B_Interpolator_Length) {
+            return false;
+        }
+    }
+
+    // Valid snapshot: restore it
+    view->tail = tail;
+    view->silence = silence;
+    cursor = YM7128B_State_Get_(cursor, view->t0_d, view->sample_size);
+
+    YM7128B_WriteQueue* queue = view->queue;
+    queue->pacing_ = (*cursor++ != 0);
+    uint64_t u64;
+    cursor = YM7128B_State_Get_(cursor, &u64, 8);
+    queue->busy_ = (uint_fast64_t)u64;
+    cursor += 4;
+    queue->head_ = 0;
+    queue->count_ = events;
+    for (size_t i = 0; i < events; ++i) {
+        YM7128B_WriteEvent* event = &queue->events_[i];
+        cursor = YM7128B_State_Get_(cursor, &u64, 8);
+        event->offset = (size_t)u64;
+        event->address = (YM7128B_Address)*cursor++;
+        event->data = (YM7128B_Register)*cursor++;
+    }
+
+    for (size_t i = 0; i < view->interpolators; ++i) {
+        *view->indices[i] = (YM7128B_Oversampler_Index)*cursor++;
+        cursor = YM7128B_State_Get_(cursor, view->histories[i],
+                                    YM7128B_Interpolator_Buffer_Length * view->sample_size);
+    }
+
+    if (count) {
+        uint8_t* samples = (uint8_t*)view->buffer;
+        size_t first = capacity - tail;
+        if (first > count) {
+            first = count;
+        }
+        cursor = YM7128B_State_Get_(cursor, &samples[tail * view->sample_size],
+                                    first * view->sample_size);
+        cursor = YM7128B_State_Get_(cursor, samples, (count - first) * view->sample_size);
+    }
+
+    assert((size_t)(cursor - (uint8_t const*)buffer) == size);
+    return true;
+}
+
+// ============================================================================
+
+// Gains of the twentieths of a decade, to convert decibels without libm
+static double const YM7128B_Decibel_Table_[20] =
+{
+    1.0,
+    1.1220184543019633,
+    1.2589254117941673,
+    1.4125375446227544,
+    1.5848931924611136,
+    1.7782794100389228,
+    1.9952623149688795,
+    2.2387211385683394,
+    2.5118864315095800,
+    2.8183829312644537,
+    3.1622776601683795,
+    3.5481338923357550,
+    3.9810717055349722,
+    4.4668359215096320,
+    5.0118723362727220,
+    5.6234132519034910,
+    6.3095734448019330,
+    7.0794578438413790,
+    7.9432823472428160,
+    8.9125093813374540
+};
+
+static double YM7128B_DecibelToGain_(int db)
+{
+    if (db <= -YM7128B_OutputStage_Muted_dB || db >= YM7128B_OutputStage_Muted_dB) {
+        return 0;
+    }
+    int n = (db < 0) ? -db : db;
+    double gain = YM7128B_Decibel_Table_[n % 20];
+    for (n /= 20; n; --n) {
+        gain *= 10;
+    }
+    return (db < 0) ? (1 / gain) : gain;
+}
+
+// Converts a gain to Q12; returns false if it does not fit, leaving zero
+static bool YM7128B_GainToOutputFixed_(double gain, YM7128B_Fixed* fixed)
+{
+    double scaled = (gain * (double)(1 << YM7128B_OutputStage_Decimals)) + 0.5;
+    if (scaled > (double)YM7128B_Fixed_Max) {
+        *fixed = 0;
+        return false;
+    }
+    *fixed = (YM7128B_Fixed)scaled;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_OutputStage_Setup(
+    YM7128B_OutputStage* self,
+    int dry_db,
+    int wet_db
+)
+{
+    assert(self);
+
+    double dry = YM7128B_DecibelToGain_(dry_db);
+    double wet = YM7128B_DecibelToGain_(wet_db);
+    self->dry = (YM7128B_Float)dry;
+    self->wet = (YM7128B_Float)wet;
+    bool dry_fits = YM7128B_GainToOutputFixed_(dry, &self->dry_fixed);
+    bool wet_fits = YM7128B_GainToOutputFixed_(wet, &self->wet_fixed);
+    self->fixed = dry_fits && wet_fits;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t YM7128B_OutputFormat_GetSize(YM7128B_OutputFormat format)
+{
+    switch (format) {
+    case YM7128B_OutputFormat_S16: return sizeof(int16_t);
+    case YM7128B_OutputFormat_F32: return sizeof(float);
+    default: return 0;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+// Saturates a full-scale sample into S16, as per the pipe encoders;
+// NaN maps to the minimum
+YM7128B_FORCE_INLINE
+int16_t YM7128B_FloatToS16_(YM7128B_Float sample)
+{
+    double scaled = (double)sample * -(double)INT16_MIN;
+    if (!(scaled >= (double)INT16_MIN)) {
+        return INT16_MIN;
+    }
+    if (scaled > (double)INT16_MAX) {
+        return INT16_MAX;
+    }
+    return (int16_t)scaled;
+}
+
+// Saturates a Q15 sum of Q12 gained samples into S16
+YM7128B_FORCE_INLINE
+int16_t YM7128B_FixedToS16_(YM7128B_Accumulator sum)
+{
+    sum >>= YM7128B_OutputStage_Decimals;
+    if (sum < INT16_MIN) {
+        return INT16_MIN;
+    }
+    if (sum > INT16_MAX) {
+        return INT16_MAX;
+    }
+    return (int16_t)sum;
+}
+
+// Mixes fixed point dry inputs with <tt>ratio</tt> wet outputs each; the dry
+// term is computed once, for both channels of all of its output frames.
+// Gains beyond Q12 mix in floating point, saturating only at the output.
+YM7128B_FORCE_INLINE
+void YM7128B_OutputStage_MixFixed_(
+    YM7128B_OutputStage const* self,
+    YM7128B_Fixed const* inputs,
+    size_t count,
+    size_t ratio,
+    YM7128B_Fixed const* outputs_left,
+    YM7128B_Fixed const* outputs_right,
+    YM7128B_OutputFormat format,
+    void* frames
+)
+{
+    if ((format == YM7128B_OutputFormat_S16) && self->fixed) {
+        int16_t* dst = (int16_t*)frames;
+        YM7128B_Accumulator const dry_gain = self->dry_fixed;
+        YM7128B_Accumulator const wet_gain = self->wet_fixed;
+        YM7128B_Accumulator const half = (YM7128B_Accumulator)1 << (YM7128B_OutputStage_Decimals - 1);
+
+        for (size_t i = 0; i < count; ++i) {
+            YM7128B_Accumulator dry = ((YM7128B_Accumulator)inputs[i] * dry_gain) + half;
+            for (size_t j = 0; j < ratio; ++j) {
+                size_t k = (i * ratio) + j;
+                YM7128B_Accumulator left = dry + ((YM7128B_Accumulator)outputs_left[k] * wet_gain);
+                YM7128B_Accumulator right = dry + ((YM7128B_Accumulator)outputs_right[k] * wet_gain);
+                *dst++ = YM7128B_FixedToS16_(left);
+                *dst++ = YM7128B_FixedToS16_(right);
+            }
+        }
+    }
+    else if (format == YM7128B_OutputFormat_S16) {
+        int16_t* dst = (int16_t*)frames;
+        YM7128B_Float const k = ((YM7128B_Float)1 / (YM7128B_Float)YM7128B_Fixed_Max);
+
+        for (size_t i = 0; i < count; ++i) {
+            YM7128B_Float dry = ((YM7128B_Float)inputs[i] * k) * self->dry;
+            for (size_t j = 0; j < ratio; ++j) {
+                size_t o = (i * ratio) + j;
+                *dst++ = YM7128B_FloatToS16_(dry + (((YM7128B_Float)outputs_left[o] * k) * self->wet));
+                *dst++ = YM7128B_FloatToS16_(dry + (((YM7128B_Float)outputs_right[o] * k) * self->wet));
+            }
+        }
+    }
+    else {
+        float* dst = (float*)frames;
+        YM7128B_Float const k = ((YM7128B_Float)1 / (YM7128B_Float)YM7128B_Fixed_Max);
+
+        for (size_t i = 0; i < count; ++i) {
+            YM7128B_Float dry = ((YM7128B_Float)inputs[i] * k) * self->dry;
+            for (size_t j = 0; j < ratio; ++j) {
+                size_t o = (i * ratio) + j;
+                *dst++ = (float)(dry + (((YM7128B_Float)outputs_left[o] * k) * self->wet));
+                *dst++ = (float)(dry + (((YM7128B_Float)outputs_right[o] * k) * self->wet));
+            }
+        }
+    }
+}
+
+// Mixes floating point dry inputs with <tt>ratio</tt> wet outputs each
+YM7128B_FORCE_INLINE
+void YM7128B_OutputStage_MixFloat_(
+    YM7128B_OutputStage const* self,
+    YM7128B_Float const* inputs,
+    size_t count,
+    size_t ratio,
+    YM7128B_Float const* outputs_left,
+    YM7128B_Float const* outputs_right,
+    YM7128B_OutputFormat format,
+    void* frames
+)
+{
+    if (format == YM7128B_OutputFormat_S16) {
+        int16_t* dst = (int16_t*)frames;
+
+        for (size_t i = 0; i < count; ++i) {
+            YM7128B_Float dry = inputs[i] * self->dry;
+            for (size_t j = 0; j < ratio; ++j) {
+                size_t k = (i * ratio) + j;
+                *dst++ = YM7128B_FloatToS16_(dry + (outputs_left[k] * self->wet));
+                *dst++ = YM7128B_FloatToS16_(dry + (outputs_right[k] * self->wet));
+            }
+        }
+    }
+    else {
+        float* dst = (float*)frames;
+
+        for (size_t i = 0; i < count; ++i) {
+            YM7128B_Float dry = inputs[i] * self->dry;
+            for (size_t j = 0; j < ratio; ++j) {
+                size_t k = (i * ratio) + j;
+                *dst++ = (float)(dry + (outputs_left[k] * self->wet));
+                *dst++ = (float)(dry + (outputs_right[k] * self->wet));
+            }
+        }
+    }
+}
+
+// ============================================================================
+
+// Patch flags, from the gains which are zero
+static unsigned YM7128B_Patch_Flags_(bool const zero[YM7128B_Reg_T0])
+{
+    unsigned flags = 0;
+
+    if (zero[YM7128B_Reg_VC] || (zero[YM7128B_Reg_C0] && zero[YM7128B_Reg_C1])) {
+        flags |= YM7128B_PatchFlag_NoFeedback;
+    }
+    if (zero[YM7128B_Reg_VM]) {
+        flags |= YM7128B_PatchFlag_NoInput;
+    }
+
+    bool left = true;
+    bool right = true;
+    for (YM7128B_Register lane = 0; lane < YM7128B_Gain_Lane_Count; ++lane) {
+        left = left && zero[YM7128B_Reg_GL1 + lane];
+        right = right && zero[YM7128B_Reg_GR1 + lane];
+        if (zero[YM7128B_Reg_GL1 + lane] && zero[YM7128B_Reg_GR1 + lane]) {
+            flags |= YM7128B_PatchFlag_Sparse;
+        }
+    }
+    if (left || zero[YM7128B_Reg_VL]) {
+        flags |= YM7128B_PatchFlag_LeftZero;
+    }
+    if (right || zero[YM7128B_Reg_VR]) {
+        flags |= YM7128B_PatchFlag_RightZero;
+    }
+    return flags;
+}
+
+// ----------------------------------------------------------------------------
+
+// Lists the output taps with any gain which is not zero; returns their count
+static YM7128B_Register YM7128B_Patch_Lanes_(
+    bool const zero[YM7128B_Reg_T0],
+    YM7128B_Register lanes[YM7128B_Gain_Lane_Count]
+)
+{
+    YM7128B_Register count = 0;
+
+    for (YM7128B_Register lane = 0; lane < YM7128B_Gain_Lane_Count; ++lane) {
+        if (!zero[YM7128B_Reg_GL1 + lane] || !zero[YM7128B_Reg_GR1 + lane]) {
+            lanes[count++] = lane;
+        }
+    }
+    return count;
+}
+
+// ----------------------------------------------------------------------------
+
+// Masks the unused bits off a register image
+static void YM7128B_Patch_MaskRegs_(
+    YM7128B_Register masked[YM7128B_Reg_Count],
+    YM7128B_Register const regs[YM7128B_Reg_Count]
+)
+{
+    for (YM7128B_Address i = 0; i < YM7128B_Reg_Count; ++i) {
+        YM7128B_Register data = regs[i];
+        if (i < YM7128B_Reg_C0) {
+            masked[i] = data & YM7128B_Gain_Data_Mask;
+        }
+        else if (i < YM7128B_Reg_T0) {
+            masked[i] = data & YM7128B_Coeff_Value_Mask;
+        }
+        else {
+            masked[i] = data & YM7128B_Tap_Value_Mask;
+        }
+    }
+}
+
+// ============================================================================
+
+static void YM7128B_PatchFixed_Write_(
+    YM7128B_PatchFixed* self,
+    YM7128B_Address address,
+    YM7128B_Register data
+)
+{
+    if (address < YM7128B_Reg_C0) {
+        self->regs_[address] = data & YM7128B_Gain_Data_Mask;
+        self->gains_[address] = YM7128B_RegisterToGainFixed(data);
+    }
+    else if (address < YM7128B_Reg_T0) {
+        self->regs_[address] = data & YM7128B_Coeff_Value_Mask;
+        self->gains_[address] = YM7128B_RegisterToCoeffFixed(data);
+    }
+    else {
+        self->regs_[address] = data & YM7128B_Tap_Value_Mask;
+        self->taps_[address - YM7128B_Reg_T0] = YM7128B_RegisterToTap(data);
+        return;
+    }
+
+    bool zero[YM7128B_Reg_T0];
+    for (YM7128B_Address i = 0; i < YM7128B_Reg_T0; ++i) {
+        zero[i] = (self->gains_[i] == 0);
+    }
+    self->flags_ = YM7128B_Patch_Flags_(zero);
+    self->lane_count_ = YM7128B_Patch_Lanes_(zero, self->lanes_);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_PatchFixed_Setup(
+    YM7128B_PatchFixed* self,
+    YM7128B_Register const regs[YM7128B_Reg_Count]
+)
+{
+    assert(self);
+    assert(regs);
+
+    for (YM7128B_Address i = YM7128B_Address_Min; i <= YM7128B_Address_Max; ++i) {
+        YM7128B_PatchFixed_Write_(self, i, regs[i]);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+static YM7128B_PatchFixed const* YM7128B_ChipFixed_Patch_(YM7128B_ChipFixed const* self)
+{
+    return self->patch_ ? self->patch_ : &self->own_;
+}
+
+// ----------------------------------------------------------------------------
+
+// Copies the shared patch, if any, so that the chip owns its registers
+static YM7128B_PatchFixed* YM7128B_ChipFixed_OwnPatch_(YM7128B_ChipFixed* self)
+{
+    if (self->patch_) {
+        self->own_ = *self->patch_;
+        self->patch_ = NULL;
+    }
+    return &self->own_;
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFixed_Ctor(YM7128B_ChipFixed* self)
+{
+    assert(self);
+
+    self->patch_ = NULL;
+    self->mailbox_ = NULL;
+    YM7128B_ChipFixed_ResetStats(self);
+    self->kernel_ = YM7128B_Kernel_GetBest();
+    self->filter_ = YM7128B_Filter_Default;
+    self->silence_ = 0;
+    self->written_ = YM7128B_Buffer_Length;
+
+    YM7128B_WriteQueue_Clear(&self->queue_);
+    self->queue_.pacing_ = false;
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFixed_Dtor(YM7128B_ChipFixed* self)
+{
+    (void)self;
+    assert(self);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFixed_Reset(YM7128B_ChipFixed* self)
+{
+    assert(self);
+
+    for (YM7128B_Address i = YM7128B_Address_Min; i <= YM7128B_Address_Max; ++i) {
+        YM7128B_ChipFixed_Write(self, i, 0x00);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFixed_Start(YM7128B_ChipFixed* self)
+{
+    assert(self);
+
+    self->t0_d_ = 0;
+
+    self->tail_ = 0;
+    self->silence_ = YM7128B_Buffer_Capacity;
+    self->written_ = YM7128B_Buffer_Length;
+
+    YM7128B_WriteQueue_Clear(&self->queue_);
+
+    for (YM7128B_Tap i = 0; i < YM7128B_Buffer_Capacity; ++i) {
+        self->buffer_[i] = 0;
+    }
+
+    for (YM7128B_Oversampler_Index i = 0; i < YM7128B_OutputChannel_Count; ++i) {
+        YM7128B_InterpolatorFixed_Reset(&self->oversampler_[i]);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFixed_Stop(YM7128B_ChipFixed* self)
+{
+    (void)self;
+    assert(self);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFixed_Process(
+    YM7128B_ChipFixed* self,
+    YM7128B_ChipFixed_Process_Data* data
+)
+{
+    assert(self);
+    assert(data);
+
+    YM7128B_ChipFixed_ProcessBlock(
+        self,
+        &data->inputs[YM7128B_InputChannel_Mono],
+        1,
+        &data->outputs[YM7128B_OutputChannel_Left][0],
+        &data->outputs[YM7128B_OutputChannel_Right][0]
+    );
+}
+
+// ----------------------------------------------------------------------------
+
+typedef void (*YM7128B_MixFixed_Func)(
+    YM7128B_Fixed const samples[YM7128B_Gain_Lane_Count],
+    YM7128B_Fixed const gains[YM7128B_OutputChannel_Count * YM7128B_Gain_Lane_Count],
+    YM7128B_Accumulator accums[YM7128B_OutputChannel_Count]
+);
+
+typedef void (*YM7128B_InterpolateFixed_Func)(
+    YM7128B_InterpolatorFixed* self,
+    YM7128B_Fixed const coeffs[YM7128B_Oversampler_Factor][YM7128B_Interpolator_Stride],
+    YM7128B_Fixed input,
+    YM7128B_Fixed outputs[YM7128B_Oversampler_Factor]
+);
+
+// ----------------------------------------------------------------------------
+
+// Specialized by the patch: without feedback, the filter is skipped;
+// when sparse, only the output taps not silent are gathered.
+// Both keep the results exactly the same, as the skipped terms are zero.
+// Native outputs skip the interpolator, one per input sample, for resampling.
+YM7128B_FORCE_INLINE
+void YM7128B_ChipFixed_ProcessBlock_(
+    YM7128B_ChipFixed* self,
+    YM7128B_Fixed const* inputs,
+    size_t count,
+    YM7128B_Fixed* outputs_left,
+    YM7128B_Fixed* outputs_right,
+    YM7128B_MixFixed_Func mix,
+    YM7128B_InterpolateFixed_Func interpolate,
+    bool feedback,
+    bool sparse,
+    bool native
+)
+{
+    YM7128B_Fixed* outputs[YM7128B_OutputChannel_Count];
+    outputs[YM7128B_OutputChannel_Left] = outputs_left;
+    outputs[YM7128B_OutputChannel_Right] = outputs_right;
+
+    YM7128B_PatchFixed const* patch = YM7128B_ChipFixed_Patch_(self);
+    YM7128B_Fixed const (*coeffs)[YM7128B_Interpolator_Stride] = YM7128B_InterpolatorFixed_Kernels[self->filter_];
+    YM7128B_Tap tail = self->tail_;
+    YM7128B_Fixed t0_d = self->t0_d_;
+    size_t silence = self->silence_;
+    YM7128B_STATS(
+        YM7128B_Stats* stats = &self->stats_;
+        YM7128B_Accumulator lane_peaks[YM7128B_Gain_Lane_Count] = { 0 };
+        YM7128B_Accumulator output_peaks[YM7128B_OutputChannel_Count] = { 0 };
+        uint64_t cycles = YM7128B_Stats_Cycles_();
+    )
+
+    // Silent output taps are not gathered, their samples staying at zero
+    YM7128B_Register lane_count = patch->lane_count_;
+    YM7128B_Fixed samples[YM7128B_Gain_Lane_Count] = { 0 };
+
+    for (size_t index = 0; index < count; ++index) {
+        YM7128B_Fixed input = inputs[index];
+        YM7128B_Fixed sample = input & (YM7128B_Fixed)YM7128B_Signal_Mask;
+
+        YM7128B_Tap t0 = tail + patch->taps_[0];
+        YM7128B_Tap filter_head  = YM7128B_Buffer_Wrap_(t0);
+        YM7128B_Fixed filter_t0  = self->buffer_[filter_head];
+        YM7128B_Fixed filter_d   = t0_d;
+        t0_d = filter_t0;
+        YM7128B_Fixed filter_vc  = 0;
+        if (feedback) {
+            YM7128B_Fixed filter_c0  = YM7128B_MulFixed(filter_t0, patch->gains_[YM7128B_Reg_C0]);
+            YM7128B_Fixed filter_c1  = YM7128B_MulFixed(filter_d, patch->gains_[YM7128B_Reg_C1]);
+            YM7128B_Fixed filter_sum = YM7128B_ClampAddFixed(filter_c0, filter_c1);
+            YM7128B_STATS(stats->feedback_clamps += YM7128B_Stats_ClampsAddFixed_(filter_c0, filter_c1);)
+            filter_vc = YM7128B_MulFixed(filter_sum, patch->gains_[YM7128B_Reg_VC]);
+        }
+
+        YM7128B_Fixed input_vm  = YM7128B_MulFixed(sample, patch->gains_[YM7128B_Reg_VM]);
+        YM7128B_Fixed input_sum = YM7128B_ClampAddFixed(input_vm, filter_vc);
+
+        tail = YM7128B_Buffer_Wrap_(tail + (YM7128B_Buffer_Capacity - 1));
+        self->buffer_[tail] = input_sum;
+        silence = (input_sum != 0) ? 0 : (silence + 1);
+        YM7128B_STATS(
+            stats->feedback_clamps += YM7128B_Stats_ClampsAddFixed_(input_vm, filter_vc);
+            cycles = YM7128B_Stats_Lap_(stats, YM7128B_Stage_Feedback, cycles);
+        )
+
+        if (sparse) {
+            for (YM7128B_Register i = 0; i < lane_count; ++i) {
+                YM7128B_Register lane = patch->lanes_[i];
+                YM7128B_Tap t = tail + patch->taps_[lane + 1];
+                YM7128B_Tap head = YM7128B_Buffer_Wrap_(t);
+                samples[lane] = self->buffer_[head];
+            }
+        }
+        else {
+            for (YM7128B_Register tap = 1; tap < YM7128B_Tap_Count; ++tap) {
+                YM7128B_Tap t = tail + patch->taps_[tap];
+                YM7128B_Tap head = YM7128B_Buffer_Wrap_(t);
+                samples[tap - 1] = self->buffer_[head];
+            }
+        }
+
+        YM7128B_STATS(
+            for (YM7128B_Register lane = 0; lane < YM7128B_Gain_Lane_Count; ++lane) {
+                YM7128B_Stats_PeakFixed_(&lane_peaks[lane], samples[lane]);
+            }
+        )
+
+        YM7128B_Accumulator accums[YM7128B_OutputChannel_Count];
+        mix(samples, &patch->gains_[YM7128B_Reg_GL1], accums);
+        YM7128B_STATS(cycles = YM7128B_Stats_Lap_(stats, YM7128B_Stage_Mix, cycles);)
+
+        for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+            YM7128B_Fixed total = YM7128B_ClampFixed(accums[channel]);
+            YM7128B_Fixed v = patch->gains_[YM7128B_Reg_VL + channel];
+            YM7128B_Fixed total_v = YM7128B_MulFixed(total, v);
+            YM7128B_STATS(stats->output_clamps += YM7128B_Stats_ClampsFixed_(accums[channel]);)
+            YM7128B_STATS(YM7128B_Stats_PeakFixed_(&output_peaks[channel], total_v);)
+
+            if (native) {
+                outputs[channel][index] = total_v;
+            }
+            else {
+                YM7128B_InterpolatorFixed* oversampler = &self->oversampler_[channel];
+                YM7128B_Fixed* output = &outputs[channel][index * YM7128B_Oversampling];
+
+                interpolate(oversampler, coeffs, total_v, output);
+            }
+        }
+        YM7128B_STATS(cycles = YM7128B_Stats_Lap_(stats, YM7128B_Stage_Oversampler, cycles);)
+    }
+
+    self->tail_ = tail;
+    self->t0_d_ = t0_d;
+    self->silence_ = silence;
+    YM7128B_STATS(YM7128B_Stats_MergeFixed_(stats, lane_peaks, output_peaks);)
+}
+
+// ----------------------------------------------------------------------------
+
+#define YM7128B_CHIPFIXED_PROCESSBLOCK(name, isa, suffix, native) \
+    static isa void YM7128B_ChipFixed_##suffix##_##name( \
+        YM7128B_ChipFixed* self, \
+        YM7128B_Fixed const* inputs, \
+        size_t count, \
+        YM7128B_Fixed* outputs_left, \
+        YM7128B_Fixed* outputs_right \
+    ) \
+    { \
+        unsigned flags = YM7128B_ChipFixed_Patch_(self)->flags_; \
+        bool feedback = !(flags & YM7128B_PatchFlag_NoFeedback); \
+        bool sparse = !!(flags & YM7128B_PatchFlag_Sparse); \
+        if (feedback) { \
+            if (sparse) { \
+                YM7128B_ChipFixed_ProcessBlock_( \
+                    self, inputs, count, outputs_left, outputs_right, \
+                    YM7128B_MixFixed_##name, YM7128B_InterpolateFixed_##name, true, true, native \
+                ); \
+            } \
+            else { \
+                YM7128B_ChipFixed_ProcessBlock_( \
+                    self, inputs, count, outputs_left, outputs_right, \
+                    YM7128B_MixFixed_##name, YM7128B_InterpolateFixed_##name, true, false, native \
+                ); \
+            } \
+        } \
+        else { \
+            if (sparse) { \
+                YM7128B_ChipFixed_ProcessBlock_( \
+                    self, inputs, count, outputs_left, outputs_right, \
+                    YM7128B_MixFixed_##name, YM7128B_InterpolateFixed_##name, false, true, native \
+                ); \
+            } \
+            else { \
+                YM7128B_ChipFixed_ProcessBlock_( \
+                    self, inputs, count, outputs_left, outputs_right, \
+                    YM7128B_MixFixed_##name, YM7128B_InterpolateFixed_##name, false, false, native \
+                ); \
+            } \
+        } \
+    }
+
+YM7128B_CHIPFIXED_PROCESSBLOCK(Scalar, , ProcessBlock, false)
+YM7128B_CHIPFIXED_PROCESSBLOCK(Scalar, , ProcessNative, true)
+#if YM7128B_SIMD_X86
+YM7128B_CHIPFIXED_PROCESSBLOCK(SSE2, YM7128B_TARGET("sse2"), ProcessBlock, false)
+YM7128B_CHIPFIXED_PROCESSBLOCK(SSE2, YM7128B_TARGET("sse2"), ProcessNative, true)
+YM7128B_CHIPFIXED_PROCESSBLOCK(AVX2, YM7128B_TARGET("avx2"), ProcessBlock, false)
+YM7128B_CHIPFIXED_PROCESSBLOCK(AVX2, YM7128B_TARGET("avx2"), ProcessNative, true)
+#endif
+#if YM7128B_SIMD_NEON
+YM7128B_CHIPFIXED_PROCESSBLOCK(NEON, , ProcessBlock, false)
+YM7128B_CHIPFIXED_PROCESSBLOCK(NEON, , ProcessNative, true)
+#endif
+
+#undef YM7128B_CHIPFIXED_PROCESSBLOCK
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipFixed_IsIdle(YM7128B_ChipFixed const* self)
+{
+    assert(self);
+
+    if ((self->silence_ < YM7128B_Buffer_Length) || (self->t0_d_ != 0)) {
+        return false;
+    }
+
+    for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+        if (!YM7128B_InterpolatorFixed_IsClear_(&self->oversampler_[channel])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFixed_GetStats(
+    YM7128B_ChipFixed const* self,
+    YM7128B_Stats* stats
+)
+{
+    assert(self);
+    assert(stats);
+
+#if YM7128B_USE_STATS
+    *stats = self->stats_;
+#else
+    (void)self;
+    memset(stats, 0, sizeof(*stats));
+#endif
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFixed_ResetStats(YM7128B_ChipFixed* self)
+{
+    (void)self;
+    assert(self);
+
+    YM7128B_STATS(memset(&self->stats_, 0, sizeof(self->stats_));)
+}
+
+// ----------------------------------------------------------------------------
+
+// Digital silence fast path: while idle, silent input samples just advance
+// the delay line and the interpolators, yielding silent outputs, <tt>ratio</tt>
+// per input sample.
+// Returns the number of processed input samples.
+static size_t YM7128B_ChipFixed_ProcessIdle_(
+    YM7128B_ChipFixed* self,
+    YM7128B_Fixed const* inputs,
+    size_t count,
+    YM7128B_Fixed* outputs_left,
+    YM7128B_Fixed* outputs_right,
+    size_t ratio
+)
+{
+    if (!count || !YM7128B_ChipFixed_IsIdle(self)) {
+        return 0;
+    }
+
+    size_t idle = 0;
+    while ((idle < count) && !(inputs[idle] & (YM7128B_Fixed)YM7128B_Signal_Mask)) {
+        ++idle;
+    }
+
+    for (size_t i = 0; i < idle * ratio; ++i) {
+        outputs_left[i] = 0;
+        outputs_right[i] = 0;
+    }
+
+    // Samples older than the nominal length may linger in the spare capacity:
+    // clear those coming back into view, as the processing loop would do
+    size_t spare = 0;
+    if (self->silence_ < YM7128B_Buffer_Capacity) {
+        spare = YM7128B_Buffer_Capacity - self->silence_;
+        if (spare > idle) {
+            spare = idle;
+        }
+    }
+    for (size_t i = 0; i < spare; ++i) {
+        self->tail_ = YM7128B_Buffer_Wrap_(self->tail_ + (YM7128B_Buffer_Capacity - 1));
+        self->buffer_[self->tail_] = 0;
+    }
+    self->tail_ = (YM7128B_Tap)YM7128B_Ring_Rewind_(self->tail_, idle - spare, YM7128B_Buffer_Capacity);
+    for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+        YM7128B_Oversampler_Index* index = &self->oversampler_[channel].index_;
+        *index = (YM7128B_Oversampler_Index)YM7128B_Ring_Rewind_(*index, idle, YM7128B_Interpolator_Length);
+    }
+    self->silence_ += idle;
+    YM7128B_STATS(self->stats_.idle_samples += idle;)
+    return idle;
+}
+
+// ----------------------------------------------------------------------------
+
+// Native outputs skip the interpolator, one per input sample
+static void YM7128B_ChipFixed_ProcessSpan_(
+    YM7128B_ChipFixed* self,
+    YM7128B_Fixed const* inputs,
+    size_t count,
+    YM7128B_Fixed* outputs_left,
+    YM7128B_Fixed* outputs_right,
+    bool native
+)
+{
+    assert(self);
+    assert(inputs || !count);
+    assert(outputs_left || !count);
+    assert(outputs_right || !count);
+
+    size_t ratio = native ? 1 : (size_t)YM7128B_Oversampling;
+    size_t idle = YM7128B_ChipFixed_ProcessIdle_(self, inputs, count, outputs_left, outputs_right, ratio);
+    inputs += idle;
+    count -= idle;
+    outputs_left += idle * ratio;
+    outputs_right += idle * ratio;
+
+    switch (self->kernel_)
+    {
+#if YM7128B_SIMD_X86
+    case YM7128B_Kernel_SSE2:
+        if (native) {
+            YM7128B_ChipFixed_ProcessNative_SSE2(self, inputs, count, outputs_left, outputs_right);
+        }
+        else {
+            YM7128B_ChipFixed_ProcessBlock_SSE2(self, inputs, count, outputs_left, outputs_right);
+        }
+        break;
+
+    case YM7128B_Kernel_AVX2:
+        if (native) {
+            YM7128B_ChipFixed_ProcessNative_AVX2(self, inputs, count, outputs_left, outputs_right);
+        }
+        else {
+            YM7128B_ChipFixed_ProcessBlock_AVX2(self, inputs, count, outputs_left, outputs_right);
+        }
+        break;
+#endif
+#if YM7128B_SIMD_NEON
+    case YM7128B_Kernel_NEON:
+        if (native) {
+            YM7128B_ChipFixed_ProcessNative_NEON(self, inputs, count, outputs_left, outputs_right);
+        }
+        else {
+            YM7128B_ChipFixed_ProcessBlock_NEON(self, inputs, count, outputs_left, outputs_right);
+        }
+        break;
+#endif
+    default:
+        if (native) {
+            YM7128B_ChipFixed_ProcessNative_Scalar(self, inputs, count, outputs_left, outputs_right);
+        }
+        else {
+            YM7128B_ChipFixed_ProcessBlock_Scalar(self, inputs, count, outputs_left, outputs_right);
+        }
+        break;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+// Takes the latest register image posted to the mailbox, if any
+static void YM7128B_ChipFixed_Receive_(YM7128B_ChipFixed* self)
+{
+    YM7128B_MailboxFixed* mailbox = self->mailbox_;
+
+    if (YM7128B_Mailbox_Acquire_(&mailbox->core_)) {
+        YM7128B_ChipFixed_SetPatch(self, &mailbox->slots_[mailbox->core_.front_]);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+// Processes a block, with native or interpolated outputs
+static void YM7128B_ChipFixed_Process_(
+    YM7128B_ChipFixed* self,
+    YM7128B_Fixed const* inputs,
+    size_t count,
+    YM7128B_Fixed* outputs_left,
+    YM7128B_Fixed* outputs_right,
+    bool native
+)
+{
+    size_t ratio = native ? 1 : (size_t)YM7128B_Oversampling;
+
+    if (self->mailbox_) {
+        YM7128B_ChipFixed_Receive_(self);
+    }
+
+    YM7128B_WriteQueue* queue = &self->queue_;
+    YM7128B_WriteEvent const* event;
+    size_t offset;
+    size_t done = 0;
+
+    while (YM7128B_WriteQueue_Peek(queue, count, &offset, &event)) {
+        if (offset > done) {
+            YM7128B_ChipFixed_ProcessSpan_(
+                self,
+                &inputs[done],
+                offset - done,
+                &outputs_left[done * ratio],
+                &outputs_right[done * ratio],
+                native
+            );
+            done = offset;
+        }
+        YM7128B_ChipFixed_Write(self, event->address, event->data);
+        YM7128B_WriteQueue_Pop(queue, offset, YM7128B_Input_Rate);
+    }
+
+    if (done < count) {
+        YM7128B_ChipFixed_ProcessSpan_(
+            self,
+            &inputs[done],
+            count - done,
+            &outputs_left[done * ratio],
+            &outputs_right[done * ratio],
+            native
+        );
+    }
+
+    YM7128B_WriteQueue_Advance(queue, count);
+    self->written_ += count;
+    YM7128B_STATS(self->stats_.samples += count;)
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFixed_ProcessBlock(
+    YM7128B_ChipFixed* self,
+    YM7128B_Fixed const* inputs,
+    size_t count,
+    YM7128B_Fixed* outputs_left,
+    YM7128B_Fixed* outputs_right
+)
+{
+    assert(self);
+    assert(inputs || !count);
+    assert(outputs_left || !count);
+    assert(outputs_right || !count);
+
+    YM7128B_ChipFixed_Process_(self, inputs, count, outputs_left, outputs_right, false);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFixed_ProcessBlockOutput(
+    YM7128B_ChipFixed* self,
+    YM7128B_OutputStage const* stage,
+    YM7128B_Fixed const* inputs,
+    size_t count,
+    YM7128B_OutputFormat format,
+    void* frames
+)
+{
+    assert(self);
+    assert(stage);
+    assert(inputs || !count);
+    assert(frames || !count);
+    assert(format < YM7128B_OutputFormat_Count);
+
+    // The wet outputs of each chunk stay in cache, for the mix to follow
+    YM7128B_Fixed outputs[YM7128B_OutputChannel_Count][YM7128B_OutputStage_Chunk * YM7128B_Oversampling];
+    size_t stride = YM7128B_OutputFormat_GetSize(format) * (YM7128B_Oversampling * YM7128B_OutputChannel_Count);
+    unsigned char* dst = (unsigned char*)frames;
+
+    while (count) {
+        size_t chunk = (count < YM7128B_OutputStage_Chunk) ? count : (size_t)YM7128B_OutputStage_Chunk;
+
+        YM7128B_ChipFixed_ProcessBlock(
+            self,
+            inputs,
+            chunk,
+            outputs[YM7128B_OutputChannel_Left],
+            outputs[YM7128B_OutputChannel_Right]
+        );
+        YM7128B_OutputStage_MixFixed_(
+            stage,
+            inputs,
+            chunk,
+            YM7128B_Oversampling,
+            outputs[YM7128B_OutputChannel_Left],
+            outputs[YM7128B_OutputChannel_Right],
+            format,
+            dst
+        );
+        inputs += chunk;
+        dst += chunk * stride;
+        count -= chunk;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+size_t YM7128B_ChipFixed_ProcessBlockResampled(
+    YM7128B_ChipFixed* self,
+    YM7128B_ResamplerFixed* resampler,
+    YM7128B_Fixed const* inputs,
+    size_t count,
+    YM7128B_Fixed* outputs_left,
+    YM7128B_Fixed* outputs_right
+)
+{
+    assert(self);
+    assert(resampler);
+    assert(inputs || !count);
+    assert(outputs_left || !count);
+    assert(outputs_right || !count);
+
+    // The native outputs of each chunk stay in cache, for the resampler
+    YM7128B_Fixed natives[YM7128B_OutputChannel_Count][YM7128B_OutputStage_Chunk];
+    size_t done = 0;
+
+    while (count) {
+        size_t chunk = (count < YM7128B_OutputStage_Chunk) ? count : (size_t)YM7128B_OutputStage_Chunk;
+
+        YM7128B_ChipFixed_Process_(
+            self,
+            inputs,
+            chunk,
+            natives[YM7128B_OutputChannel_Left],
+            natives[YM7128B_OutputChannel_Right],
+            true
+        );
+        done += YM7128B_ResamplerFixed_Process(
+            resampler,
+            natives[YM7128B_OutputChannel_Left],
+            natives[YM7128B_OutputChannel_Right],
+            chunk,
+            &outputs_left[done],
+            &outputs_right[done]
+        );
+        inputs += chunk;
+        count -= chunk;
+    }
+    return done;
+}
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipFixed_IsChunkable(YM7128B_ChipFixed const* self)
+{
+    assert(self);
+
+    return (YM7128B_ChipFixed_Patch_(self)->flags_ & YM7128B_PatchFlag_NoFeedback) != 0;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t YM7128B_ChipFixed_GetOverlap(YM7128B_ChipFixed const* self)
+{
+    (void)self;
+    assert(self);
+
+    return (size_t)YM7128B_Buffer_Length + (size_t)YM7128B_Oversampler_Length;
+}
+
+// ----------------------------------------------------------------------------
+
+// Feeds the delay line only, as the processing loop does with a silent
+// feedback path, for inputs whose outputs are not needed
+static void YM7128B_ChipFixed_Fill_(
+    YM7128B_ChipFixed* self,
+    YM7128B_Fixed const* inputs,
+    size_t count
+)
+{
+    YM7128B_PatchFixed const* patch = YM7128B_ChipFixed_Patch_(self);
+    YM7128B_Fixed const vm = patch->gains_[YM7128B_Reg_VM];
+    YM7128B_Tap tail = self->tail_;
+    YM7128B_Fixed t0_d = self->t0_d_;
+    size_t silence = self->silence_;
+
+    for (size_t index = 0; index < count; ++index) {
+        YM7128B_Fixed sample = inputs[index] & (YM7128B_Fixed)YM7128B_Signal_Mask;
+        t0_d = self->buffer_[YM7128B_Buffer_Wrap_(tail + patch->taps_[0])];
+
+        YM7128B_Fixed input_vm  = YM7128B_MulFixed(sample, vm);
+        YM7128B_Fixed input_sum = YM7128B_ClampAddFixed(input_vm, 0);
+
+        tail = YM7128B_Buffer_Wrap_(tail + (YM7128B_Buffer_Capacity - 1));
+        self->buffer_[tail] = input_sum;
+        silence = (input_sum != 0) ? 0 : (silence + 1);
+    }
+
+    self->tail_ = tail;
+    self->t0_d_ = t0_d;
+    self->silence_ = silence;
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFixed_Prime(
+    YM7128B_ChipFixed* self,
+    YM7128B_Fixed const* inputs,
+    size_t count
+)
+{
+    assert(self);
+    assert(inputs || !count);
+
+    YM7128B_ChipFixed_Start(self);
+
+    size_t overlap = YM7128B_ChipFixed_GetOverlap(self);
+    if (count > overlap) {
+        inputs += count - overlap;
+        count = overlap;
+    }
+
+    // Only the latest outputs reach the interpolator histories
+    size_t fill = (count > YM7128B_Interpolator_Length) ? (count - YM7128B_Interpolator_Length) : 0;
+    YM7128B_ChipFixed_Fill_(self, inputs, fill);
+
+    YM7128B_Fixed outputs[YM7128B_OutputChannel_Count][YM7128B_Interpolator_Length * YM7128B_Oversampling];
+    YM7128B_ChipFixed_ProcessSpan_(
+        self,
+        &inputs[fill],
+        count - fill,
+        outputs[YM7128B_OutputChannel_Left],
+        outputs[YM7128B_OutputChannel_Right],
+        false
+    );
+    self->written_ += count;
+}
+
+// ----------------------------------------------------------------------------
+
+// Parallel render of a stream, shared by its chunk jobs
+typedef struct YM7128B_ChipFixed_Render_
+{
+    YM7128B_ChipFixed* self;
+    YM7128B_ChipFixed* workers;  // by chunk, but the first
+    YM7128B_Fixed const* inputs;
+    size_t count;
+    YM7128B_Fixed* outputs_left;
+    YM7128B_Fixed* outputs_right;
+    size_t chunk_count;
+} YM7128B_ChipFixed_Render_;
+
+static void YM7128B_ChipFixed_RenderJob_(void* data, size_t index)
+{
+    YM7128B_ChipFixed_Render_ const* render = (YM7128B_ChipFixed_Render_ const*)data;
+    YM7128B_ChipFixed* chip = index ? &render->workers[index - 1] : render->self;
+    size_t begin = (size_t)(((uint_fast64_t)render->count * index) / render->chunk_count);
+    size_t end = (size_t)(((uint_fast64_t)render->count * (index + 1)) / render->chunk_count);
+
+    YM7128B_ChipFixed_Prime(chip, render->inputs, begin);
+    YM7128B_ChipFixed_ProcessBlock(
+        chip,
+        &render->inputs[begin],
+        end - begin,
+        &render->outputs_left[begin * YM7128B_Oversampling],
+        &render->outputs_right[begin * YM7128B_Oversampling]
+    );
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFixed_RenderChunks(
+    YM7128B_ChipFixed* self,
+    YM7128B_Fixed const* inputs,
+    size_t count,
+    YM7128B_Fixed* outputs_left,
+    YM7128B_Fixed* outputs_right,
+    size_t chunk_count,
+    YM7128B_RunJobs_Func run_jobs,
+    void* context
+)
+{
+    assert(self);
+    assert(inputs || !count);
+    assert(outputs_left || !count);
+    assert(outputs_right || !count);
+
+    // Registers are taken once, for the whole stream
+    struct YM7128B_MailboxFixed* mailbox = self->mailbox_;
+    if (mailbox) {
+        YM7128B_ChipFixed_Receive_(self);
+        self->mailbox_ = NULL;
+    }
+
+    // Chunks shorter than the overlap would be mostly priming
+    size_t overlap = YM7128B_ChipFixed_GetOverlap(self);
+    size_t chunk_limit = overlap ? (count / overlap) : count;
+    if (chunk_count > chunk_limit) {
+        chunk_count = chunk_limit;
+    }
+
+    YM7128B_ChipFixed* workers = NULL;
+    if ((chunk_count > 1) && run_jobs && YM7128B_ChipFixed_IsChunkable(self)) {
+        workers = (YM7128B_ChipFixed*)malloc((chunk_count - 1) * sizeof(YM7128B_ChipFixed));
+        if (workers) {
+            for (size_t i = 0; i < (chunk_count - 1); ++i) {
+                YM7128B_ChipFixed* worker = &workers[i];
+                YM7128B_ChipFixed_Ctor(worker);
+                YM7128B_ChipFixed_SetKernel(worker, self->kernel_);
+                YM7128B_ChipFixed_SetFilter(worker, self->filter_);
+                YM7128B_ChipFixed_SetPatch(worker, YM7128B_ChipFixed_Patch_(self));
+            }
+        }
+    }
+
+    if (workers) {
+        YM7128B_ChipFixed_Render_ render;
+        render.self = self;
+        render.workers = workers;
+        render.inputs = inputs;
+        render.count = count;
+        render.outputs_left = outputs_left;
+        render.outputs_right = outputs_right;
+        render.chunk_count = chunk_count;
+
+        run_jobs(context, chunk_count, YM7128B_ChipFixed_RenderJob_, &render);
+
+        for (size_t i = 0; i < (chunk_count - 1); ++i) {
+            YM7128B_ChipFixed_Dtor(&workers[i]);
+        }
+        free(workers);
+        YM7128B_ChipFixed_Prime(self, inputs, count);
+    }
+    else {
+        YM7128B_ChipFixed_Start(self);
+        YM7128B_ChipFixed_ProcessBlock(self, inputs, count, outputs_left, outputs_right);
+    }
+
+    self->mailbox_ = mailbox;
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_Register YM7128B_ChipFixed_Read(
+    YM7128B_ChipFixed const* self,
+    YM7128B_Address address
+)
+{
+    assert(self);
+
+    YM7128B_PatchFixed const* patch = YM7128B_ChipFixed_Patch_(self);
+
+    if (address < YM7128B_Reg_C0) {
+        return patch->regs_[address] & YM7128B_Gain_Data_Mask;
+    }
+    else if (address < YM7128B_Reg_T0) {
+        return patch->regs_[address] & YM7128B_Coeff_Value_Mask;
+    }
+    else if (address < YM7128B_Reg_Count) {
+        return patch->regs_[address] & YM7128B_Tap_Value_Mask;
+    }
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFixed_Write(
+    YM7128B_ChipFixed* self,
+    YM7128B_Address address,
+    YM7128B_Register data
+)
+{
+    assert(self);
+
+    if (address < YM7128B_Reg_Count) {
+        YM7128B_PatchFixed* patch = YM7128B_ChipFixed_OwnPatch_(self);
+        YM7128B_PatchFixed_Write_(patch, address, data);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFixed_SetPatch(
+    YM7128B_ChipFixed* self,
+    YM7128B_PatchFixed const* patch
+)
+{
+    assert(self);
+    assert(patch);
+
+    self->patch_ = patch;
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_PatchFixed const* YM7128B_ChipFixed_GetPatch(YM7128B_ChipFixed const* self)
+{
+    assert(self);
+
+    return YM7128B_ChipFixed_Patch_(self);
+}
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipFixed_ScheduleWrite(
+    YM7128B_ChipFixed* self,
+    size_t offset,
+    YM7128B_Address address,
+    YM7128B_Register data
+)
+{
+    assert(self);
+
+    return YM7128B_WriteQueue_Push(&self->queue_, offset, address, data);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFixed_SetWritePacing(
+    YM7128B_ChipFixed* self,
+    bool enabled
+)
+{
+    assert(self);
+
+    self->queue_.pacing_ = enabled;
+}
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipFixed_SetKernel(
+    YM7128B_ChipFixed* self,
+    YM7128B_Kernel kernel
+)
+{
+    assert(self);
+
+    if (!YM7128B_Kernel_IsSupported(kernel)) {
+        return false;
+    }
+    self->kernel_ = kernel;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipFixed_SetFilter(
+    YM7128B_ChipFixed* self,
+    YM7128B_Filter filter
+)
+{
+    assert(self);
+
+    if ((unsigned)filter >= (unsigned)YM7128B_Filter_Count) {
+        return false;
+    }
+    self->filter_ = filter;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_Filter YM7128B_ChipFixed_GetFilter(YM7128B_ChipFixed const* self)
+{
+    assert(self);
+
+    return self->filter_;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t YM7128B_ChipFixed_GetLatency(YM7128B_ChipFixed const* self)
+{
+    assert(self);
+
+    return YM7128B_Filter_GetLatency(self->filter_);
+}
+
+// ----------------------------------------------------------------------------
+
+static void YM7128B_ChipFixed_StateView_(
+    YM7128B_ChipFixed* self,
+    YM7128B_StateView_* view
+)
+{
+    view->engine = YM7128B_ChipEngine_Fixed;
+    view->sample_size = sizeof(YM7128B_Fixed);
+    view->length = YM7128B_Buffer_Length;
+    view->capacity = YM7128B_Buffer_Capacity;
+    view->tail = self->tail_;
+    view->silence = self->silence_;
+    view->written = self->written_;
+    view->regs = YM7128B_ChipFixed_Patch_(self)->regs_;
+    view->t0_d = &self->t0_d_;
+    view->buffer = self->buffer_;
+    view->queue = &self->queue_;
+    view->interpolators = YM7128B_OutputChannel_Count;
+
+    for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+        view->indices[channel] = &self->oversampler_[channel].index_;
+        view->histories[channel] = self->oversampler_[channel].buffer_;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+size_t YM7128B_ChipFixed_GetStateSize(YM7128B_ChipFixed const* self)
+{
+    (void)self;
+    assert(self);
+
+    return YM7128B_State_Size_(
+        sizeof(YM7128B_Fixed), YM7128B_OutputChannel_Count,
+        YM7128B_WRITE_QUEUE_LENGTH, YM7128B_Buffer_Length
+    );
+}
+
+// ----------------------------------------------------------------------------
+
+size_t YM7128B_ChipFixed_SaveState(
+    YM7128B_ChipFixed* self,
+    void* buffer,
+    size_t size,
+    bool delta
+)
+{
+    assert(self);
+
+    YM7128B_StateView_ view;
+    YM7128B_ChipFixed_StateView_(self, &view);
+
+    size_t saved = YM7128B_State_Save_(&view, buffer, size, delta);
+    if (saved) {
+        self->written_ = 0;
+    }
+    return saved;
+}
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipFixed_LoadState(
+    YM7128B_ChipFixed* self,
+    void const* buffer,
+    size_t size
+)
+{
+    assert(self);
+
+    YM7128B_Register regs[YM7128B_Reg_Count];
+    YM7128B_StateView_ view;
+    YM7128B_ChipFixed_StateView_(self, &view);
+
+    if (!YM7128B_State_Load_(&view, buffer, size, regs)) {
+        return false;
+    }
+
+    self->tail_ = (YM7128B_Tap)view.tail;
+    self->silence_ = view.silence;
+    self->written_ = 0;
+
+    for (YM7128B_Address i = YM7128B_Address_Min; i <= YM7128B_Address_Max; ++i) {
+        YM7128B_ChipFixed_Write(self, i, regs[i]);
+    }
+    return true;
+}
+
+// ============================================================================
+
+static void YM7128B_PatchFloat_Write_(
+    YM7128B_PatchFloat* self,
+    YM7128B_Address address,
+    YM7128B_Register data
+)
+{
+    if (address < YM7128B_Reg_C0) {
+        self->regs_[address] = data & YM7128B_Gain_Data_Mask;
+        self->gains_[address] = YM7128B_RegisterToGainFloat(data);
+    }
+    else if (address < YM7128B_Reg_T0) {
+        self->regs_[address] = data & YM7128B_Coeff_Value_Mask;
+        self->gains_[address] = YM7128B_RegisterToCoeffFloat(data);
+    }
+    else {
+        self->regs_[address] = data & YM7128B_Tap_Value_Mask;
+        self->taps_[address - YM7128B_Reg_T0] = YM7128B_RegisterToTap(data);
+        return;
+    }
+
+    bool zero[YM7128B_Reg_T0];
+    for (YM7128B_Address i = 0; i < YM7128B_Reg_T0; ++i) {
+        zero[i] = (self->gains_[i] == 0);
+    }
+    self->flags_ = YM7128B_Patch_Flags_(zero);
+    self->lane_count_ = YM7128B_Patch_Lanes_(zero, self->lanes_);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_PatchFloat_Setup(
+    YM7128B_PatchFloat* self,
+    YM7128B_Register const regs[YM7128B_Reg_Count]
+)
+{
+    assert(self);
+    assert(regs);
+
+    for (YM7128B_Address i = YM7128B_Address_Min; i <= YM7128B_Address_Max; ++i) {
+        YM7128B_PatchFloat_Write_(self, i, regs[i]);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+static YM7128B_PatchFloat const* YM7128B_ChipFloat_Patch_(YM7128B_ChipFloat const* self)
+{
+    return self->patch_ ? self->patch_ : &self->own_;
+}
+
+// ----------------------------------------------------------------------------
+
+// Copies the shared patch, if any, so that the chip owns its registers
+static YM7128B_PatchFloat* YM7128B_ChipFloat_OwnPatch_(YM7128B_ChipFloat* self)
+{
+    if (self->patch_) {
+        self->own_ = *self->patch_;
+        self->patch_ = NULL;
+    }
+    return &self->own_;
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFloat_Ctor(YM7128B_ChipFloat* self)
+{
+    assert(self);
+
+    self->patch_ = NULL;
+    self->filter_ = YM7128B_Filter_Default;
+    self->mailbox_ = NULL;
+    YM7128B_ChipFloat_ResetStats(self);
+    self->silence_ = 0;
+    self->written_ = YM7128B_Buffer_Length;
+
+    YM7128B_WriteQueue_Clear(&self->queue_);
+    self->queue_.pacing_ = false;
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFloat_Dtor(YM7128B_ChipFloat* self)
+{
+    (void)self;
+    assert(self);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFloat_Reset(YM7128B_ChipFloat* self)
+{
+    assert(self);
+
+    for (YM7128B_Address i = YM7128B_Address_Min; i <= YM7128B_Address_Max; ++i) {
+        YM7128B_ChipFloat_Write(self, i, 0x00);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFloat_Start(YM7128B_ChipFloat* self)
+{
+    assert(self);
+
+    self->t0_d_ = 0;
+
+    self->tail_ = 0;
+    self->silence_ = YM7128B_Buffer_Capacity;
+    self->written_ = YM7128B_Buffer_Length;
+
+    YM7128B_WriteQueue_Clear(&self->queue_);
+
+    for (YM7128B_Tap i = 0; i < YM7128B_Buffer_Capacity; ++i) {
+        self->buffer_[i] = 0;
+    }
+
+    for (YM7128B_Oversampler_Index i = 0; i < YM7128B_OutputChannel_Count; ++i) {
+        YM7128B_InterpolatorFloat_Reset(&self->oversampler_[i]);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFloat_Stop(YM7128B_ChipFloat* self)
+{
+    (void)self;
+    assert(self);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFloat_Process(
+    YM7128B_ChipFloat* self,
+    YM7128B_ChipFloat_Process_Data* data
+)
+{
+    assert(self);
+    assert(data);
+
+    YM7128B_ChipFloat_ProcessBlock(
+        self,
+        &data->inputs[YM7128B_InputChannel_Mono],
+        1,
+        &data->outputs[YM7128B_OutputChannel_Left][0],
+        &data->outputs[YM7128B_OutputChannel_Right][0]
+    );
+}
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipFloat_IsIdle(YM7128B_ChipFloat const* self)
+{
+    assert(self);
+
+    if ((self->silence_ < YM7128B_Buffer_Length) || (self->t0_d_ != 0)) {
+        return false;
+    }
+
+    for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+        if (!YM7128B_InterpolatorFloat_IsClear_(&self->oversampler_[channel])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFloat_GetStats(
+    YM7128B_ChipFloat const* self,
+    YM7128B_Stats* stats
+)
+{
+    assert(self);
+    assert(stats);
+
+#if YM7128B_USE_STATS
+    *stats = self->stats_;
+#else
+    (void)self;
+    memset(stats, 0, sizeof(*stats));
+#endif
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFloat_ResetStats(YM7128B_ChipFloat* self)
+{
+    (void)self;
+    assert(self);
+
+    YM7128B_STATS(memset(&self->stats_, 0, sizeof(self->stats_));)
+}
+
+// ----------------------------------------------------------------------------
+
+// Digital silence fast path: while idle, silent input samples just advance
+// the delay line and the interpolators, yielding silent outputs, <tt>ratio</tt>
+// per input sample.
+// Returns the number of processed input samples.
+static size_t YM7128B_ChipFloat_ProcessIdle_(
+    YM7128B_ChipFloat* self,
+    YM7128B_Float const* inputs,
+    size_t count,
+    YM7128B_Float* outputs_left,
+    YM7128B_Float* outputs_right,
+    size_t ratio
+)
+{
+    if (!count || !YM7128B_ChipFloat_IsIdle(self)) {
+        return 0;
+    }
+
+    size_t idle = 0;
+    while ((idle < count) && (inputs[idle] == 0)) {
+        ++idle;
+    }
+
+    for (size_t i = 0; i < idle * ratio; ++i) {
+        outputs_left[i] = 0;
+        outputs_right[i] = 0;
+    }
+
+    // Samples older than the nominal length may linger in the spare capacity:
+    // clear those coming back into view, as the processing loop would do
+    size_t spare = 0;
+    if (self->silence_ < YM7128B_Buffer_Capacity) {
+        spare = YM7128B_Buffer_Capacity - self->silence_;
+        if (spare > idle) {
+            spare = idle;
+        }
+    }
+    for (size_t i = 0; i < spare; ++i) {
+        self->tail_ = YM7128B_Buffer_Wrap_(self->tail_ + (YM7128B_Buffer_Capacity - 1));
+        self->buffer_[self->tail_] = 0;
+    }
+    self->tail_ = (YM7128B_Tap)YM7128B_Ring_Rewind_(self->tail_, idle - spare, YM7128B_Buffer_Capacity);
+    for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+        YM7128B_Oversampler_Index* index = &self->oversampler_[channel].index_;
+        *index = (YM7128B_Oversampler_Index)YM7128B_Ring_Rewind_(*index, idle, YM7128B_Interpolator_Length);
+    }
+    self->silence_ += idle;
+    YM7128B_STATS(self->stats_.idle_samples += idle;)
+    return idle;
+}
+
+// ----------------------------------------------------------------------------
+
+// Specialized by the patch: when sparse, only the output taps not silent are
+// gathered, keeping the results exactly the same.
+// Native outputs skip the interpolator, one per input sample, for resampling.
+YM7128B_FORCE_INLINE
+void YM7128B_ChipFloat_ProcessBlock_(
+    YM7128B_ChipFloat* self,
+    YM7128B_Float const* inputs,
+    size_t count,
+    YM7128B_Float* outputs_left,
+    YM7128B_Float* outputs_right,
+    bool sparse,
+    bool native
+)
+{
+    YM7128B_Float* outputs[YM7128B_OutputChannel_Count];
+    outputs[YM7128B_OutputChannel_Left] = outputs_left;
+    outputs[YM7128B_OutputChannel_Right] = outputs_right;
+
+    YM7128B_PatchFloat const* patch = YM7128B_ChipFloat_Patch_(self);
+    YM7128B_Float const (*coeffs)[YM7128B_Interpolator_Stride] = YM7128B_InterpolatorFloat_Kernels[self->filter_];
+    YM7128B_Tap tail = self->tail_;
+    YM7128B_Float t0_d = self->t0_d_;
+    size_t silence = self->silence_;
+    YM7128B_STATS(
+        YM7128B_Stats* stats = &self->stats_;
+        YM7128B_Float lane_peaks[YM7128B_Gain_Lane_Count] = { 0 };
+        YM7128B_Float output_peaks[YM7128B_OutputChannel_Count] = { 0 };
+        uint64_t cycles = YM7128B_Stats_Cycles_();
+    )
+    YM7128B_Register const* lanes = patch->lanes_;
+    YM7128B_Register lane_count = patch->lane_count_;
+
+    for (size_t index = 0; index < count; ++index) {
+        YM7128B_Float input = inputs[index];
+        YM7128B_Float sample = input;
+
+        YM7128B_Tap t0 = tail + patch->taps_[0];
+        YM7128B_Tap filter_head  = YM7128B_Buffer_Wrap_(t0);
+        YM7128B_Float filter_t0  = self->buffer_[filter_head];
+        YM7128B_Float filter_d   = t0_d;
+        t0_d = filter_t0;
+        YM7128B_Float filter_c0  = YM7128B_MulFloat(filter_t0, patch->gains_[YM7128B_Reg_C0]);
+        YM7128B_Float filter_c1  = YM7128B_MulFloat(filter_d, patch->gains_[YM7128B_Reg_C1]);
+        YM7128B_Float filter_sum = YM7128B_ClampAddFloat(filter_c0, filter_c1);
+        YM7128B_STATS(stats->feedback_clamps += YM7128B_Stats_ClampsFloat_(filter_c0 + filter_c1);)
+        YM7128B_Float filter_vc  = YM7128B_MulFloat(filter_sum, patch->gains_[YM7128B_Reg_VC]);
+
+        YM7128B_Float input_vm  = YM7128B_MulFloat(sample, patch->gains_[YM7128B_Reg_VM]);
+        YM7128B_Float input_sum = YM7128B_ClampAddFloat(input_vm, filter_vc);
+
+        tail = YM7128B_Buffer_Wrap_(tail + (YM7128B_Buffer_Capacity - 1));
+        self->buffer_[tail] = input_sum;
+        silence = (input_sum != 0) ? 0 : (silence + 1);
+        YM7128B_STATS(
+            stats->feedback_clamps += YM7128B_Stats_ClampsFloat_(input_vm + filter_vc);
+            cycles = YM7128B_Stats_Lap_(stats, YM7128B_Stage_Feedback, cycles);
+        )
+
+        YM7128B_Float accums[YM7128B_OutputChannel_Count] = { 0, 0 };
+
+        for (YM7128B_Register i = 0; i < (sparse ? lane_count : (YM7128B_Register)YM7128B_Gain_Lane_Count); ++i) {
+            YM7128B_Register tap = (sparse ? lanes[i] : i) + 1;
+            YM7128B_Tap t = tail + patch->taps_[tap];
+            YM7128B_Tap head = YM7128B_Buffer_Wrap_(t);
+            YM7128B_Float buffered = self->buffer_[head];
+            YM7128B_STATS(YM7128B_Stats_PeakFloat_(&lane_peaks[tap - 1], buffered);)
+
+            for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+                YM7128B_Register gb = YM7128B_Reg_GL1 + (channel * YM7128B_Gain_Lane_Count);
+                YM7128B_Float g = patch->gains_[gb + tap - 1];
+                YM7128B_Float buffered_g = YM7128B_MulFloat(buffered, g);
+                accums[channel] += buffered_g;
+            }
+        }
+
+        YM7128B_STATS(cycles = YM7128B_Stats_Lap_(stats, YM7128B_Stage_Mix, cycles);)
+
+        for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+            YM7128B_Float accum = accums[channel];
+
+            YM7128B_Float total = YM7128B_ClampFloat(accum);
+            YM7128B_Float v = patch->gains_[YM7128B_Reg_VL + channel];
+            YM7128B_Float total_v = YM7128B_MulFloat(total, v);
+            YM7128B_STATS(stats->output_clamps += YM7128B_Stats_ClampsFloat_(accum);)
+            YM7128B_STATS(YM7128B_Stats_PeakFloat_(&output_peaks[channel], total_v);)
+
+            if (native) {
+                outputs[channel][index] = total_v;
+            }
+            else {
+                YM7128B_InterpolatorFloat* oversampler = &self->oversampler_[channel];
+                YM7128B_Float* output = &outputs[channel][index * YM7128B_Oversampling];
+
+                YM7128B_InterpolatorFloat_Process_(oversampler, coeffs, total_v, output);
+            }
+        }
+        YM7128B_STATS(cycles = YM7128B_Stats_Lap_(stats, YM7128B_Stage_Oversampler, cycles);)
+    }
+
+    self->tail_ = tail;
+    self->t0_d_ = t0_d;
+    self->silence_ = silence;
+    YM7128B_STATS(YM7128B_Stats_MergeFloat_(stats, lane_peaks, output_peaks);)
+}
+
+// ----------------------------------------------------------------------------
+
+// Native outputs skip the interpolator, one per input sample
+static void YM7128B_ChipFloat_ProcessSpan_(
+    YM7128B_ChipFloat* self,
+    YM7128B_Float const* inputs,
+    size_t count,
+    YM7128B_Float* outputs_left,
+    YM7128B_Float* outputs_right,
+    bool native
+)
+{
+    assert(self);
+    assert(inputs || !count);
+    assert(outputs_left || !count);
+    assert(outputs_right || !count);
+
+    size_t ratio = native ? 1 : (size_t)YM7128B_Oversampling;
+    size_t idle = YM7128B_ChipFloat_ProcessIdle_(self, inputs, count, outputs_left, outputs_right, ratio);
+    inputs += idle;
+    count -= idle;
+    outputs_left += idle * ratio;
+    outputs_right += idle * ratio;
+
+    bool sparse = !!(YM7128B_ChipFloat_Patch_(self)->flags_ & YM7128B_PatchFlag_Sparse);
+    if (native) {
+        if (sparse) {
+            YM7128B_ChipFloat_ProcessBlock_(self, inputs, count, outputs_left, outputs_right, true, true);
+        }
+        else {
+            YM7128B_ChipFloat_ProcessBlock_(self, inputs, count, outputs_left, outputs_right, false, true);
+        }
+    }
+    else {
+        if (sparse) {
+            YM7128B_ChipFloat_ProcessBlock_(self, inputs, count, outputs_left, outputs_right, true, false);
+        }
+        else {
+            YM7128B_ChipFloat_ProcessBlock_(self, inputs, count, outputs_left, outputs_right, false, false);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+// Takes the latest register image posted to the mailbox, if any
+static void YM7128B_ChipFloat_Receive_(YM7128B_ChipFloat* self)
+{
+    YM7128B_MailboxFloat* mailbox = self->mailbox_;
+
+    if (YM7128B_Mailbox_Acquire_(&mailbox->core_)) {
+        YM7128B_ChipFloat_SetPatch(self, &mailbox->slots_[mailbox->core_.front_]);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+// Processes a block, with native or interpolated outputs
+static void YM7128B_ChipFloat_Process_(
+    YM7128B_ChipFloat* self,
+    YM7128B_Float const* inputs,
+    size_t count,
+    YM7128B_Float* outputs_left,
+    YM7128B_Float* outputs_right,
+    bool native
+)
+{
+    size_t ratio = native ? 1 : (size_t)YM7128B_Oversampling;
+
+    if (self->mailbox_) {
+        YM7128B_ChipFloat_Receive_(self);
+    }
+
+    YM7128B_WriteQueue* queue = &self->queue_;
+    YM7128B_WriteEvent const* event;
+    size_t offset;
+    size_t done = 0;
+
+    while (YM7128B_WriteQueue_Peek(queue, count, &offset, &event)) {
+        if (offset > done) {
+            YM7128B_ChipFloat_ProcessSpan_(
+                self,
+                &inputs[done],
+                offset - done,
+                &outputs_left[done * ratio],
+                &outputs_right[done * ratio],
+                native
+            );
+            done = offset;
+        }
+        YM7128B_ChipFloat_Write(self, event->address, event->data);
+        YM7128B_WriteQueue_Pop(queue, offset, YM7128B_Input_Rate);
+    }
+
+    if (done < count) {
+        YM7128B_ChipFloat_ProcessSpan_(
+            self,
+            &inputs[done],
+            count - done,
+            &outputs_left[done * ratio],
+            &outputs_right[done * ratio],
+            native
+        );
+    }
+
+    YM7128B_WriteQueue_Advance(queue, count);
+    self->written_ += count;
+    YM7128B_STATS(self->stats_.samples += count;)
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFloat_ProcessBlock(
+    YM7128B_ChipFloat* self,
+    YM7128B_Float const* inputs,
+    size_t count,
+    YM7128B_Float* outputs_left,
+    YM7128B_Float* outputs_right
+)
+{
+    assert(self);
+    assert(inputs || !count);
+    assert(outputs_left || !count);
+    assert(outputs_right || !count);
+
+    YM7128B_ChipFloat_Process_(self, inputs, count, outputs_left, outputs_right, false);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFloat_ProcessBlockOutput(
+    YM7128B_ChipFloat* self,
+    YM7128B_OutputStage const* stage,
+    YM7128B_Float const* inputs,
+    size_t count,
+    YM7128B_OutputFormat format,
+    void* frames
+)
+{
+    assert(self);
+    assert(stage);
+    assert(inputs || !count);
+    assert(frames || !count);
+    assert(format < YM7128B_OutputFormat_Count);
+
+    // The wet outputs of each chunk stay in cache, for the mix to follow
+    YM7128B_Float outputs[YM7128B_OutputChannel_Count][YM7128B_OutputStage_Chunk * YM7128B_Oversampling];
+    size_t stride = YM7128B_OutputFormat_GetSize(format) * (YM7128B_Oversampling * YM7128B_OutputChannel_Count);
+    unsigned char* dst = (unsigned char*)frames;
+
+    while (count) {
+        size_t chunk = (count < YM7128B_OutputStage_Chunk) ? count : (size_t)YM7128B_OutputStage_Chunk;
+
+        YM7128B_ChipFloat_ProcessBlock(
+            self,
+            inputs,
+            chunk,
+            outputs[YM7128B_OutputChannel_Left],
+            outputs[YM7128B_OutputChannel_Right]
+        );
+        YM7128B_OutputStage_MixFloat_(
+            stage,
+            inputs,
+            chunk,
+            YM7128B_Oversampling,
+            outputs[YM7128B_OutputChannel_Left],
+            outputs[YM7128B_OutputChannel_Right],
+            format,
+            dst
+        );
+        inputs += chunk;
+        dst += chunk * stride;
+        count -= chunk;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+size_t YM7128B_ChipFloat_ProcessBlockResampled(
+    YM7128B_ChipFloat* self,
+    YM7128B_ResamplerFloat* resampler,
+    YM7128B_Float const* inputs,
+    size_t count,
+    YM7128B_Float* outputs_left,
+    YM7128B_Float* outputs_right
+)
+{
+    assert(self);
+    assert(resampler);
+    assert(inputs || !count);
+    assert(outputs_left || !count);
+    assert(outputs_right || !count);
+
+    // The native outputs of each chunk stay in cache, for the resampler
+    YM7128B_Float natives[YM7128B_OutputChannel_Count][YM7128B_OutputStage_Chunk];
+    size_t done = 0;
+
+    while (count) {
+        size_t chunk = (count < YM7128B_OutputStage_Chunk) ? count : (size_t)YM7128B_OutputStage_Chunk;
+
+        YM7128B_ChipFloat_Process_(
+            self,
+            inputs,
+            chunk,
+            natives[YM7128B_OutputChannel_Left],
+            natives[YM7128B_OutputChannel_Right],
+            true
+        );
+        done += YM7128B_ResamplerFloat_Process(
+            resampler,
+            natives[YM7128B_OutputChannel_Left],
+            natives[YM7128B_OutputChannel_Right],
+            chunk,
+            &outputs_left[done],
+            &outputs_right[done]
+        );
+        inputs += chunk;
+        count -= chunk;
+    }
+    return done;
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_Register YM7128B_ChipFloat_Read(
+    YM7128B_ChipFloat const* self,
+    YM7128B_Address address
+)
+{
+    assert(self);
+
+    YM7128B_PatchFloat const* patch = YM7128B_ChipFloat_Patch_(self);
+
+    if (address < YM7128B_Reg_C0) {
+        return patch->regs_[address] & YM7128B_Gain_Data_Mask;
+    }
+    else if (address < YM7128B_Reg_T0) {
+        return patch->regs_[address] & YM7128B_Coeff_Value_Mask;
+    }
+    else if (address < YM7128B_Reg_Count) {
+        return patch->regs_[address] & YM7128B_Tap_Value_Mask;
+    }
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFloat_Write(
+    YM7128B_ChipFloat* self,
+    YM7128B_Address address,
+    YM7128B_Register data
+)
+{
+    assert(self);
+
+    if (address < YM7128B_Reg_Count) {
+        YM7128B_PatchFloat* patch = YM7128B_ChipFloat_OwnPatch_(self);
+        YM7128B_PatchFloat_Write_(patch, address, data);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFloat_SetPatch(
+    YM7128B_ChipFloat* self,
+    YM7128B_PatchFloat const* patch
+)
+{
+    assert(self);
+    assert(patch);
+
+    self->patch_ = patch;
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_PatchFloat const* YM7128B_ChipFloat_GetPatch(YM7128B_ChipFloat const* self)
+{
+    assert(self);
+
+    return YM7128B_ChipFloat_Patch_(self);
+}
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipFloat_ScheduleWrite(
+    YM7128B_ChipFloat* self,
+    size_t offset,
+    YM7128B_Address address,
+    YM7128B_Register data
+)
+{
+    assert(self);
+
+    return YM7128B_WriteQueue_Push(&self->queue_, offset, address, data);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFloat_SetWritePacing(
+    YM7128B_ChipFloat* self,
+    bool enabled
+)
+{
+    assert(self);
+
+    self->queue_.pacing_ = enabled;
+}
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipFloat_SetFilter(
+    YM7128B_ChipFloat* self,
+    YM7128B_Filter filter
+)
+{
+    assert(self);
+
+    if ((unsigned)filter >= (unsigned)YM7128B_Filter_Count) {
+        return false;
+    }
+    self->filter_ = filter;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_Filter YM7128B_ChipFloat_GetFilter(YM7128B_ChipFloat const* self)
+{
+    assert(self);
+
+    return self->filter_;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t YM7128B_ChipFloat_GetLatency(YM7128B_ChipFloat const* self)
+{
+    assert(self);
+
+    return YM7128B_Filter_GetLatency(self->filter_);
+}
+
+// ----------------------------------------------------------------------------
+
+static void YM7128B_ChipFloat_StateView_(
+    YM7128B_ChipFloat* self,
+    YM7128B_StateView_* view
+)
+{
+    view->engine = YM7128B_ChipEngine_Float;
+    view->sample_size = sizeof(YM7128B_Float);
+    view->length = YM7128B_Buffer_Length;
+    view->capacity = YM7128B_Buffer_Capacity;
+    view->tail = self->tail_;
+    view->silence = self->silence_;
+    view->written = self->written_;
+    view->regs = YM7128B_ChipFloat_Patch_(self)->regs_;
+    view->t0_d = &self->t0_d_;
+    view->buffer = self->buffer_;
+    view->queue = &self->queue_;
+    view->interpolators = YM7128B_OutputChannel_Count;
+
+    for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+        view->indices[channel] = &self->oversampler_[channel].index_;
+        view->histories[channel] = self->oversampler_[channel].buffer_;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+size_t YM7128B_ChipFloat_GetStateSize(YM7128B_ChipFloat const* self)
+{
+    (void)self;
+    assert(self);
+
+    return YM7128B_State_Size_(
+        sizeof(YM7128B_Float), YM7128B_OutputChannel_Count,
+        YM7128B_WRITE_QUEUE_LENGTH, YM7128B_Buffer_Length
+    );
+}
+
+// ----------------------------------------------------------------------------
+
+size_t YM7128B_ChipFloat_SaveState(
+    YM7128B_ChipFloat* self,
+    void* buffer,
+    size_t size,
+    bool delta
+)
+{
+    assert(self);
+
+    YM7128B_StateView_ view;
+    YM7128B_ChipFloat_StateView_(self, &view);
+
+    size_t saved = YM7128B_State_Save_(&view, buffer, size, delta);
+    if (saved) {
+        self->written_ = 0;
+    }
+    return saved;
+}
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipFloat_LoadState(
+    YM7128B_ChipFloat* self,
+    void const* buffer,
+    size_t size
+)
+{
+    assert(self);
+
+    YM7128B_Register regs[YM7128B_Reg_Count];
+    YM7128B_StateView_ view;
+    YM7128B_ChipFloat_StateView_(self, &view);
+
+    if (!YM7128B_State_Load_(&view, buffer, size, regs)) {
+        return false;
+    }
+
+    self->tail_ = (YM7128B_Tap)view.tail;
+    self->silence_ = view.silence;
+    self->written_ = 0;
+
+    for (YM7128B_Address i = YM7128B_Address_Min; i <= YM7128B_Address_Max; ++i) {
+        YM7128B_ChipFloat_Write(self, i, regs[i]);
+    }
+    return true;
+}
+
+// ============================================================================
+
+static void YM7128B_PatchIdeal_Write_(
+    YM7128B_PatchIdeal* self,
+    YM7128B_Address address,
+    YM7128B_Register data
+)
+{
+    if (address < YM7128B_Reg_C0) {
+        self->regs_[address] = data & YM7128B_Gain_Data_Mask;
+        self->gains_[address] = YM7128B_RegisterToGainFloat(data);
+    }
+    else if (address < YM7128B_Reg_T0) {
+        self->regs_[address] = data & YM7128B_Coeff_Value_Mask;
+        self->gains_[address] = YM7128B_RegisterToCoeffFloat(data);
+    }
+    else {
+        self->regs_[address] = data & YM7128B_Tap_Value_Mask;
+        self->taps_[address - YM7128B_Reg_T0] = YM7128B_RegisterToTapIdeal(data, self->sample_rate_);
+        return;
+    }
+
+    bool zero[YM7128B_Reg_T0];
+    for (YM7128B_Address i = 0; i < YM7128B_Reg_T0; ++i) {
+        zero[i] = (self->gains_[i] == 0);
+    }
+    self->flags_ = YM7128B_Patch_Flags_(zero);
+    self->lane_count_ = YM7128B_Patch_Lanes_(zero, self->lanes_);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_PatchIdeal_Setup(
+    YM7128B_PatchIdeal* self,
+    YM7128B_Register const regs[YM7128B_Reg_Count],
+    YM7128B_TapIdeal sample_rate
+)
+{
+    assert(self);
+    assert(regs);
+
+    self->sample_rate_ = sample_rate;
+
+    for (YM7128B_Address i = YM7128B_Address_Min; i <= YM7128B_Address_Max; ++i) {
+        YM7128B_PatchIdeal_Write_(self, i, regs[i]);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+static YM7128B_PatchIdeal const* YM7128B_ChipIdeal_Patch_(YM7128B_ChipIdeal const* self)
+{
+    return self->patch_ ? self->patch_ : &self->own_;
+}
+
+// ----------------------------------------------------------------------------
+
+// Copies the shared patch, if any, so that the chip owns its registers
+static YM7128B_PatchIdeal* YM7128B_ChipIdeal_OwnPatch_(YM7128B_ChipIdeal* self)
+{
+    if (self->patch_) {
+        self->own_ = *self->patch_;
+        self->patch_ = NULL;
+    }
+    return &self->own_;
+}
+
+// ----------------------------------------------------------------------------
+
+// Resolves the taps at the chip sample rate
+static void YM7128B_ChipIdeal_Retap_(YM7128B_ChipIdeal* self)
+{
+    if (self->patch_ && (self->patch_->sample_rate_ == self->sample_rate_)) {
+        return;
+    }
+
+    YM7128B_PatchIdeal* patch = YM7128B_ChipIdeal_OwnPatch_(self);
+    patch->sample_rate_ = self->sample_rate_;
+
+    for (YM7128B_Address i = 0; i < YM7128B_Tap_Count; ++i) {
+        YM7128B_Register data = patch->regs_[i + YM7128B_Reg_T0];
+        patch->taps_[i] = YM7128B_RegisterToTapIdeal(data, patch->sample_rate_);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipIdeal_Ctor(YM7128B_ChipIdeal* self)
+{
+    assert(self);
+
+    self->patch_ = NULL;
+    self->mailbox_ = NULL;
+    YM7128B_ChipIdeal_ResetStats(self);
+    self->own_.sample_rate_ = 0;
+    self->buffer_ = NULL;
+    self->length_ = 0;
+    self->silence_ = 0;
+    self->written_ = 0;
+    self->capacity_ = 0;
+    self->sample_rate_ = 0;
+    self->buffer_owned_ = false;
+
+    YM7128B_WriteQueue_Clear(&self->queue_);
+    self->queue_.pacing_ = false;
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipIdeal_Dtor(YM7128B_ChipIdeal* self)
+{
+    assert(self);
+
+    if (self->buffer_owned_) {
+        free(self->buffer_);
+    }
+    self->buffer_ = NULL;
+    self->buffer_owned_ = false;
+    self->length_ = 0;
+    self->capacity_ = 0;
+}
+
+// ----------------------------------------------------------------------------
+void YM7128B_ChipIdeal_Reset(YM7128B_ChipIdeal* self)
+{
+    assert(self);
+
+    for (YM7128B_Address i = YM7128B_Address_Min; i <= YM7128B_Address_Max; ++i) {
+        YM7128B_ChipIdeal_Write(self, i, 0x00);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipIdeal_Start(YM7128B_ChipIdeal* self)
+{
+    assert(self);
+
+    self->t0_d_ = 0;
+
+    self->tail_ = 0;
+    self->silence_ = self->length_;
+    self->written_ = self->length_;
+
+    YM7128B_WriteQueue_Clear(&self->queue_);
+
+    if (self->buffer_) {
+        for (YM7128B_TapIdeal i = 0; i < self->length_; ++i) {
+            self->buffer_[i] = 0;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipIdeal_Stop(YM7128B_ChipIdeal* self)
+{
+    (void)self;
+    assert(self);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipIdeal_Process(
+    YM7128B_ChipIdeal* self,
+    YM7128B_ChipIdeal_Process_Data* data
+)
+{
+    assert(self);
+    assert(data);
+
+    YM7128B_ChipIdeal_ProcessBlock(
+        self,
+        &data->inputs[YM7128B_InputChannel_Mono],
+        1,
+        &data->outputs[YM7128B_OutputChannel_Left],
+        &data->outputs[YM7128B_OutputChannel_Right]
+    );
+}
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipIdeal_IsIdle(YM7128B_ChipIdeal const* self)
+{
+    assert(self);
+
+    if ((self->silence_ < self->length_) || (self->t0_d_ != 0)) {
+        return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipIdeal_GetStats(
+    YM7128B_ChipIdeal const* self,
+    YM7128B_Stats* stats
+)
+{
+    assert(self);
+    assert(stats);
+
+#if YM7128B_USE_STATS
+    *stats = self->stats_;
+#else
+    (void)self;
+    memset(stats, 0, sizeof(*stats));
+#endif
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipIdeal_ResetStats(YM7128B_ChipIdeal* self)
+{
+    (void)self;
+    assert(self);
+
+    YM7128B_STATS(memset(&self->stats_, 0, sizeof(self->stats_));)
+}
+
+// ----------------------------------------------------------------------------
+
+// Digital silence fast path: while idle, silent input samples just advance
+// the delay line, yielding silent outputs.
+// The silent taps always sum up to +0, which negative output gains turn into
+// -0, as per the full computation.
+// Returns the number of processed input samples.
+static size_t YM7128B_ChipIdeal_ProcessIdle_(
+    YM7128B_ChipIdeal* self,
+    YM7128B_Float const* inputs,
+    size_t count,
+    YM7128B_Float* outputs_left,
+    YM7128B_Float* outputs_right
+)
+{
+    if (!count || !YM7128B_ChipIdeal_IsIdle(self)) {
+        return 0;
+    }
+
+    size_t idle = 0;
+    while ((idle < count) && (inputs[idle] == 0)) {
+        ++idle;
+    }
+
+    YM7128B_PatchIdeal const* patch = YM7128B_ChipIdeal_Patch_(self);
+    YM7128B_Float const og = 1 / (YM7128B_Float)YM7128B_Oversampling;
+    YM7128B_Float const zero = 0;
+    YM7128B_Float const left = YM7128B_MulFloat(YM7128B_MulFloat(zero, patch->gains_[YM7128B_Reg_VL]), og);
+    YM7128B_Float const right = YM7128B_MulFloat(YM7128B_MulFloat(zero, patch->gains_[YM7128B_Reg_VR]), og);
+
+    for (size_t i = 0; i < idle; ++i) {
+        outputs_left[i] = left;
+        outputs_right[i] = right;
+    }
+
+    self->tail_ = YM7128B_Ring_Rewind_(self->tail_, idle, self->length_);
+    self->silence_ += idle;
+    YM7128B_STATS(self->stats_.idle_samples += idle;)
+    return idle;
+}
+
+// ----------------------------------------------------------------------------
+
+// Specialized by the patch: when sparse, only the output taps not silent are
+// gathered, keeping the results exactly the same.
+YM7128B_FORCE_INLINE
+void YM7128B_ChipIdeal_ProcessBlock_(
+    YM7128B_ChipIdeal* self,
+    YM7128B_Float const* inputs,
+    size_t count,
+    YM7128B_Float* outputs_left,
+    YM7128B_Float* outputs_right,
+    bool sparse
+)
+{
+    YM7128B_Float* outputs[YM7128B_OutputChannel_Count];
+    outputs[YM7128B_OutputChannel_Left] = outputs_left;
+    outputs[YM7128B_OutputChannel_Right] = outputs_right;
+
+    YM7128B_TapIdeal length = self->length_;
+    YM7128B_PatchIdeal const* patch = YM7128B_ChipIdeal_Patch_(self);
+    YM7128B_TapIdeal tail = self->tail_;
+    YM7128B_Float t0_d = self->t0_d_;
+    YM7128B_TapIdeal silence = self->silence_;
+    YM7128B_STATS(
+        YM7128B_Stats* stats = &self->stats_;
+        YM7128B_Float lane_peaks[YM7128B_Gain_Lane_Count] = { 0 };
+        YM7128B_Float output_peaks[YM7128B_OutputChannel_Count] = { 0 };
+        uint64_t cycles = YM7128B_Stats_Cycles_();
+    )
+    YM7128B_Register const* lanes = patch->lanes_;
+    YM7128B_Register lane_count = patch->lane_count_;
+
+    for (size_t index = 0; index < count; ++index) {
+        YM7128B_Float input = inputs[index];
+        YM7128B_Float sample = input;
+
+        YM7128B_TapIdeal t0 = tail + patch->taps_[0];
+        YM7128B_TapIdeal filter_head = (t0 >= length) ? (t0 - length) : t0;
+        YM7128B_Float filter_t0  = self->buffer_[filter_head];
+        YM7128B_Float filter_d   = t0_d;
+        t0_d = filter_t0;
+        YM7128B_Float filter_c0  = YM7128B_MulFloat(filter_t0, patch->gains_[YM7128B_Reg_C0]);
+        YM7128B_Float filter_c1  = YM7128B_MulFloat(filter_d, patch->gains_[YM7128B_Reg_C1]);
+        YM7128B_Float filter_sum = YM7128B_AddFloat(filter_c0, filter_c1);
+        YM7128B_Float filter_vc  = YM7128B_MulFloat(filter_sum, patch->gains_[YM7128B_Reg_VC]);
+
+        YM7128B_Float input_vm  = YM7128B_MulFloat(sample, patch->gains_[YM7128B_Reg_VM]);
+        YM7128B_Float input_sum = YM7128B_AddFloat(input_vm, filter_vc);
+
+        tail = tail ? (tail - 1) : (length - 1);
+        self->buffer_[tail] = input_sum;
+        silence = (input_sum != 0) ? 0 : (silence + 1);
+        YM7128B_STATS(
+            cycles = YM7128B_Stats_Lap_(stats, YM7128B_Stage_Feedback, cycles);
+        )
+
+        YM7128B_Float accums[YM7128B_OutputChannel_Count] = { 0, 0 };
+
+        for (YM7128B_Register i = 0; i < (sparse ? lane_count : (YM7128B_Register)YM7128B_Gain_Lane_Count); ++i) {
+            YM7128B_Register tap = (sparse ? lanes[i] : i) + 1;
+            YM7128B_TapIdeal t = tail + patch->taps_[tap];
+            YM7128B_TapIdeal head = (t >= length) ? (t - length) : t;
+            YM7128B_Float buffered = self->buffer_[head];
+            YM7128B_STATS(YM7128B_Stats_PeakFloat_(&lane_peaks[tap - 1], buffered);)
+
+            for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+                YM7128B_Register gb = YM7128B_Reg_GL1 + (channel * YM7128B_Gain_Lane_Count);
+                YM7128B_Float g = patch->gains_[gb + tap - 1];
+                YM7128B_Float buffered_g = YM7128B_MulFloat(buffered, g);
+                accums[channel] += buffered_g;
+            }
+        }
+
+        YM7128B_STATS(cycles = YM7128B_Stats_Lap_(stats, YM7128B_Stage_Mix, cycles);)
+
+        for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+            YM7128B_Float accum = accums[channel];
+
+            YM7128B_Float total = accum;
+            YM7128B_Float v = patch->gains_[YM7128B_Reg_VL + channel];
+            YM7128B_Float total_v = YM7128B_MulFloat(total, v);
+            YM7128B_STATS(YM7128B_Stats_PeakFloat_(&output_peaks[channel], total_v);)
+            YM7128B_Float og = 1 / (YM7128B_Float)YM7128B_Oversampling;
+            YM7128B_Float oversampled = YM7128B_MulFloat(total_v, og);
+            outputs[channel][index] = oversampled;
+        }
+        YM7128B_STATS(cycles = YM7128B_Stats_Lap_(stats, YM7128B_Stage_Oversampler, cycles);)
+    }
+
+    self->tail_ = tail;
+    self->t0_d_ = t0_d;
+    self->silence_ = silence;
+    YM7128B_STATS(YM7128B_Stats_MergeFloat_(stats, lane_peaks, output_peaks);)
+}
+
+// ----------------------------------------------------------------------------
+
+static void YM7128B_ChipIdeal_ProcessSpan_(
+    YM7128B_ChipIdeal* self,
+    YM7128B_Float const* inputs,
+    size_t count,
+    YM7128B_Float* outputs_left,
+    YM7128B_Float* outputs_right
+)
+{
+    assert(self);
+    assert(inputs || !count);
+    assert(outputs_left || !count);
+    assert(outputs_right || !count);
+
+    if ((self->buffer_ == NULL) || (self->length_ == 0)) {
+        return;
+    }
+
+    size_t idle = YM7128B_ChipIdeal_ProcessIdle_(self, inputs, count, outputs_left, outputs_right);
+    inputs += idle;
+    count -= idle;
+    outputs_left += idle;
+    outputs_right += idle;
+
+    if (YM7128B_ChipIdeal_Patch_(self)->flags_ & YM7128B_PatchFlag_Sparse) {
+        YM7128B_ChipIdeal_ProcessBlock_(self, inputs, count, outputs_left, outputs_right, true);
+    }
+    else {
+        YM7128B_ChipIdeal_ProcessBlock_(self, inputs, count, outputs_left, outputs_right, false);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+// Takes the latest register image posted to the mailbox, if any
+static void YM7128B_ChipIdeal_Receive_(YM7128B_ChipIdeal* self)
+{
+    YM7128B_MailboxIdeal* mailbox = self->mailbox_;
+
+    if (YM7128B_Mailbox_Acquire_(&mailbox->core_)) {
+        YM7128B_PatchIdeal const* patch = &mailbox->slots_[mailbox->core_.front_];
+        if (!YM7128B_ChipIdeal_SetPatch(self, patch)) {
+            // Posted for another sample rate: set up again at the chip one
+            YM7128B_PatchIdeal_Setup(&self->own_, patch->regs_, self->sample_rate_);
+            self->patch_ = NULL;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipIdeal_ProcessBlock(
+    YM7128B_ChipIdeal* self,
+    YM7128B_Float const* inputs,
+    size_t count,
+    YM7128B_Float* outputs_left,
+    YM7128B_Float* outputs_right
+)
+{
+    assert(self);
+    assert(inputs || !count);
+    assert(outputs_left || !count);
+    assert(outputs_right || !count);
+
+    if (self->mailbox_) {
+        YM7128B_ChipIdeal_Receive_(self);
+    }
+
+    YM7128B_WriteQueue* queue = &self->queue_;
+    YM7128B_WriteEvent const* event;
+    size_t offset;
+    size_t done = 0;
+
+    while (YM7128B_WriteQueue_Peek(queue, count, &offset, &event)) {
+        if (offset > done) {
+            YM7128B_ChipIdeal_ProcessSpan_(
+                self,
+                &inputs[done],
+                offset - done,
+                &outputs_left[done],
+                &outputs_right[done]
+            );
+            done = offset;
+        }
+        YM7128B_ChipIdeal_Write(self, event->address, event->data);
+        YM7128B_WriteQueue_Pop(queue, offset, self->sample_rate_);
+    }
+
+    if (done < count) {
+        YM7128B_ChipIdeal_ProcessSpan_(
+            self,
+            &inputs[done],
+            count - done,
+            &outputs_left[done],
+            &outputs_right[done]
+        );
+    }
+
+    YM7128B_WriteQueue_Advance(queue, count);
+    self->written_ += count;
+    YM7128B_STATS(self->stats_.samples += count;)
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipIdeal_ProcessBlockOutput(
+    YM7128B_ChipIdeal* self,
+    YM7128B_OutputStage const* stage,
+    YM7128B_Float const* inputs,
+    size_t count,
+    YM7128B_OutputFormat format,
+    void* frames
+)
+{
+    assert(self);
+    assert(stage);
+    assert(inputs || !count);
+    assert(frames || !count);
+    assert(format < YM7128B_OutputFormat_Count);
+
+    // The wet outputs of each chunk stay in cache, for the mix to follow
+    YM7128B_Float outputs[YM7128B_OutputChannel_Count][YM7128B_OutputStage_Chunk];
+    size_t stride = YM7128B_OutputFormat_GetSize(format) * YM7128B_OutputChannel_Count;
+    unsigned char* dst = (unsigned char*)frames;
+
+    while (count) {
+        size_t chunk = (count < YM7128B_OutputStage_Chunk) ? count : (size_t)YM7128B_OutputStage_Chunk;
+
+        YM7128B_ChipIdeal_ProcessBlock(
+            self,
+            inputs,
+            chunk,
+            outputs[YM7128B_OutputChannel_Left],
+            outputs[YM7128B_OutputChannel_Right]
+        );
+        YM7128B_OutputStage_MixFloat_(
+            stage,
+            inputs,
+            chunk,
+            1,
+            outputs[YM7128B_OutputChannel_Left],
+            outputs[YM7128B_OutputChannel_Right],
+            format,
+            dst
+        );
+        inputs += chunk;
+        dst += chunk * stride;
+        count -= chunk;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_Register YM7128B_ChipIdeal_Read(
+    YM7128B_ChipIdeal const* self,
+    YM7128B_Address address
+)
+{
+    assert(self);
+
+    YM7128B_PatchIdeal const* patch = YM7128B_ChipIdeal_Patch_(self);
+
+    if (address < YM7128B_Reg_C0) {
+        return patch->regs_[address] & YM7128B_Gain_Data_Mask;
+    }
+    else if (address < YM7128B_Reg_T0) {
+        return patch->regs_[address] & YM7128B_Coeff_Value_Mask;
+    }
+    else if (address < YM7128B_Reg_Count) {
+        return patch->regs_[address] & YM7128B_Tap_Value_Mask;
+    }
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipIdeal_Write(
+    YM7128B_ChipIdeal* self,
+    YM7128B_Address address,
+    YM7128B_Register data
+)
+{
+    assert(self);
+
+    if (address < YM7128B_Reg_Count) {
+        YM7128B_PatchIdeal* patch = YM7128B_ChipIdeal_OwnPatch_(self);
+        YM7128B_PatchIdeal_Write_(patch, address, data);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipIdeal_SetPatch(
+    YM7128B_ChipIdeal* self,
+    YM7128B_PatchIdeal const* patch
+)
+{
+    assert(self);
+    assert(patch);
+
+    if (patch->sample_rate_ != self->sample_rate_) {
+        return false;
+    }
+    self->patch_ = patch;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_PatchIdeal const* YM7128B_ChipIdeal_GetPatch(YM7128B_ChipIdeal const* self)
+{
+    assert(self);
+
+    return YM7128B_ChipIdeal_Patch_(self);
+}
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipIdeal_ScheduleWrite(
+    YM7128B_ChipIdeal* self,
+    size_t offset,
+    YM7128B_Address address,
+    YM7128B_Register data
+)
+{
+    assert(self);
+
+    return YM7128B_WriteQueue_Push(&self->queue_, offset, address, data);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipIdeal_SetWritePacing(
+    YM7128B_ChipIdeal* self,
+    bool enabled
+)
+{
+    assert(self);
+
+    self->queue_.pacing_ = enabled;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t YM7128B_ChipIdeal_GetLatency(YM7128B_ChipIdeal const* self)
+{
+    (void)self;
+    assert(self);
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+// Reverses the delay line span [begin, end)
+static void YM7128B_ChipIdeal_Reverse_(
+    YM7128B_Float* buffer,
+    YM7128B_TapIdeal begin,
+    YM7128B_TapIdeal end
+)
+{
+    while (begin + 1 < end) {
+        YM7128B_Float sample = buffer[begin];
+        buffer[begin++] = buffer[--end];
+        buffer[end] = sample;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+// Rearranges the delay line by sample age, then stretches it in place to the
+// new length and sample rate, by linear interpolation; tail_ is reset.
+static void YM7128B_ChipIdeal_Resample_(
+    YM7128B_ChipIdeal* self,
+    YM7128B_TapIdeal length,
+    YM7128B_TapIdeal sample_rate
+)
+{
+    YM7128B_Float* buffer = self->buffer_;
+    YM7128B_TapIdeal old_length = self->length_;
+    YM7128B_TapIdeal old_rate = self->sample_rate_;
+    YM7128B_TapIdeal tail = self->tail_;
+    self->tail_ = 0;
+
+    if (!old_length || !sample_rate) {
+        for (YM7128B_TapIdeal i = 0; i < length; ++i) {
+            buffer[i] = 0;
+        }
+        return;
+    }
+
+    // Rotate so that buffer[age] holds the sample of that age
+    if (tail < old_length) {
+        YM7128B_ChipIdeal_Reverse_(buffer, 0, tail);
+        YM7128B_ChipIdeal_Reverse_(buffer, tail, old_length);
+        YM7128B_ChipIdeal_Reverse_(buffer, 0, old_length);
+    }
+
+    // Each new age reads older positions when the rate goes down, newer when
+    // it goes up, so the scan direction never reads an already overwritten
+    // sample; close rates may share the same length, so the rate decides
+    bool growing = (sample_rate > old_rate);
+    for (YM7128B_TapIdeal n = 0; n < length; ++n) {
+        YM7128B_TapIdeal age = growing ? (length - 1 - n) : n;
+        uint64_t position = (uint64_t)age * old_rate;
+        uint64_t index = position / sample_rate;
+        uint64_t remainder = position % sample_rate;
+        if (index >= old_length) {
+            index = old_length - 1;
+            remainder = 0;
+        }
+        YM7128B_Float sample = buffer[index];
+        if (remainder && (index + 1 < old_length)) {
+            YM7128B_Float delta = buffer[index + 1] - sample;
+            sample += delta * ((YM7128B_Float)remainder / (YM7128B_Float)sample_rate);
+        }
+        buffer[age] = sample;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipIdeal_Setup(
+    YM7128B_ChipIdeal* self,
+    YM7128B_TapIdeal sample_rate
+)
+{
+    assert(self);
+
+    if ((self->sample_rate_ != sample_rate) || (self->buffer_ == NULL)) {
+        YM7128B_TapIdeal length = (sample_rate >= 10) ? ((sample_rate / 10) + 1) : 0;
+
+        if (self->buffer_ && (length <= self->capacity_)) {
+            bool silent = (self->silence_ >= self->length_);
+            YM7128B_ChipIdeal_Resample_(self, length, sample_rate);
+            self->silence_ = silent ? length : 0;
+        }
+        else {
+            if (self->buffer_owned_) {
+                free(self->buffer_);
+            }
+            self->buffer_ = NULL;
+            self->buffer_owned_ = false;
+            self->capacity_ = 0;
+            self->tail_ = 0;
+
+            if (length) {
+                self->buffer_ = (YM7128B_Float*)calloc(length, sizeof(YM7128B_Float));
+                if (self->buffer_) {
+                    self->buffer_owned_ = true;
+                    self->capacity_ = length;
+                }
+            }
+            self->silence_ = length;
+        }
+
+        self->sample_rate_ = sample_rate;
+        self->length_ = length;
+        self->written_ = length;
+
+        if (length) {
+            YM7128B_ChipIdeal_Retap_(self);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipIdeal_Reserve(
+    YM7128B_ChipIdeal* self,
+    YM7128B_TapIdeal max_sample_rate
+)
+{
+    assert(self);
+
+    YM7128B_TapIdeal capacity = (max_sample_rate >= 10) ? ((max_sample_rate / 10) + 1) : 0;
+    if (!capacity || (self->buffer_ && (capacity <= self->capacity_))) {
+        return true;
+    }
+
+    YM7128B_Float* buffer = (YM7128B_Float*)calloc(capacity, sizeof(YM7128B_Float));
+    if (!buffer) {
+        return false;
+    }
+
+    if (self->buffer_) {
+        YM7128B_TapIdeal tail = self->tail_;
+        for (YM7128B_TapIdeal age = 0; age < self->length_; ++age) {
+            buffer[age] = self->buffer_[tail];
+            tail = ((tail + 1) < self->length_) ? (tail + 1) : 0;
+        }
+        if (self->buffer_owned_) {
+            free(self->buffer_);
+        }
+    }
+
+    self->buffer_ = buffer;
+    self->buffer_owned_ = true;
+    self->capacity_ = capacity;
+    self->tail_ = 0;
+    self->written_ = self->length_;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t YM7128B_ChipIdeal_RequiredBytes(YM7128B_TapIdeal sample_rate)
+{
+    if (sample_rate < 10) {
+        return 0;
+    }
+    size_t const mask = (size_t)YM7128B_CACHE_LINE - 1;
+    size_t length = (size_t)(sample_rate / 10) + 1;
+    return ((length * sizeof(YM7128B_Float)) + mask) & ~mask;
+}
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipIdeal_SetupWithMemory(
+    YM7128B_ChipIdeal* self,
+    YM7128B_TapIdeal sample_rate,
+    void* memory,
+    size_t bytes
+)
+{
+    assert(self);
+
+    size_t required = YM7128B_ChipIdeal_RequiredBytes(sample_rate);
+    if (required) {
+        if (!memory || (bytes < required) ||
+            ((uintptr_t)memory % sizeof(YM7128B_Float))) {
+            return false;
+        }
+    }
+
+    if (self->buffer_owned_) {
+        free(self->buffer_);
+    }
+    self->buffer_ = NULL;
+    self->buffer_owned_ = false;
+    self->length_ = 0;
+    self->capacity_ = 0;
+    self->tail_ = 0;
+    self->sample_rate_ = sample_rate;
+
+    if (required) {
+        self->length_ = (sample_rate / 10) + 1;
+        self->capacity_ = (YM7128B_TapIdeal)(bytes / sizeof(YM7128B_Float));
+        self->buffer_ = (YM7128B_Float*)memory;
+
+        for (YM7128B_TapIdeal i = 0; i < self->length_; ++i) {
+            self->buffer_[i] = 0;
+        }
+        self->silence_ = self->length_;
+        self->written_ = self->length_;
+
+        YM7128B_ChipIdeal_Retap_(self);
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+static void YM7128B_ChipIdeal_StateView_(
+    YM7128B_ChipIdeal* self,
+    YM7128B_StateView_* view
+)
+{
+    view->engine = YM7128B_ChipEngine_Ideal;
+    view->sample_size = sizeof(YM7128B_Float);
+    view->length = (self->buffer_ ? self->length_ : 0);
+    view->capacity = view->length;
+    view->tail = self->tail_;
+    view->silence = self->silence_;
+    view->written = self->written_;
+    view->regs = YM7128B_ChipIdeal_Patch_(self)->regs_;
+    view->t0_d = &self->t0_d_;
+    view->buffer = self->buffer_;
+    view->queue = &self->queue_;
+    view->interpolators = 0;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t YM7128B_ChipIdeal_GetStateSize(YM7128B_ChipIdeal const* self)
+{
+    assert(self);
+
+    return YM7128B_State_Size_(
+        sizeof(YM7128B_Float), 0,
+        YM7128B_WRITE_QUEUE_LENGTH, (self->buffer_ ? self->length_ : 0)
+    );
+}
+
+// ----------------------------------------------------------------------------
+
+size_t YM7128B_ChipIdeal_SaveState(
+    YM7128B_ChipIdeal* self,
+    void* buffer,
+    size_t size,
+    bool delta
+)
+{
+    assert(self);
+
+    YM7128B_StateView_ view;
+    YM7128B_ChipIdeal_StateView_(self, &view);
+
+    size_t saved = YM7128B_State_Save_(&view, buffer, size, delta);
+    if (saved) {
+        self->written_ = 0;
+    }
+    return saved;
+}
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipIdeal_LoadState(
+    YM7128B_ChipIdeal* self,
+    void const* buffer,
+    size_t size
+)
+{
+    assert(self);
+
+    YM7128B_Register regs[YM7128B_Reg_Count];
+    YM7128B_StateView_ view;
+    YM7128B_ChipIdeal_StateView_(self, &view);
+
+    if (!YM7128B_State_Load_(&view, buffer, size, regs)) {
+        return false;
+    }
+
+    self->tail_ = (YM7128B_TapIdeal)view.tail;
+    self->silence_ = view.silence;
+    self->written_ = 0;
+
+    for (YM7128B_Address i = YM7128B_Address_Min; i <= YM7128B_Address_Max; ++i) {
+        YM7128B_ChipIdeal_Write(self, i, regs[i]);
+    }
+    return true;
+}
+
+// ============================================================================
+
+static void YM7128B_PatchShort_Write_(
+    YM7128B_PatchShort* self,
+    YM7128B_Address address,
+    YM7128B_Register data
+)
+{
+    if (address < YM7128B_Reg_C0) {
+        self->regs_[address] = data & YM7128B_Gain_Data_Mask;
+        self->gains_[address] = YM7128B_RegisterToGainShort(data);
+    }
+    else if (address < YM7128B_Reg_T0) {
+        self->regs_[address] = data & YM7128B_Coeff_Value_Mask;
+        self->gains_[address] = YM7128B_RegisterToCoeffShort(data);
+    }
+    else {
+        self->regs_[address] = data & YM7128B_Tap_Value_Mask;
+        self->taps_[address - YM7128B_Reg_T0] = YM7128B_RegisterToTapIdeal(data, self->sample_rate_);
+        return;
+    }
+
+    bool zero[YM7128B_Reg_T0];
+    for (YM7128B_Address i = 0; i < YM7128B_Reg_T0; ++i) {
+        zero[i] = (self->gains_[i] == 0);
+    }
+    self->flags_ = YM7128B_Patch_Flags_(zero);
+    self->lane_count_ = YM7128B_Patch_Lanes_(zero, self->lanes_);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_PatchShort_Setup(
+    YM7128B_PatchShort* self,
+    YM7128B_Register const regs[YM7128B_Reg_Count],
+    YM7128B_TapIdeal sample_rate
+)
+{
+    assert(self);
+    assert(regs);
+
+    self->sample_rate_ = sample_rate;
+
+    for (YM7128B_Address i = YM7128B_Address_Min; i <= YM7128B_Address_Max; ++i) {
+        YM7128B_PatchShort_Write_(self, i, regs[i]);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+static YM7128B_PatchShort const* YM7128B_ChipShort_Patch_(YM7128B_ChipShort const* self)
+{
+    return self->patch_ ? self->patch_ : &self->own_;
+}
+
+// ----------------------------------------------------------------------------
+
+// Copies the shared patch, if any, so that the chip owns its registers
+static YM7128B_PatchShort* YM7128B_ChipShort_OwnPatch_(YM7128B_ChipShort* self)
+{
+    if (self->patch_) {
+        self->own_ = *self->patch_;
+        self->patch_ = NULL;
+    }
+    return &self->own_;
+}
+
+// ----------------------------------------------------------------------------
+
+// Resolves the taps at the chip sample rate
+static void YM7128B_ChipShort_Retap_(YM7128B_ChipShort* self)
+{
+    if (self->patch_ && (self->patch_->sample_rate_ == self->sample_rate_)) {
+        return;
+    }
+
+    YM7128B_PatchShort* patch = YM7128B_ChipShort_OwnPatch_(self);
+    patch->sample_rate_ = self->sample_rate_;
+
+    for (YM7128B_Address i = 0; i < YM7128B_Tap_Count; ++i) {
+        YM7128B_Register data = patch->regs_[i + YM7128B_Reg_T0];
+        patch->taps_[i] = YM7128B_RegisterToTapIdeal(data, patch->sample_rate_);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipShort_Ctor(YM7128B_ChipShort* self)
+{
+    assert(self);
+
+    self->patch_ = NULL;
+    self->mailbox_ = NULL;
+    YM7128B_ChipShort_ResetStats(self);
+    self->own_.sample_rate_ = 0;
+    self->buffer_ = NULL;
+    self->length_ = 0;
+    self->silence_ = 0;
+    self->written_ = 0;
+    self->capacity_ = 0;
+    self->sample_rate_ = 0;
+    self->buffer_owned_ = false;
+    self->kernel_ = YM7128B_Kernel_GetBest();
+
+    YM7128B_WriteQueue_Clear(&self->queue_);
+    self->queue_.pacing_ = false;
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipShort_Dtor(YM7128B_ChipShort* self)
+{
+    assert(self);
+
+    if (self->buffer_owned_) {
+        free(self->buffer_);
+    }
+    self->buffer_ = NULL;
+    self->buffer_owned_ = false;
+    self->length_ = 0;
+    self->capacity_ = 0;
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipShort_Reset(YM7128B_ChipShort* self)
+{
+    assert(self);
+
+    for (YM7128B_Address i = YM7128B_Address_Min; i <= YM7128B_Address_Max; ++i) {
+        YM7128B_ChipShort_Write(self, i, 0x00);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipShort_Start(YM7128B_ChipShort* self)
+{
+    assert(self);
+
+    self->t0_d_ = 0;
+
+    self->tail_ = 0;
+    self->silence_ = self->length_;
+    self->written_ = self->length_;
+
+    YM7128B_WriteQueue_Clear(&self->queue_);
+
+    if (self->buffer_) {
+        for (YM7128B_TapIdeal i = 0; i < self->length_; ++i) {
+            self->buffer_[i] = 0;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipShort_Stop(YM7128B_ChipShort* self)
+{
+    (void)self;
+    assert(self);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipShort_Process(
+    YM7128B_ChipShort* self,
+    YM7128B_ChipShort_Process_Data* data
+)
+{
+    assert(self);
+    assert(data);
+
+    YM7128B_ChipShort_ProcessBlock(
+        self,
+        &data->inputs[YM7128B_InputChannel_Mono],
+        1,
+        &data->outputs[YM7128B_OutputChannel_Left],
+        &data->outputs[YM7128B_OutputChannel_Right]
+    );
+}
+
+// ----------------------------------------------------------------------------
+
+typedef void (*YM7128B_MixShort_Func)(
+    YM7128B_Fixed const samples[YM7128B_Gain_Lane_Count],
+    YM7128B_Fixed const gains[YM7128B_OutputChannel_Count * YM7128B_Gain_Lane_Count],
+    YM7128B_Fixed accums[YM7128B_OutputChannel_Count]
+);
+
+// ----------------------------------------------------------------------------
+
+// Specialized by the patch: without feedback, the filter is skipped;
+// when sparse, only the output taps not silent are gathered.
+// Both keep the results exactly the same, as the skipped terms are zero.
+YM7128B_FORCE_INLINE
+void YM7128B_ChipShort_ProcessBlock_(
+    YM7128B_ChipShort* self,
+    YM7128B_Fixed const* inputs,
+    size_t count,
+    YM7128B_Fixed* outputs_left,
+    YM7128B_Fixed* outputs_right,
+    YM7128B_MixShort_Func mix,
+    bool feedback,
+    bool sparse
+)
+{
+    YM7128B_Fixed* outputs[YM7128B_OutputChannel_Count];
+    outputs[YM7128B_OutputChannel_Left] = outputs_left;
+    outputs[YM7128B_OutputChannel_Right] = outputs_right;
+
+    YM7128B_TapIdeal length = self->length_;
+    YM7128B_PatchShort const* patch = YM7128B_ChipShort_Patch_(self);
+    YM7128B_TapIdeal tail = self->tail_;
+    YM7128B_Fixed t0_d = self->t0_d_;
+    YM7128B_TapIdeal silence = self->silence_;
+    YM7128B_STATS(
+        YM7128B_Stats* stats = &self->stats_;
+        YM7128B_Accumulator lane_peaks[YM7128B_Gain_Lane_Count] = { 0 };
+        YM7128B_Accumulator output_peaks[YM7128B_OutputChannel_Count] = { 0 };
+        uint64_t cycles = YM7128B_Stats_Cycles_();
+    )
+
+    // Silent output taps are not gathered, their samples staying at zero
+    YM7128B_Register lane_count = patch->lane_count_;
+    YM7128B_Fixed samples[YM7128B_Gain_Lane_Count] = { 0 };
+
+    for (size_t index = 0; index < count; ++index) {
+        YM7128B_Fixed input = inputs[index];
+        YM7128B_Fixed sample = input;
+
+        YM7128B_TapIdeal t0 = tail + patch->taps_[0];
+        YM7128B_TapIdeal filter_head = (t0 >= length) ? (t0 - length) : t0;
+        YM7128B_Fixed filter_t0  = self->buffer_[filter_head];
+        YM7128B_Fixed filter_d   = t0_d;
+        t0_d = filter_t0;
+        YM7128B_Fixed filter_vc  = 0;
+        if (feedback) {
+            YM7128B_Fixed filter_c0  = YM7128B_MulShort(filter_t0, patch->gains_[YM7128B_Reg_C0]);
+            YM7128B_Fixed filter_c1  = YM7128B_MulShort(filter_d, patch->gains_[YM7128B_Reg_C1]);
+            YM7128B_Fixed filter_sum = YM7128B_ClampAddShort(filter_c0, filter_c1);
+            YM7128B_STATS(stats->feedback_clamps += YM7128B_Stats_ClampsAddShort_(filter_c0, filter_c1);)
+            filter_vc = YM7128B_MulShort(filter_sum, patch->gains_[YM7128B_Reg_VC]);
+        }
+
+        YM7128B_Fixed input_vm  = YM7128B_MulShort(sample, patch->gains_[YM7128B_Reg_VM]);
+        YM7128B_Fixed input_sum = YM7128B_ClampAddShort(input_vm, filter_vc);
+
+        tail = tail ? (tail - 1) : (length - 1);
+        self->buffer_[tail] = input_sum;
+        silence = (input_sum != 0) ? 0 : (silence + 1);
+        YM7128B_STATS(
+            stats->feedback_clamps += YM7128B_Stats_ClampsAddShort_(input_vm, filter_vc);
+            cycles = YM7128B_Stats_Lap_(stats, YM7128B_Stage_Feedback, cycles);
+        )
+
+        if (sparse) {
+            for (YM7128B_Register i = 0; i < lane_count; ++i) {
+                YM7128B_Register lane = patch->lanes_[i];
+                YM7128B_TapIdeal t = tail + patch->taps_[lane + 1];
+                YM7128B_TapIdeal head = (t >= length) ? (t - length) : t;
+                samples[lane] = self->buffer_[head];
+            }
+        }
+        else {
+            for (YM7128B_Register tap = 1; tap < YM7128B_Tap_Count; ++tap) {
+                YM7128B_TapIdeal t = tail + patch->taps_[tap];
+                YM7128B_TapIdeal head = (t >= length) ? (t - length) : t;
+                samples[tap - 1] = self->buffer_[head];
+            }
+        }
+
+        YM7128B_STATS(
+            for (YM7128B_Register lane = 0; lane < YM7128B_Gain_Lane_Count; ++lane) {
+                YM7128B_Stats_PeakFixed_(&lane_peaks[lane], samples[lane]);
+            }
+        )
+
+        YM7128B_Fixed accums[YM7128B_OutputChannel_Count];
+        mix(samples, &patch->gains_[YM7128B_Reg_GL1], accums);
+        YM7128B_STATS(cycles = YM7128B_Stats_Lap_(stats, YM7128B_Stage_Mix, cycles);)
+
+        for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+            YM7128B_Fixed total = accums[channel];
+            YM7128B_Fixed v = patch->gains_[YM7128B_Reg_VL + channel];
+            YM7128B_Fixed total_v = YM7128B_MulShort(total, v);
+            YM7128B_STATS(YM7128B_Stats_PeakFixed_(&output_peaks[channel], total_v);)
+            YM7128B_Fixed oversampled = total_v / (YM7128B_Fixed)YM7128B_Oversampling;
+            outputs[channel][index] = oversampled;
+        }
+        YM7128B_STATS(cycles = YM7128B_Stats_Lap_(stats, YM7128B_Stage_Oversampler, cycles);)
+    }
+
+    self->tail_ = tail;
+    self->t0_d_ = t0_d;
+    self->silence_ = silence;
+    YM7128B_STATS(YM7128B_Stats_MergeFixed_(stats, lane_peaks, output_peaks);)
+}
+
+// ----------------------------------------------------------------------------
+
+#define YM7128B_CHIPSHORT_PROCESSBLOCK(name, isa) \
+    static isa void YM7128B_ChipShort_ProcessBlock_##name( \
+        YM7128B_ChipShort* self, \
+        YM7128B_Fixed const* inputs, \
+        size_t count, \
+        YM7128B_Fixed* outputs_left, \
+        YM7128B_Fixed* outputs_right \
+    ) \
+    { \
+        unsigned flags = YM7128B_ChipShort_Patch_(self)->flags_; \
+        bool feedback = !(flags & YM7128B_PatchFlag_NoFeedback); \
+        bool sparse = !!(flags & YM7128B_PatchFlag_Sparse); \
+        if (feedback) { \
+            if (sparse) { \
+                YM7128B_ChipShort_ProcessBlock_( \
+                    self, inputs, count, outputs_left, outputs_right, \
+                    YM7128B_MixShort_##name, true, true \
+                ); \
+            } \
+            else { \
+                YM7128B_ChipShort_ProcessBlock_( \
+                    self, inputs, count, outputs_left, outputs_right, \
+                    YM7128B_MixShort_##name, true, false \
+                ); \
+            } \
+        } \
+        else { \
+            if (sparse) { \
+                YM7128B_ChipShort_ProcessBlock_( \
+                    self, inputs, count, outputs_left, outputs_right, \
+                    YM7128B_MixShort_##name, false, true \
+                ); \
+            } \
+            else { \
+                YM7128B_ChipShort_ProcessBlock_( \
+                    self, inputs, count, outputs_left, outputs_right, \
+                    YM7128B_MixShort_##name, false, false \
+                ); \
+            } \
+        } \
+    }
+
+YM7128B_CHIPSHORT_PROCESSBLOCK(Scalar, )
+#if YM7128B_SIMD_X86
+YM7128B_CHIPSHORT_PROCESSBLOCK(SSE2, YM7128B_TARGET("sse2"))
+YM7128B_CHIPSHORT_PROCESSBLOCK(AVX2, YM7128B_TARGET("avx2"))
+#endif
+#if YM7128B_SIMD_NEON
+YM7128B_CHIPSHORT_PROCESSBLOCK(NEON, )
+#endif
+
+#undef YM7128B_CHIPSHORT_PROCESSBLOCK
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipShort_IsIdle(YM7128B_ChipShort const* self)
+{
+    assert(self);
+
+    if ((self->silence_ < self->length_) || (self->t0_d_ != 0)) {
+        return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipShort_GetStats(
+    YM7128B_ChipShort const* self,
+    YM7128B_Stats* stats
+)
+{
+    assert(self);
+    assert(stats);
+
+#if YM7128B_USE_STATS
+    *stats = self->stats_;
+#else
+    (void)self;
+    memset(stats, 0, sizeof(*stats));
+#endif
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipShort_ResetStats(YM7128B_ChipShort* self)
+{
+    (void)self;
+    assert(self);
+
+    YM7128B_STATS(memset(&self->stats_, 0, sizeof(self->stats_));)
+}
+
+// ----------------------------------------------------------------------------
+
+// Digital silence fast path: while idle, silent input samples just advance
+// the delay line, yielding silent outputs.
+// Returns the number of processed input samples.
+static size_t YM7128B_ChipShort_ProcessIdle_(
+    YM7128B_ChipShort* self,
+    YM7128B_Fixed const* inputs,
+    size_t count,
+    YM7128B_Fixed* outputs_left,
+    YM7128B_Fixed* outputs_right
+)
+{
+    if (!count || !YM7128B_ChipShort_IsIdle(self)) {
+        return 0;
+    }
+
+    size_t idle = 0;
+    while ((idle < count) && (inputs[idle] == 0)) {
+        ++idle;
+    }
+
+    for (size_t i = 0; i < idle; ++i) {
+        outputs_left[i] = 0;
+        outputs_right[i] = 0;
+    }
+
+    self->tail_ = YM7128B_Ring_Rewind_(self->tail_, idle, self->length_);
+    self->silence_ += idle;
+    YM7128B_STATS(self->stats_.idle_samples += idle;)
+    return idle;
+}
+
+// ----------------------------------------------------------------------------
+
+static void YM7128B_ChipShort_ProcessSpan_(
+    YM7128B_ChipShort* self,
+    YM7128B_Fixed const* inputs,
+    size_t count,
+    YM7128B_Fixed* outputs_left,
+    YM7128B_Fixed* outputs_right
+)
+{
+    assert(self);
+    assert(inputs || !count);
+    assert(outputs_left || !count);
+    assert(outputs_right || !count);
+
+    if ((self->buffer_ == NULL) || (self->length_ == 0)) {
+        return;
+    }
+
+    size_t idle = YM7128B_ChipShort_ProcessIdle_(self, inputs, count, outputs_left, outputs_right);
+    inputs += idle;
+    count -= idle;
+    outputs_left += idle;
+    outputs_right += idle;
+
+    switch (self->kernel_)
+    {
+#if YM7128B_SIMD_X86
+    case YM7128B_Kernel_SSE2:
+        YM7128B_ChipShort_ProcessBlock_SSE2(self, inputs, count, outputs_left, outputs_right);
+        break;
+
+    case YM7128B_Kernel_AVX2:
+        YM7128B_ChipShort_ProcessBlock_AVX2(self, inputs, count, outputs_left, outputs_right);
+        break;
+#endif
+#if YM7128B_SIMD_NEON
+    case YM7128B_Kernel_NEON:
+        YM7128B_ChipShort_ProcessBlock_NEON(self, inputs, count, outputs_left, outputs_right);
+        break;
+#endif
+    default:
+        YM7128B_ChipShort_ProcessBlock_Scalar(self, inputs, count, outputs_left, outputs_right);
+        break;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+// Takes the latest register image posted to the mailbox, if any
+static void YM7128B_ChipShort_Receive_(YM7128B_ChipShort* self)
+{
+    YM7128B_MailboxShort* mailbox = self->mailbox_;
+
+    if (YM7128B_Mailbox_Acquire_(&mailbox->core_)) {
+        YM7128B_PatchShort const* patch = &mailbox->slots_[mailbox->core_.front_];
+        if (!YM7128B_ChipShort_SetPatch(self, patch)) {
+            // Posted for another sample rate: set up again at the chip one
+            YM7128B_PatchShort_Setup(&self->own_, patch->regs_, self->sample_rate_);
+            self->patch_ = NULL;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipShort_ProcessBlock(
+    YM7128B_ChipShort* self,
+    YM7128B_Fixed const* inputs,
+    size_t count,
+    YM7128B_Fixed* outputs_left,
+    YM7128B_Fixed* outputs_right
+)
+{
+    assert(self);
+    assert(inputs || !count);
+    assert(outputs_left || !count);
+    assert(outputs_right || !count);
+
+    if (self->mailbox_) {
+        YM7128B_ChipShort_Receive_(self);
+    }
+
+    YM7128B_WriteQueue* queue = &self->queue_;
+    YM7128B_WriteEvent const* event;
+    size_t offset;
+    size_t done = 0;
+
+    while (YM7128B_WriteQueue_Peek(queue, count, &offset, &event)) {
+        if (offset > done) {
+            YM7128B_ChipShort_ProcessSpan_(
+                self,
+                &inputs[done],
+                offset - done,
+                &outputs_left[done],
+                &outputs_right[done]
+            );
+            done = offset;
+        }
+        YM7128B_ChipShort_Write(self, event->address, event->data);
+        YM7128B_WriteQueue_Pop(queue, offset, self->sample_rate_);
+    }
+
+    if (done < count) {
+        YM7128B_ChipShort_ProcessSpan_(
+            self,
+            &inputs[done],
+            count - done,
+            &outputs_left[done],
+            &outputs_right[done]
+        );
+    }
+
+    YM7128B_WriteQueue_Advance(queue, count);
+    self->written_ += count;
+    YM7128B_STATS(self->stats_.samples += count;)
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipShort_ProcessBlockOutput(
+    YM7128B_ChipShort* self,
+    YM7128B_OutputStage const* stage,
+    YM7128B_Fixed const* inputs,
+    size_t count,
+    YM7128B_OutputFormat format,
+    void* frames
+)
+{
+    assert(self);
+    assert(stage);
+    assert(inputs || !count);
+    assert(frames || !count);
+    assert(format < YM7128B_OutputFormat_Count);
+
+    // The wet outputs of each chunk stay in cache, for the mix to follow
+    YM7128B_Fixed outputs[YM7128B_OutputChannel_Count][YM7128B_OutputStage_Chunk];
+    size_t stride = YM7128B_OutputFormat_GetSize(format) * YM7128B_OutputChannel_Count;
+    unsigned char* dst = (unsigned char*)frames;
+
+    while (count) {
+        size_t chunk = (count < YM7128B_OutputStage_Chunk) ? count : (size_t)YM7128B_OutputStage_Chunk;
+
+        YM7128B_ChipShort_ProcessBlock(
+            self,
+            inputs,
+            chunk,
+            outputs[YM7128B_OutputChannel_Left],
+            outputs[YM7128B_OutputChannel_Right]
+        );
+        YM7128B_OutputStage_MixFixed_(
+            stage,
+            inputs,
+            chunk,
+            1,
+            outputs[YM7128B_OutputChannel_Left],
+            outputs[YM7128B_OutputChannel_Right],
+            format,
+            dst
+        );
+        inputs += chunk;
+        dst += chunk * stride;
+        count -= chunk;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipShort_IsChunkable(YM7128B_ChipShort const* self)
+{
+    assert(self);
+
+    return self->buffer_ && self->length_ &&
+           ((YM7128B_ChipShort_Patch_(self)->flags_ & YM7128B_PatchFlag_NoFeedback) != 0);
+}
+
+// ----------------------------------------------------------------------------
+
+size_t YM7128B_ChipShort_GetOverlap(YM7128B_ChipShort const* self)
+{
+    assert(self);
+
+    return (size_t)self->length_;
+}
+
+// ----------------------------------------------------------------------------
+
+// Feeds the delay line only, as the processing loop does with a silent
+// feedback path, for inputs whose outputs are not needed
+static void YM7128B_ChipShort_Fill_(
+    YM7128B_ChipShort* self,
+    YM7128B_Fixed const* inputs,
+    size_t count
+)
+{
+    YM7128B_PatchShort const* patch = YM7128B_ChipShort_Patch_(self);
+    YM7128B_Fixed const vm = patch->gains_[YM7128B_Reg_VM];
+    YM7128B_TapIdeal length = self->length_;
+    YM7128B_TapIdeal tail = self->tail_;
+    YM7128B_Fixed t0_d = self->t0_d_;
+    YM7128B_TapIdeal silence = self->silence_;
+
+    for (size_t index = 0; index < count; ++index) {
+        YM7128B_Fixed sample = inputs[index];
+        YM7128B_TapIdeal t0 = tail + patch->taps_[0];
+        t0_d = self->buffer_[(t0 >= length) ? (t0 - length) : t0];
+
+        YM7128B_Fixed input_vm  = YM7128B_MulShort(sample, vm);
+        YM7128B_Fixed input_sum = YM7128B_ClampAddShort(input_vm, 0);
+
+        tail = tail ? (tail - 1) : (length - 1);
+        self->buffer_[tail] = input_sum;
+        silence = (input_sum != 0) ? 0 : (silence + 1);
+    }
+
+    self->tail_ = tail;
+    self->t0_d_ = t0_d;
+    self->silence_ = silence;
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipShort_Prime(
+    YM7128B_ChipShort* self,
+    YM7128B_Fixed const* inputs,
+    size_t count
+)
+{
+    assert(self);
+    assert(inputs || !count);
+
+    YM7128B_ChipShort_Start(self);
+
+    size_t overlap = YM7128B_ChipShort_GetOverlap(self);
+    if (count > overlap) {
+        inputs += count - overlap;
+        count = overlap;
+    }
+
+    // Without oversampler, the delay line is the whole processing state
+    if (self->buffer_ && self->length_) {
+        YM7128B_ChipShort_Fill_(self, inputs, count);
+    }
+    self->written_ += count;
+}
+
+// ----------------------------------------------------------------------------
+
+// Parallel render of a stream, shared by its chunk jobs
+typedef struct YM7128B_ChipShort_Render_
+{
+    YM7128B_ChipShort* self;
+    YM7128B_ChipShort* workers;  // by chunk, but the first
+    YM7128B_Fixed const* inputs;
+    size_t count;
+    YM7128B_Fixed* outputs_left;
+    YM7128B_Fixed* outputs_right;
+    size_t chunk_count;
+} YM7128B_ChipShort_Render_;
+
+static void YM7128B_ChipShort_RenderJob_(void* data, size_t index)
+{
+    YM7128B_ChipShort_Render_ const* render = (YM7128B_ChipShort_Render_ const*)data;
+    YM7128B_ChipShort* chip = index ? &render->workers[index - 1] : render->self;
+    size_t begin = (size_t)(((uint_fast64_t)render->count * index) / render->chunk_count);
+    size_t end = (size_t)(((uint_fast64_t)render->count * (index + 1)) / render->chunk_count);
+
+    YM7128B_ChipShort_Prime(chip, render->inputs, begin);
+    YM7128B_ChipShort_ProcessBlock(
+        chip,
+        &render->inputs[begin],
+        end - begin,
+        &render->outputs_left[begin],
+        &render->outputs_right[begin]
+    );
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipShort_RenderChunks(
+    YM7128B_ChipShort* self,
+    YM7128B_Fixed const* inputs,
+    size_t count,
+    YM7128B_Fixed* outputs_left,
+    YM7128B_Fixed* outputs_right,
+    size_t chunk_count,
+    YM7128B_RunJobs_Func run_jobs,
+    void* context
+)
+{
+    assert(self);
+    assert(inputs || !count);
+    assert(outputs_left || !count);
+    assert(outputs_right || !count);
+
+    // Registers are taken once, for the whole stream
+    struct YM7128B_MailboxShort* mailbox = self->mailbox_;
+    if (mailbox) {
+        YM7128B_ChipShort_Receive_(self);
+        self->mailbox_ = NULL;
+    }
+
+    // Chunks shorter than the overlap would be mostly priming
+    size_t overlap = YM7128B_ChipShort_GetOverlap(self);
+    size_t chunk_limit = overlap ? (count / overlap) : count;
+    if (chunk_count > chunk_limit) {
+        chunk_count = chunk_limit;
+    }
+
+    YM7128B_ChipShort* workers = NULL;
+    if ((chunk_count > 1) && run_jobs && YM7128B_ChipShort_IsChunkable(self)) {
+        size_t bytes = YM7128B_ChipShort_RequiredBytes(self->sample_rate_);
+        size_t const mask = (size_t)YM7128B_CACHE_LINE - 1;
+        size_t chips_bytes = (chunk_count - 1) * sizeof(YM7128B_ChipShort);
+        unsigned char* slab = (unsigned char*)malloc(chips_bytes + mask + ((chunk_count - 1) * bytes));
+        if (slab) {
+            // Chips first, then their delay memory, all from the same block
+            workers = (YM7128B_ChipShort*)slab;
+            unsigned char* memory = &slab[chips_bytes];
+            memory += (size_t)(-(intptr_t)memory) & mask;
+            for (size_t i = 0; i < (chunk_count - 1); ++i) {
+                YM7128B_ChipShort* worker = &workers[i];
+                YM7128B_ChipShort_Ctor(worker);
+                YM7128B_ChipShort_SetKernel(worker, self->kernel_);
+                YM7128B_ChipShort_SetupWithMemory(worker, self->sample_rate_, &memory[i * bytes], bytes);
+                YM7128B_ChipShort_SetPatch(worker, YM7128B_ChipShort_Patch_(self));
+            }
+        }
+    }
+
+    if (workers) {
+        YM7128B_ChipShort_Render_ render;
+        render.self = self;
+        render.workers = workers;
+        render.inputs = inputs;
+        render.count = count;
+        render.outputs_left = outputs_left;
+        render.outputs_right = outputs_right;
+        render.chunk_count = chunk_count;
+
+        run_jobs(context, chunk_count, YM7128B_ChipShort_RenderJob_, &render);
+
+        for (size_t i = 0; i < (chunk_count - 1); ++i) {
+            YM7128B_ChipShort_Dtor(&workers[i]);
+        }
+        free(workers);
+        YM7128B_ChipShort_Prime(self, inputs, count);
+    }
+    else {
+        YM7128B_ChipShort_Start(self);
+        YM7128B_ChipShort_ProcessBlock(self, inputs, count, outputs_left, outputs_right);
+    }
+
+    self->mailbox_ = mailbox;
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_Register YM7128B_ChipShort_Read(
+    YM7128B_ChipShort const* self,
+    YM7128B_Address address
+)
+{
+    assert(self);
+
+    YM7128B_PatchShort const* patch = YM7128B_ChipShort_Patch_(self);
+
+    if (address < YM7128B_Reg_C0) {
+        return patch->regs_[address] & YM7128B_Gain_Data_Mask;
+    }
+    else if (address < YM7128B_Reg_T0) {
+        return patch->regs_[address] & YM7128B_Coeff_Value_Mask;
+    }
+    else if (address < YM7128B_Reg_Count) {
+        return patch->regs_[address] & YM7128B_Tap_Value_Mask;
+    }
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipShort_Write(
+    YM7128B_ChipShort* self,
+    YM7128B_Address address,
+    YM7128B_Register data
+)
+{
+    assert(self);
+
+    if (address < YM7128B_Reg_Count) {
+        YM7128B_PatchShort* patch = YM7128B_ChipShort_OwnPatch_(self);
+        YM7128B_PatchShort_Write_(patch, address, data);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipShort_SetPatch(
+    YM7128B_ChipShort* self,
+    YM7128B_PatchShort const* patch
+)
+{
+    assert(self);
+    assert(patch);
+
+    if (patch->sample_rate_ != self->sample_rate_) {
+        return false;
+    }
+    self->patch_ = patch;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_PatchShort const* YM7128B_ChipShort_GetPatch(YM7128B_ChipShort const* self)
+{
+    assert(self);
+
+    return YM7128B_ChipShort_Patch_(self);
+}
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipShort_ScheduleWrite(
+    YM7128B_ChipShort* self,
+    size_t offset,
+    YM7128B_Address address,
+    YM7128B_Register data
+)
+{
+    assert(self);
+
+    return YM7128B_WriteQueue_Push(&self->queue_, offset, address, data);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipShort_SetWritePacing(
+    YM7128B_ChipShort* self,
+    bool enabled
+)
+{
+    assert(self);
+
+    self->queue_.pacing_ = enabled;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t YM7128B_ChipShort_GetLatency(YM7128B_ChipShort const* self)
+{
+    (void)self;
+    assert(self);
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipShort_SetKernel(
+    YM7128B_ChipShort* self,
+    YM7128B_Kernel kernel
+)
+{
+    assert(self);
+
+    if (!YM7128B_Kernel_IsSupported(kernel)) {
+        return false;
+    }
+    self->kernel_ = kernel;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+// Reverses the delay line span [begin, end)
+static void YM7128B_ChipShort_Reverse_(
+    YM7128B_Fixed* buffer,
+    YM7128B_TapIdeal begin,
+    YM7128B_TapIdeal end
+)
+{
+    while (begin + 1 < end) {
+        YM7128B_Fixed sample = buffer[begin];
+        buffer[begin++] = buffer[--end];
+        buffer[end] = sample;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+// Rearranges the delay line by sample age, then stretches it in place to the
+// new length and sample rate, by linear interpolation; tail_ is reset.
+static void YM7128B_ChipShort_Resample_(
+    YM7128B_ChipShort* self,
+    YM7128B_TapIdeal length,
+    YM7128B_TapIdeal sample_rate
+)
+{
+    YM7128B_Fixed* buffer = self->buffer_;
+    YM7128B_TapIdeal old_length = self->length_;
+    YM7128B_TapIdeal old_rate = self->sample_rate_;
+    YM7128B_TapIdeal tail = self->tail_;
+    self->tail_ = 0;
+
+    if (!old_length || !sample_rate) {
+        for (YM7128B_TapIdeal i = 0; i < length; ++i) {
+            buffer[i] = 0;
+        }
+        return;
+    }
+
+    // Rotate so that buffer[age] holds the sample of that age
+    if (tail < old_length) {
+        YM7128B_ChipShort_Reverse_(buffer, 0, tail);
+        YM7128B_ChipShort_Reverse_(buffer, tail, old_length);
+        YM7128B_ChipShort_Reverse_(buffer, 0, old_length);
+    }
+
+    // Each new age reads older positions when the rate goes down, newer when
+    // it goes up, so the scan direction never reads an already overwritten
+    // sample; close rates may share the same length, so the rate decides
+    bool growing = (sample_rate > old_rate);
+    for (YM7128B_TapIdeal n = 0; n < length; ++n) {
+        YM7128B_TapIdeal age = growing ? (length - 1 - n) : n;
+        uint64_t position = (uint64_t)age * old_rate;
+        uint64_t index = position / sample_rate;
+        uint64_t remainder = position % sample_rate;
+        if (index >= old_length) {
+            index = old_length - 1;
+            remainder = 0;
+        }
+        YM7128B_Fixed sample = buffer[index];
+        if (remainder && (index + 1 < old_length)) {
+            int64_t delta = (int64_t)buffer[index + 1] - sample;
+            sample += (YM7128B_Fixed)((delta * (int64_t)remainder) / (int64_t)sample_rate);
+        }
+        buffer[age] = sample;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipShort_Setup(
+    YM7128B_ChipShort* self,
+    YM7128B_TapIdeal sample_rate
+)
+{
+    assert(self);
+
+    if ((self->sample_rate_ != sample_rate) || (self->buffer_ == NULL)) {
+        YM7128B_TapIdeal length = (sample_rate >= 10) ? ((sample_rate / 10) + 1) : 0;
+
+        if (self->buffer_ && (length <= self->capacity_)) {
+            bool silent = (self->silence_ >= self->length_);
+            YM7128B_ChipShort_Resample_(self, length, sample_rate);
+            self->silence_ = silent ? length : 0;
+        }
+        else {
+            if (self->buffer_owned_) {
+                free(self->buffer_);
+            }
+            self->buffer_ = NULL;
+            self->buffer_owned_ = false;
+            self->capacity_ = 0;
+            self->tail_ = 0;
+
+            if (length) {
+                self->buffer_ = (YM7128B_Fixed*)calloc(length, sizeof(YM7128B_Fixed));
+                if (self->buffer_) {
+                    self->buffer_owned_ = true;
+                    self->capacity_ = length;
+                }
+            }
+            self->silence_ = length;
+        }
+
+        self->sample_rate_ = sample_rate;
+        self->length_ = length;
+        self->written_ = length;
+
+        if (length) {
+            YM7128B_ChipShort_Retap_(self);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipShort_Reserve(
+    YM7128B_ChipShort* self,
+    YM7128B_TapIdeal max_sample_rate
+)
+{
+    assert(self);
+
+    YM7128B_TapIdeal capacity = (max_sample_rate >= 10) ? ((max_sample_rate / 10) + 1) : 0;
+    if (!capacity || (self->buffer_ && (capacity <= self->capacity_))) {
+        return true;
+    }
+
+    YM7128B_Fixed* buffer = (YM7128B_Fixed*)calloc(capacity, sizeof(YM7128B_Fixed));
+    if (!buffer) {
+        return false;
+    }
+
+    if (self->buffer_) {
+        YM7128B_TapIdeal tail = self->tail_;
+        for (YM7128B_TapIdeal age = 0; age < self->length_; ++age) {
+            buffer[age] = self->buffer_[tail];
+            tail = ((tail + 1) < self->length_) ? (tail + 1) : 0;
+        }
+        if (self->buffer_owned_) {
+            free(self->buffer_);
+        }
+    }
+
+    self->buffer_ = buffer;
+    self->buffer_owned_ = true;
+    self->capacity_ = capacity;
+    self->tail_ = 0;
+    self->written_ = self->length_;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t YM7128B_ChipShort_RequiredBytes(YM7128B_TapIdeal sample_rate)
+{
+    if (sample_rate < 10) {
+        return 0;
+    }
+    size_t const mask = (size_t)YM7128B_CACHE_LINE - 1;
+    size_t length = (size_t)(sample_rate / 10) + 1;
+    return ((length * sizeof(YM7128B_Fixed)) + mask) & ~mask;
+}
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipShort_SetupWithMemory(
+    YM7128B_ChipShort* self,
+    YM7128B_TapIdeal sample_rate,
+    void* memory,
+    size_t bytes
+)
+{
+    assert(self);
+
+    size_t required = YM7128B_ChipShort_RequiredBytes(sample_rate);
+    if (required) {
+        if (!memory || (bytes < required) ||
+            ((uintptr_t)memory % sizeof(YM7128B_Fixed))) {
+            return false;
+        }
+    }
+
+    if (self->buffer_owned_) {
+        free(self->buffer_);
+    }
+    self->buffer_ = NULL;
+    self->buffer_owned_ = false;
+    self->length_ = 0;
+    self->capacity_ = 0;
+    self->tail_ = 0;
+    self->sample_rate_ = sample_rate;
+
+    if (required) {
+        self->length_ = (sample_rate / 10) + 1;
+        self->capacity_ = (YM7128B_TapIdeal)(bytes / sizeof(YM7128B_Fixed));
+        self->buffer_ = (YM7128B_Fixed*)memory;
+
+        for (YM7128B_TapIdeal i = 0; i < self->length_; ++i) {
+            self->buffer_[i] = 0;
+        }
+        self->silence_ = self->length_;
+        self->written_ = self->length_;
+
+        YM7128B_ChipShort_Retap_(self);
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+static void YM7128B_ChipShort_StateView_(
+    YM7128B_ChipShort* self,
+    YM7128B_StateView_* view
+)
+{
+    view->engine = YM7128B_ChipEngine_Short;
+    view->sample_size = sizeof(YM7128B_Fixed);
+    view->length = (self->buffer_ ? self->length_ : 0);
+    view->capacity = view->length;
+    view->tail = self->tail_;
+    view->silence = self->silence_;
+    view->written = self->written_;
+    view->regs = YM7128B_ChipShort_Patch_(self)->regs_;
+    view->t0_d = &self->t0_d_;
+    view->buffer = self->buffer_;
+    view->queue = &self->queue_;
+    view->interpolators = 0;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t YM7128B_ChipShort_GetStateSize(YM7128B_ChipShort const* self)
+{
+    assert(self);
+
+    return YM7128B_State_Size_(
+        sizeof(YM7128B_Fixed), 0,
+        YM7128B_WRITE_QUEUE_LENGTH, (self->buffer_ ? self->length_ : 0)
+    );
+}
+
+// ----------------------------------------------------------------------------
+
+size_t YM7128B_ChipShort_SaveState(
+    YM7128B_ChipShort* self,
+    void* buffer,
+    size_t size,
+    bool delta
+)
+{
+    assert(self);
+
+    YM7128B_StateView_ view;
+    YM7128B_ChipShort_StateView_(self, &view);
+
+    size_t saved = YM7128B_State_Save_(&view, buffer, size, delta);
+    if (saved) {
+        self->written_ = 0;
+    }
+    return saved;
+}
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipShort_LoadState(
+    YM7128B_ChipShort* self,
+    void const* buffer,
+    size_t size
+)
+{
+    assert(self);
+
+    YM7128B_Register regs[YM7128B_Reg_Count];
+    YM7128B_StateView_ view;
+    YM7128B_ChipShort_StateView_(self, &view);
+
+    if (!YM7128B_State_Load_(&view, buffer, size, regs)) {
+        return false;
+    }
+
+    self->tail_ = (YM7128B_TapIdeal)view.tail;
+    self->silence_ = view.silence;
+    self->written_ = 0;
+
+    for (YM7128B_Address i = YM7128B_Address_Min; i <= YM7128B_Address_Max; ++i) {
+        YM7128B_ChipShort_Write(self, i, regs[i]);
+    }
+    return true;
+}
+
+// ============================================================================
+
+// Interned patch, keyed by engine, sample rate and register image
+typedef struct YM7128B_PatchNode_
+{
+    uint32_t hash;
+    YM7128B_ChipEngine engine;
+    YM7128B_TapIdeal sample_rate;
+    YM7128B_Register regs[YM7128B_Reg_Count];
+    union {
+        YM7128B_PatchFixed fixed;
+        YM7128B_PatchFloat real;
+        YM7128B_PatchIdeal ideal;
+        YM7128B_PatchShort shorts;
+    } patch;
+} YM7128B_PatchNode_;
+
+// ----------------------------------------------------------------------------
+
+// FNV-1a hash of the patch key
+static uint32_t YM7128B_PatchTable_Hash_(
+    YM7128B_ChipEngine engine,
+    YM7128B_TapIdeal sample_rate,
+    YM7128B_Register const regs[YM7128B_Reg_Count]
+)
+{
+    uint32_t hash = 2166136261u;
+
+    hash = (hash ^ (uint32_t)engine) * 16777619u;
+    for (size_t i = 0; i < sizeof(sample_rate); ++i) {
+        hash = (hash ^ (uint32_t)((sample_rate >> (i * CHAR_BIT)) & 0xFF)) * 16777619u;
+    }
+    for (YM7128B_Address i = 0; i < YM7128B_Reg_Count; ++i) {
+        hash = (hash ^ (uint32_t)regs[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// ----------------------------------------------------------------------------
+
+// Doubles the open addressing slots, keeping the load factor within 1/2
+static bool YM7128B_PatchTable_Grow_(YM7128B_PatchTable* self)
+{
+    size_t capacity = self->capacity_ ? (self->capacity_ * 2) : 16;
+    void** slots = (void**)calloc(capacity, sizeof(void*));
+    if (!slots) {
+        return false;
+    }
+
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < self->capacity_; ++i) {
+        YM7128B_PatchNode_* node = (YM7128B_PatchNode_*)self->slots_[i];
+        if (node) {
+            size_t index = node->hash & mask;
+            while (slots[index]) {
+                index = (index + 1) & mask;
+            }
+            slots[index] = node;
+        }
+    }
+
+    free(self->slots_);
+    self->slots_ = slots;
+    self->capacity_ = capacity;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+static YM7128B_PatchNode_* YM7128B_PatchTable_Intern_(
+    YM7128B_PatchTable* self,
+    YM7128B_ChipEngine engine,
+    YM7128B_TapIdeal sample_rate,
+    YM7128B_Register const regs[YM7128B_Reg_Count]
+)
+{
+    assert(self);
+    assert(regs);
+
+    YM7128B_Register masked[YM7128B_Reg_Count];
+    YM7128B_Patch_MaskRegs_(masked, regs);
+    uint32_t hash = YM7128B_PatchTable_Hash_(engine, sample_rate, masked);
+
+    if (self->capacity_) {
+        size_t mask = self->capacity_ - 1;
+        for (size_t index = hash & mask; self->slots_[index]; index = (index + 1) & mask) {
+            YM7128B_PatchNode_* node = (YM7128B_PatchNode_*)self->slots_[index];
+            if ((node->hash == hash) && (node->engine == engine) &&
+                (node->sample_rate == sample_rate) &&
+                !memcmp(node->regs, masked, YM7128B_Reg_Count)) {
+                return node;
+            }
+        }
+    }
+
+    if (((self->count_ + 1) * 2) > self->capacity_) {
+        if (!YM7128B_PatchTable_Grow_(self)) {
+            return NULL;
+        }
+    }
+
+    YM7128B_PatchNode_* node = (YM7128B_PatchNode_*)calloc(1, sizeof(YM7128B_PatchNode_));
+    if (!node) {
+        return NULL;
+    }
+    node->hash = hash;
+    node->engine = engine;
+    node->sample_rate = sample_rate;
+    memcpy(node->regs, masked, YM7128B_Reg_Count);
+
+    switch (engine) {
+    case YM7128B_ChipEngine_Fixed:
+        YM7128B_PatchFixed_Setup(&node->patch.fixed, masked);
+        break;
+
+    case YM7128B_ChipEngine_Float:
+        YM7128B_PatchFloat_Setup(&node->patch.real, masked);
+        break;
+
+    case YM7128B_ChipEngine_Ideal:
+        YM7128B_PatchIdeal_Setup(&node->patch.ideal, masked, sample_rate);
+        break;
+
+    default:
+        YM7128B_PatchShort_Setup(&node->patch.shorts, masked, sample_rate);
+        break;
+    }
+
+    size_t mask = self->capacity_ - 1;
+    size_t index = hash & mask;
+    while (self->slots_[index]) {
+        index = (index + 1) & mask;
+    }
+    self->slots_[index] = node;
+    ++self->count_;
+    return node;
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_PatchTable_Ctor(YM7128B_PatchTable* self)
+{
+    assert(self);
+
+    self->slots_ = NULL;
+    self->capacity_ = 0;
+    self->count_ = 0;
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_PatchTable_Dtor(YM7128B_PatchTable* self)
+{
+    assert(self);
+
+    for (size_t i = 0; i < self->capacity_; ++i) {
+        free(self->slots_[i]);
+    }
+    free(self->slots_);
+    YM7128B_PatchTable_Ctor(self);
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_PatchFixed const* YM7128B_PatchTable_InternFixed(
+    YM7128B_PatchTable* self,
+    YM7128B_Register const regs[YM7128B_Reg_Count]
+)
+{
+    YM7128B_PatchNode_* node = YM7128B_PatchTable_Intern_(self, YM7128B_ChipEngine_Fixed, 0, regs);
+    return node ? &node->patch.fixed : NULL;
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_PatchFloat const* YM7128B_PatchTable_InternFloat(
+    YM7128B_PatchTable* self,
+    YM7128B_Register const regs[YM7128B_Reg_Count]
+)
+{
+    YM7128B_PatchNode_* node = YM7128B_PatchTable_Intern_(self, YM7128B_ChipEngine_Float, 0, regs);
+    return node ? &node->patch.real : NULL;
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_PatchIdeal const* YM7128B_PatchTable_InternIdeal(
+    YM7128B_PatchTable* self,
+    YM7128B_Register const regs[YM7128B_Reg_Count],
+    YM7128B_TapIdeal sample_rate
+)
+{
+    YM7128B_PatchNode_* node = YM7128B_PatchTable_Intern_(self, YM7128B_ChipEngine_Ideal, sample_rate, regs);
+    return node ? &node->patch.ideal : NULL;
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_PatchShort const* YM7128B_PatchTable_InternShort(
+    YM7128B_PatchTable* self,
+    YM7128B_Register const regs[YM7128B_Reg_Count],
+    YM7128B_TapIdeal sample_rate
+)
+{
+    YM7128B_PatchNode_* node = YM7128B_PatchTable_Intern_(self, YM7128B_ChipEngine_Short, sample_rate, regs);
+    return node ? &node->patch.shorts : NULL;
+}
+
+// ============================================================================
+
+void YM7128B_MailboxFixed_Ctor(YM7128B_MailboxFixed* self)
+{
+    assert(self);
+
+    YM7128B_Mailbox_Ctor_(&self->core_);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_MailboxFixed_Dtor(YM7128B_MailboxFixed* self)
+{
+    (void)self;
+    assert(self);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_MailboxFixed_Post(
+    YM7128B_MailboxFixed* self,
+    YM7128B_Register const regs[YM7128B_Reg_Count]
+)
+{
+    assert(self);
+    assert(regs);
+
+    YM7128B_PatchFixed_Setup(&self->slots_[self->core_.back_], regs);
+    YM7128B_Mailbox_Publish_(&self->core_);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFixed_SetMailbox(
+    YM7128B_ChipFixed* self,
+    YM7128B_MailboxFixed* mailbox
+)
+{
+    assert(self);
+
+    // Not to keep referencing a slot of the previous mailbox
+    YM7128B_MailboxFixed const* previous = self->mailbox_;
+    if (previous && self->patch_) {
+        for (unsigned i = 0; i < YM7128B_Mailbox_Slot_Count; ++i) {
+            if (self->patch_ == &previous->slots_[i]) {
+                YM7128B_ChipFixed_OwnPatch_(self);
+                break;
+            }
+        }
+    }
+    self->mailbox_ = mailbox;
+}
+
+// ============================================================================
+
+void YM7128B_MailboxFloat_Ctor(YM7128B_MailboxFloat* self)
+{
+    assert(self);
+
+    YM7128B_Mailbox_Ctor_(&self->core_);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_MailboxFloat_Dtor(YM7128B_MailboxFloat* self)
+{
+    (void)self;
+    assert(self);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_MailboxFloat_Post(
+    YM7128B_MailboxFloat* self,
+    YM7128B_Register const regs[YM7128B_Reg_Count]
+)
+{
+    assert(self);
+    assert(regs);
+
+    YM7128B_PatchFloat_Setup(&self->slots_[self->core_.back_], regs);
+    YM7128B_Mailbox_Publish_(&self->core_);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipFloat_SetMailbox(
+    YM7128B_ChipFloat* self,
+    YM7128B_MailboxFloat* mailbox
+)
+{
+    assert(self);
+
+    // Not to keep referencing a slot of the previous mailbox
+    YM7128B_MailboxFloat const* previous = self->mailbox_;
+    if (previous && self->patch_) {
+        for (unsigned i = 0; i < YM7128B_Mailbox_Slot_Count; ++i) {
+            if (self->patch_ == &previous->slots_[i]) {
+                YM7128B_ChipFloat_OwnPatch_(self);
+                break;
+            }
+        }
+    }
+    self->mailbox_ = mailbox;
+}
+
+// ============================================================================
+
+void YM7128B_MailboxIdeal_Ctor(YM7128B_MailboxIdeal* self)
+{
+    assert(self);
+
+    YM7128B_Mailbox_Ctor_(&self->core_);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_MailboxIdeal_Dtor(YM7128B_MailboxIdeal* self)
+{
+    (void)self;
+    assert(self);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_MailboxIdeal_Post(
+    YM7128B_MailboxIdeal* self,
+    YM7128B_Register const regs[YM7128B_Reg_Count],
+    YM7128B_TapIdeal sample_rate
+)
+{
+    assert(self);
+    assert(regs);
+
+    YM7128B_PatchIdeal_Setup(&self->slots_[self->core_.back_], regs, sample_rate);
+    YM7128B_Mailbox_Publish_(&self->core_);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipIdeal_SetMailbox(
+    YM7128B_ChipIdeal* self,
+    YM7128B_MailboxIdeal* mailbox
+)
+{
+    assert(self);
+
+    // Not to keep referencing a slot of the previous mailbox
+    YM7128B_MailboxIdeal const* previous = self->mailbox_;
+    if (previous && self->patch_) {
+        for (unsigned i = 0; i < YM7128B_Mailbox_Slot_Count; ++i) {
+            if (self->patch_ == &previous->slots_[i]) {
+                YM7128B_ChipIdeal_OwnPatch_(self);
+                break;
+            }
+        }
+    }
+    self->mailbox_ = mailbox;
+}
+
+// ============================================================================
+
+void YM7128B_MailboxShort_Ctor(YM7128B_MailboxShort* self)
+{
+    assert(self);
+
+    YM7128B_Mailbox_Ctor_(&self->core_);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_MailboxShort_Dtor(YM7128B_MailboxShort* self)
+{
+    (void)self;
+    assert(self);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_MailboxShort_Post(
+    YM7128B_MailboxShort* self,
+    YM7128B_Register const regs[YM7128B_Reg_Count],
+    YM7128B_TapIdeal sample_rate
+)
+{
+    assert(self);
+    assert(regs);
+
+    YM7128B_PatchShort_Setup(&self->slots_[self->core_.back_], regs, sample_rate);
+    YM7128B_Mailbox_Publish_(&self->core_);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipShort_SetMailbox(
+    YM7128B_ChipShort* self,
+    YM7128B_MailboxShort* mailbox
+)
+{
+    assert(self);
+
+    // Not to keep referencing a slot of the previous mailbox
+    YM7128B_MailboxShort const* previous = self->mailbox_;
+    if (previous && self->patch_) {
+        for (unsigned i = 0; i < YM7128B_Mailbox_Slot_Count; ++i) {
+            if (self->patch_ == &previous->slots_[i]) {
+                YM7128B_ChipShort_OwnPatch_(self);
+                break;
+            }
+        }
+    }
+    self->mailbox_ = mailbox;
+}
+
+// ============================================================================
+
+// Size of a bank array, rounded up to YM7128B_CACHE_LINE
+static size_t YM7128B_ChipBank_ArraySize_(size_t count, size_t size)
+{
+    size_t const mask = (size_t)YM7128B_CACHE_LINE - 1;
+    return ((count * size) + mask) & ~mask;
+}
+
+// ----------------------------------------------------------------------------
+
+static void YM7128B_ChipBankFixed_Free_(YM7128B_ChipBankFixed* self)
+{
+    free(self->regs_);
+    free(self->arena_);
+
+    self->arena_ = NULL;
+    self->regs_ = NULL;
+    self->gains_ = NULL;
+    self->taps_ = NULL;
+    self->t0_d_ = NULL;
+    self->buffer_ = NULL;
+    self->oversampler_ = NULL;
+    self->accums_ = NULL;
+    self->chip_count_ = 0;
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipBankFixed_Ctor(YM7128B_ChipBankFixed* self)
+{
+    assert(self);
+
+    self->regs_ = NULL;
+    self->gains_ = NULL;
+    self->taps_ = NULL;
+    self->t0_d_ = NULL;
+    self->buffer_ = NULL;
+    self->oversampler_ = NULL;
+    self->accums_ = NULL;
+    self->chip_count_ = 0;
+    self->arena_ = NULL;
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipBankFixed_Dtor(YM7128B_ChipBankFixed* self)
+{
+    assert(self);
+
+    YM7128B_ChipBankFixed_Free_(self);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipBankFixed_Reset(YM7128B_ChipBankFixed* self)
+{
+    assert(self);
+
+    for (size_t chip = 0; chip < self->chip_count_; ++chip) {
+        for (YM7128B_Address i = YM7128B_Address_Min; i <= YM7128B_Address_Max; ++i) {
+            YM7128B_ChipBankFixed_Write(self, chip, i, 0x00);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipBankFixed_Start(YM7128B_ChipBankFixed* self)
+{
+    assert(self);
+
+    size_t const chips = self->chip_count_;
+
+    self->tail_ = 0;
+    self->oversampler_index_ = 0;
+
+    if (self->buffer_) {
+        for (size_t chip = 0; chip < chips; ++chip) {
+            self->t0_d_[chip] = 0;
+        }
+
+        for (size_t i = 0; i < (YM7128B_Buffer_Length * chips); ++i) {
+            self->buffer_[i] = 0;
+        }
+
+        size_t const history_length = YM7128B_Interpolator_Length * 2 * chips;
+
+        for (size_t i = 0; i < (YM7128B_OutputChannel_Count * history_length); ++i) {
+            self->oversampler_[i] = 0;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipBankFixed_Stop(YM7128B_ChipBankFixed* self)
+{
+    (void)self;
+    assert(self);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipBankFixed_ProcessBlock(
+    YM7128B_ChipBankFixed* self,
+    YM7128B_Fixed const* inputs,
+    size_t count,
+    YM7128B_Fixed* outputs_left,
+    YM7128B_Fixed* outputs_right
+)
+{
+    assert(self);
+    assert(inputs || !count);
+    assert(outputs_left || !count);
+    assert(outputs_right || !count);
+
+    if ((self->buffer_ == NULL) || (self->chip_count_ == 0)) {
+        return;
+    }
+
+    YM7128B_Fixed* outputs[YM7128B_OutputChannel_Count];
+    outputs[YM7128B_OutputChannel_Left] = outputs_left;
+    outputs[YM7128B_OutputChannel_Right] = outputs_right;
+
+    size_t const chips = self->chip_count_;
+    size_t const history_length = YM7128B_Interpolator_Length * 2 * chips;
+    YM7128B_Fixed* buffer = self->buffer_;
+    YM7128B_Fixed const* gains = self->gains_;
+    YM7128B_Tap const* taps = self->taps_;
+    YM7128B_Accumulator* accums_l = &self->accums_[YM7128B_OutputChannel_Left * chips];
+    YM7128B_Accumulator* accums_r = &self->accums_[YM7128B_OutputChannel_Right * chips];
+
+    YM7128B_Tap tail = self->tail_;
+    YM7128B_Oversampler_Index oversampler_index = self->oversampler_index_;
+
+    for (size_t index = 0; index < count; ++index) {
+        YM7128B_Fixed const* inputs_chips = &inputs[index * chips];
+        YM7128B_Tap next_tail = tail ? (tail - 1) : (YM7128B_Buffer_Length - 1);
+        YM7128B_Fixed* buffer_tail = &buffer[next_tail * chips];
+
+        for (size_t chip = 0; chip < chips; ++chip) {
+            YM7128B_Fixed input = inputs_chips[chip];
+            YM7128B_Fixed sample = input & (YM7128B_Fixed)YM7128B_Signal_Mask;
+
+            YM7128B_Tap t0 = tail + taps[chip];
+            YM7128B_Tap filter_head = (t0 >= YM7128B_Buffer_Length) ? (t0 - YM7128B_Buffer_Length) : t0;
+            YM7128B_Fixed filter_t0  = buffer[(filter_head * chips) + chip];
+            YM7128B_Fixed filter_d   = self->t0_d_[chip];
+            self->t0_d_[chip] = filter_t0;
+            YM7128B_Fixed filter_c0  = YM7128B_MulFixed(filter_t0, gains[(YM7128B_Reg_C0 * chips) + chip]);
+            YM7128B_Fixed filter_c1  = YM7128B_MulFixed(filter_d, gains[(YM7128B_Reg_C1 * chips) + chip]);
+            YM7128B_Fixed filter_sum = YM7128B_ClampAddFixed(filter_c0, filter_c1);
+            YM7128B_Fixed filter_vc  = YM7128B_MulFixed(filter_sum, gains[(YM7128B_Reg_VC * chips) + chip]);
+
+            YM7128B_Fixed input_vm  = YM7128B_MulFixed(sample, gains[(YM7128B_Reg_VM * chips) + chip]);
+            YM7128B_Fixed input_sum = YM7128B_ClampAddFixed(input_vm, filter_vc);
+
+            buffer_tail[chip] = input_sum;
+        }
+
+        tail = next_tail;
+
+        for (size_t chip = 0; chip < chips; ++chip) {
+            accums_l[chip] = 0;
+            accums_r[chip] = 0;
+        }
+
+        for (YM7128B_Register tap = 1; tap < YM7128B_Tap_Count; ++tap) {
+            YM7128B_Tap const* taps_chips = &taps[tap * chips];
+            YM7128B_Fixed const* gains_l = &gains[(YM7128B_Reg_GL1 + tap - 1) * chips];
+            YM7128B_Fixed const* gains_r = &gains[(YM7128B_Reg_GR1 + tap - 1) * chips];
+
+            for (size_t chip = 0; chip < chips; ++chip) {
+                YM7128B_Tap t = tail + taps_chips[chip];
+                YM7128B_Tap head = (t >= YM7128B_Buffer_Length) ? (t - YM7128B_Buffer_Length) : t;
+                YM7128B_Fixed buffered = buffer[(head * chips) + chip];
+                accums_l[chip] += YM7128B_MulFixed(buffered, gains_l[chip]);
+                accums_r[chip] += YM7128B_MulFixed(buffered, gains_r[chip]);
+            }
+        }
+
+        oversampler_index = oversampler_index ? (oversampler_index - 1) : (YM7128B_Interpolator_Length - 1);
+
+        for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+            YM7128B_Accumulator* accums = &self->accums_[channel * chips];
+            YM7128B_Fixed const* gains_v = &gains[(YM7128B_Reg_VL + channel) * chips];
+            YM7128B_Fixed* history = &self->oversampler_[channel * history_length];
+            YM7128B_Fixed* history_head = &history[oversampler_index * chips];
+            YM7128B_Fixed* history_mirror = &history[(oversampler_index + YM7128B_Interpolator_Length) * chips];
+
+            for (size_t chip = 0; chip < chips; ++chip) {
+                YM7128B_Fixed total = YM7128B_ClampFixed(accums[chip]);
+                YM7128B_Fixed total_v = YM7128B_MulFixed(total, gains_v[chip]);
+                history_head[chip] = total_v;
+                history_mirror[chip] = total_v;
+            }
+
+            for (YM7128B_Oversampler_Index phase = 0; phase < YM7128B_Oversampler_Factor; ++phase) {
+                YM7128B_Fixed const* kernel = &YM7128B_InterpolatorFixed_Kernel[phase][0];
+                YM7128B_Oversampler_Index length = YM7128B_Interpolator_PhaseLength(phase);
+                YM7128B_Fixed* output = &outputs[channel][((index * YM7128B_Oversampling) + phase) * chips];
+
+                for (size_t chip = 0; chip < chips; ++chip) {
+                    accums[chip] = 0;
+                }
+
+                for (YM7128B_Oversampler_Index i = 0; i < length; ++i) {
+                    YM7128B_Fixed const* window = &history_head[i * chips];
+                    YM7128B_Fixed coeff = kernel[i];
+
+                    for (size_t chip = 0; chip < chips; ++chip) {
+                        accums[chip] += YM7128B_MulFixed(window[chip], coeff);
+                    }
+                }
+
+                for (size_t chip = 0; chip < chips; ++chip) {
+                    output[chip] = YM7128B_ClampFixed(accums[chip]) & (YM7128B_Fixed)YM7128B_Signal_Mask;
+                }
+            }
+        }
+    }
+
+    self->tail_ = tail;
+    self->oversampler_index_ = oversampler_index;
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_Register YM7128B_ChipBankFixed_Read(
+    YM7128B_ChipBankFixed const* self,
+    size_t chip,
+    YM7128B_Address address
+)
+{
+    assert(self);
+    assert(chip < self->chip_count_);
+
+    size_t const offset = (address * self->chip_count_) + chip;
+
+    if (address < YM7128B_Reg_C0) {
+        return self->regs_[offset] & YM7128B_Gain_Data_Mask;
+    }
+    else if (address < YM7128B_Reg_T0) {
+        return self->regs_[offset] & YM7128B_Coeff_Value_Mask;
+    }
+    else if (address < YM7128B_Reg_Count) {
+        return self->regs_[offset] & YM7128B_Tap_Value_Mask;
+    }
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipBankFixed_Write(
+    YM7128B_ChipBankFixed* self,
+    size_t chip,
+    YM7128B_Address address,
+    YM7128B_Register data
+)
+{
+    assert(self);
+    assert(chip < self->chip_count_);
+
+    size_t const offset = (address * self->chip_count_) + chip;
+
+    if (address < YM7128B_Reg_C0) {
+        self->regs_[offset] = data & YM7128B_Gain_Data_Mask;
+        self->gains_[offset] = YM7128B_RegisterToGainFixed(data);
+    }
+    else if (address < YM7128B_Reg_T0) {
+        self->regs_[offset] = data & YM7128B_Coeff_Value_Mask;
+        self->gains_[offset] = YM7128B_RegisterToCoeffFixed(data);
+    }
+    else if (address < YM7128B_Reg_Count) {
+        self->regs_[offset] = data & YM7128B_Tap_Value_Mask;
+        size_t const tap = ((address - YM7128B_Reg_T0) * self->chip_count_) + chip;
+        self->taps_[tap] = YM7128B_RegisterToTap(data);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+bool YM7128B_ChipBankFixed_Setup(
+    YM7128B_ChipBankFixed* self,
+    size_t chip_count
+)
+{
+    assert(self);
+
+    if ((self->chip_count_ != chip_count) || (self->buffer_ == NULL)) {
+        YM7128B_ChipBankFixed_Free_(self);
+
+        if (chip_count == 0) {
+            return true;
+        }
+        // The delay line takes most of the arena, which is then safe to size
+        if (chip_count > ((SIZE_MAX / 4) / (YM7128B_Buffer_Length * sizeof(YM7128B_Fixed)))) {
+            return false;
+        }
+
+        size_t const history_length = YM7128B_Interpolator_Length * 2 * chip_count;
+
+        // Hottest first, as per the processing loops
+        size_t const taps_size = YM7128B_ChipBank_ArraySize_(YM7128B_Tap_Count * chip_count, sizeof(YM7128B_Tap));
+        size_t const gains_size = YM7128B_ChipBank_ArraySize_(YM7128B_Reg_T0 * chip_count, sizeof(YM7128B_Fixed));
+        size_t const t0_d_size = YM7128B_ChipBank_ArraySize_(chip_count, sizeof(YM7128B_Fixed));
+        size_t const accums_size = YM7128B_ChipBank_ArraySize_(YM7128B_OutputChannel_Count * chip_count, sizeof(YM7128B_Accumulator));
+        size_t const oversampler_size = YM7128B_ChipBank_ArraySize_(YM7128B_OutputChannel_Count * history_length, sizeof(YM7128B_Fixed));
+        size_t const buffer_size = YM7128B_ChipBank_ArraySize_(YM7128B_Buffer_Length * chip_count, sizeof(YM7128B_Fixed));
+        size_t const arena_size = taps_size + gains_size + t0_d_size + accums_size + oversampler_size + buffer_size;
+
+        self->regs_ = (YM7128B_Register*)calloc(YM7128B_Reg_Count * chip_count, sizeof(YM7128B_Register));
+        self->arena_ = calloc(arena_size + (YM7128B_CACHE_LINE - 1), 1);
+
+        if (!self->regs_ || !self->arena_) {
+            YM7128B_ChipBankFixed_Free_(self);
+            return false;
+        }
+
+        uintptr_t const mask = (uintptr_t)YM7128B_CACHE_LINE - 1;
+        unsigned char* arena = (unsigned char*)self->arena_;
+        arena += (size_t)((YM7128B_CACHE_LINE - ((uintptr_t)arena & mask)) & mask);
+
+        self->taps_ = (YM7128B_Tap*)(void*)arena;
+        arena += taps_size;
+        self->gains_ = (YM7128B_Fixed*)(void*)arena;
+        arena += gains_size;
+        self->t0_d_ = (YM7128B_Fixed*)(void*)arena;
+        arena += t0_d_size;
+        self->accums_ = (YM7128B_Accumulator*)(void*)arena;
+        arena += accums_size;
+        self->oversampler_ = (YM7128B_Fixed*)(void*)arena;
+        arena += oversampler_size;
+        self->buffer_ = (YM7128B_Fixed*)(void*)arena;
+
+        self->chip_count_ = chip_count;
+        YM7128B_ChipBankFixed_Reset(self);
+    }
+    return true;
+}
+
+// ============================================================================
+
+static void YM7128B_ChipBankFloat_Free_(YM7128B_ChipBankFloat* self)
+{
+    free(self->regs_);
+    free(self->gains_);
+    free(self->taps_);
+    free(self->t0_d_);
+    free(self->buffer_);
+    free(self->oversampler_);
+    free(self->accums_);
+
+    self->regs_ = NULL;
+    self->gains_ = NULL;
+    self->taps_ = NULL;
+    self->t0_d_ = NULL;
+    self->buffer_ = NULL;
+    self->oversampler_ = NULL;
+    self->accums_ = NULL;
+    self->chip_count_ = 0;
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipBankFloat_Ctor(YM7128B_ChipBankFloat* self)
+{
+    assert(self);
+
+    self->regs_ = NULL;
+    self->gains_ = NULL;
+    self->taps_ = NULL;
+    self->t0_d_ = NULL;
+    self->buffer_ = NULL;
+    self->oversampler_ = NULL;
+    self->accums_ = NULL;
+    self->chip_count_ = 0;
+    self->kernel_ = YM7128B_Kernel_GetBest();
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipBankFloat_Dtor(YM7128B_ChipBankFloat* self)
+{
+    assert(self);
+
+    YM7128B_ChipBankFloat_Free_(self);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipBankFloat_Reset(YM7128B_ChipBankFloat* self)
+{
+    assert(self);
+
+    for (size_t chip = 0; chip < self->chip_count_; ++chip) {
+        for (YM7128B_Address i = YM7128B_Address_Min; i <= YM7128B_Address_Max; ++i) {
+            YM7128B_ChipBankFloat_Write(self, chip, i, 0x00);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipBankFloat_Start(YM7128B_ChipBankFloat* self)
+{
+    assert(self);
+
+    size_t const chips = self->chip_count_;
+
+    self->tail_ = 0;
+    self->oversampler_index_ = 0;
+
+    if (self->buffer_) {
+        for (size_t chip = 0; chip < chips; ++chip) {
+            self->t0_d_[chip] = 0;
+        }
+
+        for (size_t i = 0; i < (YM7128B_Buffer_Length * chips); ++i) {
+            self->buffer_[i] = 0;
+        }
+
+        size_t const history_length = YM7128B_Interpolator_Length * 2 * chips;
+
+        for (size_t i = 0; i < (YM7128B_OutputChannel_Count * history_length); ++i) {
+            self->oversampler_[i] = 0;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipBankFloat_Stop(YM7128B_ChipBankFloat* self)
+{
+    (void)self;
+    assert(self);
+}
+
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// Bank tap mix kernels: they gather a delay tap across all the chips, and add
+// its products by both output gains to the chip accumulators. Each chip is a
+// vector lane, computed with the same operations, in the same order, as the
+// scalar code, so that results are the same for any vector width.
+
+typedef void (*YM7128B_MixBankFloat_Func)(
+    YM7128B_Float const* buffer,
+    YM7128B_Tap const* taps,
+    YM7128B_Tap tail,
+    YM7128B_Float const* gains_l,
+    YM7128B_Float const* gains_r,
+    YM7128B_Float* accums_l,
+    YM7128B_Float* accums_r,
+    size_t chips
+);
+
+#if YM7128B_SIMD_X86 || YM7128B_SIMD_NEON
+// The vector kernels require YM7128B_FLOAT to match YM7128B_FLOAT_SINGLE
+typedef char YM7128B_MixBankFloat_TypeCheck_[
+    (sizeof(YM7128B_Float) == (YM7128B_FLOAT_SINGLE ? sizeof(float) : sizeof(double))) ? 1 : -1
+];
+#endif
+
+// ----------------------------------------------------------------------------
+
+YM7128B_FORCE_INLINE
+void YM7128B_MixBankFloat_Range_(
+    YM7128B_Float const* buffer,
+    YM7128B_Tap const* taps,
+    YM7128B_Tap tail,
+    YM7128B_Float const* gains_l,
+    YM7128B_Float const* gains_r,
+    YM7128B_Float* accums_l,
+    YM7128B_Float* accums_r,
+    size_t chip,
+    size_t chips
+)
+{
+    for (; chip < chips; ++chip) {
+        YM7128B_Tap t = tail + taps[chip];
+        YM7128B_Tap head = (t >= YM7128B_Buffer_Length) ? (t - YM7128B_Buffer_Length) : t;
+        YM7128B_Float buffered = buffer[(head * chips) + chip];
+        accums_l[chip] += YM7128B_MulFloat(buffered, gains_l[chip]);
+        accums_r[chip] += YM7128B_MulFloat(buffered, gains_r[chip]);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_FORCE_INLINE
+void YM7128B_MixBankFloat_Scalar(
+    YM7128B_Float const* buffer,
+    YM7128B_Tap const* taps,
+    YM7128B_Tap tail,
+    YM7128B_Float const* gains_l,
+    YM7128B_Float const* gains_r,
+    YM7128B_Float* accums_l,
+    YM7128B_Float* accums_r,
+    size_t chips
+)
+{
+    YM7128B_MixBankFloat_Range_(buffer, taps, tail, gains_l, gains_r, accums_l, accums_r, 0, chips);
+}
+
+// ----------------------------------------------------------------------------
+
+#if YM7128B_SIMD_X86
+
+#if YM7128B_FLOAT_SINGLE
+    #define YM7128B_FloatLanes_SSE2 4
+    #define YM7128B_FloatVector_SSE2 __m128
+    #define YM7128B_GatherFloat_SSE2(p, o) _mm_setr_ps((p)[(o)[0]], (p)[(o)[1]], (p)[(o)[2]], (p)[(o)[3]])
+    #define YM7128B_LoadFloat_SSE2(p) _mm_loadu_ps(p)
+    #define YM7128B_StoreFloat_SSE2(p, a) _mm_storeu_ps((p), (a))
+    #define YM7128B_AddFloat_SSE2(a, b) _mm_add_ps((a), (b))
+    #define YM7128B_MulFloat_SSE2(a, b) _mm_mul_ps((a), (b))
+#else
+    #define YM7128B_FloatLanes_SSE2 2
+    #define YM7128B_FloatVector_SSE2 __m128d
+    #define YM7128B_GatherFloat_SSE2(p, o) _mm_setr_pd((p)[(o)[0]], (p)[(o)[1]])
+    #define YM7128B_LoadFloat_SSE2(p) _mm_loadu_pd(p)
+    #define YM7128B_StoreFloat_SSE2(p, a) _mm_storeu_pd((p), (a))
+    #define YM7128B_AddFloat_SSE2(a, b) _mm_add_pd((a), (b))
+    #define YM7128B_MulFloat_SSE2(a, b) _mm_mul_pd((a), (b))
+#endif
+
+// No gathers: lanes are loaded one by one, then processed together
+YM7128B_FORCE_INLINE YM7128B_TARGET("sse2")
+void YM7128B_MixBankFloat_SSE2(
+    YM7128B_Float const* buffer,
+    YM7128B_Tap const* taps,
+    YM7128B_Tap tail,
+    YM7128B_Float const* gains_l,
+    YM7128B_Float const* gains_r,
+    YM7128B_Float* accums_l,
+    YM7128B_Float* accums_r,
+    size_t chips
+)
+{
+    size_t chip = 0;
+
+    for (; (chip + YM7128B_FloatLanes_SSE2) <= chips; chip += YM7128B_FloatLanes_SSE2) {
+        size_t offsets[YM7128B_FloatLanes_SSE2];
+
+        for (size_t lane = 0; lane < YM7128B_FloatLanes_SSE2; ++lane) {
+            YM7128B_Tap t = tail + taps[chip + lane];
+            YM7128B_Tap head = (t >= YM7128B_Buffer_Length) ? (t - YM7128B_Buffer_Length) : t;
+            offsets[lane] = (head * chips) + chip + lane;
+        }
+
+        YM7128B_FloatVector_SSE2 buffered = YM7128B_GatherFloat_SSE2(buffer, offsets);
+        YM7128B_FloatVector_SSE2 gl = YM7128B_LoadFloat_SSE2(&gains_l[chip]);
+        YM7128B_FloatVector_SSE2 gr = YM7128B_LoadFloat_SSE2(&gains_r[chip]);
+        YM7128B_FloatVector_SSE2 al = YM7128B_LoadFloat_SSE2(&accums_l[chip]);
+        YM7128B_FloatVector_SSE2 ar = YM7128B_LoadFloat_SSE2(&accums_r[chip]);
+        YM7128B_StoreFloat_SSE2(&accums_l[chip], YM7128B_AddFloat_SSE2(al, YM7128B_MulFloat_SSE2(buffered, gl)));
+        YM7128B_StoreFloat_SSE2(&accums_r[chip], YM7128B_AddFloat_SSE2(ar, YM7128B_MulFloat_SSE2(buffered, gr)));
+    }
+
+    YM7128B_MixBankFloat_Range_(buffer, taps, tail, gains_l, gains_r, accums_l, accums_r, chip, chips);
+}
+
+#undef YM7128B_FloatLanes_SSE2
+#undef YM7128B_FloatVector_SSE2
+#undef YM7128B_GatherFloat_SSE2
+#undef YM7128B_LoadFloat_SSE2
+#undef YM7128B_StoreFloat_SSE2
+#undef YM7128B_AddFloat_SSE2
+#undef YM7128B_MulFloat_SSE2
+
+// ----------------------------------------------------------------------------
+
+#if YM7128B_FLOAT_SINGLE
+    #define YM7128B_FloatLanes_AVX2 8
+    #define YM7128B_FloatVector_AVX2 __m256
+    #define YM7128B_IndexVector_AVX2 __m256i
+    #define YM7128B_LoadTaps_AVX2(p) _mm256_cvtepu16_epi32(_mm_loadu_si128((__m128i const*)(void const*)(p)))
+    #define YM7128B_Index_AVX2(op, ...) _mm256_##op##_epi32(__VA_ARGS__)
+    #define YM7128B_IndexAnd_AVX2(a, b) _mm256_and_si256((a), (b))
+    #define YM7128B_IndexSet_AVX2(x) _mm256_set1_epi32(x)
+    #define YM7128B_IndexLanes_AVX2() _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)
+    #define YM7128B_Gather_AVX2(p, i) \
+        _mm256_mask_i32gather_ps(_mm256_setzero_ps(), (p), (i), _mm256_castsi256_ps(_mm256_set1_epi32(-1)), sizeof(float))
+    #define YM7128B_LoadFloat_AVX2(p) _mm256_loadu_ps(p)
+    #define YM7128B_StoreFloat_AVX2(p, a) _mm256_storeu_ps((p), (a))
+    #define YM7128B_AddFloat_AVX2(a, b) _mm256_add_ps((a), (b))
+    #define YM7128B_MulFloat_AVX2(a, b) _mm256_mul_ps((a), (b))
+#else
+    #define YM7128B_FloatLanes_AVX2 4
+    #define YM7128B_FloatVector_AVX2 __m256d
+    #define YM7128B_IndexVector_AVX2 __m128i
+    #define YM7128B_LoadTaps_AVX2(p) _mm_cvtepu16_epi32(_mm_loadl_epi64((__m128i const*)(void const*)(p)))
+    #define YM7128B_Index_AVX2(op, ...) _mm_##op##_epi32(__VA_ARGS__)
+    #define YM7128B_IndexAnd_AVX2(a, b) _mm_and_si128((a), (b))
+    #define YM7128B_IndexSet_AVX2(x) _mm_set1_epi32(x)
+    #define YM7128B_IndexLanes_AVX2() _mm_setr_epi32(0, 1, 2, 3)
+    #define YM7128B_Gather_AVX2(p, i) \
+        _mm256_mask_i32gather_pd(_mm256_setzero_pd(), (p), (i), _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), sizeof(double))
+    #define YM7128B_LoadFloat_AVX2(p) _mm256_loadu_pd(p)
+    #define YM7128B_StoreFloat_AVX2(p, a) _mm256_storeu_pd((p), (a))
+    #define YM7128B_AddFloat_AVX2(a, b) _mm256_add_pd((a), (b))
+    #define YM7128B_MulFloat_AVX2(a, b) _mm256_mul_pd((a), (b))
+#endif
+
+// Hardware gathers, with 32-bit offsets; masked, to keep the source defined
+YM7128B_FORCE_INLINE YM7128B_TARGET("avx2")
+void YM7128B_MixBankFloat_AVX2(
+    YM7128B_Float const* buffer,
+    YM7128B_Tap const* taps,
+    YM7128B_Tap tail,
+    YM7128B_Float const* gains_l,
+    YM7128B_Float const* gains_r,
+    YM7128B_Float* accums_l,
+    YM7128B_Float* accums_r,
+    size_t chips
+)
+{
+    size_t chip = 0;
+
+    if (chips <= ((size_t)INT32_MAX / YM7128B_Buffer_Length)) {
+        YM7128B_IndexVector_AVX2 const length = YM7128B_IndexSet_AVX2(YM7128B_Buffer_Length);
+        YM7128B_IndexVector_AVX2 const limit = YM7128B_IndexSet_AVX2(YM7128B_Buffer_Length - 1);
+        YM7128B_IndexVector_AVX2 const stride = YM7128B_IndexSet_AVX2((int32_t)chips);
+        YM7128B_IndexVector_AVX2 const tails = YM7128B_IndexSet_AVX2((int32_t)tail);
+        YM7128B_IndexVector_AVX2 lanes = YM7128B_IndexLanes_AVX2();
+        YM7128B_IndexVector_AVX2 const step = YM7128B_IndexSet_AVX2(YM7128B_FloatLanes_AVX2);
+
+        for (; (chip + YM7128B_FloatLanes_AVX2) <= chips; chip += YM7128B_FloatLanes_AVX2) {
+            YM7128B_IndexVector_AVX2 t = YM7128B_Index_AVX2(add, tails, YM7128B_LoadTaps_AVX2(&taps[chip]));
+            YM7128B_IndexVector_AVX2 wrap = YM7128B_IndexAnd_AVX2(YM7128B_Index_AVX2(cmpgt, t, limit), length);
+            YM7128B_IndexVector_AVX2 head = YM7128B_Index_AVX2(sub, t, wrap);
+            YM7128B_IndexVector_AVX2 offset = YM7128B_Index_AVX2(add, YM7128B_Index_AVX2(mullo, head, stride), lanes);
+            lanes = YM7128B_Index_AVX2(add, lanes, step);
+
+            YM7128B_FloatVector_AVX2 buffered = YM7128B_Gather_AVX2(buffer, offset);
+            YM7128B_FloatVector_AVX2 gl = YM7128B_LoadFloat_AVX2(&gains_l[chip]);
+            YM7128B_FloatVector_AVX2 gr = YM7128B_LoadFloat_AVX2(&gains_r[chip]);
+            YM7128B_FloatVector_AVX2 al = YM7128B_LoadFloat_AVX2(&accums_l[chip]);
+            YM7128B_FloatVector_AVX2 ar = YM7128B_LoadFloat_AVX2(&accums_r[chip]);
+            YM7128B_StoreFloat_AVX2(&accums_l[chip], YM7128B_AddFloat_AVX2(al, YM7128B_MulFloat_AVX2(buffered, gl)));
+            YM7128B_StoreFloat_AVX2(&accums_r[chip], YM7128B_AddFloat_AVX2(ar, YM7128B_MulFloat_AVX2(buffered, gr)));
+        }
+    }
+
+    YM7128B_MixBankFloat_Range_(buffer, taps, tail, gains_l, gains_r, accums_l, accums_r, chip, chips);
+}
+
+#undef YM7128B_FloatLanes_AVX2
+#undef YM7128B_FloatVector_AVX2
+#undef YM7128B_IndexVector_AVX2
+#undef YM7128B_LoadTaps_AVX2
+#undef YM7128B_Index_AVX2
+#undef YM7128B_IndexAnd_AVX2
+#undef YM7128B_IndexSet_AVX2
+#undef YM7128B_IndexLanes_AVX2
+#undef YM7128B_Gather_AVX2
+#undef YM7128B_LoadFloat_AVX2
+#undef YM7128B_StoreFloat_AVX2
+#undef YM7128B_AddFloat_AVX2
+#undef YM7128B_MulFloat_AVX2
+
+#endif  // YM7128B_SIMD_X86
+
+// ----------------------------------------------------------------------------
+
+#if YM7128B_SIMD_NEON
+
+#if YM7128B_FLOAT_SINGLE
+    #define YM7128B_FloatLanes_NEON 4
+    #define YM7128B_FloatVector_NEON float32x4_t
+    #define YM7128B_GatherFloat_NEON(p, o) \
+        vld1q_lane_f32(&(p)[(o)[3]], vld1q_lane_f32(&(p)[(o)[2]], \
+        vld1q_lane_f32(&(p)[(o)[1]], vld1q_dup_f32(&(p)[(o)[0]]), 1), 2), 3)
+    #define YM7128B_LoadFloat_NEON(p) vld1q_f32(p)
+    #define YM7128B_StoreFloat_NEON(p, a) vst1q_f32((p), (a))
+    #define YM7128B_AddFloat_NEON(a, b) vaddq_f32((a), (b))
+    #define YM7128B_MulFloat_NEON(a, b) vmulq_f32((a), (b))
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define YM7128B_FloatLanes_NEON 2
+    #define YM7128B_FloatVector_NEON float64x2_t
+    #define YM7128B_GatherFloat_NEON(p, o) vld1q_lane_f64(&(p)[(o)[1]], vld1q_dup_f64(&(p)[(o)[0]]), 1)
+    #define YM7128B_LoadFloat_NEON(p) vld1q_f64(p)
+    #define YM7128B_StoreFloat_NEON(p, a) vst1q_f64((p), (a))
+    #define YM7128B_AddFloat_NEON(a, b) vaddq_f64((a), (b))
+    #define YM7128B_MulFloat_NEON(a, b) vmulq_f64((a), (b))
+#endif
+
+// No gathers: lanes are loaded one by one, then processed together
+YM7128B_FORCE_INLINE
+void YM7128B_MixBankFloat_NEON(
+    YM7128B_Float const* buffer,
+    YM7128B_Tap const* taps,
+    YM7128B_Tap tail,
+    YM7128B_Float const* gains_l,
+    YM7128B_Float const* gains_r,
+    YM7128B_Float* accums_l,
+    YM7128B_Float* accums_r,
+    size_t chips
+)
+{
+    size_t chip = 0;
+
+#ifdef YM7128B_FloatLanes_NEON
+    for (; (chip + YM7128B_FloatLanes_NEON) <= chips; chip += YM7128B_FloatLanes_NEON) {
+        size_t offsets[YM7128B_FloatLanes_NEON];
+
+        for (size_t lane = 0; lane < YM7128B_FloatLanes_NEON; ++lane) {
+            YM7128B_Tap t = tail + taps[chip + lane];
+            YM7128B_Tap head = (t >= YM7128B_Buffer_Length) ? (t - YM7128B_Buffer_Length) : t;
+            offsets[lane] = (head * chips) + chip + lane;
+        }
+
+        YM7128B_FloatVector_NEON buffered = YM7128B_GatherFloat_NEON(buffer, offsets);
+        YM7128B_FloatVector_NEON gl = YM7128B_LoadFloat_NEON(&gains_l[chip]);
+        YM7128B_FloatVector_NEON gr = YM7128B_LoadFloat_NEON(&gains_r[chip]);
+        YM7128B_FloatVector_NEON al = YM7128B_LoadFloat_NEON(&accums_l[chip]);
+        YM7128B_FloatVector_NEON ar = YM7128B_LoadFloat_NEON(&accums_r[chip]);
+        YM7128B_StoreFloat_NEON(&accums_l[chip], YM7128B_AddFloat_NEON(al, YM7128B_MulFloat_NEON(buffered, gl)));
+        YM7128B_StoreFloat_NEON(&accums_r[chip], YM7128B_AddFloat_NEON(ar, YM7128B_MulFloat_NEON(buffered, gr)));
+    }
+#endif
+
+    YM7128B_MixBankFloat_Range_(buffer, taps, tail, gains_l, gains_r, accums_l, accums_r, chip, chips);
+}
+
+#ifdef YM7128B_FloatLanes_NEON
+#undef YM7128B_FloatLanes_NEON
+#undef YM7128B_FloatVector_NEON
+#undef YM7128B_GatherFloat_NEON
+#undef YM7128B_LoadFloat_NEON
+#undef YM7128B_StoreFloat_NEON
+#undef YM7128B_AddFloat_NEON
+#undef YM7128B_MulFloat_NEON
+#endif
+
+#endif  // YM7128B_SIMD_NEON
+
+// ----------------------------------------------------------------------------
+
+YM7128B_FORCE_INLINE
+void YM7128B_ChipBankFloat_ProcessBlock_(
+    YM7128B_ChipBankFloat* self,
+    YM7128B_Float const* inputs,
+    size_t count,
+    YM7128B_Float* outputs_left,
+    YM7128B_Float* outputs_right,
+    YM7128B_MixBankFloat_Func mix
+)
+{
+    if ((self->buffer_ == NULL) || (self->chip_count_ == 0)) {
+        return;
+    }
+
+    YM7128B_Float* outputs[YM7128B_OutputChannel_Count];
+    outputs[YM7128B_OutputChannel_Left] = outputs_left;
+    outputs[YM7128B_OutputChannel_Right] = outputs_right;
+
+    size_t const chips = self->chip_count_;
+    size_t const history_length = YM7128B_Interpolator_Length * 2 * chips;
+    YM7128B_Float* buffer = self->buffer_;
+    YM7128B_Float const* gains = self->gains_;
+    YM7128B_Tap const* taps = self->taps_;
+    YM7128B_Float* accums_l = &self->accums_[YM7128B_OutputChannel_Left * chips];
+    YM7128B_Float* accums_r = &self->accums_[YM7128B_OutputChannel_Right * chips];
+
+    YM7128B_Tap tail = self->tail_;
+    YM7128B_Oversampler_Index oversampler_index = self->oversampler_index_;
+
+    for (size_t index = 0; index < count; ++index) {
+        YM7128B_Float const* inputs_chips = &inputs[index * chips];
+        YM7128B_Tap next_tail = tail ? (tail - 1) : (YM7128B_Buffer_Length - 1);
+        YM7128B_Float* buffer_tail = &buffer[next_tail * chips];
+
+        for (size_t chip = 0; chip < chips; ++chip) {
+            YM7128B_Float input = inputs_chips[chip];
+            YM7128B_Float sample = input;
+
+            YM7128B_Tap t0 = tail + taps[chip];
+            YM7128B_Tap filter_head = (t0 >= YM7128B_Buffer_Length) ? (t0 - YM7128B_Buffer_Length) : t0;
+            YM7128B_Float filter_t0  = buffer[(filter_head * chips) + chip];
+            YM7128B_Float filter_d   = self->t0_d_[chip];
+            self->t0_d_[chip] = filter_t0;
+            YM7128B_Float filter_c0  = YM7128B_MulFloat(filter_t0, gains[(YM7128B_Reg_C0 * chips) + chip]);
+            YM7128B_Float filter_c1  = YM7128B_MulFloat(filter_d, gains[(YM7128B_Reg_C1 * chips) + chip]);
+            YM7128B_Float filter_sum = YM7128B_ClampAddFloat(filter_c0, filter_c1);
+            YM7128B_Float filter_vc  = YM7128B_MulFloat(filter_sum, gains[(YM7128B_Reg_VC * chips) + chip]);
+
+            YM7128B_Float input_vm  = YM7128B_MulFloat(sample, gains[(YM7128B_Reg_VM * chips) + chip]);
+            YM7128B_Float input_sum = YM7128B_ClampAddFloat(input_vm, filter_vc);
+
+            buffer_tail[chip] = input_sum;
+        }
+
+        tail = next_tail;
+
+        for (size_t chip = 0; chip < chips; ++chip) {
+            accums_l[chip] = 0;
+            accums_r[chip] = 0;
+        }
+
+        for (YM7128B_Register tap = 1; tap < YM7128B_Tap_Count; ++tap) {
+            YM7128B_Tap const* taps_chips = &taps[tap * chips];
+            YM7128B_Float const* gains_l = &gains[(YM7128B_Reg_GL1 + tap - 1) * chips];
+            YM7128B_Float const* gains_r = &gains[(YM7128B_Reg_GR1 + tap - 1) * chips];
+
+            mix(buffer, taps_chips, tail, gains_l, gains_r, accums_l, accums_r, chips);
+        }
+
+        oversampler_index = oversampler_index ? (oversampler_index - 1) : (YM7128B_Interpolator_Length - 1);
+
+        for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+            YM7128B_Float* accums = &self->accums_[channel * chips];
+            YM7128B_Float const* gains_v = &gains[(YM7128B_Reg_VL + channel) * chips];
+            YM7128B_Float* history = &self->oversampler_[channel * history_length];
+            YM7128B_Float* history_head = &history[oversampler_index * chips];
+            YM7128B_Float* history_mirror = &history[(oversampler_index + YM7128B_Interpolator_Length) * chips];
+
+            for (size_t chip = 0; chip < chips; ++chip) {
+                YM7128B_Float total = YM7128B_ClampFloat(accums[chip]);
+                YM7128B_Float total_v = YM7128B_MulFloat(total, gains_v[chip]);
+                history_head[chip] = total_v;
+                history_mirror[chip] = total_v;
+            }
+
+            for (YM7128B_Oversampler_Index phase = 0; phase < YM7128B_Oversampler_Factor; ++phase) {
+                YM7128B_Float const* kernel = &YM7128B_InterpolatorFloat_Kernel[phase][0];
+                YM7128B_Oversampler_Index length = YM7128B_Interpolator_PhaseLength(phase);
+                YM7128B_Float* output = &outputs[channel][((index * YM7128B_Oversampling) + phase) * chips];
+
+                for (size_t chip = 0; chip < chips; ++chip) {
+                    accums[chip] = 0;
+                }
+
+                for (YM7128B_Oversampler_Index i = 0; i < length; ++i) {
+                    YM7128B_Float const* window = &history_head[i * chips];
+                    YM7128B_Float coeff = kernel[i];
+
+                    for (size_t chip = 0; chip < chips; ++chip) {
+                        accums[chip] += YM7128B_MulFloat(window[chip], coeff);
+                    }
+                }
+
+                for (size_t chip = 0; chip < chips; ++chip) {
+                    output[chip] = YM7128B_ClampFloat(accums[chip]);
+                }
+            }
+        }
+    }
+
+    self->tail_ = tail;
+    self->oversampler_index_ = oversampler_index;
+}
+
+// ----------------------------------------------------------------------------
+
+#define YM7128B_CHIPBANKFLOAT_PROCESSBLOCK(name, isa) \
+    static isa void YM7128B_ChipBankFloat_ProcessBlock_##name( \
+        YM7128B_ChipBankFloat* self, \
+        YM7128B_Float const* inputs, \
+        size_t count, \
+        YM7128B_Float* outputs_left, \
+        YM7128B_Float* outputs_right \
+    ) \
+    { \
+        YM7128B_ChipBankFloat_ProcessBlock_( \
+            self, inputs, count, outputs_left, outputs_right, \
+            YM7128B_MixBankFloat_##name \
+        ); \
+    }
+
+YM7128B_CHIPBANKFLOAT_PROCESSBLOCK(Scalar, )
+#if YM7128B_SIMD_X86
+YM7128B_CHIPBANKFLOAT_PROCESSBLOCK(SSE2, YM7128B_TARGET("sse2"))
+YM7128B_CHIPBANKFLOAT_PROCESSBLOCK(AVX2, YM7128B_TARGET("avx2"))
+#endif
+#if YM7128B_SIMD_NEON
+YM7128B_CHIPBANKFLOAT_PROCESSBLOCK(NEON, )
+#endif
+
+#undef YM7128B_CHIPBANKFLOAT_PROCESSBLOCK
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipBankFloat_ProcessBlock(
+    YM7128B_ChipBankFloat* self,
+    YM7128B_Float const* inputs,
+    size_t count,
+    YM7128B_Float* outputs_left,
+    YM7128B_Float* outputs_right
+)
+{
+    assert(self);
+    assert(inputs || !count);
+    assert(outputs_left || !count);
+    assert(outputs_right || !count);
+
+    switch (self->kernel_)
+    {
+#if YM7128B_SIMD_X86
+    case YM7128B_Kernel_SSE2:
+        YM7128B_ChipBankFloat_ProcessBlock_SSE2(self, inputs, count, outputs_left, outputs_right);
+        break;
+
+    case YM7128B_Kernel_AVX2:
+        YM7128B_ChipBankFloat_ProcessBlock_AVX2(self, inputs, count, outputs_left, outputs_right);
+        break;
+#endif
+#if YM7128B_SIMD_NEON
+    case YM7128B_Kernel_NEON:
+        YM7128B_ChipBankFloat_ProcessBlock_NEON(self, inputs, count, outputs_left, outputs_right);
+        break;
+#endif
+    default:
+        YM7128B_ChipBankFloat_ProcessBlock_Scalar(self, inputs, count, outputs_left, outputs_right);
+        break;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_Register YM7128B_ChipBankFloat_Read(
+    YM7128B_ChipBankFloat const* self,
+    size_t chip,
+    YM7128B_Address address
+)
+{
+    assert(self);
+    assert(chip < self->chip_count_);
+
+    size_t const offset = (address * self->chip_count_) + chip;
+
     if (address < YM7128B_Reg_C0) {
-        return self->regs_[address] & YM7128B_Gain_Data_Mask;
+        return self->regs_[offset] & YM7128B_Gain_Data_Mask;
     }
     else if (address < YM7128B_Reg_T0) {
-        return self->regs_[address] & YM7128B_Coeff_Value_Mask;
+        return self->regs_[offset] & YM7128B_Coeff_Value_Mask;
     }
     else if (address < YM7128B_Reg_Count) {
-        return self->regs_[address] & YM7128B_Tap_Value_Mask;
+        return self->regs_[offset] & YM7128B_Tap_Value_Mask;
     }
     return 0;
 }
 
 // ----------------------------------------------------------------------------
 
-void YM7128B_ChipIdeal_Write(
-    YM7128B_ChipIdeal* self,
+void YM7128B_ChipBankFloat_Write(
+    YM7128B_ChipBankFloat* self,
+    size_t chip,
     YM7128B_Address address,
     YM7128B_Register data
 )
 {
     assert(self);
+    assert(chip < self->chip_count_);
+
+    size_t const offset = (address * self->chip_count_) + chip;
 
     if (address < YM7128B_Reg_C0) {
-        self->regs_[address] = data & YM7128B_Gain_Data_Mask;
-        self->gains_[address] = YM7128B_RegisterToGainFloat(data);
+        self->regs_[offset] = data & YM7128B_Gain_Data_Mask;
+        self->gains_[offset] = YM7128B_RegisterToGainFloat(data);
     }
     else if (address < YM7128B_Reg_T0) {
-        self->regs_[address] = data & YM7128B_Coeff_Value_Mask;
-        self->gains_[address] = YM7128B_RegisterToCoeffFloat(data);
+        self->regs_[offset] = data & YM7128B_Coeff_Value_Mask;
+        self->gains_[offset] = YM7128B_RegisterToCoeffFloat(data);
     }
     else if (address < YM7128B_Reg_Count) {
-        self->regs_[address] = data & YM7128B_Tap_Value_Mask;
-        self->taps_[address - YM7128B_Reg_T0] = YM7128B_RegisterToTapIdeal(data, self->sample_rate_);
+        self->regs_[offset] = data & YM7128B_Tap_Value_Mask;
+        size_t const tap = ((address - YM7128B_Reg_T0) * self->chip_count_) + chip;
+        self->taps_[tap] = YM7128B_RegisterToTap(data);
     }
 }
 
 // ----------------------------------------------------------------------------
-void YM7128B_ChipIdeal_Setup(
-    YM7128B_ChipIdeal* self,
-    YM7128B_TapIdeal sample_rate
+
+bool YM7128B_ChipBankFloat_Setup(
+    YM7128B_ChipBankFloat* self,
+    size_t chip_count
 )
 {
     assert(self);
 
-    if ((self->sample_rate_ != sample_rate) || (self->buffer_ == NULL)) {
-        self->sample_rate_ = sample_rate;
+    if ((self->chip_count_ != chip_count) || (self->buffer_ == NULL)) {
+        YM7128B_ChipBankFloat_Free_(self);
 
-        if (self->buffer_) {
-            free(self->buffer_);
-            self->buffer_ = NULL;
+        if (chip_count == 0) {
+            return true;
+        }
+        if (chip_count > (SIZE_MAX / YM7128B_Buffer_Length)) {
+            return false;
         }
 
-        if (sample_rate >= 10) {
-            self->length_ = (sample_rate / 10) + 1;
-            self->buffer_ = (YM7128B_Float*)calloc(self->length_, sizeof(YM7128B_Float));
+        size_t const history_length = YM7128B_Interpolator_Length * 2 * chip_count;
 
-            for (YM7128B_Address i = 0; i < YM7128B_Tap_Count; ++i) {
-                YM7128B_Register data = self->regs_[i + YM7128B_Reg_T0];
-                self->taps_[i] = YM7128B_RegisterToTapIdeal(data, self->sample_rate_);
-            }
-        }
-        else {
-            self->length_ = 0;
+        self->regs_ = (YM7128B_Register*)calloc(YM7128B_Reg_Count * chip_count, sizeof(YM7128B_Register));
+        self->gains_ = (YM7128B_Float*)calloc(YM7128B_Reg_T0 * chip_count, sizeof(YM7128B_Float));
+        self->taps_ = (YM7128B_Tap*)calloc(YM7128B_Tap_Count * chip_count, sizeof(YM7128B_Tap));
+        self->t0_d_ = (YM7128B_Float*)calloc(chip_count, sizeof(YM7128B_Float));
+        self->buffer_ = (YM7128B_Float*)calloc(YM7128B_Buffer_Length * chip_count, sizeof(YM7128B_Float));
+        self->oversampler_ = (YM7128B_Float*)calloc(YM7128B_OutputChannel_Count * history_length, sizeof(YM7128B_Float));
+        self->accums_ = (YM7128B_Float*)calloc(YM7128B_OutputChannel_Count * chip_count, sizeof(YM7128B_Float));
+
+        if (!self->regs_ || !self->gains_ || !self->taps_ || !self->t0_d_ ||
+            !self->buffer_ || !self->oversampler_ || !self->accums_) {
+            YM7128B_ChipBankFloat_Free_(self);
+            return false;
         }
+
+        self->chip_count_ = chip_count;
+        YM7128B_ChipBankFloat_Reset(self);
     }
+    return true;
 }
 
-// ============================================================================
+// ----------------------------------------------------------------------------
 
-void YM7128B_ChipShort_Ctor(YM7128B_ChipShort* self)
+bool YM7128B_ChipBankFloat_SetKernel(
+    YM7128B_ChipBankFloat* self,
+    YM7128B_Kernel kernel
+)
 {
     assert(self);
 
-    self->buffer_ = NULL;
-    self->length_ = 0;
-    self->sample_rate_ = 0;
+    if (!YM7128B_Kernel_IsSupported(kernel)) {
+        return false;
+    }
+    self->kernel_ = kernel;
+    return true;
 }
 
+// ============================================================================
+
+// Function table thunks, casting the chip status of each engine
+#define YM7128B_CHIP_THUNKS_(Engine) \
+    static void YM7128B_Chip##Engine##_CtorThunk_(void* state) \
+    { YM7128B_Chip##Engine##_Ctor((YM7128B_Chip##Engine*)state); } \
+    static void YM7128B_Chip##Engine##_DtorThunk_(void* state) \
+    { YM7128B_Chip##Engine##_Dtor((YM7128B_Chip##Engine*)state); } \
+    static void YM7128B_Chip##Engine##_ResetThunk_(void* state) \
+    { YM7128B_Chip##Engine##_Reset((YM7128B_Chip##Engine*)state); } \
+    static void YM7128B_Chip##Engine##_StartThunk_(void* state) \
+    { YM7128B_Chip##Engine##_Start((YM7128B_Chip##Engine*)state); } \
+    static void YM7128B_Chip##Engine##_StopThunk_(void* state) \
+    { YM7128B_Chip##Engine##_Stop((YM7128B_Chip##Engine*)state); } \
+    static YM7128B_Register YM7128B_Chip##Engine##_ReadThunk_(void const* state, YM7128B_Address address) \
+    { return YM7128B_Chip##Engine##_Read((YM7128B_Chip##Engine const*)state, address); } \
+    static void YM7128B_Chip##Engine##_WriteThunk_(void* state, YM7128B_Address address, YM7128B_Register data) \
+    { YM7128B_Chip##Engine##_Write((YM7128B_Chip##Engine*)state, address, data); }
+
+YM7128B_CHIP_THUNKS_(Fixed)
+YM7128B_CHIP_THUNKS_(Float)
+YM7128B_CHIP_THUNKS_(Ideal)
+YM7128B_CHIP_THUNKS_(Short)
+
 // ----------------------------------------------------------------------------
 
-void YM7128B_ChipShort_Dtor(YM7128B_ChipShort* self)
+static bool YM7128B_ChipIdeal_SetupThunk_(void* state, YM7128B_TapIdeal sample_rate, void* memory, size_t bytes)
 {
-    assert(self);
+    return YM7128B_ChipIdeal_SetupWithMemory((YM7128B_ChipIdeal*)state, sample_rate, memory, bytes);
+}
 
-    if (self->buffer_) {
-        free(self->buffer_);
-        self->buffer_ = NULL;
-        self->length_ = 0;
-    }
+static bool YM7128B_ChipShort_SetupThunk_(void* state, YM7128B_TapIdeal sample_rate, void* memory, size_t bytes)
+{
+    return YM7128B_ChipShort_SetupWithMemory((YM7128B_ChipShort*)state, sample_rate, memory, bytes);
 }
 
 // ----------------------------------------------------------------------------
 
-void YM7128B_ChipShort_Reset(YM7128B_ChipShort* self)
+// Converts full-scale samples into fixed point, as the pipe decoders do
+YM7128B_FORCE_INLINE
+void YM7128B_Chip_FloatToFixed_(
+    YM7128B_Float const* src,
+    YM7128B_Fixed* dst,
+    size_t count
+)
 {
-    assert(self);
+    YM7128B_Float const k = (YM7128B_Float)YM7128B_Fixed_Max;
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = (YM7128B_Fixed)(YM7128B_ClampFloat(src[i]) * k);
+    }
+}
 
-    for (YM7128B_Address i = YM7128B_Address_Min; i <= YM7128B_Address_Max; ++i) {
-        YM7128B_ChipShort_Write(self, i, 0x00);
+YM7128B_FORCE_INLINE
+void YM7128B_Chip_FixedToFloat_(
+    YM7128B_Fixed const* src,
+    YM7128B_Float* dst,
+    size_t count
+)
+{
+    YM7128B_Float const k = ((YM7128B_Float)1 / (YM7128B_Float)YM7128B_Fixed_Max);
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = (YM7128B_Float)src[i] * k;
+    }
+}
+
+// Processes fixed point engines in chunks, converting the samples in cache
+#define YM7128B_CHIP_PROCESS_FIXED_(Engine, Ratio) \
+    static void YM7128B_Chip##Engine##_ProcessThunk_( \
+        void* state, \
+        YM7128B_Float const* inputs, \
+        size_t count, \
+        YM7128B_Float* outputs_left, \
+        YM7128B_Float* outputs_right \
+    ) \
+    { \
+        YM7128B_Fixed chunk_inputs[YM7128B_OutputStage_Chunk]; \
+        YM7128B_Fixed chunk_outputs[YM7128B_OutputChannel_Count][YM7128B_OutputStage_Chunk * (Ratio)]; \
+        while (count) { \
+            size_t chunk = (count < YM7128B_OutputStage_Chunk) ? count : (size_t)YM7128B_OutputStage_Chunk; \
+            YM7128B_Chip_FloatToFixed_(inputs, chunk_inputs, chunk); \
+            YM7128B_Chip##Engine##_ProcessBlock( \
+                (YM7128B_Chip##Engine*)state, \
+                chunk_inputs, \
+                chunk, \
+                chunk_outputs[YM7128B_OutputChannel_Left], \
+                chunk_outputs[YM7128B_OutputChannel_Right] \
+            ); \
+            YM7128B_Chip_FixedToFloat_(chunk_outputs[YM7128B_OutputChannel_Left], outputs_left, chunk * (Ratio)); \
+            YM7128B_Chip_FixedToFloat_(chunk_outputs[YM7128B_OutputChannel_Right], outputs_right, chunk * (Ratio)); \
+            inputs += chunk; \
+            outputs_left += chunk * (Ratio); \
+            outputs_right += chunk * (Ratio); \
+            count -= chunk; \
+        } \
     }
+
+YM7128B_CHIP_PROCESS_FIXED_(Fixed, YM7128B_Oversampling)
+YM7128B_CHIP_PROCESS_FIXED_(Short, 1)
+
+static void YM7128B_ChipFloat_ProcessThunk_(
+    void* state,
+    YM7128B_Float const* inputs,
+    size_t count,
+    YM7128B_Float* outputs_left,
+    YM7128B_Float* outputs_right
+)
+{
+    YM7128B_ChipFloat_ProcessBlock((YM7128B_ChipFloat*)state, inputs, count, outputs_left, outputs_right);
+}
+
+static void YM7128B_ChipIdeal_ProcessThunk_(
+    void* state,
+    YM7128B_Float const* inputs,
+    size_t count,
+    YM7128B_Float* outputs_left,
+    YM7128B_Float* outputs_right
+)
+{
+    YM7128B_ChipIdeal_ProcessBlock((YM7128B_ChipIdeal*)state, inputs, count, outputs_left, outputs_right);
 }
 
 // ----------------------------------------------------------------------------
 
-void YM7128B_ChipShort_Start(YM7128B_ChipShort* self)
+YM7128B_ChipVtable const YM7128B_Chip_Vtables[YM7128B_ChipEngine_Count] =
 {
-    assert(self);
+    {
+        YM7128B_ChipEngine_Fixed,
+        sizeof(YM7128B_ChipFixed),
+        YM7128B_Oversampling,
+        YM7128B_ChipFixed_CtorThunk_,
+        YM7128B_ChipFixed_DtorThunk_,
+        NULL,
+        NULL,
+        YM7128B_ChipFixed_ResetThunk_,
+        YM7128B_ChipFixed_StartThunk_,
+        YM7128B_ChipFixed_StopThunk_,
+        YM7128B_ChipFixed_ReadThunk_,
+        YM7128B_ChipFixed_WriteThunk_,
+        YM7128B_ChipFixed_ProcessThunk_
+    },
+    {
+        YM7128B_ChipEngine_Float,
+        sizeof(YM7128B_ChipFloat),
+        YM7128B_Oversampling,
+        YM7128B_ChipFloat_CtorThunk_,
+        YM7128B_ChipFloat_DtorThunk_,
+        NULL,
+        NULL,
+        YM7128B_ChipFloat_ResetThunk_,
+        YM7128B_ChipFloat_StartThunk_,
+        YM7128B_ChipFloat_StopThunk_,
+        YM7128B_ChipFloat_ReadThunk_,
+        YM7128B_ChipFloat_WriteThunk_,
+        YM7128B_ChipFloat_ProcessThunk_
+    },
+    {
+        YM7128B_ChipEngine_Ideal,
+        sizeof(YM7128B_ChipIdeal),
+        1,
+        YM7128B_ChipIdeal_CtorThunk_,
+        YM7128B_ChipIdeal_DtorThunk_,
+        YM7128B_ChipIdeal_RequiredBytes,
+        YM7128B_ChipIdeal_SetupThunk_,
+        YM7128B_ChipIdeal_ResetThunk_,
+        YM7128B_ChipIdeal_StartThunk_,
+        YM7128B_ChipIdeal_StopThunk_,
+        YM7128B_ChipIdeal_ReadThunk_,
+        YM7128B_ChipIdeal_WriteThunk_,
+        YM7128B_ChipIdeal_ProcessThunk_
+    },
+    {
+        YM7128B_ChipEngine_Short,
+        sizeof(YM7128B_ChipShort),
+        1,
+        YM7128B_ChipShort_CtorThunk_,
+        YM7128B_ChipShort_DtorThunk_,
+        YM7128B_ChipShort_RequiredBytes,
+        YM7128B_ChipShort_SetupThunk_,
+        YM7128B_ChipShort_ResetThunk_,
+        YM7128B_ChipShort_StartThunk_,
+        YM7128B_ChipShort_StopThunk_,
+        YM7128B_ChipShort_ReadThunk_,
+        YM7128B_ChipShort_WriteThunk_,
+        YM7128B_ChipShort_ProcessThunk_
+    }
+};
 
-    self->t0_d_ = 0;
+// ----------------------------------------------------------------------------
 
-    self->tail_ = 0;
+static void* YM7128B_Allocator_Alloc_(YM7128B_Allocator const* self, size_t size)
+{
+    return self->alloc ? self->alloc(self->context, size) : malloc(size);
+}
 
-    if (self->buffer_) {
-        for (YM7128B_TapIdeal i = 0; i < self->length_; ++i) {
-            self->buffer_[i] = 0;
-        }
+static void YM7128B_Allocator_Free_(YM7128B_Allocator const* self, void* memory)
+{
+    if (self->free) {
+        self->free(self->context, memory);
+    }
+    else {
+        free(memory);
     }
 }
 
-// ----------------------------------------------------------------------------
+// Allocates and sets up the status of an engine chip, followed by its delay
+// memory, with cleared registers
+static void* YM7128B_Chip_CreateState_(
+    YM7128B_Allocator const* allocator,
+    YM7128B_ChipVtable const* vtable,
+    YM7128B_TapIdeal sample_rate
+)
+{
+    size_t const mask = (size_t)YM7128B_CACHE_LINE - 1;
+    size_t const state_bytes = (vtable->state_size + mask) & ~mask;
+    size_t const delay_bytes = vtable->required_bytes ? vtable->required_bytes(sample_rate) : 0;
 
-void YM7128B_ChipShort_Stop(YM7128B_ChipShort* self)
+    unsigned char* memory = (unsigned char*)YM7128B_Allocator_Alloc_(allocator, state_bytes + delay_bytes);
+    if (!memory) {
+        return NULL;
+    }
+
+    vtable->ctor(memory);
+    if (vtable->setup_with_memory &&
+        !vtable->setup_with_memory(memory, sample_rate, &memory[state_bytes], delay_bytes)) {
+        vtable->dtor(memory);
+        YM7128B_Allocator_Free_(allocator, memory);
+        return NULL;
+    }
+    vtable->reset(memory);
+    return memory;
+}
+
+static void YM7128B_Chip_DestroyState_(
+    YM7128B_Allocator const* allocator,
+    YM7128B_ChipVtable const* vtable,
+    void* state
+)
 {
-    (void)self;
-    assert(self);
+    vtable->dtor(state);
+    YM7128B_Allocator_Free_(allocator, state);
 }
 
 // ----------------------------------------------------------------------------
 
-void YM7128B_ChipShort_Process(
-    YM7128B_ChipShort* self,
-    YM7128B_ChipShort_Process_Data* data
+YM7128B_Chip* YM7128B_Chip_Create(
+    YM7128B_ChipEngine engine,
+    YM7128B_TapIdeal sample_rate,
+    YM7128B_Allocator const* allocator
 )
 {
-    assert(self);
-    assert(data);
+    if ((unsigned)engine >= (unsigned)YM7128B_ChipEngine_Count) {
+        return NULL;
+    }
+    YM7128B_Allocator const default_allocator = { NULL, NULL, NULL };
+    if (!allocator) {
+        allocator = &default_allocator;
+    }
 
-    if ((self->buffer_ == NULL) || (self->length_ == 0)) {
-        return;
+    YM7128B_Chip* self = (YM7128B_Chip*)YM7128B_Allocator_Alloc_(allocator, sizeof(YM7128B_Chip));
+    if (!self) {
+        return NULL;
+    }
+    self->vtable_ = &YM7128B_Chip_Vtables[engine];
+    self->sample_rate_ = sample_rate;
+    self->allocator_ = *allocator;
+    self->started_ = false;
+
+    self->state_ = YM7128B_Chip_CreateState_(allocator, self->vtable_, sample_rate);
+    if (!self->state_) {
+        YM7128B_Allocator_Free_(allocator, self);
+        return NULL;
     }
+    return self;
+}
+
+// ----------------------------------------------------------------------------
 
-    YM7128B_Fixed input = data->inputs[YM7128B_InputChannel_Mono];
-    YM7128B_Fixed sample = input;
+void YM7128B_Chip_Destroy(YM7128B_Chip* self)
+{
+    if (self) {
+        YM7128B_Allocator const allocator = self->allocator_;
+        YM7128B_Chip_DestroyState_(&allocator, self->vtable_, self->state_);
+        YM7128B_Allocator_Free_(&allocator, self);
+    }
+}
 
-    YM7128B_TapIdeal t0 = self->tail_ + self->taps_[0];
-    YM7128B_TapIdeal filter_head = (t0 >= self->length_) ? (t0 - self->length_) : t0;
-    YM7128B_Fixed filter_t0  = self->buffer_[filter_head];
-    YM7128B_Fixed filter_d   = self->t0_d_;
-    self->t0_d_ = filter_t0;
-    YM7128B_Fixed filter_c0  = YM7128B_MulShort(filter_t0, self->gains_[YM7128B_Reg_C0]);
-    YM7128B_Fixed filter_c1  = YM7128B_MulShort(filter_d, self->gains_[YM7128B_Reg_C1]);
-    YM7128B_Fixed filter_sum = YM7128B_ClampAddShort(filter_c0, filter_c1);
-    YM7128B_Fixed filter_vc  = YM7128B_MulShort(filter_sum, self->gains_[YM7128B_Reg_VC]);
+// ----------------------------------------------------------------------------
 
-    YM7128B_Fixed input_vm  = YM7128B_MulShort(sample, self->gains_[YM7128B_Reg_VM]);
-    YM7128B_Fixed input_sum = YM7128B_ClampAddShort(input_vm, filter_vc);
+void YM7128B_Chip_Reset(YM7128B_Chip* self)
+{
+    assert(self);
 
-    self->tail_ = self->tail_ ? (self->tail_ - 1) : (self->length_ - 1);
-    self->buffer_[self->tail_] = input_sum;
+    self->vtable_->reset(self->state_);
+}
 
-    for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
-        YM7128B_Register gb = YM7128B_Reg_GL1 + (channel * YM7128B_Gain_Lane_Count);
-        YM7128B_Fixed accum = 0;
+// ----------------------------------------------------------------------------
 
-        for (YM7128B_Register tap = 1; tap < YM7128B_Tap_Count; ++tap) {
-            YM7128B_TapIdeal t = self->tail_ + self->taps_[tap];
-            YM7128B_TapIdeal head = (t >= self->length_) ? (t - self->length_) : t;
-            YM7128B_Fixed buffered = self->buffer_[head];
-            YM7128B_Fixed g = self->gains_[gb + tap - 1];
-            YM7128B_Fixed buffered_g = YM7128B_MulShort(buffered, g);
-            accum += buffered_g;
-        }
+void YM7128B_Chip_Start(YM7128B_Chip* self)
+{
+    assert(self);
 
-        YM7128B_Fixed total = accum;
-        YM7128B_Fixed v = self->gains_[YM7128B_Reg_VL + channel];
-        YM7128B_Fixed total_v = YM7128B_MulShort(total, v);
-        YM7128B_Fixed oversampled = total_v / (YM7128B_Fixed)YM7128B_Oversampling;
-        data->outputs[channel] = oversampled;
-    }
+    self->vtable_->start(self->state_);
+    self->started_ = true;
 }
 
 // ----------------------------------------------------------------------------
 
-YM7128B_Register YM7128B_ChipShort_Read(
-    YM7128B_ChipShort const* self,
+void YM7128B_Chip_Stop(YM7128B_Chip* self)
+{
+    assert(self);
+
+    self->vtable_->stop(self->state_);
+    self->started_ = false;
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_Register YM7128B_Chip_Read(
+    YM7128B_Chip const* self,
     YM7128B_Address address
 )
 {
     assert(self);
 
-    if (address < YM7128B_Reg_C0) {
-        return self->regs_[address] & YM7128B_Gain_Data_Mask;
-    }
-    else if (address < YM7128B_Reg_T0) {
-        return self->regs_[address] & YM7128B_Coeff_Value_Mask;
-    }
-    else if (address < YM7128B_Reg_Count) {
-        return self->regs_[address] & YM7128B_Tap_Value_Mask;
-    }
-    return 0;
+    return self->vtable_->read(self->state_, address);
 }
 
 // ----------------------------------------------------------------------------
 
-void YM7128B_ChipShort_Write(
-    YM7128B_ChipShort* self,
+void YM7128B_Chip_Write(
+    YM7128B_Chip* self,
     YM7128B_Address address,
     YM7128B_Register data
 )
 {
     assert(self);
 
-    if (address < YM7128B_Reg_C0) {
-        self->regs_[address] = data & YM7128B_Gain_Data_Mask;
-        YM7128B_Fixed gain = YM7128B_RegisterToGainShort(data);
-        self->gains_[address] = gain;
+    self->vtable_->write(self->state_, address, data);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_Chip_ProcessBlock(
+    YM7128B_Chip* self,
+    YM7128B_Float const* inputs,
+    size_t count,
+    YM7128B_Float* outputs_left,
+    YM7128B_Float* outputs_right
+)
+{
+    assert(self);
+    assert(inputs || !count);
+    assert(outputs_left || !count);
+    assert(outputs_right || !count);
+
+    self->vtable_->process_block(self->state_, inputs, count, outputs_left, outputs_right);
+}
+
+// ----------------------------------------------------------------------------
+
+size_t YM7128B_Chip_GetOutputRatio(YM7128B_Chip const* self)
+{
+    assert(self);
+
+    return self->vtable_->output_ratio;
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_ChipEngine YM7128B_Chip_GetEngine(YM7128B_Chip const* self)
+{
+    assert(self);
+
+    return self->vtable_->engine;
+}
+
+// ----------------------------------------------------------------------------
+
+void* YM7128B_Chip_GetState(YM7128B_Chip* self)
+{
+    assert(self);
+
+    return self->state_;
+}
+
+// ----------------------------------------------------------------------------
+
+// Engine agnostic view of an engine chip status
+static void YM7128B_Chip_StateView_(
+    YM7128B_ChipEngine engine,
+    void* state,
+    YM7128B_StateView_* view
+)
+{
+    switch (engine) {
+    case YM7128B_ChipEngine_Fixed: YM7128B_ChipFixed_StateView_((YM7128B_ChipFixed*)state, view); break;
+    case YM7128B_ChipEngine_Float: YM7128B_ChipFloat_StateView_((YM7128B_ChipFloat*)state, view); break;
+    case YM7128B_ChipEngine_Ideal: YM7128B_ChipIdeal_StateView_((YM7128B_ChipIdeal*)state, view); break;
+    default: YM7128B_ChipShort_StateView_((YM7128B_ChipShort*)state, view); break;
     }
-    else if (address < YM7128B_Reg_T0) {
-        self->regs_[address] = data & YM7128B_Coeff_Value_Mask;
-        YM7128B_Fixed coeff = YM7128B_RegisterToCoeffShort(data);
-        self->gains_[address] = coeff;
+}
+
+// Copies delay samples across engines, converting between Q15 and
+// full-scale floating point if needed
+static void YM7128B_Chip_CopySamples_(
+    void* dst,
+    size_t dst_size,
+    void const* src,
+    size_t src_size,
+    size_t count
+)
+{
+    if (dst_size == src_size) {
+        memcpy(dst, src, count * src_size);
     }
-    else if (address < YM7128B_Reg_Count) {
-        self->regs_[address] = data & YM7128B_Tap_Value_Mask;
-        YM7128B_TapIdeal tap = YM7128B_RegisterToTapIdeal(data, self->sample_rate_);
-        self->taps_[address - YM7128B_Reg_T0] = tap;
+    else if (dst_size == sizeof(YM7128B_Fixed)) {
+        YM7128B_Chip_FloatToFixed_((YM7128B_Float const*)src, (YM7128B_Fixed*)dst, count);
+    }
+    else {
+        YM7128B_Chip_FixedToFloat_((YM7128B_Fixed const*)src, (YM7128B_Float*)dst, count);
     }
 }
 
-// ----------------------------------------------------------------------------
+// Carries the delay line, with the interpolator histories, over to a fresh
+// engine chip of the same family: Fixed and Float share the ring layout at
+// the nominal rate, while Ideal and Short share it at the same sample rate.
+// Returns false if the layouts differ, leaving the new chip silent.
+static bool YM7128B_Chip_CopyDelay_(
+    YM7128B_ChipEngine dst_engine,
+    void* dst,
+    YM7128B_ChipEngine src_engine,
+    void* src
+)
+{
+    bool dst_ideal = (dst_engine == YM7128B_ChipEngine_Ideal) || (dst_engine == YM7128B_ChipEngine_Short);
+    bool src_ideal = (src_engine == YM7128B_ChipEngine_Ideal) || (src_engine == YM7128B_ChipEngine_Short);
+    if (dst_ideal != src_ideal) {
+        return false;
+    }
 
-void YM7128B_ChipShort_Setup(
-    YM7128B_ChipShort* self,
+    YM7128B_StateView_ to;
+    YM7128B_StateView_ from;
+    YM7128B_Chip_StateView_(dst_engine, dst, &to);
+    YM7128B_Chip_StateView_(src_engine, src, &from);
+    if (!to.capacity || (to.capacity != from.capacity) || (to.interpolators != from.interpolators)) {
+        return false;
+    }
+
+    YM7128B_Chip_CopySamples_(to.buffer, to.sample_size, from.buffer, from.sample_size, from.capacity);
+    YM7128B_Chip_CopySamples_(to.t0_d, to.sample_size, from.t0_d, from.sample_size, 1);
+    for (size_t i = 0; i < from.interpolators; ++i) {
+        *to.indices[i] = *from.indices[i];
+        YM7128B_Chip_CopySamples_(to.histories[i], to.sample_size, from.histories[i], from.sample_size,
+                                  YM7128B_Interpolator_Buffer_Length);
+    }
+
+    switch (dst_engine) {
+    case YM7128B_ChipEngine_Fixed:
+        ((YM7128B_ChipFixed*)dst)->tail_ = (YM7128B_Tap)from.tail;
+        ((YM7128B_ChipFixed*)dst)->silence_ = from.silence;
+        break;
+    case YM7128B_ChipEngine_Float:
+        ((YM7128B_ChipFloat*)dst)->tail_ = (YM7128B_Tap)from.tail;
+        ((YM7128B_ChipFloat*)dst)->silence_ = from.silence;
+        break;
+    case YM7128B_ChipEngine_Ideal:
+        ((YM7128B_ChipIdeal*)dst)->tail_ = (YM7128B_TapIdeal)from.tail;
+        ((YM7128B_ChipIdeal*)dst)->silence_ = (YM7128B_TapIdeal)from.silence;
+        break;
+    default:
+        ((YM7128B_ChipShort*)dst)->tail_ = (YM7128B_TapIdeal)from.tail;
+        ((YM7128B_ChipShort*)dst)->silence_ = (YM7128B_TapIdeal)from.silence;
+        break;
+    }
+    return true;
+}
+
+// Takes the latest register image posted to the mailbox of an engine chip,
+// if any, which the next processed block would have applied
+static void YM7128B_Chip_Receive_(
+    YM7128B_ChipEngine engine,
+    void* state
+)
+{
+    switch (engine) {
+    case YM7128B_ChipEngine_Fixed: {
+        YM7128B_ChipFixed* chip = (YM7128B_ChipFixed*)state;
+        if (chip->mailbox_) {
+            YM7128B_ChipFixed_Receive_(chip);
+        }
+        break;
+    }
+    case YM7128B_ChipEngine_Float: {
+        YM7128B_ChipFloat* chip = (YM7128B_ChipFloat*)state;
+        if (chip->mailbox_) {
+            YM7128B_ChipFloat_Receive_(chip);
+        }
+        break;
+    }
+    case YM7128B_ChipEngine_Ideal: {
+        YM7128B_ChipIdeal* chip = (YM7128B_ChipIdeal*)state;
+        if (chip->mailbox_) {
+            YM7128B_ChipIdeal_Receive_(chip);
+        }
+        break;
+    }
+    default: {
+        YM7128B_ChipShort* chip = (YM7128B_ChipShort*)state;
+        if (chip->mailbox_) {
+            YM7128B_ChipShort_Receive_(chip);
+        }
+        break;
+    }
+    }
+}
+
+// Filter setting of an engine chip, if it has any
+static YM7128B_Filter* YM7128B_Chip_Filter_(
+    YM7128B_ChipEngine engine,
+    void* state
+)
+{
+    switch (engine) {
+    case YM7128B_ChipEngine_Fixed: return &((YM7128B_ChipFixed*)state)->filter_;
+    case YM7128B_ChipEngine_Float: return &((YM7128B_ChipFloat*)state)->filter_;
+    default: return NULL;
+    }
+}
+
+// Kernel setting of an engine chip, if it has any
+static YM7128B_Kernel* YM7128B_Chip_Kernel_(
+    YM7128B_ChipEngine engine,
+    void* state
+)
+{
+    switch (engine) {
+    case YM7128B_ChipEngine_Fixed: return &((YM7128B_ChipFixed*)state)->kernel_;
+    case YM7128B_ChipEngine_Short: return &((YM7128B_ChipShort*)state)->kernel_;
+    default: return NULL;
+    }
+}
+
+// Input sample rate of an engine chip, timing its scheduled writes
+static uint_fast64_t YM7128B_Chip_InputRate_(
+    YM7128B_ChipEngine engine,
     YM7128B_TapIdeal sample_rate
 )
 {
-    assert(self);
+    bool ideal = (engine == YM7128B_ChipEngine_Ideal) || (engine == YM7128B_ChipEngine_Short);
+    return ideal ? (uint_fast64_t)sample_rate : (uint_fast64_t)YM7128B_Input_Rate;
+}
 
-    if ((self->sample_rate_ != sample_rate) || (self->buffer_ == NULL)) {
-        self->sample_rate_ = sample_rate;
+// Carries the settings over to a fresh engine chip: the filter and the
+// kernel where both engines have them, and the pending scheduled writes,
+// with their offsets and pacing rebased to the new input rate; they stay
+// as-is within a family, and keep their order anyway.
+static void YM7128B_Chip_CopySettings_(
+    YM7128B_ChipEngine dst_engine,
+    void* dst,
+    YM7128B_ChipEngine src_engine,
+    void* src,
+    YM7128B_TapIdeal sample_rate
+)
+{
+    YM7128B_Filter* dst_filter = YM7128B_Chip_Filter_(dst_engine, dst);
+    YM7128B_Filter const* src_filter = YM7128B_Chip_Filter_(src_engine, src);
+    if (dst_filter && src_filter) {
+        *dst_filter = *src_filter;
+    }
 
-        if (self->buffer_) {
-            free(self->buffer_);
-            self->buffer_ = NULL;
+    YM7128B_Kernel* dst_kernel = YM7128B_Chip_Kernel_(dst_engine, dst);
+    YM7128B_Kernel const* src_kernel = YM7128B_Chip_Kernel_(src_engine, src);
+    if (dst_kernel && src_kernel) {
+        *dst_kernel = *src_kernel;
+    }
+
+    YM7128B_StateView_ to;
+    YM7128B_StateView_ from;
+    YM7128B_Chip_StateView_(dst_engine, dst, &to);
+    YM7128B_Chip_StateView_(src_engine, src, &from);
+    *to.queue = *from.queue;
+
+    uint_fast64_t dst_rate = YM7128B_Chip_InputRate_(dst_engine, sample_rate);
+    uint_fast64_t src_rate = YM7128B_Chip_InputRate_(src_engine, sample_rate);
+    if (dst_rate != src_rate) {
+        YM7128B_WriteQueue* queue = to.queue;
+        for (size_t i = queue->head_; i < queue->count_; ++i) {
+            uint_fast64_t offset = (uint_fast64_t)queue->events_[i].offset;
+            queue->events_[i].offset = (size_t)(((offset * dst_rate) + (src_rate / 2)) / src_rate);
         }
+        queue->busy_ = ((queue->busy_ * dst_rate) + (src_rate / 2)) / src_rate;
+    }
+}
 
-        if (sample_rate >= 10) {
-            self->length_ = (sample_rate / 10) + 1;
-            self->buffer_ = (YM7128B_Fixed*)calloc(self->length_, sizeof(YM7128B_Fixed));
+// ----------------------------------------------------------------------------
 
-            for (YM7128B_Address i = 0; i < YM7128B_Tap_Count; ++i) {
-                YM7128B_Register data = self->regs_[i + YM7128B_Reg_T0];
-                self->taps_[i] = YM7128B_RegisterToTapIdeal(data, self->sample_rate_);
-            }
-        }
-        else {
-            self->length_ = 0;
-        }
+bool YM7128B_Chip_SetEngine(
+    YM7128B_Chip* self,
+    YM7128B_ChipEngine engine
+)
+{
+    assert(self);
+
+    if ((unsigned)engine >= (unsigned)YM7128B_ChipEngine_Count) {
+        return false;
+    }
+    YM7128B_ChipVtable const* vtable = &YM7128B_Chip_Vtables[engine];
+    if (vtable == self->vtable_) {
+        return true;
+    }
+
+    void* state = YM7128B_Chip_CreateState_(&self->allocator_, vtable, self->sample_rate_);
+    if (!state) {
+        return false;
+    }
+    YM7128B_Chip_Receive_(self->vtable_->engine, self->state_);
+    for (YM7128B_Address r = 0; r < (YM7128B_Address)YM7128B_Reg_Count; ++r) {
+        vtable->write(state, r, self->vtable_->read(self->state_, r));
     }
+    if (self->started_) {
+        vtable->start(state);
+        YM7128B_Chip_CopyDelay_(engine, state, self->vtable_->engine, self->state_);
+        self->vtable_->stop(self->state_);
+    }
+    YM7128B_Chip_CopySettings_(engine, state, self->vtable_->engine, self->state_, self->sample_rate_);
+
+    YM7128B_Chip_DestroyState_(&self->allocator_, self->vtable_, self->state_);
+    self->vtable_ = vtable;
+    self->state_ = state;
+    return true;
 }
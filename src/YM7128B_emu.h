@@ -43,20 +43,53 @@ extern "C" {
 #define YM7128B_INLINE static inline
 #endif
 
+#ifndef YM7128B_FLOAT_SINGLE
+#define YM7128B_FLOAT_SINGLE 0      //!< Selects float as YM7128B_FLOAT, with matching tables and kernels
+#endif
+
 #ifndef YM7128B_FLOAT
+#if YM7128B_FLOAT_SINGLE
+#define YM7128B_FLOAT float         //!< Floating point data type
+#else
 #define YM7128B_FLOAT double        //!< Floating point data type
-#define YM7128B_Float_Min   (-1)    //!< Maximum floating point value
-#define YM7128B_Float_Max   (+1)    //!< Minimum floating point value
+#endif
+#endif
+
+#ifndef YM7128B_Float_Min
+#define YM7128B_Float_Min   (-1)    //!< Minimum floating point value
+#define YM7128B_Float_Max   (+1)    //!< Maximum floating point value
 #endif
 
 #ifndef YM7128B_USE_MINPHASE
-#define YM7128B_USE_MINPHASE 0          //!< Enables minimum-phase oversampler kernel
+#define YM7128B_USE_MINPHASE 0          //!< Selects minimum-phase oversampler kernels by default
+#endif
+
+#ifndef YM7128B_USE_SIMD
+#define YM7128B_USE_SIMD 1              //!< Enables SIMD processing kernels
+#endif
+
+#ifndef YM7128B_USE_POW2_DELAY
+#define YM7128B_USE_POW2_DELAY 0        //!< Enables power-of-two delay line capacity
+#endif
+
+#ifndef YM7128B_USE_STATS
+#define YM7128B_USE_STATS 0             //!< Enables per-chip performance and signal counters
+#endif
+
+#ifndef YM7128B_WRITE_QUEUE_LENGTH
+#define YM7128B_WRITE_QUEUE_LENGTH 128  //!< Scheduled register writes per chip
+#endif
+
+#ifndef YM7128B_CACHE_LINE
+#define YM7128B_CACHE_LINE 64           //!< Alignment of chip bank arrays, power of two
 #endif
 
 // ============================================================================
 
 #define YM7128B_VERSION "0.1.3"
 
+#define YM7128B_STATE_VERSION 1  //!< State snapshot format version
+
 char const* YM7128B_GetVersion(void);
 
 // ============================================================================
@@ -119,6 +152,14 @@ typedef enum YM7128B_OutputChannel {
     YM7128B_OutputChannel_Count
 } YM7128B_OutputChannel;
 
+//! Rounds a 16-bit value up to a power of two, as a constant expression
+#define YM7128B_CEIL_POW2_16_(n) \
+    (YM7128B_SMEAR_16_((n) - 1) + 1)
+
+#define YM7128B_SMEAR_16_(v) \
+    ((v) | ((v) >> 1) | ((v) >> 2) | ((v) >> 3) | ((v) >> 4) | ((v) >> 5) | ((v) >> 6) | ((v) >> 7) | \
+     ((v) >> 8) | ((v) >> 9) | ((v) >> 10) | ((v) >> 11) | ((v) >> 12) | ((v) >> 13) | ((v) >> 14) | ((v) >> 15))
+
 //! Datasheet specifications
 enum YM7128B_DatasheetSpecs {
     //! Clock rate [Hz]
@@ -145,6 +186,15 @@ enum YM7128B_DatasheetSpecs {
     //! Nominal delay line buffer length
     YM7128B_Buffer_Length     = (YM7128B_Input_Rate / 10) + 1,
 
+    //! Delay line buffer capacity, for the Fixed and Float engines.
+    //! Rounded up to a power of two if YM7128B_USE_POW2_DELAY is set, so
+    //! that positions wrap by masking; older samples are just never read.
+#if YM7128B_USE_POW2_DELAY
+    YM7128B_Buffer_Capacity   = YM7128B_CEIL_POW2_16_(YM7128B_Buffer_Length),
+#else
+    YM7128B_Buffer_Capacity   = YM7128B_Buffer_Length,
+#endif
+
     // Delay line taps
     YM7128B_Tap_Count         = 9,
     YM7128B_Tap_Value_Bits    = 5,
@@ -219,6 +269,21 @@ typedef enum YM7128B_ChipEngine {
     YM7128B_ChipEngine_Count
 } YM7128B_ChipEngine;
 
+//! Processing kernel instruction sets
+typedef enum YM7128B_Kernel {
+    YM7128B_Kernel_Scalar = 0,
+    YM7128B_Kernel_SSE2,
+    YM7128B_Kernel_AVX2,
+    YM7128B_Kernel_NEON,
+    YM7128B_Kernel_Count
+} YM7128B_Kernel;
+
+//! Tells whether the kernel is both compiled in and supported by the CPU
+bool YM7128B_Kernel_IsSupported(YM7128B_Kernel kernel);
+
+//! Best kernel supported by the CPU, detected at runtime
+YM7128B_Kernel YM7128B_Kernel_GetBest(void);
+
 // ----------------------------------------------------------------------------
 
 extern signed char const YM7128B_GainDecibel_Table[YM7128B_Gain_Data_Count / 2];
@@ -438,13 +503,58 @@ typedef uint_fast8_t YM7128B_Oversampler_Index;
 enum YM7128B_OversamplerSpecs {
     YM7128B_Oversampler_Factor = YM7128B_Oversampling,
     YM7128B_Oversampler_Length = 19,
+
+    //! Polyphase interpolator history length, i.e. the longest phase
+    YM7128B_Interpolator_Length = (YM7128B_Oversampler_Length + YM7128B_Oversampler_Factor - 1) /
+                                  YM7128B_Oversampler_Factor,
+
+    //! Interpolator kernel phase stride, padded for full-width vector loads
+    YM7128B_Interpolator_Stride = 16,
+
+    //! Interpolator history length, mirrored and padded for vector loads
+    YM7128B_Interpolator_Buffer_Length = YM7128B_Interpolator_Length + YM7128B_Interpolator_Stride,
+
+    //! Version of the history layout, see YM7128B_OversamplerFixed
+    YM7128B_Oversampler_Layout_Version = 1,
 };
 
+//! Number of kernel taps of the given interpolator phase
+#define YM7128B_Interpolator_PhaseLength(phase) \
+    ((YM7128B_Oversampler_Length - (phase) + YM7128B_Oversampler_Factor - 1) / YM7128B_Oversampler_Factor)
+
+//! Interpolator filter kernels, all sharing the same history layout.
+//! Shorter kernels are padded with zero coefficients.
+typedef enum YM7128B_Filter {
+    YM7128B_Filter_Linear = 0,  //!< Linear phase, 19 taps
+    YM7128B_Filter_Minimum,     //!< Minimum phase, 19 taps
+    YM7128B_Filter_LowOrder,    //!< Linear phase half-band, 7 taps; lowest latency
+
+    YM7128B_Filter_Count,
+
+    //! As per YM7128B_USE_MINPHASE
+    YM7128B_Filter_Default = YM7128B_USE_MINPHASE ? YM7128B_Filter_Minimum : YM7128B_Filter_Linear
+} YM7128B_Filter;
+
+//! Group delay of the given filter at low frequencies, rounded to whole
+//! output (oversampled) samples; zero if not valid.
+size_t YM7128B_Filter_GetLatency(YM7128B_Filter filter);
+
 // ----------------------------------------------------------------------------
 
+//! Oversampler FIR filter.
+//! The input history is a mirrored ring buffer: each input sample is written
+//! at both <tt>index_</tt> and <tt>index_ + YM7128B_Oversampler_Length</tt>,
+//! with <tt>index_</tt> decreasing at each sample. So, the latest samples are
+//! always found contiguous, from newest to oldest, starting at
+//! <tt>buffer_[index_]</tt>. The same layout applies to all the oversampler
+//! and interpolator types, as per YM7128B_Oversampler_Layout_Version.
+//! Interpolators pad their buffers up to YM7128B_Interpolator_Buffer_Length,
+//! so that vector kernels can always load a whole padded phase; padding
+//! samples are multiplied by zero kernel coefficients.
 typedef struct YM7128B_OversamplerFixed
 {
-    YM7128B_Fixed buffer_[YM7128B_Oversampler_Length];
+    YM7128B_Fixed buffer_[YM7128B_Oversampler_Length * 2];
+    YM7128B_Oversampler_Index index_;
 } YM7128B_OversamplerFixed;
 
 extern YM7128B_Fixed const YM7128B_OversamplerFixed_Kernel[YM7128B_Oversampler_Length];
@@ -459,9 +569,10 @@ void YM7128B_OversamplerFixed_Clear(
 {
     assert(self);
 
-    for (YM7128B_Oversampler_Index index = 0; index < YM7128B_Oversampler_Length; ++index) {
+    for (YM7128B_Oversampler_Index index = 0; index < YM7128B_Oversampler_Length * 2; ++index) {
         self->buffer_[index] = input;
     }
+    self->index_ = 0;
 }
 
 // ----------------------------------------------------------------------------
@@ -485,7 +596,8 @@ YM7128B_Fixed YM7128B_OversamplerFixed_Process(
 
 typedef struct YM7128B_OversamplerFloat
 {
-    YM7128B_Float buffer_[YM7128B_Oversampler_Length];
+    YM7128B_Float buffer_[YM7128B_Oversampler_Length * 2];
+    YM7128B_Oversampler_Index index_;
 } YM7128B_OversamplerFloat;
 
 extern YM7128B_Float const YM7128B_OversamplerFloat_Kernel[YM7128B_Oversampler_Length];
@@ -500,9 +612,10 @@ void YM7128B_OversamplerFloat_Clear(
 {
     assert(self);
 
-    for (YM7128B_Oversampler_Index index = 0; index < YM7128B_Oversampler_Length; ++index) {
+    for (YM7128B_Oversampler_Index index = 0; index < YM7128B_Oversampler_Length * 2; ++index) {
         self->buffer_[index] = input;
     }
+    self->index_ = 0;
 }
 
 // ----------------------------------------------------------------------------
@@ -522,15 +635,411 @@ YM7128B_Float YM7128B_OversamplerFloat_Process(
 
 // ============================================================================
 
-typedef struct YM7128B_ChipFixed
+//! Polyphase 2x interpolator.
+//! It is equivalent to feeding an oversampler with the input sample, followed
+//! by zero-stuffed samples, but it skips all the taps multiplied by zero.
+//! The kernel is split into phases, each producing one output sample.
+typedef struct YM7128B_InterpolatorFixed
+{
+    YM7128B_Fixed buffer_[YM7128B_Interpolator_Buffer_Length];
+    YM7128B_Oversampler_Index index_;
+} YM7128B_InterpolatorFixed;
+
+extern YM7128B_Fixed const YM7128B_InterpolatorFixed_Kernels[YM7128B_Filter_Count][YM7128B_Oversampler_Factor][YM7128B_Interpolator_Stride];
+
+//! Kernel of YM7128B_Filter_Default
+#define YM7128B_InterpolatorFixed_Kernel (YM7128B_InterpolatorFixed_Kernels[YM7128B_Filter_Default])
+
+// ----------------------------------------------------------------------------
+
+YM7128B_INLINE
+void YM7128B_InterpolatorFixed_Clear(
+    YM7128B_InterpolatorFixed* self,
+    YM7128B_Fixed input
+)
+{
+    assert(self);
+
+    for (YM7128B_Oversampler_Index index = 0; index < YM7128B_Interpolator_Buffer_Length; ++index) {
+        self->buffer_[index] = input;
+    }
+    self->index_ = 0;
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_INLINE
+void YM7128B_InterpolatorFixed_Reset(YM7128B_InterpolatorFixed* self)
+{
+    assert(self);
+
+    YM7128B_InterpolatorFixed_Clear(self, 0);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_InterpolatorFixed_Process(
+    YM7128B_InterpolatorFixed* self,
+    YM7128B_Fixed input,
+    YM7128B_Fixed outputs[YM7128B_Oversampler_Factor]
+);
+
+// ============================================================================
+
+//! Polyphase 2x interpolator.
+//! It is equivalent to feeding an oversampler with the input sample, followed
+//! by zero-stuffed samples, but it skips all the taps multiplied by zero.
+//! The kernel is split into phases, each producing one output sample.
+typedef struct YM7128B_InterpolatorFloat
+{
+    YM7128B_Float buffer_[YM7128B_Interpolator_Buffer_Length];
+    YM7128B_Oversampler_Index index_;
+} YM7128B_InterpolatorFloat;
+
+extern YM7128B_Float const YM7128B_InterpolatorFloat_Kernels[YM7128B_Filter_Count][YM7128B_Oversampler_Factor][YM7128B_Interpolator_Stride];
+
+//! Kernel of YM7128B_Filter_Default
+#define YM7128B_InterpolatorFloat_Kernel (YM7128B_InterpolatorFloat_Kernels[YM7128B_Filter_Default])
+
+// ----------------------------------------------------------------------------
+
+YM7128B_INLINE
+void YM7128B_InterpolatorFloat_Clear(
+    YM7128B_InterpolatorFloat* self,
+    YM7128B_Float input
+)
+{
+    assert(self);
+
+    for (YM7128B_Oversampler_Index index = 0; index < YM7128B_Interpolator_Buffer_Length; ++index) {
+        self->buffer_[index] = input;
+    }
+    self->index_ = 0;
+}
+
+// ----------------------------------------------------------------------------
+
+YM7128B_INLINE
+void YM7128B_InterpolatorFloat_Reset(YM7128B_InterpolatorFloat* self)
+{
+    assert(self);
+
+    YM7128B_InterpolatorFloat_Clear(self, 0);
+}
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_InterpolatorFloat_Process(
+    YM7128B_InterpolatorFloat* self,
+    YM7128B_Float input,
+    YM7128B_Float outputs[YM7128B_Oversampler_Factor]
+);
+
+// ============================================================================
+
+//! Register write, scheduled at an input sample offset
+typedef struct YM7128B_WriteEvent
+{
+    size_t offset;  //!< Input sample offset, relative to the next processed block
+    YM7128B_Address address;
+    YM7128B_Register data;
+} YM7128B_WriteEvent;
+
+//! Queue of scheduled register writes, sorted by offset.
+//! Events at the same offset keep their scheduling order.
+//! With pacing enabled, writes are delayed so as not to exceed
+//! YM7128B_Write_Rate, as per the actual serial interface.
+//! Pacing time is measured in ticks, with <tt>YM7128B_Write_Rate</tt> ticks
+//! per input sample, and <tt>sample_rate</tt> ticks per register write.
+typedef struct YM7128B_WriteQueue
+{
+    size_t head_;
+    size_t count_;
+    uint_fast64_t busy_;
+    bool pacing_;
+    YM7128B_WriteEvent events_[YM7128B_WRITE_QUEUE_LENGTH];
+} YM7128B_WriteQueue;
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_WriteQueue_Clear(YM7128B_WriteQueue* self);
+
+//! Schedules a write; returns false if the queue is full.
+bool YM7128B_WriteQueue_Push(
+    YM7128B_WriteQueue* self,
+    size_t offset,
+    YM7128B_Address address,
+    YM7128B_Register data
+);
+
+//! Gets the next write due before <tt>count</tt> input samples, if any.
+//! The effective offset accounts for pacing.
+bool YM7128B_WriteQueue_Peek(
+    YM7128B_WriteQueue const* self,
+    size_t count,
+    size_t* offset,
+    YM7128B_WriteEvent const** event
+);
+
+//! Removes the peeked write, applied at the effective offset.
+void YM7128B_WriteQueue_Pop(
+    YM7128B_WriteQueue* self,
+    size_t offset,
+    YM7128B_TapIdeal sample_rate
+);
+
+//! Rebases the pending writes after a block of <tt>count</tt> input samples.
+void YM7128B_WriteQueue_Advance(
+    YM7128B_WriteQueue* self,
+    size_t count
+);
+
+// ============================================================================
+
+//! Processing stages, as timed by YM7128B_Stats
+typedef enum YM7128B_Stage {
+    YM7128B_Stage_Feedback = 0,  //!< Feedback filter and delay line input
+    YM7128B_Stage_Mix,           //!< Output tap gathering and mixing
+    YM7128B_Stage_Oversampler,   //!< Output gains and oversampling
+    YM7128B_Stage_Count
+} YM7128B_Stage;
+
+//! Performance and signal counters of a chip, kept only when built with
+//! YM7128B_USE_STATS; otherwise they are left out of the chip altogether.
+//! Clamps are those hit by the arithmetic of each engine, so the Ideal
+//! engine never clamps, and the Short engine clamps its output sums within
+//! the tap mix, not counted.
+//! Cycles are read from the CPU timestamp counter where available, around
+//! each stage of each sample, which slows processing down by some margin.
+typedef struct YM7128B_Stats
+{
+    uint_fast64_t samples;          //!< Input samples processed, idle ones included
+    uint_fast64_t idle_samples;     //!< Input samples bypassed by the digital silence fast path
+    uint_fast64_t feedback_clamps;  //!< Clamps within the feedback path, delay line input included
+    uint_fast64_t output_clamps;    //!< Clamps of the output tap sums
+    YM7128B_Float lane_peaks[YM7128B_Gain_Lane_Count];        //!< Peak magnitude of each output tap
+    YM7128B_Float output_peaks[YM7128B_OutputChannel_Count];  //!< Peak magnitude of each output, before oversampling
+    uint_fast64_t cycles[YM7128B_Stage_Count];  //!< Cycles spent by each stage
+} YM7128B_Stats;
+
+// ============================================================================
+
+//! Interleaved stereo sample formats of the output stage, in host order
+typedef enum YM7128B_OutputFormat {
+    YM7128B_OutputFormat_S16 = 0,  //!< int16_t, saturated
+    YM7128B_OutputFormat_F32,      //!< float, full scale at +/-1
+    YM7128B_OutputFormat_Count
+} YM7128B_OutputFormat;
+
+//! Output stage gains, applied by the <tt>ProcessBlockOutput()</tt>
+//! functions, which mix the dry input with the wet chip outputs.
+//! The Fixed and Short engines into S16 mix in integer arithmetics, while
+//! both gains fit Q12 (up to almost +18 dB); otherwise, and for the other
+//! engines, they mix in floating point.
+typedef struct YM7128B_OutputStage
+{
+    YM7128B_Float dry;        //!< Dry input gain, linear
+    YM7128B_Float wet;        //!< Wet output gain, linear
+    YM7128B_Fixed dry_fixed;  //!< Dry input gain, Q12
+    YM7128B_Fixed wet_fixed;  //!< Wet output gain, Q12
+    bool fixed;               //!< Both gains fit Q12, for the integer mix
+} YM7128B_OutputStage;
+
+enum {
+    YM7128B_OutputStage_Decimals = 12,    //!< Fixed point decimals of the gains
+    YM7128B_OutputStage_Muted_dB = 128,   //!< Gains outside (-128; +128) dB mute
+    YM7128B_OutputStage_Chunk    = 256    //!< Input samples processed per chip call
+};
+
+// ----------------------------------------------------------------------------
+
+//! Sets the dry and wet gains, in decibels; values outside
+//! <tt>(-YM7128B_OutputStage_Muted_dB; +YM7128B_OutputStage_Muted_dB)</tt>
+//! do mute.
+void YM7128B_OutputStage_Setup(
+    YM7128B_OutputStage* self,
+    int dry_db,
+    int wet_db
+);
+
+//! Size of an output sample, in bytes; zero if not supported.
+size_t YM7128B_OutputFormat_GetSize(YM7128B_OutputFormat format);
+
+// ============================================================================
+
+//! Job of a parallel render, run once per <tt>index</tt>
+typedef void (*YM7128B_Job_Func)(void* data, size_t index);
+
+//! Runs the jobs of indices <tt>[0; count)</tt>, possibly in parallel, and
+//! returns once all of them are done; provided by the host, as the library
+//! does not spawn threads on its own.
+typedef void (*YM7128B_RunJobs_Func)(
+    void* context,
+    size_t count,
+    YM7128B_Job_Func job,
+    void* data
+);
+
+// ============================================================================
+
+//! Output rate converter of the Fixed and Float engines, fused into their
+//! <tt>ProcessBlockResampled()</tt> functions in place of the 2x
+//! interpolator: a single polyphase windowed-sinc filter resamples the chip
+//! signal straight from YM7128B_Input_Rate to the host rate.
+//! Its half-band response replaces the one of the interpolator, with the
+//! same DC gain, a flatter passband, and a deeper stopband.
+enum YM7128B_ResamplerSpecs {
+    YM7128B_Resampler_Length = 24,         //!< Kernel taps, i.e. input history
+    YM7128B_Resampler_Phases = 64,         //!< Kernel phases, linearly interpolated
+    YM7128B_Resampler_Fraction_Bits = 15,  //!< Interpolation bits between phases
+
+    //! Output rate range [Hz]; the kernel cutoff is fixed at the input Nyquist
+    YM7128B_Resampler_Min_Rate = YM7128B_Input_Rate,
+    YM7128B_Resampler_Max_Rate = 384000,
+};
+
+extern YM7128B_Fixed const YM7128B_ResamplerFixed_Kernel[YM7128B_Resampler_Phases + 1][YM7128B_Resampler_Length];
+extern YM7128B_Float const YM7128B_ResamplerFloat_Kernel[YM7128B_Resampler_Phases + 1][YM7128B_Resampler_Length];
+
+//! Group delay at low frequencies for the given output rate, rounded to
+//! whole output samples; zero if the rate is not supported.
+size_t YM7128B_Resampler_GetLatency(YM7128B_TapIdeal output_rate);
+
+// ----------------------------------------------------------------------------
+
+//! Resampler state, with the history of both output channels.
+//! The history is a mirrored ring buffer, as per the oversamplers.
+//! The output position is tracked exactly, as the phase past the latest
+//! input sample in units of <tt>1 / output_rate_</tt> input samples, so
+//! that long streams keep the nominal rate without drifting.
+typedef struct YM7128B_ResamplerFixed
+{
+    YM7128B_Fixed buffer_[YM7128B_OutputChannel_Count][YM7128B_Resampler_Length * 2];
+    YM7128B_TapIdeal output_rate_;
+    YM7128B_TapIdeal phase_;
+    uint_fast64_t scale_;  // phase_ to kernel position, in 32-bit fixed point
+    uint_fast8_t index_;
+} YM7128B_ResamplerFixed;
+
+//! Sets the output rate and clears the state; returns false if the rate is
+//! outside <tt>[YM7128B_Resampler_Min_Rate; YM7128B_Resampler_Max_Rate]</tt>,
+//! leaving the resampler unchanged.
+bool YM7128B_ResamplerFixed_Setup(
+    YM7128B_ResamplerFixed* self,
+    YM7128B_TapIdeal output_rate
+);
+
+//! Clears the history and the phase, keeping the output rate.
+void YM7128B_ResamplerFixed_Reset(YM7128B_ResamplerFixed* self);
+
+//! Exact number of output samples per channel yielded by the next
+//! <tt>count</tt> input samples.
+size_t YM7128B_ResamplerFixed_GetOutputCount(
+    YM7128B_ResamplerFixed const* self,
+    size_t count
+);
+
+//! Resamples stereo inputs at YM7128B_Input_Rate, writing as many outputs
+//! as per GetOutputCount(), which are also returned.
+size_t YM7128B_ResamplerFixed_Process(
+    YM7128B_ResamplerFixed* self,
+    YM7128B_Fixed const* inputs_left,
+    YM7128B_Fixed const* inputs_right,
+    size_t count,
+    YM7128B_Fixed* outputs_left,
+    YM7128B_Fixed* outputs_right
+);
+
+// ----------------------------------------------------------------------------
+
+//! Floating point resampler, as per YM7128B_ResamplerFixed.
+typedef struct YM7128B_ResamplerFloat
+{
+    YM7128B_Float buffer_[YM7128B_OutputChannel_Count][YM7128B_Resampler_Length * 2];
+    YM7128B_TapIdeal output_rate_;
+    YM7128B_TapIdeal phase_;
+    uint_fast64_t scale_;
+    uint_fast8_t index_;
+} YM7128B_ResamplerFloat;
+
+bool YM7128B_ResamplerFloat_Setup(
+    YM7128B_ResamplerFloat* self,
+    YM7128B_TapIdeal output_rate
+);
+
+void YM7128B_ResamplerFloat_Reset(YM7128B_ResamplerFloat* self);
+
+size_t YM7128B_ResamplerFloat_GetOutputCount(
+    YM7128B_ResamplerFloat const* self,
+    size_t count
+);
+
+size_t YM7128B_ResamplerFloat_Process(
+    YM7128B_ResamplerFloat* self,
+    YM7128B_Float const* inputs_left,
+    YM7128B_Float const* inputs_right,
+    size_t count,
+    YM7128B_Float* outputs_left,
+    YM7128B_Float* outputs_right
+);
+
+// ============================================================================
+
+//! Patch flags, telling register settings which simplify processing.
+//! They are exact for each engine: for instance, the pseudo-negative zero
+//! gain of the Fixed engine is not null.
+typedef enum YM7128B_PatchFlag {
+    YM7128B_PatchFlag_NoFeedback = 1 << 0,  //!< No feedback into the delay line
+    YM7128B_PatchFlag_NoInput    = 1 << 1,  //!< No input into the delay line
+    YM7128B_PatchFlag_LeftZero   = 1 << 2,  //!< Silent left output
+    YM7128B_PatchFlag_RightZero  = 1 << 3,  //!< Silent right output
+    YM7128B_PatchFlag_Sparse     = 1 << 4   //!< Some output taps are silent on both channels
+} YM7128B_PatchFlag;
+
+//! Fixed chip patch: a register image, with pre-resolved gains and taps.
+//! Immutable once set up, it can be shared by any number of chips.
+typedef struct YM7128B_PatchFixed
 {
-    YM7128B_Register regs_[YM7128B_Reg_Count];
-    YM7128B_Fixed gains_[YM7128B_Reg_T0];
     YM7128B_Tap taps_[YM7128B_Tap_Count];
-    YM7128B_Fixed t0_d_;
+    YM7128B_Fixed gains_[YM7128B_Reg_T0];
+    unsigned flags_;  //!< Mask of YM7128B_PatchFlag
+    YM7128B_Register lanes_[YM7128B_Gain_Lane_Count];  //!< Output taps not silent, minus one
+    YM7128B_Register lane_count_;  //!< Number of <tt>lanes_</tt>
+    YM7128B_Register regs_[YM7128B_Reg_Count];
+} YM7128B_PatchFixed;
+
+//! Sets up the patch from a register image, as per the <tt>--regdump</tt>
+//! format of YM7128B_pipe.
+void YM7128B_PatchFixed_Setup(
+    YM7128B_PatchFixed* self,
+    YM7128B_Register const regs[YM7128B_Reg_Count]
+);
+
+// ----------------------------------------------------------------------------
+
+//! Fixed chip.
+//! Fields are laid out from the hottest to the coldest: the state read at
+//! each sample comes first, within the first cache lines, followed by the
+//! delay line, while scheduled events come last.
+//! Registers are held by a patch, either shared, or private to the chip
+//! (<tt>own_</tt>, when <tt>patch_</tt> is null).
+typedef struct YM7128B_ChipFixed
+{
     YM7128B_Tap tail_;
-    YM7128B_Fixed buffer_[YM7128B_Buffer_Length];
-    YM7128B_OversamplerFixed oversampler_[YM7128B_OutputChannel_Count];
+    YM7128B_Fixed t0_d_;
+    size_t silence_;
+    YM7128B_PatchFixed const* patch_;
+    YM7128B_PatchFixed own_;
+    YM7128B_Kernel kernel_;
+    YM7128B_Filter filter_;
+    YM7128B_InterpolatorFixed oversampler_[YM7128B_OutputChannel_Count];
+    YM7128B_Fixed buffer_[YM7128B_Buffer_Capacity];
+    size_t written_;
+    YM7128B_WriteQueue queue_;
+    struct YM7128B_MailboxFixed* mailbox_;  //!< Register updates from another thread, if any
+#if YM7128B_USE_STATS
+    YM7128B_Stats stats_;
+#endif
 } YM7128B_ChipFixed;
 
 typedef struct YM7128B_ChipFixed_Process_Data
@@ -556,6 +1065,44 @@ void YM7128B_ChipFixed_Process(
     YM7128B_ChipFixed_Process_Data* data
 );
 
+//! Processes a block of contiguous mono input samples.
+//! Each output buffer receives <tt>count * YM7128B_Oversampling</tt> samples.
+//! Scheduled writes are applied at their input sample offsets.
+void YM7128B_ChipFixed_ProcessBlock(
+    YM7128B_ChipFixed* self,
+    YM7128B_Fixed const* inputs,
+    size_t count,
+    YM7128B_Fixed* outputs_left,
+    YM7128B_Fixed* outputs_right
+);
+
+//! Processes a block as per ProcessBlock(), mixing the dry inputs with the
+//! wet outputs through the output stage, straight into <tt>count * YM7128B_Oversampling</tt> stereo frames
+//! of interleaved left/right samples, as per <tt>format</tt>.
+void YM7128B_ChipFixed_ProcessBlockOutput(
+    YM7128B_ChipFixed* self,
+    YM7128B_OutputStage const* stage,
+    YM7128B_Fixed const* inputs,
+    size_t count,
+    YM7128B_OutputFormat format,
+    void* frames
+);
+
+//! Processes a block as per ProcessBlock(), but resampling the outputs to
+//! the rate of <tt>resampler</tt>, in place of the 2x interpolator.
+//! Each output buffer receives as many samples as told by the
+//! <tt>GetOutputCount()</tt> of the resampler, which are also returned.
+//! The interpolator state is left untouched, so a stream should be processed
+//! either way only.
+size_t YM7128B_ChipFixed_ProcessBlockResampled(
+    YM7128B_ChipFixed* self,
+    YM7128B_ResamplerFixed* resampler,
+    YM7128B_Fixed const* inputs,
+    size_t count,
+    YM7128B_Fixed* outputs_left,
+    YM7128B_Fixed* outputs_right
+);
+
 YM7128B_Register YM7128B_ChipFixed_Read(
     YM7128B_ChipFixed const* self,
     YM7128B_Address address
@@ -567,17 +1114,172 @@ void YM7128B_ChipFixed_Write(
     YM7128B_Register data
 );
 
+//! Makes the chip reference a shared patch in place of its own registers,
+//! at once; the patch must outlive such a reference, which any later
+//! register write detaches, after copying the patch.
+void YM7128B_ChipFixed_SetPatch(
+    YM7128B_ChipFixed* self,
+    YM7128B_PatchFixed const* patch
+);
+
+//! Gets the patch in use, either shared or private to the chip.
+YM7128B_PatchFixed const* YM7128B_ChipFixed_GetPatch(YM7128B_ChipFixed const* self);
+
+//! Schedules a register write, applied by the next processed blocks just
+//! before the input sample at <tt>offset</tt>, counted from the start of the
+//! next block. Returns false if the write queue is full.
+//! Writes scheduled at the same offset are applied in order.
+bool YM7128B_ChipFixed_ScheduleWrite(
+    YM7128B_ChipFixed* self,
+    size_t offset,
+    YM7128B_Address address,
+    YM7128B_Register data
+);
+
+//! Enables pacing of scheduled writes, as per YM7128B_Write_Rate.
+void YM7128B_ChipFixed_SetWritePacing(
+    YM7128B_ChipFixed* self,
+    bool enabled
+);
+
+//! Selects the processing kernel; returns false if not supported.
+//! The constructor selects the best supported kernel by default.
+bool YM7128B_ChipFixed_SetKernel(
+    YM7128B_ChipFixed* self,
+    YM7128B_Kernel kernel
+);
+
+//! Selects the interpolator filter; returns false if not valid.
+//! The constructor selects YM7128B_Filter_Default.
+//! The interpolator history is kept, so it can be changed while running.
+bool YM7128B_ChipFixed_SetFilter(
+    YM7128B_ChipFixed* self,
+    YM7128B_Filter filter
+);
+
+YM7128B_Filter YM7128B_ChipFixed_GetFilter(YM7128B_ChipFixed const* self);
+
+//! Latency of the outputs [output samples], as per the interpolator filter.
+size_t YM7128B_ChipFixed_GetLatency(YM7128B_ChipFixed const* self);
+
+//! Tells whether the delay line, the feedback filter and the output
+//! interpolators have decayed to exact zeros, so that silent inputs yield
+//! silent outputs. While idle, silent inputs just advance the delay line, and
+//! hosts feeding silence may skip the chip altogether; any non-zero input
+//! sample resumes processing.
+bool YM7128B_ChipFixed_IsIdle(YM7128B_ChipFixed const* self);
+
+//! Tells whether the feedback path is silent, so that the outputs depend only
+//! on the latest GetOverlap() input samples: then a stream can be rendered in
+//! chunks, each primed by its preceding inputs, with the same results.
+bool YM7128B_ChipFixed_IsChunkable(YM7128B_ChipFixed const* self);
+
+//! Input samples needed to prime a chunk, i.e. <tt>YM7128B_Buffer_Length + YM7128B_Oversampler_Length</tt>.
+size_t YM7128B_ChipFixed_GetOverlap(YM7128B_ChipFixed const* self);
+
+//! Restarts the chip as per Start(), then feeds the <tt>count</tt> input
+//! samples preceding a chunk of a stream, only the latest GetOverlap() ones
+//! being read, without outputs.
+//! Processing the chunk then yields the same outputs as processing the whole
+//! stream since Start(), as long as the chip is chunkable.
+void YM7128B_ChipFixed_Prime(
+    YM7128B_ChipFixed* self,
+    YM7128B_Fixed const* inputs,
+    size_t count
+);
+
+//! Renders a whole stream, as per Start() and then ProcessBlock(), split into
+//! <tt>chunk_count</tt> chunks run by <tt>run_jobs</tt>, each on its own
+//! worker chip sharing the patch, primed by the preceding inputs.
+//! Falls back to serial processing if the chip is not chunkable, or on
+//! allocation failure. The chip ends primed by the latest inputs, as after
+//! serial processing.
+void YM7128B_ChipFixed_RenderChunks(
+    YM7128B_ChipFixed* self,
+    YM7128B_Fixed const* inputs,
+    size_t count,
+    YM7128B_Fixed* outputs_left,
+    YM7128B_Fixed* outputs_right,
+    size_t chunk_count,
+    YM7128B_RunJobs_Func run_jobs,
+    void* context
+);
+
+//! Gets the performance and signal counters accumulated since construction
+//! or the last reset; all zeros unless built with YM7128B_USE_STATS.
+//! Peak magnitudes are relative to the full scale.
+void YM7128B_ChipFixed_GetStats(
+    YM7128B_ChipFixed const* self,
+    YM7128B_Stats* stats
+);
+
+//! Clears the performance and signal counters.
+void YM7128B_ChipFixed_ResetStats(YM7128B_ChipFixed* self);
+
+//! Size of a full state snapshot [bytes], the largest written by SaveState().
+size_t YM7128B_ChipFixed_GetStateSize(YM7128B_ChipFixed const* self);
+
+//! Saves a snapshot of the chip state, in a compact versioned binary format,
+//! as of YM7128B_STATE_VERSION; returns its size [bytes], or 0 if the buffer
+//! is too small.
+//! A delta snapshot only holds the delay samples written since the previous
+//! snapshot, for cheap rollback; it is full if all of them were overwritten.
+size_t YM7128B_ChipFixed_SaveState(
+    YM7128B_ChipFixed* self,
+    void* buffer,
+    size_t size,
+    bool delta
+);
+
+//! Restores a snapshot, saved by a chip of the same engine, by the
+//! same build; a delta snapshot applies on top of the previous one, so that
+//! a chain is loaded in order, starting from a full snapshot.
+//! Returns false on invalid data, leaving the chip unchanged.
+bool YM7128B_ChipFixed_LoadState(
+    YM7128B_ChipFixed* self,
+    void const* buffer,
+    size_t size
+);
+
 // ============================================================================
 
-typedef struct YM7128B_ChipFloat
+//! Float chip patch: a register image, with pre-resolved gains and taps.
+//! Immutable once set up, it can be shared by any number of chips.
+typedef struct YM7128B_PatchFloat
 {
-    YM7128B_Register regs_[YM7128B_Reg_Count];
-    YM7128B_Float gains_[YM7128B_Reg_T0];
     YM7128B_Tap taps_[YM7128B_Tap_Count];
+    YM7128B_Float gains_[YM7128B_Reg_T0];
+    unsigned flags_;  //!< Mask of YM7128B_PatchFlag
+    YM7128B_Register lanes_[YM7128B_Gain_Lane_Count];  //!< Output taps not silent, minus one
+    YM7128B_Register lane_count_;  //!< Number of <tt>lanes_</tt>
+    YM7128B_Register regs_[YM7128B_Reg_Count];
+} YM7128B_PatchFloat;
+
+//! Sets up the patch from a register image, as per the <tt>--regdump</tt>
+//! format of YM7128B_pipe.
+void YM7128B_PatchFloat_Setup(
+    YM7128B_PatchFloat* self,
+    YM7128B_Register const regs[YM7128B_Reg_Count]
+);
+
+// ----------------------------------------------------------------------------
+
+typedef struct YM7128B_ChipFloat
+{
+    YM7128B_PatchFloat const* patch_;
+    YM7128B_PatchFloat own_;
     YM7128B_Float t0_d_;
     YM7128B_Tap tail_;
-    YM7128B_Float buffer_[YM7128B_Buffer_Length];
-    YM7128B_OversamplerFloat oversampler_[YM7128B_OutputChannel_Count];
+    size_t silence_;
+    YM7128B_Float buffer_[YM7128B_Buffer_Capacity];
+    YM7128B_InterpolatorFloat oversampler_[YM7128B_OutputChannel_Count];
+    YM7128B_Filter filter_;
+    size_t written_;
+    YM7128B_WriteQueue queue_;
+    struct YM7128B_MailboxFloat* mailbox_;  //!< Register updates from another thread, if any
+#if YM7128B_USE_STATS
+    YM7128B_Stats stats_;
+#endif
 } YM7128B_ChipFloat;
 
 typedef struct YM7128B_ChipFloat_Process_Data
@@ -603,6 +1305,44 @@ void YM7128B_ChipFloat_Process(
     YM7128B_ChipFloat_Process_Data* data
 );
 
+//! Processes a block of contiguous mono input samples.
+//! Each output buffer receives <tt>count * YM7128B_Oversampling</tt> samples.
+//! Scheduled writes are applied at their input sample offsets.
+void YM7128B_ChipFloat_ProcessBlock(
+    YM7128B_ChipFloat* self,
+    YM7128B_Float const* inputs,
+    size_t count,
+    YM7128B_Float* outputs_left,
+    YM7128B_Float* outputs_right
+);
+
+//! Processes a block as per ProcessBlock(), mixing the dry inputs with the
+//! wet outputs through the output stage, straight into <tt>count * YM7128B_Oversampling</tt> stereo frames
+//! of interleaved left/right samples, as per <tt>format</tt>.
+void YM7128B_ChipFloat_ProcessBlockOutput(
+    YM7128B_ChipFloat* self,
+    YM7128B_OutputStage const* stage,
+    YM7128B_Float const* inputs,
+    size_t count,
+    YM7128B_OutputFormat format,
+    void* frames
+);
+
+//! Processes a block as per ProcessBlock(), but resampling the outputs to
+//! the rate of <tt>resampler</tt>, in place of the 2x interpolator.
+//! Each output buffer receives as many samples as told by the
+//! <tt>GetOutputCount()</tt> of the resampler, which are also returned.
+//! The interpolator state is left untouched, so a stream should be processed
+//! either way only.
+size_t YM7128B_ChipFloat_ProcessBlockResampled(
+    YM7128B_ChipFloat* self,
+    YM7128B_ResamplerFloat* resampler,
+    YM7128B_Float const* inputs,
+    size_t count,
+    YM7128B_Float* outputs_left,
+    YM7128B_Float* outputs_right
+);
+
 YM7128B_Register YM7128B_ChipFloat_Read(
     YM7128B_ChipFloat const* self,
     YM7128B_Address address
@@ -614,21 +1354,136 @@ void YM7128B_ChipFloat_Write(
     YM7128B_Register data
 );
 
-// ============================================================================
+//! Makes the chip reference a shared patch in place of its own registers,
+//! at once; the patch must outlive such a reference, which any later
+//! register write detaches, after copying the patch.
+void YM7128B_ChipFloat_SetPatch(
+    YM7128B_ChipFloat* self,
+    YM7128B_PatchFloat const* patch
+);
 
-typedef struct YM7128B_ChipIdeal
-{
-    YM7128B_Register regs_[YM7128B_Reg_Count];
-    YM7128B_Float gains_[YM7128B_Reg_T0];
-    YM7128B_TapIdeal taps_[YM7128B_Tap_Count];
-    YM7128B_Float t0_d_;
-    YM7128B_TapIdeal tail_;
-    YM7128B_Float* buffer_;
-    YM7128B_TapIdeal length_;
-    YM7128B_TapIdeal sample_rate_;
-} YM7128B_ChipIdeal;
+//! Gets the patch in use, either shared or private to the chip.
+YM7128B_PatchFloat const* YM7128B_ChipFloat_GetPatch(YM7128B_ChipFloat const* self);
 
-typedef struct YM7128B_ChipIdeal_Process_Data
+//! Schedules a register write, applied by the next processed blocks just
+//! before the input sample at <tt>offset</tt>, counted from the start of the
+//! next block. Returns false if the write queue is full.
+//! Writes scheduled at the same offset are applied in order.
+bool YM7128B_ChipFloat_ScheduleWrite(
+    YM7128B_ChipFloat* self,
+    size_t offset,
+    YM7128B_Address address,
+    YM7128B_Register data
+);
+
+//! Enables pacing of scheduled writes, as per YM7128B_Write_Rate.
+void YM7128B_ChipFloat_SetWritePacing(
+    YM7128B_ChipFloat* self,
+    bool enabled
+);
+
+//! Selects the interpolator filter; returns false if not valid.
+//! The constructor selects YM7128B_Filter_Default.
+//! The interpolator history is kept, so it can be changed while running.
+bool YM7128B_ChipFloat_SetFilter(
+    YM7128B_ChipFloat* self,
+    YM7128B_Filter filter
+);
+
+YM7128B_Filter YM7128B_ChipFloat_GetFilter(YM7128B_ChipFloat const* self);
+
+//! Latency of the outputs [output samples], as per the interpolator filter.
+size_t YM7128B_ChipFloat_GetLatency(YM7128B_ChipFloat const* self);
+
+//! Tells whether the delay line, the feedback filter and the output
+//! interpolators have decayed to exact zeros, so that silent inputs yield
+//! silent outputs. While idle, silent inputs just advance the delay line, and
+//! hosts feeding silence may skip the chip altogether; any non-zero input
+//! sample resumes processing.
+bool YM7128B_ChipFloat_IsIdle(YM7128B_ChipFloat const* self);
+
+//! Gets the performance and signal counters accumulated since construction
+//! or the last reset; all zeros unless built with YM7128B_USE_STATS.
+//! Peak magnitudes are relative to the full scale.
+void YM7128B_ChipFloat_GetStats(
+    YM7128B_ChipFloat const* self,
+    YM7128B_Stats* stats
+);
+
+//! Clears the performance and signal counters.
+void YM7128B_ChipFloat_ResetStats(YM7128B_ChipFloat* self);
+
+//! Size of a full state snapshot [bytes], the largest written by SaveState().
+size_t YM7128B_ChipFloat_GetStateSize(YM7128B_ChipFloat const* self);
+
+//! Saves a snapshot of the chip state, in a compact versioned binary format,
+//! as of YM7128B_STATE_VERSION; returns its size [bytes], or 0 if the buffer
+//! is too small.
+//! A delta snapshot only holds the delay samples written since the previous
+//! snapshot, for cheap rollback; it is full if all of them were overwritten.
+size_t YM7128B_ChipFloat_SaveState(
+    YM7128B_ChipFloat* self,
+    void* buffer,
+    size_t size,
+    bool delta
+);
+
+//! Restores a snapshot, saved by a chip of the same engine, by the
+//! same build; a delta snapshot applies on top of the previous one, so that
+//! a chain is loaded in order, starting from a full snapshot.
+//! Returns false on invalid data, leaving the chip unchanged.
+bool YM7128B_ChipFloat_LoadState(
+    YM7128B_ChipFloat* self,
+    void const* buffer,
+    size_t size
+);
+
+// ============================================================================
+
+//! Ideal chip patch: a register image, with pre-resolved gains and taps.
+//! Immutable once set up, it can be shared by any number of chips.
+typedef struct YM7128B_PatchIdeal
+{
+    YM7128B_TapIdeal taps_[YM7128B_Tap_Count];
+    YM7128B_Float gains_[YM7128B_Reg_T0];
+    unsigned flags_;  //!< Mask of YM7128B_PatchFlag
+    YM7128B_Register lanes_[YM7128B_Gain_Lane_Count];  //!< Output taps not silent, minus one
+    YM7128B_Register lane_count_;  //!< Number of <tt>lanes_</tt>
+    YM7128B_TapIdeal sample_rate_;
+    YM7128B_Register regs_[YM7128B_Reg_Count];
+} YM7128B_PatchIdeal;
+
+//! Sets up the patch from a register image, as per the <tt>--regdump</tt>
+//! format of YM7128B_pipe, with taps resolved at the given sample rate.
+void YM7128B_PatchIdeal_Setup(
+    YM7128B_PatchIdeal* self,
+    YM7128B_Register const regs[YM7128B_Reg_Count],
+    YM7128B_TapIdeal sample_rate
+);
+
+// ----------------------------------------------------------------------------
+
+typedef struct YM7128B_ChipIdeal
+{
+    YM7128B_PatchIdeal const* patch_;
+    YM7128B_PatchIdeal own_;
+    YM7128B_Float t0_d_;
+    YM7128B_TapIdeal tail_;
+    YM7128B_TapIdeal silence_;
+    YM7128B_Float* buffer_;
+    YM7128B_TapIdeal length_;
+    YM7128B_TapIdeal capacity_;
+    YM7128B_TapIdeal sample_rate_;
+    bool buffer_owned_;
+    YM7128B_TapIdeal written_;
+    YM7128B_WriteQueue queue_;
+    struct YM7128B_MailboxIdeal* mailbox_;  //!< Register updates from another thread, if any
+#if YM7128B_USE_STATS
+    YM7128B_Stats stats_;
+#endif
+} YM7128B_ChipIdeal;
+
+typedef struct YM7128B_ChipIdeal_Process_Data
 {
     YM7128B_Float inputs[YM7128B_InputChannel_Count];
     YM7128B_Float outputs[YM7128B_OutputChannel_Count];
@@ -651,6 +1506,29 @@ void YM7128B_ChipIdeal_Process(
     YM7128B_ChipIdeal_Process_Data* data
 );
 
+//! Processes a block of contiguous mono input samples.
+//! Each output buffer receives <tt>count</tt> samples.
+//! Scheduled writes are applied at their input sample offsets.
+void YM7128B_ChipIdeal_ProcessBlock(
+    YM7128B_ChipIdeal* self,
+    YM7128B_Float const* inputs,
+    size_t count,
+    YM7128B_Float* outputs_left,
+    YM7128B_Float* outputs_right
+);
+
+//! Processes a block as per ProcessBlock(), mixing the dry inputs with the
+//! wet outputs through the output stage, straight into <tt>count</tt> stereo frames
+//! of interleaved left/right samples, as per <tt>format</tt>.
+void YM7128B_ChipIdeal_ProcessBlockOutput(
+    YM7128B_ChipIdeal* self,
+    YM7128B_OutputStage const* stage,
+    YM7128B_Float const* inputs,
+    size_t count,
+    YM7128B_OutputFormat format,
+    void* frames
+);
+
 YM7128B_Register YM7128B_ChipIdeal_Read(
     YM7128B_ChipIdeal const* self,
     YM7128B_Address address
@@ -662,23 +1540,159 @@ void YM7128B_ChipIdeal_Write(
     YM7128B_Register data
 );
 
+//! Makes the chip reference a shared patch in place of its own registers,
+//! at once; the patch must outlive such a reference, which any later
+//! register write detaches, after copying the patch.
+//! Returns false if the patch was set up for another sample rate, leaving
+//! the chip unchanged.
+bool YM7128B_ChipIdeal_SetPatch(
+    YM7128B_ChipIdeal* self,
+    YM7128B_PatchIdeal const* patch
+);
+
+//! Gets the patch in use, either shared or private to the chip.
+YM7128B_PatchIdeal const* YM7128B_ChipIdeal_GetPatch(YM7128B_ChipIdeal const* self);
+
+//! Schedules a register write, applied by the next processed blocks just
+//! before the input sample at <tt>offset</tt>, counted from the start of the
+//! next block. Returns false if the write queue is full.
+//! Writes scheduled at the same offset are applied in order.
+bool YM7128B_ChipIdeal_ScheduleWrite(
+    YM7128B_ChipIdeal* self,
+    size_t offset,
+    YM7128B_Address address,
+    YM7128B_Register data
+);
+
+//! Enables pacing of scheduled writes, as per YM7128B_Write_Rate.
+void YM7128B_ChipIdeal_SetWritePacing(
+    YM7128B_ChipIdeal* self,
+    bool enabled
+);
+
+//! Latency of the outputs [output samples]: always zero, without oversampling.
+size_t YM7128B_ChipIdeal_GetLatency(YM7128B_ChipIdeal const* self);
+
+//! Tells whether the delay line and the feedback filter have decayed to exact
+//! zeros, so that silent inputs yield silent outputs.
+//! While idle, silent inputs just advance the delay line, and
+//! hosts feeding silence may skip the chip altogether; any non-zero input
+//! sample resumes processing.
+bool YM7128B_ChipIdeal_IsIdle(YM7128B_ChipIdeal const* self);
+
+//! Gets the performance and signal counters accumulated since construction
+//! or the last reset; all zeros unless built with YM7128B_USE_STATS.
+//! Peak magnitudes are relative to the full scale.
+void YM7128B_ChipIdeal_GetStats(
+    YM7128B_ChipIdeal const* self,
+    YM7128B_Stats* stats
+);
+
+//! Clears the performance and signal counters.
+void YM7128B_ChipIdeal_ResetStats(YM7128B_ChipIdeal* self);
+
+//! Size of a full state snapshot [bytes], the largest written by SaveState().
+size_t YM7128B_ChipIdeal_GetStateSize(YM7128B_ChipIdeal const* self);
+
+//! Saves a snapshot of the chip state, in a compact versioned binary format,
+//! as of YM7128B_STATE_VERSION; returns its size [bytes], or 0 if the buffer
+//! is too small.
+//! A delta snapshot only holds the delay samples written since the previous
+//! snapshot, for cheap rollback; it is full if all of them were overwritten.
+size_t YM7128B_ChipIdeal_SaveState(
+    YM7128B_ChipIdeal* self,
+    void* buffer,
+    size_t size,
+    bool delta
+);
+
+//! Restores a snapshot, saved by a chip of the same engine and sample rate, by the
+//! same build; a delta snapshot applies on top of the previous one, so that
+//! a chain is loaded in order, starting from a full snapshot.
+//! Returns false on invalid data, leaving the chip unchanged.
+bool YM7128B_ChipIdeal_LoadState(
+    YM7128B_ChipIdeal* self,
+    void const* buffer,
+    size_t size
+);
+
+//! Sets the sample rate, allocating the delay memory only if it exceeds the
+//! reserved capacity; else the delay line contents are resampled in place,
+//! without any heap call nor audible reset.
 void YM7128B_ChipIdeal_Setup(
     YM7128B_ChipIdeal* self,
     YM7128B_TapIdeal sample_rate
 );
 
+//! Reserves heap delay memory for sample rates up to the given one, so that
+//! later Setup() calls within it never allocate; keeps the delay contents.
+//! Returns false on allocation failure, leaving the chip unchanged.
+bool YM7128B_ChipIdeal_Reserve(
+    YM7128B_ChipIdeal* self,
+    YM7128B_TapIdeal max_sample_rate
+);
+
+//! Size of the delay memory for the given sample rate [bytes], rounded up to
+//! YM7128B_CACHE_LINE, so that many chips can share a contiguous slab.
+size_t YM7128B_ChipIdeal_RequiredBytes(YM7128B_TapIdeal sample_rate);
+
+//! Like Setup(), but binds the delay memory to a caller-owned buffer,
+//! without any heap allocation; the memory is cleared, and must outlive
+//! the chip, or any later Setup*() call.
+//! The whole buffer is the reserved capacity for later Setup() calls.
+//! Returns false if the buffer is too small or misaligned for
+//! <tt>YM7128B_Float</tt>, leaving the chip unchanged.
+bool YM7128B_ChipIdeal_SetupWithMemory(
+    YM7128B_ChipIdeal* self,
+    YM7128B_TapIdeal sample_rate,
+    void* memory,
+    size_t bytes
+);
+
 // ============================================================================
 
-typedef struct YM7128B_ChipShort
+//! Short chip patch: a register image, with pre-resolved gains and taps.
+//! Immutable once set up, it can be shared by any number of chips.
+typedef struct YM7128B_PatchShort
 {
-    YM7128B_Register regs_[YM7128B_Reg_Count];
-    YM7128B_Fixed gains_[YM7128B_Reg_T0];
     YM7128B_TapIdeal taps_[YM7128B_Tap_Count];
+    YM7128B_Fixed gains_[YM7128B_Reg_T0];
+    unsigned flags_;  //!< Mask of YM7128B_PatchFlag
+    YM7128B_Register lanes_[YM7128B_Gain_Lane_Count];  //!< Output taps not silent, minus one
+    YM7128B_Register lane_count_;  //!< Number of <tt>lanes_</tt>
+    YM7128B_TapIdeal sample_rate_;
+    YM7128B_Register regs_[YM7128B_Reg_Count];
+} YM7128B_PatchShort;
+
+//! Sets up the patch from a register image, as per the <tt>--regdump</tt>
+//! format of YM7128B_pipe, with taps resolved at the given sample rate.
+void YM7128B_PatchShort_Setup(
+    YM7128B_PatchShort* self,
+    YM7128B_Register const regs[YM7128B_Reg_Count],
+    YM7128B_TapIdeal sample_rate
+);
+
+// ----------------------------------------------------------------------------
+
+typedef struct YM7128B_ChipShort
+{
+    YM7128B_PatchShort const* patch_;
+    YM7128B_PatchShort own_;
     YM7128B_Fixed t0_d_;
     YM7128B_TapIdeal tail_;
+    YM7128B_TapIdeal silence_;
     YM7128B_Fixed* buffer_;
     YM7128B_TapIdeal length_;
+    YM7128B_TapIdeal capacity_;
     YM7128B_TapIdeal sample_rate_;
+    bool buffer_owned_;
+    YM7128B_Kernel kernel_;
+    YM7128B_TapIdeal written_;
+    YM7128B_WriteQueue queue_;
+    struct YM7128B_MailboxShort* mailbox_;  //!< Register updates from another thread, if any
+#if YM7128B_USE_STATS
+    YM7128B_Stats stats_;
+#endif
 } YM7128B_ChipShort;
 
 typedef struct YM7128B_ChipShort_Process_Data
@@ -704,6 +1718,29 @@ void YM7128B_ChipShort_Process(
     YM7128B_ChipShort_Process_Data* data
 );
 
+//! Processes a block of contiguous mono input samples.
+//! Each output buffer receives <tt>count</tt> samples.
+//! Scheduled writes are applied at their input sample offsets.
+void YM7128B_ChipShort_ProcessBlock(
+    YM7128B_ChipShort* self,
+    YM7128B_Fixed const* inputs,
+    size_t count,
+    YM7128B_Fixed* outputs_left,
+    YM7128B_Fixed* outputs_right
+);
+
+//! Processes a block as per ProcessBlock(), mixing the dry inputs with the
+//! wet outputs through the output stage, straight into <tt>count</tt> stereo frames
+//! of interleaved left/right samples, as per <tt>format</tt>.
+void YM7128B_ChipShort_ProcessBlockOutput(
+    YM7128B_ChipShort* self,
+    YM7128B_OutputStage const* stage,
+    YM7128B_Fixed const* inputs,
+    size_t count,
+    YM7128B_OutputFormat format,
+    void* frames
+);
+
 YM7128B_Register YM7128B_ChipShort_Read(
     YM7128B_ChipShort const* self,
     YM7128B_Address address
@@ -715,11 +1752,622 @@ void YM7128B_ChipShort_Write(
     YM7128B_Register data
 );
 
+//! Makes the chip reference a shared patch in place of its own registers,
+//! at once; the patch must outlive such a reference, which any later
+//! register write detaches, after copying the patch.
+//! Returns false if the patch was set up for another sample rate, leaving
+//! the chip unchanged.
+bool YM7128B_ChipShort_SetPatch(
+    YM7128B_ChipShort* self,
+    YM7128B_PatchShort const* patch
+);
+
+//! Gets the patch in use, either shared or private to the chip.
+YM7128B_PatchShort const* YM7128B_ChipShort_GetPatch(YM7128B_ChipShort const* self);
+
+//! Schedules a register write, applied by the next processed blocks just
+//! before the input sample at <tt>offset</tt>, counted from the start of the
+//! next block. Returns false if the write queue is full.
+//! Writes scheduled at the same offset are applied in order.
+bool YM7128B_ChipShort_ScheduleWrite(
+    YM7128B_ChipShort* self,
+    size_t offset,
+    YM7128B_Address address,
+    YM7128B_Register data
+);
+
+//! Enables pacing of scheduled writes, as per YM7128B_Write_Rate.
+void YM7128B_ChipShort_SetWritePacing(
+    YM7128B_ChipShort* self,
+    bool enabled
+);
+
+//! Latency of the outputs [output samples]: always zero, without oversampling.
+size_t YM7128B_ChipShort_GetLatency(YM7128B_ChipShort const* self);
+
+//! Tells whether the delay line and the feedback filter have decayed to exact
+//! zeros, so that silent inputs yield silent outputs.
+//! While idle, silent inputs just advance the delay line, and
+//! hosts feeding silence may skip the chip altogether; any non-zero input
+//! sample resumes processing.
+bool YM7128B_ChipShort_IsIdle(YM7128B_ChipShort const* self);
+
+//! Tells whether the feedback path is silent, so that the outputs depend only
+//! on the latest GetOverlap() input samples: then a stream can be rendered in
+//! chunks, each primed by its preceding inputs, with the same results.
+bool YM7128B_ChipShort_IsChunkable(YM7128B_ChipShort const* self);
+
+//! Input samples needed to prime a chunk, i.e. the delay line length.
+size_t YM7128B_ChipShort_GetOverlap(YM7128B_ChipShort const* self);
+
+//! Restarts the chip as per Start(), then feeds the <tt>count</tt> input
+//! samples preceding a chunk of a stream, only the latest GetOverlap() ones
+//! being read, without outputs.
+//! Processing the chunk then yields the same outputs as processing the whole
+//! stream since Start(), as long as the chip is chunkable.
+void YM7128B_ChipShort_Prime(
+    YM7128B_ChipShort* self,
+    YM7128B_Fixed const* inputs,
+    size_t count
+);
+
+//! Renders a whole stream, as per Start() and then ProcessBlock(), split into
+//! <tt>chunk_count</tt> chunks run by <tt>run_jobs</tt>, each on its own
+//! worker chip sharing the patch, primed by the preceding inputs.
+//! Falls back to serial processing if the chip is not chunkable, or on
+//! allocation failure. The chip ends primed by the latest inputs, as after
+//! serial processing.
+void YM7128B_ChipShort_RenderChunks(
+    YM7128B_ChipShort* self,
+    YM7128B_Fixed const* inputs,
+    size_t count,
+    YM7128B_Fixed* outputs_left,
+    YM7128B_Fixed* outputs_right,
+    size_t chunk_count,
+    YM7128B_RunJobs_Func run_jobs,
+    void* context
+);
+
+//! Gets the performance and signal counters accumulated since construction
+//! or the last reset; all zeros unless built with YM7128B_USE_STATS.
+//! Peak magnitudes are relative to the full scale.
+void YM7128B_ChipShort_GetStats(
+    YM7128B_ChipShort const* self,
+    YM7128B_Stats* stats
+);
+
+//! Clears the performance and signal counters.
+void YM7128B_ChipShort_ResetStats(YM7128B_ChipShort* self);
+
+//! Size of a full state snapshot [bytes], the largest written by SaveState().
+size_t YM7128B_ChipShort_GetStateSize(YM7128B_ChipShort const* self);
+
+//! Saves a snapshot of the chip state, in a compact versioned binary format,
+//! as of YM7128B_STATE_VERSION; returns its size [bytes], or 0 if the buffer
+//! is too small.
+//! A delta snapshot only holds the delay samples written since the previous
+//! snapshot, for cheap rollback; it is full if all of them were overwritten.
+size_t YM7128B_ChipShort_SaveState(
+    YM7128B_ChipShort* self,
+    void* buffer,
+    size_t size,
+    bool delta
+);
+
+//! Restores a snapshot, saved by a chip of the same engine and sample rate, by the
+//! same build; a delta snapshot applies on top of the previous one, so that
+//! a chain is loaded in order, starting from a full snapshot.
+//! Returns false on invalid data, leaving the chip unchanged.
+bool YM7128B_ChipShort_LoadState(
+    YM7128B_ChipShort* self,
+    void const* buffer,
+    size_t size
+);
+
+//! Selects the processing kernel; returns false if not supported.
+//! The constructor selects the best supported kernel by default.
+bool YM7128B_ChipShort_SetKernel(
+    YM7128B_ChipShort* self,
+    YM7128B_Kernel kernel
+);
+
+//! Sets the sample rate, allocating the delay memory only if it exceeds the
+//! reserved capacity; else the delay line contents are resampled in place,
+//! without any heap call nor audible reset.
 void YM7128B_ChipShort_Setup(
     YM7128B_ChipShort* self,
     YM7128B_TapIdeal sample_rate
 );
 
+//! Reserves heap delay memory for sample rates up to the given one, so that
+//! later Setup() calls within it never allocate; keeps the delay contents.
+//! Returns false on allocation failure, leaving the chip unchanged.
+bool YM7128B_ChipShort_Reserve(
+    YM7128B_ChipShort* self,
+    YM7128B_TapIdeal max_sample_rate
+);
+
+//! Size of the delay memory for the given sample rate [bytes], rounded up to
+//! YM7128B_CACHE_LINE, so that many chips can share a contiguous slab.
+size_t YM7128B_ChipShort_RequiredBytes(YM7128B_TapIdeal sample_rate);
+
+//! Like Setup(), but binds the delay memory to a caller-owned buffer,
+//! without any heap allocation; the memory is cleared, and must outlive
+//! the chip, or any later Setup*() call.
+//! The whole buffer is the reserved capacity for later Setup() calls.
+//! Returns false if the buffer is too small or misaligned for
+//! <tt>YM7128B_Fixed</tt>, leaving the chip unchanged.
+bool YM7128B_ChipShort_SetupWithMemory(
+    YM7128B_ChipShort* self,
+    YM7128B_TapIdeal sample_rate,
+    void* memory,
+    size_t bytes
+);
+
+// ============================================================================
+
+//! Table of interned patches: each distinct register image is set up once
+//! per engine and sample rate, and shared by all of its users.
+//! Patches live until the table is destroyed. Not thread-safe.
+typedef struct YM7128B_PatchTable
+{
+    void** slots_;
+    size_t capacity_;
+    size_t count_;
+} YM7128B_PatchTable;
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_PatchTable_Ctor(YM7128B_PatchTable* self);
+
+void YM7128B_PatchTable_Dtor(YM7128B_PatchTable* self);
+
+//! Gets the interned patch of the register image, setting it up if new;
+//! returns null on allocation failure.
+YM7128B_PatchFixed const* YM7128B_PatchTable_InternFixed(
+    YM7128B_PatchTable* self,
+    YM7128B_Register const regs[YM7128B_Reg_Count]
+);
+
+//! Gets the interned patch of the register image, setting it up if new;
+//! returns null on allocation failure.
+YM7128B_PatchFloat const* YM7128B_PatchTable_InternFloat(
+    YM7128B_PatchTable* self,
+    YM7128B_Register const regs[YM7128B_Reg_Count]
+);
+
+//! Gets the interned patch of the register image at the given sample rate,
+//! setting it up if new; returns null on allocation failure.
+YM7128B_PatchIdeal const* YM7128B_PatchTable_InternIdeal(
+    YM7128B_PatchTable* self,
+    YM7128B_Register const regs[YM7128B_Reg_Count],
+    YM7128B_TapIdeal sample_rate
+);
+
+//! Gets the interned patch of the register image at the given sample rate,
+//! setting it up if new; returns null on allocation failure.
+YM7128B_PatchShort const* YM7128B_PatchTable_InternShort(
+    YM7128B_PatchTable* self,
+    YM7128B_Register const regs[YM7128B_Reg_Count],
+    YM7128B_TapIdeal sample_rate
+);
+
+// ============================================================================
+
+//! Register update mailbox: a wait-free single-producer single-consumer
+//! triple buffer, so that another thread can replace the register image used
+//! by a chip while it is processing.
+//! The producer sets up the back slot, then swaps it with the middle one,
+//! flagged as fresh; at the start of each processed block, the chip swaps a
+//! fresh middle slot with the front one, and references it as its patch.
+//! Neither side ever waits for the other; posts not yet taken by the chip are
+//! superseded by newer ones.
+typedef struct YM7128B_Mailbox
+{
+    long state_;           //!< Middle slot index, plus the fresh flag; atomic
+    unsigned char back_;   //!< Slot owned by the producer
+    unsigned char front_;  //!< Slot owned by the chip
+} YM7128B_Mailbox;
+
+//! Mailbox specifications
+enum YM7128B_MailboxSpecs {
+    YM7128B_Mailbox_Slot_Count = 3
+};
+
+// ----------------------------------------------------------------------------
+
+//! Register update mailbox of a Fixed chip.
+typedef struct YM7128B_MailboxFixed
+{
+    YM7128B_PatchFixed slots_[YM7128B_Mailbox_Slot_Count];
+    YM7128B_Mailbox core_;
+} YM7128B_MailboxFixed;
+
+void YM7128B_MailboxFixed_Ctor(YM7128B_MailboxFixed* self);
+
+void YM7128B_MailboxFixed_Dtor(YM7128B_MailboxFixed* self);
+
+//! Posts a register image as per the <tt>--regdump</tt> format of
+//! YM7128B_pipe; wait-free, from the single producer thread.
+void YM7128B_MailboxFixed_Post(
+    YM7128B_MailboxFixed* self,
+    YM7128B_Register const regs[YM7128B_Reg_Count]
+);
+
+//! Attaches the chip to a mailbox, or detaches it if null; the mailbox
+//! serves a single chip, and the chip must not be processing meanwhile.
+//! The posted register images apply at the start of the next processed
+//! blocks, replacing any register writes done meanwhile.
+void YM7128B_ChipFixed_SetMailbox(
+    YM7128B_ChipFixed* self,
+    YM7128B_MailboxFixed* mailbox
+);
+
+// ----------------------------------------------------------------------------
+
+//! Register update mailbox of a Float chip.
+typedef struct YM7128B_MailboxFloat
+{
+    YM7128B_PatchFloat slots_[YM7128B_Mailbox_Slot_Count];
+    YM7128B_Mailbox core_;
+} YM7128B_MailboxFloat;
+
+void YM7128B_MailboxFloat_Ctor(YM7128B_MailboxFloat* self);
+
+void YM7128B_MailboxFloat_Dtor(YM7128B_MailboxFloat* self);
+
+//! Posts a register image as per the <tt>--regdump</tt> format of
+//! YM7128B_pipe; wait-free, from the single producer thread.
+void YM7128B_MailboxFloat_Post(
+    YM7128B_MailboxFloat* self,
+    YM7128B_Register const regs[YM7128B_Reg_Count]
+);
+
+//! Attaches the chip to a mailbox, or detaches it if null; the mailbox
+//! serves a single chip, and the chip must not be processing meanwhile.
+//! The posted register images apply at the start of the next processed
+//! blocks, replacing any register writes done meanwhile.
+void YM7128B_ChipFloat_SetMailbox(
+    YM7128B_ChipFloat* self,
+    YM7128B_MailboxFloat* mailbox
+);
+
+// ----------------------------------------------------------------------------
+
+//! Register update mailbox of a Ideal chip.
+typedef struct YM7128B_MailboxIdeal
+{
+    YM7128B_PatchIdeal slots_[YM7128B_Mailbox_Slot_Count];
+    YM7128B_Mailbox core_;
+} YM7128B_MailboxIdeal;
+
+void YM7128B_MailboxIdeal_Ctor(YM7128B_MailboxIdeal* self);
+
+void YM7128B_MailboxIdeal_Dtor(YM7128B_MailboxIdeal* self);
+
+//! Posts a register image at the given sample rate, as per the
+//! <tt>--regdump</tt> format of YM7128B_pipe; wait-free, from the single
+//! producer thread.
+void YM7128B_MailboxIdeal_Post(
+    YM7128B_MailboxIdeal* self,
+    YM7128B_Register const regs[YM7128B_Reg_Count],
+    YM7128B_TapIdeal sample_rate
+);
+
+//! Attaches the chip to a mailbox, or detaches it if null; the mailbox
+//! serves a single chip, and the chip must not be processing meanwhile.
+//! The posted register images apply at the start of the next processed
+//! blocks, replacing any register writes done meanwhile; images posted for
+//! another sample rate are set up again by the chip, at its own rate.
+void YM7128B_ChipIdeal_SetMailbox(
+    YM7128B_ChipIdeal* self,
+    YM7128B_MailboxIdeal* mailbox
+);
+
+// ----------------------------------------------------------------------------
+
+//! Register update mailbox of a Short chip.
+typedef struct YM7128B_MailboxShort
+{
+    YM7128B_PatchShort slots_[YM7128B_Mailbox_Slot_Count];
+    YM7128B_Mailbox core_;
+} YM7128B_MailboxShort;
+
+void YM7128B_MailboxShort_Ctor(YM7128B_MailboxShort* self);
+
+void YM7128B_MailboxShort_Dtor(YM7128B_MailboxShort* self);
+
+//! Posts a register image at the given sample rate, as per the
+//! <tt>--regdump</tt> format of YM7128B_pipe; wait-free, from the single
+//! producer thread.
+void YM7128B_MailboxShort_Post(
+    YM7128B_MailboxShort* self,
+    YM7128B_Register const regs[YM7128B_Reg_Count],
+    YM7128B_TapIdeal sample_rate
+);
+
+//! Attaches the chip to a mailbox, or detaches it if null; the mailbox
+//! serves a single chip, and the chip must not be processing meanwhile.
+//! The posted register images apply at the start of the next processed
+//! blocks, replacing any register writes done meanwhile; images posted for
+//! another sample rate are set up again by the chip, at its own rate.
+void YM7128B_ChipShort_SetMailbox(
+    YM7128B_ChipShort* self,
+    YM7128B_MailboxShort* mailbox
+);
+
+// ============================================================================
+
+//! Bank of Fixed chips, processed in lockstep.
+//! Chip states are stored as structures of arrays, chip index being the
+//! fastest-varying one: <tt>gains_[address * chip_count_ + chip]</tt>,
+//! <tt>buffer_[position * chip_count_ + chip]</tt>, and so on.
+//! All the chips share the same delay line position and oversampler history
+//! index, so that the processing loops run across chips, with contiguous
+//! gains and outputs, and gathered delay taps only.
+//! Each chip produces the same output as a standalone YM7128B_ChipFixed.
+//! The processing arrays share a single allocation, <tt>arena_</tt>, each
+//! aligned to YM7128B_CACHE_LINE, from the hottest to the delay line; the
+//! register values, only read back by the user, are allocated apart.
+typedef struct YM7128B_ChipBankFixed
+{
+    YM7128B_Register* regs_;
+    YM7128B_Fixed* gains_;
+    YM7128B_Tap* taps_;
+    YM7128B_Fixed* t0_d_;
+    YM7128B_Tap tail_;
+    YM7128B_Fixed* buffer_;
+    YM7128B_Fixed* oversampler_;
+    YM7128B_Oversampler_Index oversampler_index_;
+    YM7128B_Accumulator* accums_;
+    size_t chip_count_;
+    void* arena_;
+} YM7128B_ChipBankFixed;
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipBankFixed_Ctor(YM7128B_ChipBankFixed* self);
+
+void YM7128B_ChipBankFixed_Dtor(YM7128B_ChipBankFixed* self);
+
+void YM7128B_ChipBankFixed_Reset(YM7128B_ChipBankFixed* self);
+
+void YM7128B_ChipBankFixed_Start(YM7128B_ChipBankFixed* self);
+
+void YM7128B_ChipBankFixed_Stop(YM7128B_ChipBankFixed* self);
+
+//! Processes a block of mono input samples, interleaved by chip:
+//! <tt>inputs[index * chip_count + chip]</tt>.
+//! Each output buffer receives <tt>count * YM7128B_Oversampling</tt> frames,
+//! interleaved the same way.
+void YM7128B_ChipBankFixed_ProcessBlock(
+    YM7128B_ChipBankFixed* self,
+    YM7128B_Fixed const* inputs,
+    size_t count,
+    YM7128B_Fixed* outputs_left,
+    YM7128B_Fixed* outputs_right
+);
+
+YM7128B_Register YM7128B_ChipBankFixed_Read(
+    YM7128B_ChipBankFixed const* self,
+    size_t chip,
+    YM7128B_Address address
+);
+
+void YM7128B_ChipBankFixed_Write(
+    YM7128B_ChipBankFixed* self,
+    size_t chip,
+    YM7128B_Address address,
+    YM7128B_Register data
+);
+
+//! Allocates the status of <tt>chip_count</tt> chips, with cleared registers.
+//! To be called before Reset(); returns false on allocation failure.
+bool YM7128B_ChipBankFixed_Setup(
+    YM7128B_ChipBankFixed* self,
+    size_t chip_count
+);
+
+// ============================================================================
+
+//! Bank of Float chips, processed in lockstep.
+//! Chip states are stored as structures of arrays, chip index being the
+//! fastest-varying one: <tt>gains_[address * chip_count_ + chip]</tt>,
+//! <tt>buffer_[position * chip_count_ + chip]</tt>, and so on.
+//! All the chips share the same delay line position and oversampler history
+//! index, so that the processing loops run across chips, with contiguous
+//! gains and outputs, and gathered delay taps only.
+//! Each chip produces the same output as a standalone YM7128B_ChipFloat.
+//! The tap mix kernels run a chip per vector lane, so that wider vectors
+//! (and single precision) process more chips at once, with the same results.
+typedef struct YM7128B_ChipBankFloat
+{
+    YM7128B_Register* regs_;
+    YM7128B_Float* gains_;
+    YM7128B_Tap* taps_;
+    YM7128B_Float* t0_d_;
+    YM7128B_Tap tail_;
+    YM7128B_Float* buffer_;
+    YM7128B_Float* oversampler_;
+    YM7128B_Oversampler_Index oversampler_index_;
+    YM7128B_Float* accums_;
+    size_t chip_count_;
+    YM7128B_Kernel kernel_;
+} YM7128B_ChipBankFloat;
+
+// ----------------------------------------------------------------------------
+
+void YM7128B_ChipBankFloat_Ctor(YM7128B_ChipBankFloat* self);
+
+void YM7128B_ChipBankFloat_Dtor(YM7128B_ChipBankFloat* self);
+
+void YM7128B_ChipBankFloat_Reset(YM7128B_ChipBankFloat* self);
+
+void YM7128B_ChipBankFloat_Start(YM7128B_ChipBankFloat* self);
+
+void YM7128B_ChipBankFloat_Stop(YM7128B_ChipBankFloat* self);
+
+//! Processes a block of mono input samples, interleaved by chip:
+//! <tt>inputs[index * chip_count + chip]</tt>.
+//! Each output buffer receives <tt>count * YM7128B_Oversampling</tt> frames,
+//! interleaved the same way.
+void YM7128B_ChipBankFloat_ProcessBlock(
+    YM7128B_ChipBankFloat* self,
+    YM7128B_Float const* inputs,
+    size_t count,
+    YM7128B_Float* outputs_left,
+    YM7128B_Float* outputs_right
+);
+
+YM7128B_Register YM7128B_ChipBankFloat_Read(
+    YM7128B_ChipBankFloat const* self,
+    size_t chip,
+    YM7128B_Address address
+);
+
+void YM7128B_ChipBankFloat_Write(
+    YM7128B_ChipBankFloat* self,
+    size_t chip,
+    YM7128B_Address address,
+    YM7128B_Register data
+);
+
+//! Allocates the status of <tt>chip_count</tt> chips, with cleared registers.
+//! To be called before Reset(); returns false on allocation failure.
+bool YM7128B_ChipBankFloat_Setup(
+    YM7128B_ChipBankFloat* self,
+    size_t chip_count
+);
+
+//! Selects the processing kernel; returns false if not supported.
+//! The constructor selects the best supported kernel by default.
+bool YM7128B_ChipBankFloat_SetKernel(
+    YM7128B_ChipBankFloat* self,
+    YM7128B_Kernel kernel
+);
+
+// ============================================================================
+
+//! Memory allocator of generic chips; null functions select malloc() and free()
+typedef struct YM7128B_Allocator
+{
+    void* (*alloc)(void* context, size_t size);    //!< Returns null on failure
+    void (*free)(void* context, void* memory);
+    void* context;  //!< Passed to the functions
+} YM7128B_Allocator;
+
+//! Function table of an engine, driving its chip status via generic chips.
+//! Block I/O is uniform: mono <tt>YM7128B_Float</tt> inputs, and left/right
+//! <tt>YM7128B_Float</tt> outputs of <tt>output_ratio</tt> samples per
+//! input sample; fixed point engines convert samples on the fly.
+typedef struct YM7128B_ChipVtable
+{
+    YM7128B_ChipEngine engine;
+    size_t state_size;    //!< Chip status size [bytes]
+    size_t output_ratio;  //!< Output samples per input sample
+
+    void (*ctor)(void* state);
+    void (*dtor)(void* state);
+    size_t (*required_bytes)(YM7128B_TapIdeal sample_rate);  //!< Delay memory; null if built in
+    bool (*setup_with_memory)(void* state, YM7128B_TapIdeal sample_rate, void* memory, size_t bytes);
+    void (*reset)(void* state);
+    void (*start)(void* state);
+    void (*stop)(void* state);
+    YM7128B_Register (*read)(void const* state, YM7128B_Address address);
+    void (*write)(void* state, YM7128B_Address address, YM7128B_Register data);
+    void (*process_block)(
+        void* state,
+        YM7128B_Float const* inputs,
+        size_t count,
+        YM7128B_Float* outputs_left,
+        YM7128B_Float* outputs_right
+    );
+} YM7128B_ChipVtable;
+
+//! Function tables, by YM7128B_ChipEngine
+extern YM7128B_ChipVtable const YM7128B_Chip_Vtables[YM7128B_ChipEngine_Count];
+
+//! Engine-agnostic chip handle, dispatching each call via the function table
+//! of its current engine, which can be swapped while running.
+//! The status of the engine chip and its delay memory share a single
+//! allocation; the Fixed and Float engines run at YM7128B_Input_Rate,
+//! regardless of the sample rate.
+typedef struct YM7128B_Chip
+{
+    YM7128B_ChipVtable const* vtable_;
+    void* state_;
+    YM7128B_TapIdeal sample_rate_;
+    YM7128B_Allocator allocator_;
+    bool started_;
+} YM7128B_Chip;
+
+// ----------------------------------------------------------------------------
+
+//! Creates a chip of the given engine, with cleared registers, ready to be
+//! started; a null allocator selects malloc() and free().
+//! Returns null on allocation failure.
+YM7128B_Chip* YM7128B_Chip_Create(
+    YM7128B_ChipEngine engine,
+    YM7128B_TapIdeal sample_rate,
+    YM7128B_Allocator const* allocator
+);
+
+void YM7128B_Chip_Destroy(YM7128B_Chip* self);
+
+void YM7128B_Chip_Reset(YM7128B_Chip* self);
+
+void YM7128B_Chip_Start(YM7128B_Chip* self);
+
+void YM7128B_Chip_Stop(YM7128B_Chip* self);
+
+YM7128B_Register YM7128B_Chip_Read(
+    YM7128B_Chip const* self,
+    YM7128B_Address address
+);
+
+void YM7128B_Chip_Write(
+    YM7128B_Chip* self,
+    YM7128B_Address address,
+    YM7128B_Register data
+);
+
+//! Processes a block of contiguous mono input samples, with a single
+//! dispatch. Each output buffer receives
+//! <tt>count * YM7128B_Chip_GetOutputRatio()</tt> samples.
+void YM7128B_Chip_ProcessBlock(
+    YM7128B_Chip* self,
+    YM7128B_Float const* inputs,
+    size_t count,
+    YM7128B_Float* outputs_left,
+    YM7128B_Float* outputs_right
+);
+
+//! Output samples per input sample of the current engine.
+size_t YM7128B_Chip_GetOutputRatio(YM7128B_Chip const* self);
+
+YM7128B_ChipEngine YM7128B_Chip_GetEngine(YM7128B_Chip const* self);
+
+//! Status of the current engine chip, as per YM7128B_Chip_GetEngine(),
+//! for engine specific calls.
+void* YM7128B_Chip_GetState(YM7128B_Chip* self);
+
+//! Swaps the engine between blocks, keeping the registers and the running
+//! state, and the output ratio may change.
+//! Within the same family (Fixed and Float, or Ideal and Short), the delay
+//! line and interpolators carry over, converted to the new sample type, so
+//! the echo tail goes on; across families, the delay line restarts from
+//! silence.
+//! The filter and kernel choices carry over to engines having them, and the
+//! scheduled writes stay pending, rebased to the new input rate.
+//! Shared patches and mailboxes are engine specific: the new chip owns a
+//! copy of the current registers, taking any fresh mailbox post first, and
+//! the caller attaches a new patch or mailbox via YM7128B_Chip_GetState().
+//! Returns false on allocation failure, leaving the chip unchanged.
+bool YM7128B_Chip_SetEngine(
+    YM7128B_Chip* self,
+    YM7128B_ChipEngine engine
+);
+
 // ============================================================================
 
 #ifdef __cplusplus
@@ -0,0 +1,906 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2020-2023, Andrea Zoppi
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// C++17 front-end to the C library.
+//
+// YM7128B::Chip wraps the very same chip structures of YM7128B_emu.h, so that
+// it can be passed to the C functions via state(), and vice versa.
+// Its block processing is a template kernel, with the engine arithmetic, the
+// sample type and the oversampler fixed at compile time: all the policies are
+// constexpr, so that the compiler can fully inline them and unroll the tap
+// and interpolator loops.
+// Its results are the same as those of the C library, built with the same
+// floating point options.
+// The performance counters of YM7128B_USE_STATS are not updated by the
+// template kernel.
+
+#ifndef _YM7128B_EMU_HPP_
+#define _YM7128B_EMU_HPP_
+
+#include "YM7128B_emu.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace YM7128B {
+
+// ============================================================================
+
+//! Emulation engines, as per the C chip types
+enum class Engine {
+    Fixed,  //!< YM7128B_ChipFixed
+    Float,  //!< YM7128B_ChipFloat
+    Ideal,  //!< YM7128B_ChipIdeal
+    Short,  //!< YM7128B_ChipShort
+};
+
+// ============================================================================
+// Arithmetic policies: constexpr copies of the YM7128B_emu.h operators, with
+// the same results.
+
+//! Fixed engine arithmetic: YM7128B_MulFixed and friends
+struct ArithmeticFixed {
+    using Sample = YM7128B_Fixed;
+    using Accumulator = YM7128B_Accumulator;
+
+    //! Multiplications by a zero gain yield exactly zero
+    static constexpr bool Exact_Zero = true;
+
+    static constexpr Sample Input(Sample input)
+    {
+        return (Sample)(input & (Sample)YM7128B_Signal_Mask);
+    }
+
+    static constexpr Sample Clamp(Accumulator signal)
+    {
+        if (signal < YM7128B_Fixed_Min) {
+            signal = YM7128B_Fixed_Min;
+        }
+        if (signal > YM7128B_Fixed_Max) {
+            signal = YM7128B_Fixed_Max;
+        }
+        return (Sample)((Sample)signal & (Sample)YM7128B_Operand_Mask);
+    }
+
+    static constexpr Sample Add(Sample a, Sample b)
+    {
+        Accumulator aa = a & (Sample)YM7128B_Operand_Mask;
+        Accumulator bb = b & (Sample)YM7128B_Operand_Mask;
+        return Clamp(aa + bb);
+    }
+
+    static constexpr Sample Mul(Sample a, Sample b)
+    {
+        Accumulator aa = a & (Sample)YM7128B_Operand_Mask;
+        Accumulator bb = b & (Sample)YM7128B_Operand_Mask;
+        Accumulator mm = aa * bb;
+        Sample x = (Sample)(((mm >> (YM7128B_Fixed_Decimals - 1)) + 1) >> 1);
+        return (Sample)(x & (Sample)YM7128B_Operand_Mask);
+    }
+
+    static constexpr Accumulator Accumulate(Accumulator accum, Sample product)
+    {
+        return accum + product;
+    }
+
+    static constexpr Sample Total(Accumulator accum)
+    {
+        return Clamp(accum);
+    }
+
+    static constexpr Sample Output(Sample total)
+    {
+        return (Sample)(total & (Sample)YM7128B_Signal_Mask);
+    }
+
+    static constexpr Sample Coeff(double real)
+    {
+        return (Sample)((Sample)(real * YM7128B_Fixed_Max) & (Sample)YM7128B_Coeff_Mask);
+    }
+};
+
+// ----------------------------------------------------------------------------
+
+//! Float engine arithmetic: YM7128B_MulFloat and friends, clamped
+struct ArithmeticFloat {
+    using Sample = YM7128B_Float;
+    using Accumulator = YM7128B_Float;
+
+    static constexpr bool Exact_Zero = false;
+
+    static constexpr Sample Input(Sample input)
+    {
+        return input;
+    }
+
+    static constexpr Sample Clamp(Sample signal)
+    {
+        if (signal < YM7128B_Float_Min) {
+            return YM7128B_Float_Min;
+        }
+        if (signal > YM7128B_Float_Max) {
+            return YM7128B_Float_Max;
+        }
+        return signal;
+    }
+
+    static constexpr Sample Add(Sample a, Sample b)
+    {
+        return Clamp(a + b);
+    }
+
+    static constexpr Sample Mul(Sample a, Sample b)
+    {
+        return a * b;
+    }
+
+    static constexpr Accumulator Accumulate(Accumulator accum, Sample product)
+    {
+        return accum + product;
+    }
+
+    static constexpr Sample Total(Accumulator accum)
+    {
+        return Clamp(accum);
+    }
+
+    static constexpr Sample Output(Sample total)
+    {
+        return total;
+    }
+
+    static constexpr Sample Coeff(double real)
+    {
+        return (Sample)real;
+    }
+};
+
+// ----------------------------------------------------------------------------
+
+//! Ideal engine arithmetic: unclamped YM7128B_MulFloat and YM7128B_AddFloat
+struct ArithmeticIdeal {
+    using Sample = YM7128B_Float;
+    using Accumulator = YM7128B_Float;
+
+    static constexpr bool Exact_Zero = false;
+
+    static constexpr Sample Input(Sample input)
+    {
+        return input;
+    }
+
+    static constexpr Sample Add(Sample a, Sample b)
+    {
+        return a + b;
+    }
+
+    static constexpr Sample Mul(Sample a, Sample b)
+    {
+        return a * b;
+    }
+
+    static constexpr Accumulator Accumulate(Accumulator accum, Sample product)
+    {
+        return accum + product;
+    }
+
+    static constexpr Sample Total(Accumulator accum)
+    {
+        return accum;
+    }
+
+    //! Output level without oversampling
+    static constexpr Sample Level(Sample total)
+    {
+        return Mul(total, 1 / (Sample)YM7128B_Oversampling);
+    }
+};
+
+// ----------------------------------------------------------------------------
+
+//! Short engine arithmetic: YM7128B_MulShort and friends
+struct ArithmeticShort {
+    using Sample = YM7128B_Fixed;
+    using Accumulator = YM7128B_Fixed;
+
+    static constexpr bool Exact_Zero = true;
+
+    static constexpr Sample Input(Sample input)
+    {
+        return input;
+    }
+
+    static constexpr Sample Clamp(YM7128B_Accumulator signal)
+    {
+        if (signal < YM7128B_Fixed_Min) {
+            return (Sample)YM7128B_Fixed_Min;
+        }
+        if (signal > YM7128B_Fixed_Max) {
+            return (Sample)YM7128B_Fixed_Max;
+        }
+        return (Sample)signal;
+    }
+
+    static constexpr Sample Add(Sample a, Sample b)
+    {
+        YM7128B_Accumulator aa = a;
+        YM7128B_Accumulator bb = b;
+        return Clamp(aa + bb);
+    }
+
+    static constexpr Sample Mul(Sample a, Sample b)
+    {
+        YM7128B_Accumulator aa = a;
+        YM7128B_Accumulator bb = b;
+        YM7128B_Accumulator mm = aa * bb;
+        return (Sample)((((mm >> YM7128B_Fixed_Decimals) - 1) + 1) >> 1);
+    }
+
+    //! Wraps around, as the 16-bit sums of the C kernels
+    static constexpr Accumulator Accumulate(Accumulator accum, Sample product)
+    {
+        return (Accumulator)(accum + product);
+    }
+
+    static constexpr Sample Total(Accumulator accum)
+    {
+        return accum;
+    }
+
+    //! Output level without oversampling
+    static constexpr Sample Level(Sample total)
+    {
+        return (Sample)(total / (Sample)YM7128B_Oversampling);
+    }
+};
+
+// ============================================================================
+// Oversampler policies: the interpolators keep the history layout of
+// YM7128B_InterpolatorFixed and YM7128B_InterpolatorFloat, whatever the kernel.
+
+//! Linear phase interpolator kernel
+struct InterpolatorLinear {
+    static constexpr unsigned Factor = YM7128B_Oversampler_Factor;
+    static constexpr YM7128B_Filter Filter = YM7128B_Filter_Linear;
+    static constexpr size_t Latency = 9;  //!< As per YM7128B_Filter_GetLatency()
+
+    static constexpr double Kernel[YM7128B_Oversampler_Factor][YM7128B_Interpolator_Stride] =
+    {
+        {  // even phase
+            +0.005969087803865891,
+            -0.016623943725986926,
+            +0.038895802111020034,
+            -0.089238395139830201,
+            +0.312314472963171053,
+            +0.312314472963171053,
+            -0.089238395139830201,
+            +0.038895802111020034,
+            -0.016623943725986926,
+            +0.005969087803865891
+        },
+        {  // odd phase
+            -0.003826518613910499,
+            +0.007053928712894589,
+            -0.010501507751597486,
+            +0.013171814880420758,
+            +0.485820312497107776,
+            +0.013171814880420758,
+            -0.010501507751597486,
+            +0.007053928712894589,
+            -0.003826518613910499
+        }
+    };
+};
+
+// ----------------------------------------------------------------------------
+
+//! Minimum phase interpolator kernel
+struct InterpolatorMinimum {
+    static constexpr unsigned Factor = YM7128B_Oversampler_Factor;
+    static constexpr YM7128B_Filter Filter = YM7128B_Filter_Minimum;
+    static constexpr size_t Latency = 2;  //!< As per YM7128B_Filter_GetLatency()
+
+    static constexpr double Kernel[YM7128B_Oversampler_Factor][YM7128B_Interpolator_Stride] =
+    {
+        {  // even phase
+            +0.073585247514714749,
+            +0.442535202999738531,
+            +0.026195691646307945,
+            -0.081176763571493171,
+            +0.067960765530891545,
+            -0.044393769145659796,
+            +0.023451305043275420,
+            -0.009480786001493536,
+            +0.003347671274177581,
+            +0.000483958628744376
+        },
+        {  // odd phase
+            +0.269340051166713890,
+            +0.350129745841520346,
+            -0.178423532471468610,
+            +0.083194010466739091,
+            -0.035840063980478287,
+            +0.013156688603347873,
+            -0.004374029821991059,
+            +0.002700502551912207,
+            -0.002391896275498628
+        }
+    };
+};
+
+// ----------------------------------------------------------------------------
+
+//! Low order half-band interpolator kernel, for the lowest latency
+struct InterpolatorLowOrder {
+    static constexpr unsigned Factor = YM7128B_Oversampler_Factor;
+    static constexpr YM7128B_Filter Filter = YM7128B_Filter_LowOrder;
+    static constexpr size_t Latency = 3;  //!< As per YM7128B_Filter_GetLatency()
+
+    static constexpr double Kernel[YM7128B_Oversampler_Factor][YM7128B_Interpolator_Stride] =
+    {
+        {  // even phase
+            -0.031250000000000000,
+            +0.281250000000000000,
+            +0.281250000000000000,
+            -0.031250000000000000
+        },
+        {  // odd phase
+            +0.000000000000000000,
+            +0.500000000000000000,
+            +0.000000000000000000
+        }
+    };
+};
+
+// ----------------------------------------------------------------------------
+
+//! Interpolator kernel of YM7128B_Filter_Default, as per YM7128B_USE_MINPHASE
+using InterpolatorDefault = std::conditional_t<YM7128B_USE_MINPHASE, InterpolatorMinimum, InterpolatorLinear>;
+
+//! No oversampling, as required by the Ideal and Short engines
+struct Direct {
+    static constexpr unsigned Factor = 1;
+    static constexpr size_t Latency = 0;
+};
+
+// ============================================================================
+
+//! Per-engine C types and functions
+template <Engine E>
+struct EngineTraits;
+
+#define YM7128B_ENGINE_TRAITS_(name, arithmetic, oversampler, heap) \
+    template <> \
+    struct EngineTraits<Engine::name> { \
+        using State = YM7128B_Chip##name; \
+        using Arithmetic = arithmetic; \
+        using Sample = typename Arithmetic::Sample; \
+        using DefaultOversampler = oversampler; \
+        static constexpr bool Heap = heap; /*!< Heap delay line of length_ */ \
+        static void Ctor(State* self) { YM7128B_Chip##name##_Ctor(self); } \
+        static void Dtor(State* self) { YM7128B_Chip##name##_Dtor(self); } \
+        static void Reset(State* self) { YM7128B_Chip##name##_Reset(self); } \
+        static void Start(State* self) { YM7128B_Chip##name##_Start(self); } \
+        static void Stop(State* self) { YM7128B_Chip##name##_Stop(self); } \
+        static bool IsIdle(State const* self) { return YM7128B_Chip##name##_IsIdle(self); } \
+        static YM7128B_Register Read(State const* self, YM7128B_Address address) \
+        { \
+            return YM7128B_Chip##name##_Read(self, address); \
+        } \
+        static void Write(State* self, YM7128B_Address address, YM7128B_Register data) \
+        { \
+            YM7128B_Chip##name##_Write(self, address, data); \
+        } \
+        static void ProcessBlock( \
+            State* self, \
+            Sample const* inputs, \
+            size_t count, \
+            Sample* outputs_left, \
+            Sample* outputs_right \
+        ) \
+        { \
+            YM7128B_Chip##name##_ProcessBlock(self, inputs, count, outputs_left, outputs_right); \
+        } \
+    };
+
+YM7128B_ENGINE_TRAITS_(Fixed, ArithmeticFixed, InterpolatorDefault, false)
+YM7128B_ENGINE_TRAITS_(Float, ArithmeticFloat, InterpolatorDefault, false)
+YM7128B_ENGINE_TRAITS_(Ideal, ArithmeticIdeal, Direct, true)
+YM7128B_ENGINE_TRAITS_(Short, ArithmeticShort, Direct, true)
+
+#undef YM7128B_ENGINE_TRAITS_
+
+// ============================================================================
+
+//! Chip emulator, processing blocks of SampleT with a compile-time kernel.
+//!
+//! SampleT is either the native sample type of the engine, a floating point
+//! type, or int16_t, converted as by the pipe example.
+//! The Oversampler is an interpolator policy for the Fixed and Float engines,
+//! and Direct for the Ideal and Short engines.
+template <
+    Engine E,
+    typename SampleT = typename EngineTraits<E>::Sample,
+    typename Oversampler = typename EngineTraits<E>::DefaultOversampler
+>
+class Chip {
+public:
+    using Traits = EngineTraits<E>;
+    using State = typename Traits::State;    //!< C chip structure
+    using Native = typename Traits::Sample;  //!< Sample type of the engine
+    using Sample = SampleT;
+
+    //! Output samples per input sample
+    static constexpr size_t Oversampling = Oversampler::Factor;
+
+    //! Latency of the outputs [output samples]
+    static constexpr size_t Latency = Oversampler::Latency;
+
+    static_assert(
+        (Oversampler::Factor == 1) == Traits::Heap,
+        "Fixed and Float engines need an interpolator, Ideal and Short engines need Direct"
+    );
+    static_assert(
+        std::is_same_v<SampleT, Native> || std::is_floating_point_v<SampleT> ||
+        std::is_same_v<SampleT, int16_t>,
+        "Unsupported sample type"
+    );
+
+    //! Constructs the chip with its registers reset, and the filter of the
+    //! Oversampler selected for the C functions too.
+    Chip()
+    {
+        Traits::Ctor(&state_);
+        Traits::Reset(&state_);
+        if constexpr (Oversampling > 1) {
+            state_.filter_ = Oversampler::Filter;
+        }
+    }
+
+    ~Chip() { Traits::Dtor(&state_); }
+
+    Chip(Chip const&) = delete;
+    Chip& operator=(Chip const&) = delete;
+
+    //! C chip structure, for use with the C library functions
+    State& state() { return state_; }
+    State const& state() const { return state_; }
+
+    void Reset() { Traits::Reset(&state_); }
+    void Start() { Traits::Start(&state_); }
+    void Stop() { Traits::Stop(&state_); }
+    bool IsIdle() const { return Traits::IsIdle(&state_); }
+
+    YM7128B_Register Read(YM7128B_Address address) const
+    {
+        return Traits::Read(&state_, address);
+    }
+
+    void Write(YM7128B_Address address, YM7128B_Register data)
+    {
+        Traits::Write(&state_, address, data);
+    }
+
+    //! Sets up the heap delay line of the Ideal and Short engines.
+    void Setup(YM7128B_TapIdeal sample_rate)
+    {
+        static_assert(Traits::Heap, "Only for the Ideal and Short engines");
+        if constexpr (E == Engine::Ideal) {
+            YM7128B_ChipIdeal_Setup(&state_, sample_rate);
+        }
+        else {
+            YM7128B_ChipShort_Setup(&state_, sample_rate);
+        }
+    }
+
+    //! Processes a block of contiguous mono input samples, as per the
+    //! ProcessBlock function of the C engine; each output channel gets
+    //! <tt>count * Oversampling</tt> samples.
+    void ProcessBlock(
+        SampleT const* inputs,
+        size_t count,
+        SampleT* outputs_left,
+        SampleT* outputs_right
+    )
+    {
+        assert(inputs || !count);
+        assert(outputs_left || !count);
+        assert(outputs_right || !count);
+
+        if constexpr (std::is_same_v<SampleT, Native>) {
+            ProcessNative_(inputs, count, outputs_left, outputs_right);
+        }
+        else {
+            Native native_inputs[Chunk_Length_];
+            Native native_left[Chunk_Length_ * Oversampling];
+            Native native_right[Chunk_Length_ * Oversampling];
+
+            while (count) {
+                size_t length = (count < Chunk_Length_) ? count : Chunk_Length_;
+
+                for (size_t i = 0; i < length; ++i) {
+                    native_inputs[i] = ToNative_(inputs[i]);
+                }
+
+                ProcessNative_(native_inputs, length, native_left, native_right);
+
+                for (size_t i = 0; i < length * Oversampling; ++i) {
+                    outputs_left[i] = FromNative_(native_left[i]);
+                    outputs_right[i] = FromNative_(native_right[i]);
+                }
+
+                inputs += length;
+                outputs_left += length * Oversampling;
+                outputs_right += length * Oversampling;
+                count -= length;
+            }
+        }
+    }
+
+private:
+    using Arithmetic = typename Traits::Arithmetic;
+    using Accumulator = typename Arithmetic::Accumulator;
+    using Position = decltype(State::tail_);
+
+    static constexpr size_t Chunk_Length_ = 256;  // converted samples per chunk
+
+    State state_;
+
+    // ------------------------------------------------------------------------
+
+    static constexpr Native ToNative_(SampleT x)
+    {
+        if constexpr (std::is_floating_point_v<Native>) {
+            if constexpr (std::is_floating_point_v<SampleT>) {
+                return (Native)x;
+            }
+            else {
+                return (Native)x / -(Native)INT16_MIN;
+            }
+        }
+        else {
+            YM7128B_Float y = ArithmeticFloat::Clamp((YM7128B_Float)x);
+            return (Native)(y * (YM7128B_Float)YM7128B_Fixed_Max);
+        }
+    }
+
+    static constexpr SampleT FromNative_(Native y)
+    {
+        if constexpr (std::is_floating_point_v<Native>) {
+            if constexpr (std::is_floating_point_v<SampleT>) {
+                return (SampleT)y;
+            }
+            else {
+                double scaled = y * -(double)INT16_MIN;
+                scaled = (scaled < INT16_MIN) ? INT16_MIN : scaled;
+                scaled = (scaled > INT16_MAX) ? INT16_MAX : scaled;
+                return (SampleT)scaled;
+            }
+        }
+        else {
+            return (SampleT)((YM7128B_Float)y * ((YM7128B_Float)1 / (YM7128B_Float)YM7128B_Fixed_Max));
+        }
+    }
+
+    // ------------------------------------------------------------------------
+
+    // Interpolator kernel coefficients, in the engine format
+    struct KernelTable_ {
+        Native coeffs[YM7128B_Oversampler_Factor][YM7128B_Interpolator_Stride];
+    };
+
+    static constexpr KernelTable_ MakeKernel_()
+    {
+        KernelTable_ table = {};
+        if constexpr (Oversampling > 1) {
+            for (unsigned phase = 0; phase < YM7128B_Oversampler_Factor; ++phase) {
+                for (unsigned i = 0; i < YM7128B_Interpolator_Stride; ++i) {
+                    table.coeffs[phase][i] = Arithmetic::Coeff(Oversampler::Kernel[phase][i]);
+                }
+            }
+        }
+        return table;
+    }
+
+    static constexpr KernelTable_ Coeffs_ = MakeKernel_();
+
+    // ------------------------------------------------------------------------
+
+    // Wraps a delay line position from below twice the buffer length
+    Position Wrap_(Position position) const
+    {
+        if constexpr (Traits::Heap) {
+            return (position >= state_.length_) ? (position - state_.length_) : position;
+        }
+        else if constexpr (YM7128B_USE_POW2_DELAY) {
+            return position & (Position)(YM7128B_Buffer_Capacity - 1);
+        }
+        else {
+            return (position >= YM7128B_Buffer_Capacity) ? (position - YM7128B_Buffer_Capacity) : position;
+        }
+    }
+
+    // Moves the delay line tail one sample back
+    Position Step_(Position tail) const
+    {
+        if constexpr (Traits::Heap) {
+            return tail ? (tail - 1) : (state_.length_ - 1);
+        }
+        else {
+            return Wrap_((Position)(tail + (YM7128B_Buffer_Capacity - 1)));
+        }
+    }
+
+    static size_t Rewind_(size_t position, size_t steps, size_t length)
+    {
+        steps %= length;
+        return (position >= steps) ? (position - steps) : (position + length - steps);
+    }
+
+    // ------------------------------------------------------------------------
+
+    template <typename Interpolator>
+    static void Interpolate_(Interpolator* self, Native input, Native* outputs)
+    {
+        YM7128B_Oversampler_Index index = self->index_;
+        index = index ? (index - 1) : (YM7128B_Interpolator_Length - 1);
+        self->index_ = index;
+        self->buffer_[index] = input;
+        self->buffer_[index + YM7128B_Interpolator_Length] = input;
+
+        Native const* window = &self->buffer_[index];
+
+        for (unsigned phase = 0; phase < YM7128B_Oversampler_Factor; ++phase) {
+            unsigned length = YM7128B_Interpolator_PhaseLength(phase);
+            Accumulator accum = 0;
+
+            for (unsigned i = 0; i < length; ++i) {
+                Native oversampled = Arithmetic::Mul(window[i], Coeffs_.coeffs[phase][i]);
+                accum = Arithmetic::Accumulate(accum, oversampled);
+            }
+
+            outputs[phase] = Arithmetic::Output(Arithmetic::Total(accum));
+        }
+    }
+
+    // ------------------------------------------------------------------------
+
+    // Digital silence fast path, as per the C engines
+    size_t ProcessIdle_(
+        Native const* inputs,
+        size_t count,
+        Native* outputs_left,
+        Native* outputs_right
+    )
+    {
+        if (!count || !Traits::IsIdle(&state_)) {
+            return 0;
+        }
+
+        size_t idle = 0;
+        while ((idle < count) && !Arithmetic::Input(inputs[idle])) {
+            ++idle;
+        }
+
+        // Silent taps sum up to +0, which negative output gains turn into -0
+        Native zeros[YM7128B_OutputChannel_Count] = { 0, 0 };
+        if constexpr (Oversampling == 1) {
+            auto const* patch = state_.patch_ ? state_.patch_ : &state_.own_;
+            for (unsigned channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+                zeros[channel] = Arithmetic::Level(Arithmetic::Mul(Native(0), patch->gains_[YM7128B_Reg_VL + channel]));
+            }
+        }
+
+        for (size_t i = 0; i < idle * Oversampling; ++i) {
+            outputs_left[i] = zeros[YM7128B_OutputChannel_Left];
+            outputs_right[i] = zeros[YM7128B_OutputChannel_Right];
+        }
+
+        if constexpr (Traits::Heap) {
+            state_.tail_ = Rewind_(state_.tail_, idle, state_.length_);
+        }
+        else {
+            // Clears the spare capacity coming back into view
+            size_t spare = 0;
+            if (state_.silence_ < YM7128B_Buffer_Capacity) {
+                spare = YM7128B_Buffer_Capacity - state_.silence_;
+                if (spare > idle) {
+                    spare = idle;
+                }
+            }
+            for (size_t i = 0; i < spare; ++i) {
+                state_.tail_ = Step_(state_.tail_);
+                state_.buffer_[state_.tail_] = 0;
+            }
+            state_.tail_ = (Position)Rewind_(state_.tail_, idle - spare, YM7128B_Buffer_Capacity);
+
+            for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+                YM7128B_Oversampler_Index* index = &state_.oversampler_[channel].index_;
+                *index = (YM7128B_Oversampler_Index)Rewind_(*index, idle, YM7128B_Interpolator_Length);
+            }
+        }
+        state_.silence_ += idle;
+        return idle;
+    }
+
+    // ------------------------------------------------------------------------
+
+    template <bool Feedback>
+    void Kernel_(
+        Native const* inputs,
+        size_t count,
+        Native* outputs_left,
+        Native* outputs_right
+    )
+    {
+        Native* outputs[YM7128B_OutputChannel_Count] = { outputs_left, outputs_right };
+
+        auto const* patch = state_.patch_ ? state_.patch_ : &state_.own_;
+        Native const* gains = patch->gains_;
+        Position tail = state_.tail_;
+        Native t0_d = state_.t0_d_;
+        auto silence = state_.silence_;
+
+        for (size_t index = 0; index < count; ++index) {
+            Native sample = Arithmetic::Input(inputs[index]);
+
+            Native filter_t0 = state_.buffer_[Wrap_((Position)(tail + patch->taps_[0]))];
+            Native filter_d  = t0_d;
+            t0_d = filter_t0;
+            Native filter_vc = 0;
+            if constexpr (Feedback) {
+                Native filter_c0  = Arithmetic::Mul(filter_t0, gains[YM7128B_Reg_C0]);
+                Native filter_c1  = Arithmetic::Mul(filter_d, gains[YM7128B_Reg_C1]);
+                Native filter_sum = Arithmetic::Add(filter_c0, filter_c1);
+                filter_vc = Arithmetic::Mul(filter_sum, gains[YM7128B_Reg_VC]);
+            }
+
+            Native input_vm  = Arithmetic::Mul(sample, gains[YM7128B_Reg_VM]);
+            Native input_sum = Arithmetic::Add(input_vm, filter_vc);
+
+            tail = Step_(tail);
+            state_.buffer_[tail] = input_sum;
+            silence = (input_sum != 0) ? 0 : (silence + 1);
+
+            Accumulator accums[YM7128B_OutputChannel_Count] = { 0, 0 };
+
+            for (unsigned lane = 0; lane < YM7128B_Gain_Lane_Count; ++lane) {
+                Native buffered = state_.buffer_[Wrap_((Position)(tail + patch->taps_[lane + 1]))];
+
+                for (unsigned channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+                    Native g = gains[YM7128B_Reg_GL1 + (channel * YM7128B_Gain_Lane_Count) + lane];
+                    accums[channel] = Arithmetic::Accumulate(accums[channel], Arithmetic::Mul(buffered, g));
+                }
+            }
+
+            for (unsigned channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+                Native total = Arithmetic::Total(accums[channel]);
+                Native total_v = Arithmetic::Mul(total, gains[YM7128B_Reg_VL + channel]);
+
+                if constexpr (Oversampling > 1) {
+                    Interpolate_(&state_.oversampler_[channel], total_v, &outputs[channel][index * Oversampling]);
+                }
+                else {
+                    outputs[channel][index] = Arithmetic::Level(total_v);
+                }
+            }
+        }
+
+        state_.tail_ = tail;
+        state_.t0_d_ = t0_d;
+        state_.silence_ = silence;
+    }
+
+    // ------------------------------------------------------------------------
+
+    void ProcessSpan_(
+        Native const* inputs,
+        size_t count,
+        Native* outputs_left,
+        Native* outputs_right
+    )
+    {
+        if constexpr (Traits::Heap) {
+            if ((state_.buffer_ == nullptr) || (state_.length_ == 0)) {
+                return;
+            }
+        }
+
+        size_t idle = ProcessIdle_(inputs, count, outputs_left, outputs_right);
+        inputs += idle;
+        count -= idle;
+        outputs_left += idle * Oversampling;
+        outputs_right += idle * Oversampling;
+
+        // Only the fixed point engines skip silent feedback, as the C kernels
+        if constexpr (Arithmetic::Exact_Zero) {
+            auto const* patch = state_.patch_ ? state_.patch_ : &state_.own_;
+            if (patch->flags_ & YM7128B_PatchFlag_NoFeedback) {
+                Kernel_<false>(inputs, count, outputs_left, outputs_right);
+                return;
+            }
+        }
+        Kernel_<true>(inputs, count, outputs_left, outputs_right);
+    }
+
+    // ------------------------------------------------------------------------
+
+    void ProcessNative_(
+        Native const* inputs,
+        size_t count,
+        Native* outputs_left,
+        Native* outputs_right
+    )
+    {
+        if (state_.mailbox_) {
+            // An empty block just takes the latest mailbox image, if any
+            Traits::ProcessBlock(&state_, inputs, 0, outputs_left, outputs_right);
+        }
+
+        YM7128B_TapIdeal sample_rate = YM7128B_Input_Rate;
+        if constexpr (Traits::Heap) {
+            sample_rate = state_.sample_rate_;
+        }
+
+        YM7128B_WriteQueue* queue = &state_.queue_;
+        YM7128B_WriteEvent const* event;
+        size_t offset;
+        size_t done = 0;
+
+        while (YM7128B_WriteQueue_Peek(queue, count, &offset, &event)) {
+            if (offset > done) {
+                ProcessSpan_(
+                    &inputs[done],
+                    offset - done,
+                    &outputs_left[done * Oversampling],
+                    &outputs_right[done * Oversampling]
+                );
+                done = offset;
+            }
+            Traits::Write(&state_, event->address, event->data);
+            YM7128B_WriteQueue_Pop(queue, offset, sample_rate);
+        }
+
+        if (done < count) {
+            ProcessSpan_(
+                &inputs[done],
+                count - done,
+                &outputs_left[done * Oversampling],
+                &outputs_right[done * Oversampling]
+            );
+        }
+
+        YM7128B_WriteQueue_Advance(queue, count);
+        state_.written_ += count;
+    }
+};
+
+}  // namespace YM7128B
+
+#endif  // _YM7128B_EMU_HPP_